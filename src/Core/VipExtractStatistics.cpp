@@ -29,8 +29,21 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QPainterPath>
+
 #include "VipExtractStatistics.h"
+#include "VipIODevice.h"
+#include "VipProgress.h"
 #include "VipSceneModel.h"
+#include "VipSet.h"
 
 QStringList VipExtractComponent::supportedComponents() const
 {
@@ -708,6 +721,455 @@ void VipExtractStatistics::apply()
 	}
 }
 
+// Statistic flag corresponding to each VipExtractStatistics output
+static const Vip::ArrayStatistic _trace_stats[8] = { Vip::Min, Vip::Max, Vip::Mean, Vip::Std, Vip::PixelCount, Vip::Entropy, Vip::Kurtosis, Vip::Skewness };
+
+namespace
+{
+	/// Pixels [x0, x1) of an image row covered by the shape at index \a shape
+	struct StatsRun
+	{
+		int x0;
+		int x1;
+		int shape;
+	};
+
+	/// Run-length rasterization of a list of shapes clipped to the image rectangle
+	struct StatsLabels
+	{
+		QSize imageSize;
+		QVector<QPainterPath> paths; // shapes used to build the runs
+		QVector<StatsRun> runs;	     // sorted by row, then by x0
+		QVector<qsizetype> rowStart; // runs of row y are in [rowStart[y], rowStart[y+1])
+		QVector<qsizetype> rowPixels; // cumulative pixel count before row y
+
+		void build(const VipShapeList& shapes, const QSize& size)
+		{
+			imageSize = size;
+			paths.resize(shapes.size());
+			const QRect image_rect(QPoint(0, 0), size);
+
+			QVector<StatsRun> tmp;
+			QVector<int> rows;
+			for (int i = 0; i < shapes.size(); ++i) {
+				paths[i] = shapes[i].shape();
+				const QVector<QRect> rects = shapes[i].fillRects();
+				for (const QRect& rect : rects) {
+					const QRect r = rect & image_rect;
+					if (r.isEmpty())
+						continue;
+					for (int y = r.top(); y <= r.bottom(); ++y) {
+						tmp.push_back(StatsRun{ r.left(), r.right() + 1, i });
+						rows.push_back(y);
+					}
+				}
+			}
+
+			// counting sort on rows, then sort each row by x0 so that rows are read from left to right
+			rowStart.fill(0, size.height() + 1);
+			for (int y : rows)
+				++rowStart[y + 1];
+			for (int y = 0; y < size.height(); ++y)
+				rowStart[y + 1] += rowStart[y];
+			runs.resize(tmp.size());
+			QVector<qsizetype> pos = rowStart;
+			for (qsizetype i = 0; i < tmp.size(); ++i)
+				runs[pos[rows[i]]++] = tmp[i];
+
+			rowPixels.fill(0, size.height() + 1);
+			for (int y = 0; y < size.height(); ++y) {
+				std::sort(runs.begin() + rowStart[y], runs.begin() + rowStart[y + 1], [](const StatsRun& a, const StatsRun& b) { return a.x0 < b.x0; });
+				qsizetype count = 0;
+				for (qsizetype r = rowStart[y]; r < rowStart[y + 1]; ++r)
+					count += runs[r].x1 - runs[r].x0;
+				rowPixels[y + 1] = rowPixels[y] + count;
+			}
+		}
+
+		bool isValid(const VipShapeList& shapes, const QSize& size) const
+		{
+			if (size != imageSize || shapes.size() != paths.size())
+				return false;
+			for (int i = 0; i < shapes.size(); ++i)
+				if (shapes[i].shape() != paths[i])
+					return false;
+			return true;
+		}
+	};
+
+	/// Statistics of a single shape, accumulated by one thread and merged afterward
+	struct StatsAccumulator
+	{
+		qsizetype n = 0;
+		double min = 0, max = 0;
+		QPoint minPos, maxPos;
+		double sum = 0, sum2 = 0;
+		double M1 = 0, M2 = 0, M3 = 0, M4 = 0; // central moments, only for skewness and kurtosis
+		std::unordered_map<double, qsizetype> counts; // only for entropy
+
+		VIP_ALWAYS_INLINE void add(double v, int x, int y, bool moments, bool entropy)
+		{
+			if (vipIsNan(v))
+				return;
+			if (!n) {
+				min = max = v;
+				minPos = maxPos = QPoint(x, y);
+			}
+			else if (v < min) {
+				min = v;
+				minPos = QPoint(x, y);
+			}
+			else if (v > max) {
+				max = v;
+				maxPos = QPoint(x, y);
+			}
+			qsizetype n1 = n++;
+			sum += v;
+			sum2 += v * v;
+
+			if (moments) {
+				// same update as detail::ComputeStats
+				double delta = v - M1;
+				double delta_n = delta / n;
+				double delta_n2 = delta_n * delta_n;
+				double term1 = delta * delta_n * n1;
+				M1 += delta_n;
+				M4 += term1 * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * M2 - 4 * delta_n * M3;
+				M3 += term1 * delta_n * (n - 2) - 3 * delta_n * M2;
+				M2 += term1;
+			}
+			if (entropy)
+				++counts[v];
+		}
+
+		/// Merge the statistics of pixels following this accumulator ones (in row major order)
+		void join(const StatsAccumulator& o)
+		{
+			if (!o.n)
+				return;
+			if (!n) {
+				*this = o;
+				return;
+			}
+			if (o.min < min) {
+				min = o.min;
+				minPos = o.minPos;
+			}
+			if (o.max > max) {
+				max = o.max;
+				maxPos = o.maxPos;
+			}
+
+			// combine central moments (see Terriberry, "Computing higher-order moments online")
+			const double na = n, nb = o.n, nn = na + nb;
+			const double delta = o.M1 - M1, delta2 = delta * delta;
+			const double m2 = M2 + o.M2 + delta2 * na * nb / nn;
+			const double m3 = M3 + o.M3 + delta2 * delta * na * nb * (na - nb) / (nn * nn) + 3 * delta * (na * o.M2 - nb * M2) / nn;
+			const double m4 = M4 + o.M4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (nn * nn * nn) + 6 * delta2 * (na * na * o.M2 + nb * nb * M2) / (nn * nn) +
+					  4 * delta * (na * o.M3 - nb * M3) / nn;
+			M1 = (na * M1 + nb * o.M1) / nn;
+			M2 = m2;
+			M3 = m3;
+			M4 = m4;
+
+			n += o.n;
+			sum += o.sum;
+			sum2 += o.sum2;
+			for (const auto& c : o.counts)
+				counts[c.first] += c.second;
+		}
+
+		double mean() const { return n ? sum / n : 0; }
+		double std() const { return n ? std::sqrt((sum2 - n * mean() * mean()) / n) : 0; }
+		double skewness() const { return n ? std::sqrt(double(n)) * M3 / std::pow(M2, 1.5) : 0; }
+		double kurtosis() const { return n ? double(n) * M4 / (M2 * M2) - 3.0 : 0; }
+		double entropy() const
+		{
+			if (!n)
+				return 0;
+			double inv_log_2 = 1 / std::log(2);
+			double res = 0;
+			for (const auto& c : counts) {
+				double p = c.second / double(n);
+				res += p * std::log(p) * inv_log_2;
+			}
+			return -res;
+		}
+	};
+
+	template<class T>
+	void accumulateRows(const T* data, qsizetype width, const StatsLabels& labels, int y0, int y1, StatsAccumulator* accs, bool moments, bool entropy)
+	{
+		for (int y = y0; y < y1; ++y) {
+			const T* row = data + y * width;
+			for (qsizetype r = labels.rowStart[y]; r < labels.rowStart[y + 1]; ++r) {
+				const StatsRun& run = labels.runs[r];
+				StatsAccumulator& acc = accs[run.shape];
+				for (int x = run.x0; x < run.x1; ++x)
+					acc.add((double)row[x], x, y, moments, entropy);
+			}
+		}
+	}
+
+	void accumulateRows(const VipNDArray& ar, const StatsLabels& labels, int y0, int y1, StatsAccumulator* accs, bool moments, bool entropy)
+	{
+		const qsizetype w = ar.shape(1);
+		switch (ar.dataType()) {
+			case QMetaType::Bool:
+				accumulateRows((const bool*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::Char:
+			case QMetaType::SChar:
+				accumulateRows((const qint8*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::UChar:
+				accumulateRows((const quint8*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::Short:
+				accumulateRows((const qint16*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::UShort:
+				accumulateRows((const quint16*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::Int:
+				accumulateRows((const qint32*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::UInt:
+				accumulateRows((const quint32*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::LongLong:
+				accumulateRows((const qint64*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::ULongLong:
+				accumulateRows((const quint64*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			case QMetaType::Float:
+				accumulateRows((const float*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+			default:
+				// double, the input array was converted if necessary
+				accumulateRows((const double*)ar.constData(), w, labels, y0, y1, accs, moments, entropy);
+				break;
+		}
+	}
+
+	bool hasNativeType(int type)
+	{
+		switch (type) {
+			case QMetaType::Bool:
+			case QMetaType::Char:
+			case QMetaType::SChar:
+			case QMetaType::UChar:
+			case QMetaType::Short:
+			case QMetaType::UShort:
+			case QMetaType::Int:
+			case QMetaType::UInt:
+			case QMetaType::LongLong:
+			case QMetaType::ULongLong:
+			case QMetaType::Float:
+			case QMetaType::Double:
+				return true;
+			default:
+				return false;
+		}
+	}
+}
+
+class VipExtractMultiStatistics::PrivateData
+{
+public:
+	Vip::ArrayStatistics stats{ Vip::AllStats };
+	VipShapeList fixedShapes;
+	StatsLabels labels;
+	int maxThreads{ 0 };
+};
+
+VipExtractMultiStatistics::VipExtractMultiStatistics(QObject* parent)
+  : VipExtractShapeData(parent)
+{
+	VIP_CREATE_PRIVATE_DATA();
+}
+
+VipExtractMultiStatistics::~VipExtractMultiStatistics() {}
+
+void VipExtractMultiStatistics::setStatistics(Vip::ArrayStatistics s)
+{
+	if (s != d_data->stats) {
+		d_data->stats = s;
+		updateStatistics();
+	}
+}
+
+void VipExtractMultiStatistics::setStatistic(Vip::ArrayStatistic s, bool on)
+{
+	if (d_data->stats.testFlag(s) != on) {
+		if (on)
+			d_data->stats |= s;
+		else
+			d_data->stats &= ~s;
+
+		updateStatistics();
+	}
+}
+bool VipExtractMultiStatistics::testStatistic(Vip::ArrayStatistic s) const
+{
+	return d_data->stats.testFlag(s);
+}
+
+Vip::ArrayStatistics VipExtractMultiStatistics::statistics() const
+{
+	return d_data->stats;
+}
+
+void VipExtractMultiStatistics::setFixedShapes(const VipShapeList& shapes)
+{
+	d_data->fixedShapes = shapes;
+}
+VipShapeList VipExtractMultiStatistics::fixedShapes() const
+{
+	return d_data->fixedShapes;
+}
+
+void VipExtractMultiStatistics::setMaxThreads(int threads)
+{
+	d_data->maxThreads = qMax(threads, 0);
+}
+int VipExtractMultiStatistics::maxThreads() const
+{
+	return d_data->maxThreads;
+}
+
+void VipExtractMultiStatistics::updateStatistics()
+{
+	for (int i = 0; i < 8; ++i)
+		topLevelOutputAt(i)->setEnabled(testStatistic(_trace_stats[i]));
+}
+
+void VipExtractMultiStatistics::apply()
+{
+	VipAnyData data = inputAt(0)->data();
+	VipNDArray ar = data.data().value<VipNDArray>();
+	VipShapeList shapes = d_data->fixedShapes.size() ? d_data->fixedShapes : this->shapes();
+
+	if (ar.isEmpty() || ar.shapeCount() != 2 || shapes.isEmpty() || !ar.canConvert<double>()) {
+		setError("wrong input values", VipProcessingObject::WrongInput);
+		return;
+	}
+
+	// rebuild the run-length labels only if a shape or the image size changed
+	const QSize size(ar.shape(1), ar.shape(0));
+	if (!d_data->labels.isValid(shapes, size))
+		d_data->labels.build(shapes, size);
+	const StatsLabels& labels = d_data->labels;
+
+	if (!hasNativeType(ar.dataType()))
+		ar = ar.convert(QMetaType::Double);
+	ar = ar.dense();
+
+	const bool moments = testStatistic(Vip::Skewness) || testStatistic(Vip::Kurtosis);
+	const bool entropy = testStatistic(Vip::Entropy);
+
+	// split the rows in bands of (roughly) the same pixel count, one band per thread
+	const qsizetype total = labels.rowPixels.last();
+	int bands = 1;
+#ifdef _OPENMP
+	if (total >= vipParallelSizeThreshold())
+		bands = d_data->maxThreads ? d_data->maxThreads : QThread::idealThreadCount();
+#endif
+	bands = qMax(1, qMin(bands, size.height()));
+	QVector<int> bandStart(bands + 1, size.height());
+	bandStart[0] = 0;
+	for (int b = 1, y = 0; b < bands; ++b) {
+		const qsizetype target = total * b / bands;
+		while (y < size.height() && labels.rowPixels[y] < target)
+			++y;
+		bandStart[b] = y;
+	}
+
+	std::vector<std::vector<StatsAccumulator>> accs(bands, std::vector<StatsAccumulator>(shapes.size()));
+	VIP_PARALLEL_FOR_NUM_THREADS(bands)
+	for (int b = 0; b < bands; ++b)
+		accumulateRows(ar, labels, bandStart[b], bandStart[b + 1], accs[b].data(), moments, entropy);
+
+	// merge the bands in row order
+	std::vector<StatsAccumulator>& res = accs[0];
+	for (int b = 1; b < bands; ++b)
+		for (int s = 0; s < shapes.size(); ++s)
+			res[s].join(accs[b][s]);
+
+	for (int i = 0; i < 8; ++i)
+		topLevelOutputAt(i)->toMultiOutput()->resize(shapes.size());
+
+	for (int s = 0; s < shapes.size(); ++s) {
+		const StatsAccumulator& st = res[s];
+		QString name = shapes[s].name();
+		if (name.isEmpty())
+			name = shapes[s].group() + " " + QString::number(shapes[s].id());
+
+		if (testStatistic(Vip::Min)) {
+			VipAnyData any = create(QVariant::fromValue(st.min));
+			any.setName(name + " minimum");
+			any.setTime(data.time());
+			any.setYUnit(data.zUnit());
+			any.setXUnit("time");
+			any.setAttribute("Pos", QVariant::fromValue(st.minPos));
+			topLevelOutputAt(0)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::Max)) {
+			VipAnyData any = create(QVariant::fromValue(st.max));
+			any.setName(name + " maximum");
+			any.setTime(data.time());
+			any.setYUnit(data.zUnit());
+			any.setXUnit("time");
+			any.setAttribute("Pos", QVariant::fromValue(st.maxPos));
+			topLevelOutputAt(1)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::Mean)) {
+			VipAnyData any = create(QVariant::fromValue(st.mean()));
+			any.setName(name + " mean");
+			any.setTime(data.time());
+			any.setYUnit(data.zUnit());
+			any.setXUnit("time");
+			topLevelOutputAt(2)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::Std)) {
+			VipAnyData any = create(QVariant::fromValue(st.std()));
+			any.setName(name + " std");
+			any.setTime(data.time());
+			any.setXUnit("time");
+			topLevelOutputAt(3)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::PixelCount)) {
+			VipAnyData any = create(QVariant::fromValue(st.n));
+			any.setName(name + " pixels");
+			any.setTime(data.time());
+			any.setXUnit("time");
+			topLevelOutputAt(4)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::Entropy)) {
+			VipAnyData any = create(QVariant::fromValue(st.entropy()));
+			any.setName(name + " entropy");
+			any.setTime(data.time());
+			any.setXUnit("time");
+			topLevelOutputAt(5)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::Kurtosis)) {
+			VipAnyData any = create(QVariant::fromValue(st.kurtosis()));
+			any.setName(name + " kurtosis");
+			any.setTime(data.time());
+			any.setXUnit("time");
+			topLevelOutputAt(6)->toMultiOutput()->at(s)->setData(any);
+		}
+		if (testStatistic(Vip::Skewness)) {
+			VipAnyData any = create(QVariant::fromValue(st.skewness()));
+			any.setName(name + " skewness");
+			any.setTime(data.time());
+			any.setXUnit("time");
+			topLevelOutputAt(7)->toMultiOutput()->at(s)->setData(any);
+		}
+	}
+}
+
 VipExtractShapeAttribute::VipExtractShapeAttribute()
 {
 	outputAt(0)->setData(0);
@@ -792,10 +1254,257 @@ VipArchive& operator>>(VipArchive& stream, VipExtractStatistics* r)
 	return stream;
 }
 
+VipArchive& operator<<(VipArchive& stream, const VipExtractMultiStatistics* r)
+{
+	return stream.content("statistics", (int)r->statistics());
+}
+
+VipArchive& operator>>(VipArchive& stream, VipExtractMultiStatistics* r)
+{
+	r->setStatistics(Vip::ArrayStatistics(stream.read("statistics").value<int>()));
+	return stream;
+}
+
+namespace
+{
+	/// A private copy of the pipeline processing a contiguous range of times
+	struct TraceSegment
+	{
+		qsizetype begin{ 0 };
+		qsizetype end{ 0 };
+		QList<VipProcessingObject*> objects;
+		VipIODevice* device{ nullptr };
+		VipExtractMultiStatistics* extract{ nullptr };
+		QVector<VipTimeTrace> traces;
+
+		~TraceSegment()
+		{
+			delete extract;
+			qDeleteAll(objects);
+		}
+	};
+}
+
+static VipOutput* cloneOutput(VipOutput* out, const QMap<VipProcessingObject*, VipProcessingObject*>& clones)
+{
+	if (!out)
+		return nullptr;
+	VipProcessingObject* src = out->parentProcessing();
+	VipProcessingObject* dst = clones.value(src, nullptr);
+	if (!dst)
+		return nullptr;
+	int index = src->indexOf(out);
+	if (index < 0 || index >= dst->outputCount())
+		return nullptr;
+	return dst->outputAt(index);
+}
+
+static bool cloneTraceSegment(const QList<VipProcessingObject*>& objects,
+			      VipIODevice* device,
+			      VipOutput* source,
+			      const VipShapeList& shapes,
+			      Vip::ArrayStatistics stats,
+			      TraceSegment& seg)
+{
+	// duplicate each processing and disconnect it from the original pipeline
+	QMap<VipProcessingObject*, VipProcessingObject*> clones;
+	for (VipProcessingObject* obj : objects) {
+		VipProcessingObject* c = obj->copy();
+		if (!c)
+			return false;
+		seg.objects.append(c);
+		clones[obj] = c;
+		c->clearConnections();
+		c->setDeleteOnOutputConnectionsClosed(false);
+		c->setScheduleStrategies(VipProcessingObject::NoThread);
+		c->setLogErrors(QSet<int>());
+		if (c->inputCount() != obj->inputCount() || c->outputCount() != obj->outputCount() || c->propertyCount() != obj->propertyCount())
+			return false;
+	}
+
+	// rebuild the connections inside the copied pipeline
+	for (VipProcessingObject* obj : objects) {
+		VipProcessingObject* c = clones[obj];
+		for (int i = 0; i < obj->inputCount(); ++i) {
+			if (VipOutput* out = cloneOutput(obj->inputAt(i)->source(), clones))
+				c->inputAt(i)->setConnection(out);
+			else if (obj->inputAt(i)->source())
+				return false;
+		}
+		for (int i = 0; i < obj->propertyCount(); ++i) {
+			if (VipOutput* out = cloneOutput(obj->propertyAt(i)->source(), clones))
+				c->propertyAt(i)->setConnection(out);
+			else
+				c->propertyAt(i)->setData(obj->propertyAt(i)->data());
+		}
+	}
+
+	seg.device = qobject_cast<VipIODevice*>(clones.value(device, nullptr));
+	VipOutput* src = cloneOutput(source, clones);
+	if (!seg.device || !src || !seg.device->open(VipIODevice::ReadOnly))
+		return false;
+
+	// a single extractor computes the statistics of all shapes in one pass per frame
+	seg.extract = new VipExtractMultiStatistics();
+	seg.extract->setScheduleStrategies(VipProcessingObject::NoThread);
+	seg.extract->setLogErrors(QSet<int>());
+	seg.extract->setStatistics(stats);
+	seg.extract->setFixedShapes(shapes);
+	seg.extract->setMaxThreads(1); // segments are already processed in parallel
+	src->setConnection(seg.extract->inputAt(0));
+	seg.traces.resize(shapes.size());
+	return true;
+}
+
+static void runTraceSegment(TraceSegment* seg, const QVector<qint64>* times, std::atomic<qsizetype>* done, std::atomic<bool>* cancel)
+{
+	for (qsizetype i = seg->begin; i < seg->end; ++i) {
+		if (cancel->load(std::memory_order_relaxed))
+			break;
+
+		VipExtractMultiStatistics* extract = seg->extract;
+		// synchronous update: pull the data through the copied pipeline in this thread
+		if (seg->device->read((*times)[i], true) && extract->update() && !extract->hasError()) {
+			for (qsizetype s = 0; s < seg->traces.size(); ++s) {
+				VipTimeTrace& trace = seg->traces[s];
+				for (int j = 0; j < 8; ++j) {
+					if (!extract->testStatistic(_trace_stats[j]))
+						continue;
+					const VipAnyData any = extract->topLevelOutputAt(j)->toMultiOutput()->at(s)->data();
+					trace.values[j].push_back(VipPoint(any.time(), any.value<double>()));
+					if (j == 0)
+						trace.minPos.push_back(any.attribute("Pos").value<VipPoint>());
+					else if (j == 1)
+						trace.maxPos.push_back(any.attribute("Pos").value<VipPoint>());
+				}
+			}
+		}
+		done->fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+bool vipExtractTimeTraces(VipOutput* source,
+			  const VipShapeList& shapes,
+			  Vip::ArrayStatistics stats,
+			  QVector<VipTimeTrace>& traces,
+			  const VipTimeRange& range,
+			  int one_frame_out_of,
+			  int threads,
+			  VipProgress* progress)
+{
+	traces = QVector<VipTimeTrace>(shapes.size());
+	if (!source || !source->parentProcessing() || shapes.isEmpty())
+		return false;
+
+	// find the pipeline and its unique temporal device
+	QList<VipProcessingObject*> objects = source->parentProcessing()->allSources();
+	objects.append(source->parentProcessing());
+	objects = vipToSet(objects).values();
+
+	VipIODevice* device = nullptr;
+	for (VipProcessingObject* obj : objects) {
+		if (VipIODevice* d = qobject_cast<VipIODevice*>(obj)) {
+			if (d->deviceType() != VipIODevice::Temporal || device)
+				return false;
+			device = d;
+		}
+	}
+	if (!device)
+		return false;
+
+	// list the times to process
+	qint64 first = device->firstTime();
+	qint64 last = device->lastTime();
+	if (range != VipInvalidTimeRange) {
+		first = qMax(first, range.first);
+		last = qMin(last, range.second);
+	}
+	if (one_frame_out_of < 1)
+		one_frame_out_of = 1;
+
+	QVector<qint64> times;
+	qint64 time = device->closestTime(first);
+	if (time < first)
+		time = device->nextTime(time);
+	while (time != VipInvalidTime && time <= last) {
+		times.append(time);
+		bool end = false;
+		for (int i = 0; i < one_frame_out_of; ++i) {
+			qint64 next = device->nextTime(time);
+			if (next == time || next == VipInvalidTime) {
+				end = true;
+				break;
+			}
+			time = next;
+		}
+		if (end)
+			break;
+	}
+	if (times.isEmpty())
+		return true;
+
+	// split the times into contiguous segments, each segment being processed by its own pipeline copy
+	if (threads <= 0)
+		threads = QThread::idealThreadCount();
+	const qsizetype min_frames_per_segment = 8;
+	qsizetype seg_count = qMax((qsizetype)1, qMin((qsizetype)threads, times.size() / min_frames_per_segment));
+
+	std::vector<std::unique_ptr<TraceSegment>> segments;
+	for (qsizetype i = 0; i < seg_count; ++i) {
+		std::unique_ptr<TraceSegment> seg(new TraceSegment());
+		seg->begin = i * times.size() / seg_count;
+		seg->end = (i + 1) * times.size() / seg_count;
+		if (!cloneTraceSegment(objects, device, source, shapes, stats, *seg))
+			return false;
+		segments.push_back(std::move(seg));
+	}
+
+	if (progress)
+		progress->setRange(0, times.size());
+
+	std::atomic<qsizetype> done{ 0 };
+	std::atomic<bool> cancel{ false };
+	std::vector<std::thread> workers;
+	for (qsizetype i = 0; i < seg_count; ++i)
+		workers.emplace_back(runTraceSegment, segments[i].get(), &times, &done, &cancel);
+
+	// the calling thread only reports the progress
+	while (done.load() < times.size() && !cancel.load()) {
+		if (progress) {
+			progress->setValue(done.load());
+			if (progress->canceled())
+				cancel.store(true);
+		}
+		QThread::msleep(20);
+	}
+	for (std::thread& th : workers)
+		th.join();
+
+	if (cancel.load())
+		return false;
+
+	// concatenate the segments in time order
+	for (qsizetype i = 0; i < seg_count; ++i) {
+		for (qsizetype s = 0; s < shapes.size(); ++s) {
+			const VipTimeTrace& part = segments[i]->traces[s];
+			VipTimeTrace& trace = traces[s];
+			for (int j = 0; j < 8; ++j)
+				for (const VipPoint& pt : part.values[j])
+					trace.values[j].push_back(pt);
+			for (const VipPoint& pt : part.minPos)
+				trace.minPos.push_back(pt);
+			for (const VipPoint& pt : part.maxPos)
+				trace.maxPos.push_back(pt);
+		}
+	}
+	return true;
+}
+
 static int registerStreamOperators()
 {
 	vipRegisterArchiveStreamOperators<VipSplitAndMerge*>();
 	vipRegisterArchiveStreamOperators<VipExtractStatistics*>();
+	vipRegisterArchiveStreamOperators<VipExtractMultiStatistics*>();
 	return 0;
 }
 
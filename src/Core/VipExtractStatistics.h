@@ -40,6 +40,8 @@
 /// @{
 
 class VipArchive;
+class VipIODevice;
+class VipProgress;
 
 /// \a VipExtractComponent is a \a VipProcessingObject that extract a component from a \a VipNDArray.
 /// For instance, it can extract the Red, Green, Blue or Alpha component from a color image, the Real, Imaginary, Amplitude or Argument from a complex image, etc.
@@ -291,6 +293,100 @@ VIP_REGISTER_QOBJECT_METATYPE(VipExtractStatistics*)
 VIP_CORE_EXPORT VipArchive& operator<<(VipArchive& stream, const VipExtractStatistics* r);
 VIP_CORE_EXPORT VipArchive& operator>>(VipArchive& stream, VipExtractStatistics* r);
 
+/// Extract the same statistics as VipExtractStatistics for several shapes in a single pass over each image.
+///
+/// The shapes are the ones returned by VipSceneModelBasedProcessing::shapes() (merge strategy is ignored), or the shapes
+/// set with setFixedShapes(). They are rasterized once into a run-length structure listing, for each image row, the pixel runs
+/// covered by each shape. This structure is cached and only rebuilt when a shape or the image size changes.
+/// Each image is then traversed row by row (rows are split between threads), and the statistics of all shapes are accumulated at once.
+///
+/// Each output is a VipMultiOutput with one output per shape, in shapes order. The output data (names, units, "Pos" attribute
+/// of minimum and maximum) are the same as for VipExtractStatistics.
+class VIP_CORE_EXPORT VipExtractMultiStatistics : public VipExtractShapeData
+{
+	Q_OBJECT
+
+	VIP_IO(VipInput image)
+
+	VIP_IO(VipMultiOutput min)
+	VIP_IO(VipMultiOutput max)
+	VIP_IO(VipMultiOutput mean)
+	VIP_IO(VipMultiOutput std)
+	VIP_IO(VipMultiOutput pixel_count);
+	VIP_IO(VipMultiOutput entropy);
+	VIP_IO(VipMultiOutput kurtosis);
+	VIP_IO(VipMultiOutput skewness);
+
+	Q_CLASSINFO("description", "Extract the minimum, maximum, mean, standard deviation and pixel count of an image inside several shapes")
+	Q_CLASSINFO("category", "Miscellaneous")
+
+public:
+	VipExtractMultiStatistics(QObject* parent = nullptr);
+	~VipExtractMultiStatistics();
+
+	/// Set the statistics we want to extract. The corresponding outputs will only update there values if their statistics are enabled.
+	void setStatistics(Vip::ArrayStatistics);
+	void setStatistic(Vip::ArrayStatistic, bool on = true);
+	bool testStatistic(Vip::ArrayStatistic) const;
+	Vip::ArrayStatistics statistics() const;
+
+	/// Set the shapes directly. Like VipSceneModelBasedProcessing::setFixedShape(), reload() will never be called when the shapes change.
+	/// Set an empty list to use VipSceneModelBasedProcessing::shapes() instead.
+	void setFixedShapes(const VipShapeList& shapes);
+	VipShapeList fixedShapes() const;
+
+	/// Set the maximum number of threads used to process an image. 0 (default) means all available cores.
+	void setMaxThreads(int threads);
+	int maxThreads() const;
+
+protected:
+	virtual void apply();
+
+private:
+	void updateStatistics();
+	VIP_DECLARE_PRIVATE_DATA();
+};
+
+VIP_REGISTER_QOBJECT_METATYPE(VipExtractMultiStatistics*)
+VIP_CORE_EXPORT VipArchive& operator<<(VipArchive& stream, const VipExtractMultiStatistics* r);
+VIP_CORE_EXPORT VipArchive& operator>>(VipArchive& stream, VipExtractMultiStatistics* r);
+
+/// Time traces extracted by #vipExtractTimeTraces() for a single shape.
+/// \a values contains one VipPointVector per statistic, following the VipExtractStatistics outputs order
+/// (min, max, mean, std, pixel count, entropy, kurtosis, skewness). Disabled statistics are left empty.
+/// \a minPos and \a maxPos store the position of the minimum/maximum pixel for each time.
+struct VipTimeTrace
+{
+	QVector<VipPointVector> values;
+	VipPointVector minPos;
+	VipPointVector maxPos;
+	VipTimeTrace()
+	  : values(8)
+	{
+	}
+};
+
+/// Extract the statistics of several shapes over a whole movie.
+///
+/// \a source is the output producing the images (usually the last processing before a display object).
+/// Its pipeline must contain exactly one Temporal VipIODevice, and the shapes must be expressed in \a source image coordinates.
+///
+/// The requested time range (the device time limits if \a range is invalid) is split into contiguous segments,
+/// one per thread (QThread::idealThreadCount() if \a threads <= 0). Each segment is processed by a private copy of the
+/// pipeline (device included) running in its own thread, and the results are concatenated in time order into \a traces
+/// (one VipTimeTrace per shape). Only one frame out of \a one_frame_out_of is processed.
+///
+/// The original pipeline is left untouched. Returns false if the pipeline cannot be duplicated, or if the extraction
+/// was canceled through \a progress (which must live in the calling thread).
+VIP_CORE_EXPORT bool vipExtractTimeTraces(VipOutput* source,
+					  const VipShapeList& shapes,
+					  Vip::ArrayStatistics stats,
+					  QVector<VipTimeTrace>& traces,
+					  const VipTimeRange& range = VipInvalidTimeRange,
+					  int one_frame_out_of = 1,
+					  int threads = 0,
+					  VipProgress* progress = nullptr);
+
 /// Extract a VipShape's attribute based on an input VipSceneModel and the properties \a shape_group, \a shape_id (to find the shape in
 /// the scene model) and \a shape_attribute (the attribute name in the VipShape).
 /// The output value is stored as a processing output. The value is converted to double if possible.
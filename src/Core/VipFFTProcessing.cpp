@@ -0,0 +1,277 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "VipFFTProcessing.h"
+#include "VipFFT.h"
+
+#include <cmath>
+
+/// Returns the amplitude of a complex array, or the absolute value of a real one
+static VipNDArray amplitude(const VipNDArray& ar)
+{
+	if (ar.isEmpty())
+		return ar;
+	const qsizetype size = ar.size();
+	if (ar.dataType() == qMetaTypeId<complex_f>()) {
+		VipNDArray res(QMetaType::Float, ar.shape());
+		const complex_f* src = static_cast<const complex_f*>(ar.constData());
+		float* dst = static_cast<float*>(res.data());
+		for (qsizetype i = 0; i < size; ++i)
+			dst[i] = std::abs(src[i]);
+		return res;
+	}
+	if (ar.dataType() == qMetaTypeId<complex_d>()) {
+		VipNDArray res(QMetaType::Double, ar.shape());
+		const complex_d* src = static_cast<const complex_d*>(ar.constData());
+		double* dst = static_cast<double*>(res.data());
+		for (qsizetype i = 0; i < size; ++i)
+			dst[i] = std::abs(src[i]);
+		return res;
+	}
+	// vipIRFFT returns a dense float or double array that we can modify in place
+	VipNDArray res = ar;
+	if (res.dataType() == QMetaType::Float) {
+		float* dst = static_cast<float*>(res.data());
+		for (qsizetype i = 0; i < size; ++i)
+			dst[i] = std::abs(dst[i]);
+	}
+	else if (res.dataType() == QMetaType::Double) {
+		double* dst = static_cast<double*>(res.data());
+		for (qsizetype i = 0; i < size; ++i)
+			dst[i] = std::abs(dst[i]);
+	}
+	return res;
+}
+
+/// Returns the sampling step of a regularly sampled curve
+static double samplingStep(const VipComplexPointVector& curve)
+{
+	const qsizetype n = curve.size();
+	if (n < 2)
+		return 1.;
+	const double step = (curve.last().x() - curve.first().x()) / (n - 1);
+	return (step > 0 && std::isfinite(step)) ? step : 1.;
+}
+
+/// Returns the frequency step of a spectrum ordered like the output of VipFFT or VipRFFT
+static double frequencyStep(const VipComplexPointVector& spectrum)
+{
+	if (spectrum.size() < 2)
+		return 1.;
+	const double step = spectrum[1].x() - spectrum[0].x();
+	return (step > 0 && std::isfinite(step)) ? step : 1.;
+}
+
+/// Transform complex values with the raw 1D FFT
+static std::vector<complex_d> transformValues(const VipComplexPointVector& curve, Vip::FFTDirection dir)
+{
+	std::vector<complex_d> values(curve.size());
+	for (qsizetype i = 0; i < curve.size(); ++i)
+		values[i] = curve[i].y();
+	vipFFT(values.data(), values.data(), values.size(), dir);
+	return values;
+}
+
+/// Roll the points of \a curve by \a shift
+static VipComplexPointVector rollCurve(const VipComplexPointVector& curve, qsizetype shift)
+{
+	const qsizetype n = curve.size();
+	VipComplexPointVector res(n);
+	for (qsizetype i = 0; i < n; ++i)
+		res[(i + shift) % n] = curve[i];
+	return res;
+}
+
+VipBaseFFT::VipBaseFFT(QObject* parent)
+  : VipProcessingObject(parent)
+{
+	this->outputAt(0)->setData(VipNDArray());
+}
+
+bool VipBaseFFT::acceptInput(int, const QVariant& v) const
+{
+	return v.userType() == qMetaTypeId<VipNDArray>() || v.userType() == qMetaTypeId<VipPointVector>() || v.userType() == qMetaTypeId<VipComplexPointVector>();
+}
+
+void VipBaseFFT::apply()
+{
+	try {
+		const VipAnyData any = inputAt(0)->data();
+		QVariant out;
+
+		if (any.data().userType() == qMetaTypeId<VipPointVector>() || any.data().userType() == qMetaTypeId<VipComplexPointVector>()) {
+			VipComplexPointVector curve;
+			if (any.data().userType() == qMetaTypeId<VipPointVector>()) {
+				const VipPointVector points = any.value<VipPointVector>();
+				curve.resize(points.size());
+				for (qsizetype i = 0; i < points.size(); ++i)
+					curve[i] = VipComplexPoint(points[i].x(), complex_d(points[i].y(), 0));
+			}
+			else
+				curve = any.value<VipComplexPointVector>();
+
+			if (curve.size() == 0) {
+				setError("Empty input curve", VipProcessingObject::WrongInput);
+				return;
+			}
+			out = applyCurve(curve);
+		}
+		else {
+			const VipNDArray ar = any.value<VipNDArray>();
+			if (ar.isEmpty()) {
+				setError("Empty input array", VipProcessingObject::WrongInput);
+				return;
+			}
+			const VipNDArray res = applyArray(ar);
+			if (res.isEmpty() && !hasError())
+				setError("Unsupported input array type", VipProcessingObject::WrongInput);
+			out = QVariant::fromValue(res);
+		}
+
+		if (!hasError()) {
+			VipAnyData odata = create(out);
+			odata.setTime(any.time());
+			outputAt(0)->setData(odata);
+		}
+	}
+	catch (const std::exception& e) {
+		setError(e.what());
+	}
+}
+
+VipNDArray VipFFT::applyArray(const VipNDArray& ar)
+{
+	return vipFFT(ar);
+}
+
+QVariant VipFFT::applyCurve(const VipComplexPointVector& curve)
+{
+	const qsizetype n = curve.size();
+	const std::vector<complex_d> values = transformValues(curve, Vip::FFTForward);
+
+	// frequencies in the same order as numpy.fft.fftfreq
+	const double df = 1. / (n * samplingStep(curve));
+	VipComplexPointVector res(n);
+	for (qsizetype i = 0; i < n; ++i)
+		res[i] = VipComplexPoint((i < (n + 1) / 2 ? i : i - n) * df, values[i]);
+	return QVariant::fromValue(res);
+}
+
+VipNDArray VipIFFT::applyArray(const VipNDArray& ar)
+{
+	return amplitude(vipIFFT(ar));
+}
+
+QVariant VipIFFT::applyCurve(const VipComplexPointVector& curve)
+{
+	const qsizetype n = curve.size();
+	const std::vector<complex_d> values = transformValues(curve, Vip::FFTBackward);
+
+	const double dt = 1. / (n * frequencyStep(curve));
+	VipPointVector res(n);
+	for (qsizetype i = 0; i < n; ++i)
+		res[i] = VipPoint(i * dt, std::abs(values[i]));
+	return QVariant::fromValue(res);
+}
+
+VipNDArray VipRFFT::applyArray(const VipNDArray& ar)
+{
+	if (ar.isComplex()) {
+		setError("RFFT requires a real input array", VipProcessingObject::WrongInput);
+		return VipNDArray();
+	}
+	return vipRFFT(ar);
+}
+
+QVariant VipRFFT::applyCurve(const VipComplexPointVector& curve)
+{
+	const qsizetype n = curve.size();
+	VipNDArray values(QMetaType::Double, vipVector(n));
+	double* ptr = static_cast<double*>(values.data());
+	for (qsizetype i = 0; i < n; ++i)
+		ptr[i] = curve[i].y().real();
+
+	const VipNDArray spectrum = vipRFFT(values);
+	const complex_d* s = static_cast<const complex_d*>(spectrum.constData());
+	const double df = 1. / (n * samplingStep(curve));
+	VipComplexPointVector res(spectrum.size());
+	for (qsizetype i = 0; i < res.size(); ++i)
+		res[i] = VipComplexPoint(i * df, s[i]);
+	return QVariant::fromValue(res);
+}
+
+VipNDArray VipIRFFT::applyArray(const VipNDArray& ar)
+{
+	return amplitude(vipIRFFT(ar));
+}
+
+QVariant VipIRFFT::applyCurve(const VipComplexPointVector& curve)
+{
+	const qsizetype m = curve.size();
+	if (m < 2) {
+		setError("IRFFT requires at least 2 input samples", VipProcessingObject::WrongInput);
+		return QVariant();
+	}
+	VipNDArray values(qMetaTypeId<complex_d>(), vipVector(m));
+	complex_d* ptr = static_cast<complex_d*>(values.data());
+	for (qsizetype i = 0; i < m; ++i)
+		ptr[i] = curve[i].y();
+
+	const VipNDArray signal = vipIRFFT(values);
+	const double* s = static_cast<const double*>(signal.constData());
+	const qsizetype n = signal.size();
+	const double dt = 1. / (n * frequencyStep(curve));
+	VipPointVector res(n);
+	for (qsizetype i = 0; i < n; ++i)
+		res[i] = VipPoint(i * dt, std::abs(s[i]));
+	return QVariant::fromValue(res);
+}
+
+VipNDArray VipFFTShift::applyArray(const VipNDArray& ar)
+{
+	return vipFFTShift(ar);
+}
+
+QVariant VipFFTShift::applyCurve(const VipComplexPointVector& curve)
+{
+	return QVariant::fromValue(rollCurve(curve, curve.size() / 2));
+}
+
+VipNDArray VipIFFTShift::applyArray(const VipNDArray& ar)
+{
+	return vipIFFTShift(ar);
+}
+
+QVariant VipIFFTShift::applyCurve(const VipComplexPointVector& curve)
+{
+	return QVariant::fromValue(rollCurve(curve, curve.size() - curve.size() / 2));
+}
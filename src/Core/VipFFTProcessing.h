@@ -0,0 +1,182 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_FFT_PROCESSING_H
+#define VIP_FFT_PROCESSING_H
+
+#include "VipProcessingObject.h"
+#include "VipVectors.h"
+
+/// @brief Base class for the discrete Fourier transform processings.
+///
+/// The input can be a VipNDArray (signal, image or any N-D array), a VipPointVector or a VipComplexPointVector.
+/// For curves, the transform is applied on the y values, which are supposed to be regularly sampled,
+/// and the x values are converted to frequencies (forward transforms) or back to times (inverse transforms).
+/// For arrays, the transform is performed over all axes, like numpy.fft.fftn.
+class VIP_CORE_EXPORT VipBaseFFT : public VipProcessingObject
+{
+	Q_OBJECT
+	VIP_IO(VipInput input)
+	VIP_IO(VipOutput output)
+	VIP_CATEGORY("Discrete Fourier Transform")
+public:
+	VipBaseFFT(QObject* parent = nullptr);
+
+	virtual DisplayHint displayHint() const { return DisplayOnDifferentSupport; }
+	virtual bool acceptInput(int index, const QVariant& v) const;
+
+protected:
+	/// @brief Apply the transform to an array
+	virtual VipNDArray applyArray(const VipNDArray& ar) = 0;
+	/// @brief Apply the transform to a curve. Returns a VipPointVector or a VipComplexPointVector.
+	virtual QVariant applyCurve(const VipComplexPointVector& curve) = 0;
+	virtual void apply();
+};
+
+/// @brief Compute the N-dimensional discrete Fourier Transform.
+class VIP_CORE_EXPORT VipFFT : public VipBaseFFT
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Compute the N-dimensional discrete Fourier Transform.\n"
+			"This function computes the N-dimensional discrete Fourier Transform over all axes\n"
+			"of an N-dimensional array by means of the Fast Fourier Transform (FFT).")
+public:
+	VipFFT(QObject* parent = nullptr)
+	  : VipBaseFFT(parent)
+	{
+	}
+
+protected:
+	virtual VipNDArray applyArray(const VipNDArray& ar);
+	virtual QVariant applyCurve(const VipComplexPointVector& curve);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipFFT*)
+
+/// @brief Compute the amplitude of the N-dimensional inverse discrete Fourier Transform.
+class VIP_CORE_EXPORT VipIFFT : public VipBaseFFT
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Compute the N-dimensional inverse discrete Fourier Transform.\n"
+			"This function computes the inverse of the N-dimensional discrete Fourier Transform over\n"
+			"all axes of an N-dimensional array by means of the Fast Fourier Transform (FFT), and returns its amplitude.\n"
+			"The input should be ordered in the same way as is returned by the FFT, i.e. it should have the term\n"
+			"for zero frequency in the low-order corner, the positive frequency terms in the first half of all axes\n"
+			"and the negative frequency terms in the second half of all axes.")
+public:
+	VipIFFT(QObject* parent = nullptr)
+	  : VipBaseFFT(parent)
+	{
+	}
+
+protected:
+	virtual VipNDArray applyArray(const VipNDArray& ar);
+	virtual QVariant applyCurve(const VipComplexPointVector& curve);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipIFFT*)
+
+/// @brief Compute the N-dimensional discrete Fourier Transform for real input.
+class VIP_CORE_EXPORT VipRFFT : public VipBaseFFT
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Compute the N-dimensional discrete Fourier Transform for real input.\n"
+			"All axes are transformed, with the real transform performed over the last axis\n"
+			"(which only keeps the n/2+1 non negative frequencies), while the remaining transforms are complex.")
+public:
+	VipRFFT(QObject* parent = nullptr)
+	  : VipBaseFFT(parent)
+	{
+	}
+
+protected:
+	virtual VipNDArray applyArray(const VipNDArray& ar);
+	virtual QVariant applyCurve(const VipComplexPointVector& curve);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipRFFT*)
+
+/// @brief Compute the amplitude of the inverse of the N-dimensional FFT of real input.
+class VIP_CORE_EXPORT VipIRFFT : public VipBaseFFT
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Compute the inverse of the N-dimensional FFT of real input.\n"
+			"This function computes the inverse of the N-dimensional discrete Fourier Transform for real input\n"
+			"over all axes of an N-dimensional array, and returns its amplitude.\n"
+			"The input should be ordered in the same way as is returned by the RFFT.")
+public:
+	VipIRFFT(QObject* parent = nullptr)
+	  : VipBaseFFT(parent)
+	{
+	}
+
+protected:
+	virtual VipNDArray applyArray(const VipNDArray& ar);
+	virtual QVariant applyCurve(const VipComplexPointVector& curve);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipIRFFT*)
+
+/// @brief Shift the zero-frequency component to the center of the spectrum.
+class VIP_CORE_EXPORT VipFFTShift : public VipBaseFFT
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Shift the zero-frequency component to the center of the spectrum.\n"
+			"This function swaps half-spaces for all axes.\n"
+			"Note that y[0] is the Nyquist component only if len(x) is even.")
+public:
+	VipFFTShift(QObject* parent = nullptr)
+	  : VipBaseFFT(parent)
+	{
+	}
+
+protected:
+	virtual VipNDArray applyArray(const VipNDArray& ar);
+	virtual QVariant applyCurve(const VipComplexPointVector& curve);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipFFTShift*)
+
+/// @brief The inverse of VipFFTShift.
+class VIP_CORE_EXPORT VipIFFTShift : public VipBaseFFT
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("The inverse of FFTShift.\n"
+			"Although identical for even-length x, the functions differ by one sample for odd-length x.")
+public:
+	VipIFFTShift(QObject* parent = nullptr)
+	  : VipBaseFFT(parent)
+	{
+	}
+
+protected:
+	virtual VipNDArray applyArray(const VipNDArray& ar);
+	virtual QVariant applyCurve(const VipComplexPointVector& curve);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipIFFTShift*)
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "VipFilterProcessing.h"
+
+VipNDArray VipBorderModeFilter::checkOutput(const VipNDArray& ar)
+{
+	if (ar.isEmpty())
+		setError("Unsupported input array type or parameters", VipProcessingObject::WrongInput);
+	return ar;
+}
+
+VipNDArray VipMinimumFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipMinimumFilter(ar, windowSize(), borderMode()));
+}
+
+VipNDArray VipMaximumFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipMaximumFilter(ar, windowSize(), borderMode()));
+}
+
+VipNDArray VipUniformFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipUniformFilter(ar, windowSize(), borderMode()));
+}
+
+VipNDArray VipMedianFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipMedianFilter(ar, windowSize(), borderMode()));
+}
+
+VipNDArray VipPercentileFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipPercentileFilter(ar, propertyName("Percentile")->value<double>(), windowSize(), borderMode()));
+}
+
+VipNDArray VipRankFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipRankFilter(ar, propertyName("Rank")->value<int>(), windowSize(), borderMode()));
+}
+
+VipNDArray VipGaussianFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipGaussianFilter(ar, propertyName("Sigma")->value<double>(), qMax(0, propertyName("Order")->value<int>()), borderMode()));
+}
+
+VipNDArray VipSobelFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipSobelFilter(ar, -1, borderMode()));
+}
+
+VipNDArray VipPrewittFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipPrewittFilter(ar, -1, borderMode()));
+}
+
+VipNDArray VipLaplaceFilter::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipLaplaceFilter(ar, borderMode()));
+}
+
+VipNDArray VipGreyDilation::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipGreyDilation(ar, windowSize(), fullConnectivity(), borderMode()));
+}
+
+VipNDArray VipGreyErosion::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipGreyErosion(ar, windowSize(), fullConnectivity(), borderMode()));
+}
+
+VipNDArray VipGreyOpening::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipGreyOpening(ar, windowSize(), fullConnectivity(), borderMode()));
+}
+
+VipNDArray VipGreyClosing::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipGreyClosing(ar, windowSize(), fullConnectivity(), borderMode()));
+}
+
+VipNDArray VipBinaryMorphology::checkOutput(const VipNDArray& ar)
+{
+	if (ar.isEmpty())
+		setError("Binary morphology only works on 1D or 2D numerical arrays", VipProcessingObject::WrongInput);
+	return ar;
+}
+
+VipNDArray VipBinaryDilation::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipBinaryDilation(ar, iterations(), fullConnectivity()));
+}
+
+VipNDArray VipBinaryErosion::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipBinaryErosion(ar, iterations(), fullConnectivity()));
+}
+
+VipNDArray VipBinaryOpening::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipBinaryOpening(ar, iterations(), fullConnectivity()));
+}
+
+VipNDArray VipBinaryClosing::applyProcessing(const VipNDArray& ar)
+{
+	return checkOutput(vipBinaryClosing(ar, iterations(), fullConnectivity()));
+}
@@ -0,0 +1,371 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_FILTER_PROCESSING_H
+#define VIP_FILTER_PROCESSING_H
+
+#include "VipFilters.h"
+#include "VipImageProcessing.h"
+
+/// @brief Base class for the native filters using a border mode
+class VIP_CORE_EXPORT VipBorderModeFilter : public VipStdImageProcessing
+{
+	Q_OBJECT
+	VIP_IO(VipProperty Mode)
+	VIP_CATEGORY("Filters")
+	VIP_IO_DESCRIPTION(Mode, "The mode parameter determines how the array borders are handled")
+	VIP_PROPERTY_EDIT(Mode, "VipEnumEdit{ qproperty-enumNames:'reflect,nearest,mirror,wrap';  qproperty-value:'reflect' ;}")
+public:
+	VipBorderModeFilter(QObject* parent = nullptr)
+	  : VipStdImageProcessing(parent)
+	{
+		propertyName("Mode")->setData(QString("reflect"));
+	}
+
+protected:
+	Vip::FilterBorderMode borderMode() const { return vipFilterBorderMode(propertyName("Mode")->value<QString>()); }
+	/// Set an error and returns a null array if \a ar is null
+	VipNDArray checkOutput(const VipNDArray& ar);
+};
+
+/// @brief Base class for the native filters working on a square window
+class VIP_CORE_EXPORT VipWindowFilter : public VipBorderModeFilter
+{
+	Q_OBJECT
+	VIP_IO(VipProperty Size)
+	VIP_IO_DESCRIPTION(Size, "Window size along each axis")
+	VIP_PROPERTY_EDIT(Size, VIP_SPINBOX_EDIT(1, 101, 1, 3))
+public:
+	VipWindowFilter(QObject* parent = nullptr)
+	  : VipBorderModeFilter(parent)
+	{
+		propertyName("Size")->setData(3);
+	}
+
+protected:
+	int windowSize() const { return qMax(1, propertyName("Size")->value<int>()); }
+};
+
+class VIP_CORE_EXPORT VipMinimumFilter : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Calculate a multi-dimensional minimum filter.\nThe computation time does not depend on the window size.")
+public:
+	VipMinimumFilter(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipMinimumFilter*)
+
+class VIP_CORE_EXPORT VipMaximumFilter : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Calculate a multi-dimensional maximum filter.\nThe computation time does not depend on the window size.")
+public:
+	VipMaximumFilter(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipMaximumFilter*)
+
+class VIP_CORE_EXPORT VipUniformFilter : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Multi-dimensional uniform (mean) filter")
+public:
+	VipUniformFilter(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipUniformFilter*)
+
+class VIP_CORE_EXPORT VipMedianFilter : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Median filter of 1D signals or images with an arbitrary window size")
+public:
+	VipMedianFilter(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipMedianFilter*)
+
+class VIP_CORE_EXPORT VipPercentileFilter : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_IO(VipProperty Percentile)
+	VIP_DESCRIPTION("Percentile filter of 1D signals or images with an arbitrary window size")
+	VIP_IO_DESCRIPTION(Percentile, "The percentile parameter may be less than zero, i.e., percentile = -20 equals percentile = 80")
+	VIP_PROPERTY_EDIT(Percentile, VIP_DOUBLE_SPINBOX_EDIT(-100, 100, 1, 20))
+public:
+	VipPercentileFilter(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+		propertyName("Percentile")->setData(20.);
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipPercentileFilter*)
+
+class VIP_CORE_EXPORT VipRankFilter : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_IO(VipProperty Rank)
+	VIP_DESCRIPTION("Rank filter of 1D signals or images with an arbitrary window size")
+	VIP_IO_DESCRIPTION(Rank, "The rank parameter may be less than zero, i.e., rank = -1 indicates the largest element")
+	VIP_PROPERTY_EDIT(Rank, VIP_SPINBOX_EDIT(-10000, 10000, 1, 0))
+public:
+	VipRankFilter(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+		propertyName("Rank")->setData(0);
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipRankFilter*)
+
+class VIP_CORE_EXPORT VipGaussianFilter : public VipBorderModeFilter
+{
+	Q_OBJECT
+	VIP_IO(VipProperty Sigma)
+	VIP_IO(VipProperty Order)
+	VIP_DESCRIPTION("Multidimensional separable Gaussian filter")
+	VIP_IO_DESCRIPTION(Sigma, "Standard deviation of the Gaussian kernel, equal for all axes")
+	VIP_IO_DESCRIPTION(Order, "An order of 0 corresponds to convolution with a Gaussian kernel.\nA positive order corresponds to convolution with that derivative of a Gaussian.")
+	VIP_PROPERTY_EDIT(Sigma, VIP_DOUBLE_SPINBOX_EDIT(0, 1000, 0.5, 1))
+	VIP_PROPERTY_EDIT(Order, VIP_SPINBOX_EDIT(0, 10, 1, 0))
+public:
+	VipGaussianFilter(QObject* parent = nullptr)
+	  : VipBorderModeFilter(parent)
+	{
+		propertyName("Sigma")->setData(1.);
+		propertyName("Order")->setData(0);
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipGaussianFilter*)
+
+class VIP_CORE_EXPORT VipSobelFilter : public VipBorderModeFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Calculate a multi-dimensional Sobel filter along the last axis")
+public:
+	VipSobelFilter(QObject* parent = nullptr)
+	  : VipBorderModeFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipSobelFilter*)
+
+class VIP_CORE_EXPORT VipPrewittFilter : public VipBorderModeFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Calculate a multi-dimensional Prewitt filter along the last axis")
+public:
+	VipPrewittFilter(QObject* parent = nullptr)
+	  : VipBorderModeFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipPrewittFilter*)
+
+class VIP_CORE_EXPORT VipLaplaceFilter : public VipBorderModeFilter
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("N-dimensional Laplace filter based on approximate second derivatives")
+public:
+	VipLaplaceFilter(QObject* parent = nullptr)
+	  : VipBorderModeFilter(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipLaplaceFilter*)
+
+/// @brief Base class for greyscale morphology with a flat structuring element
+class VIP_CORE_EXPORT VipGreyMorphology : public VipWindowFilter
+{
+	Q_OBJECT
+	VIP_IO(VipProperty FullConnectivity)
+	VIP_CATEGORY("Morphology")
+	VIP_IO_DESCRIPTION(FullConnectivity, "If true, the structuring element is a full square.\nOtherwise, it is a cross made of the lines along each axis.")
+public:
+	VipGreyMorphology(QObject* parent = nullptr)
+	  : VipWindowFilter(parent)
+	{
+		propertyName("FullConnectivity")->setData(true);
+	}
+
+protected:
+	bool fullConnectivity() const { return propertyName("FullConnectivity")->value<bool>(); }
+};
+
+class VIP_CORE_EXPORT VipGreyDilation : public VipGreyMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Calculate a greyscale dilation.\nFor a full structuring element, it is a maximum filter over a sliding window.")
+public:
+	VipGreyDilation(QObject* parent = nullptr)
+	  : VipGreyMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipGreyDilation*)
+
+class VIP_CORE_EXPORT VipGreyErosion : public VipGreyMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Calculate a greyscale erosion.\nFor a full structuring element, it is a minimum filter over a sliding window.")
+public:
+	VipGreyErosion(QObject* parent = nullptr)
+	  : VipGreyMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipGreyErosion*)
+
+class VIP_CORE_EXPORT VipGreyOpening : public VipGreyMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Multi-dimensional greyscale opening.\nA greyscale opening consists in the succession of a greyscale erosion, and a greyscale dilation.")
+public:
+	VipGreyOpening(QObject* parent = nullptr)
+	  : VipGreyMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipGreyOpening*)
+
+class VIP_CORE_EXPORT VipGreyClosing : public VipGreyMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Multi-dimensional greyscale closing.\nA greyscale closing consists in the succession of a greyscale dilation, and a greyscale erosion.")
+public:
+	VipGreyClosing(QObject* parent = nullptr)
+	  : VipGreyMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipGreyClosing*)
+
+/// @brief Base class for binary morphology on 1D or 2D masks
+class VIP_CORE_EXPORT VipBinaryMorphology : public VipStdImageProcessing
+{
+	Q_OBJECT
+	VIP_IO(VipProperty Iterations)
+	VIP_IO(VipProperty FullConnectivity)
+	VIP_CATEGORY("Morphology")
+	VIP_IO_DESCRIPTION(Iterations, "Number of times the operation is repeated.\nIf iterations is less than 1, the operation is repeated until the result does not change anymore.")
+	VIP_IO_DESCRIPTION(FullConnectivity, "If true, diagonally-connected elements are considered neighbors")
+	VIP_PROPERTY_EDIT(Iterations, VIP_SPINBOX_EDIT(0, 20, 1, 1))
+public:
+	VipBinaryMorphology(QObject* parent = nullptr)
+	  : VipStdImageProcessing(parent)
+	{
+		propertyName("Iterations")->setData(1);
+		propertyName("FullConnectivity")->setData(true);
+	}
+
+protected:
+	int iterations() const { return propertyName("Iterations")->value<int>(); }
+	bool fullConnectivity() const { return propertyName("FullConnectivity")->value<bool>(); }
+	/// Set an error and returns a null array if \a ar is null
+	VipNDArray checkOutput(const VipNDArray& ar);
+};
+
+class VIP_CORE_EXPORT VipBinaryDilation : public VipBinaryMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Binary dilation of 1D or 2D masks")
+public:
+	VipBinaryDilation(QObject* parent = nullptr)
+	  : VipBinaryMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipBinaryDilation*)
+
+class VIP_CORE_EXPORT VipBinaryErosion : public VipBinaryMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Binary erosion of 1D or 2D masks")
+public:
+	VipBinaryErosion(QObject* parent = nullptr)
+	  : VipBinaryMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipBinaryErosion*)
+
+class VIP_CORE_EXPORT VipBinaryOpening : public VipBinaryMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Binary opening of 1D or 2D masks.\nThe opening is the dilation of the erosion of the mask by the structuring element.")
+public:
+	VipBinaryOpening(QObject* parent = nullptr)
+	  : VipBinaryMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipBinaryOpening*)
+
+class VIP_CORE_EXPORT VipBinaryClosing : public VipBinaryMorphology
+{
+	Q_OBJECT
+	VIP_DESCRIPTION("Binary closing of 1D or 2D masks.\nThe closing is the erosion of the dilation of the mask by the structuring element.")
+public:
+	VipBinaryClosing(QObject* parent = nullptr)
+	  : VipBinaryMorphology(parent)
+	{
+	}
+	virtual VipNDArray applyProcessing(const VipNDArray& ar);
+};
+VIP_REGISTER_QOBJECT_METATYPE(VipBinaryClosing*)
+
+#endif
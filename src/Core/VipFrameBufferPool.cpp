@@ -0,0 +1,211 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "VipFrameBufferPool.h"
+#include "VipMemoryPool.h"
+#include "VipRgb.h"
+
+// Shared between the pool and all the arrays it allocates, so that arrays can outlive the pool
+class VipFrameBufferPool::PrivateData
+{
+public:
+	std::mutex mutex;
+	std::map<size_t, std::vector<void*>> free_lists;
+	std::atomic<bool> enabled{ true };
+	std::atomic<qint64> max_cached{ 0 };
+	std::atomic<qint64> cached{ 0 };
+	std::atomic<qint64> used{ 0 };
+	std::atomic<qint64> hits{ 0 };
+	std::atomic<qint64> misses{ 0 };
+	std::atomic<qint64> unpooled{ 0 };
+
+	static size_t pages(size_t bytes) noexcept { return bytes / vipOSPageSize(); }
+
+	void* take(size_t bytes)
+	{
+		{
+			std::lock_guard<std::mutex> ll(mutex);
+			auto it = free_lists.find(bytes);
+			if (it != free_lists.end() && it->second.size()) {
+				void* p = it->second.back();
+				it->second.pop_back();
+				cached.fetch_sub((qint64)bytes);
+				hits.fetch_add(1, std::memory_order_relaxed);
+				return p;
+			}
+		}
+		misses.fetch_add(1, std::memory_order_relaxed);
+		return vipOSAllocatePages(pages(bytes));
+	}
+
+	void release(void* p, size_t bytes)
+	{
+		used.fetch_sub((qint64)bytes);
+		if (enabled.load(std::memory_order_relaxed) && cached.load() + (qint64)bytes <= max_cached.load()) {
+			std::lock_guard<std::mutex> ll(mutex);
+			free_lists[bytes].push_back(p);
+			cached.fetch_add((qint64)bytes);
+			return;
+		}
+		vipOSFreePages(p, pages(bytes));
+	}
+
+	void clear()
+	{
+		std::map<size_t, std::vector<void*>> lists;
+		{
+			std::lock_guard<std::mutex> ll(mutex);
+			lists.swap(free_lists);
+			cached.store(0);
+		}
+		for (auto it = lists.begin(); it != lists.end(); ++it)
+			for (void* p : it->second)
+				vipOSFreePages(p, pages(it->first));
+	}
+
+	~PrivateData() { clear(); }
+};
+
+static bool isPoolable(int data_type)
+{
+	return vipIsArithmetic(data_type) || vipIsComplex(data_type) || data_type == qMetaTypeId<VipRGB>();
+}
+
+VipFrameBufferPool::VipFrameBufferPool(qint64 max_cached_bytes)
+  : d_data(new PrivateData())
+{
+	d_data->max_cached.store(max_cached_bytes);
+}
+
+VipFrameBufferPool::~VipFrameBufferPool()
+{
+	// Arrays still in use will free their buffer on release
+	d_data->enabled.store(false);
+	d_data->clear();
+}
+
+void VipFrameBufferPool::setMaxCachedBytes(qint64 bytes)
+{
+	d_data->max_cached.store(bytes);
+	if (d_data->cached.load() > bytes)
+		d_data->clear();
+}
+
+qint64 VipFrameBufferPool::maxCachedBytes() const
+{
+	return d_data->max_cached.load();
+}
+
+void VipFrameBufferPool::setEnabled(bool enable)
+{
+	d_data->enabled.store(enable);
+	if (!enable)
+		d_data->clear();
+}
+
+bool VipFrameBufferPool::isEnabled() const
+{
+	return d_data->enabled.load();
+}
+
+size_t VipFrameBufferPool::sizeClass(size_t bytes) noexcept
+{
+	const size_t page = vipOSPageSize();
+	size_t pages = (bytes + page - 1) / page;
+	if (pages <= 4)
+		return std::max(pages, (size_t)1) * page;
+
+	// 4 size classes per power of 2
+	size_t log = 0;
+	while ((pages >> log) > 1)
+		++log;
+	const size_t step = (size_t)1 << (log - 2);
+	pages = (pages + step - 1) / step * step;
+	return pages * page;
+}
+
+VipNDArray VipFrameBufferPool::allocate(int data_type, const VipNDArrayShape& shape)
+{
+	if (!d_data->enabled.load(std::memory_order_relaxed) || !isPoolable(data_type)) {
+		d_data->unpooled.fetch_add(1, std::memory_order_relaxed);
+		return VipNDArray(data_type, shape);
+	}
+
+	VipSharedHandle h = vipCreateArrayHandle(VipNDArrayHandle::Standard, data_type);
+	if (h->handleType() != VipNDArrayHandle::Standard) {
+		d_data->unpooled.fetch_add(1, std::memory_order_relaxed);
+		return VipNDArray(data_type, shape);
+	}
+
+	const qsizetype count = vipShapeToSize(shape);
+	if (count == 0)
+		return VipNDArray(data_type, shape);
+
+	const size_t bytes = sizeClass((size_t)count * (size_t)h->dataSize());
+	void* ptr = d_data->take(bytes);
+	if (!ptr)
+		return VipNDArray(data_type, shape);
+	d_data->used.fetch_add((qint64)bytes);
+
+	std::shared_ptr<PrivateData> d = d_data;
+	VipDeleteFunction del = [d, bytes](void* p) { d->release(p, bytes); };
+	return VipNDArray(vipCreateArrayHandle(VipNDArrayHandle::Standard, data_type, ptr, shape, del));
+}
+
+VipFrameBufferPool::Statistics VipFrameBufferPool::statistics() const
+{
+	Statistics res;
+	res.hits = d_data->hits.load();
+	res.misses = d_data->misses.load();
+	res.unpooled = d_data->unpooled.load();
+	res.cachedBytes = d_data->cached.load();
+	res.usedBytes = d_data->used.load();
+	res.maxCachedBytes = d_data->max_cached.load();
+	return res;
+}
+
+void VipFrameBufferPool::resetStatistics()
+{
+	d_data->hits.store(0);
+	d_data->misses.store(0);
+	d_data->unpooled.store(0);
+}
+
+void VipFrameBufferPool::clear()
+{
+	d_data->clear();
+}
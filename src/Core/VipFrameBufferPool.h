@@ -0,0 +1,121 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_FRAME_BUFFER_POOL_H
+#define VIP_FRAME_BUFFER_POOL_H
+
+#include <memory>
+
+#include "VipConfig.h"
+#include "VipNDArray.h"
+
+/// \addtogroup Core
+/// @{
+
+/// @brief A pool of recyclable VipNDArray frame buffers.
+///
+/// VipFrameBufferPool allocates dense VipNDArray objects whose data buffer is drawn from a set of free lists
+/// sorted by size class. When the last reference to the array data is released, the buffer goes back
+/// to the pool instead of being freed, and will be reused by the next allocation of the same size class.
+/// This removes most of the malloc/free churn and page faulting of video pipelines producing frames of
+/// constant shape at high frame rates.
+///
+/// Buffers are directly allocated with vipOSAllocatePages(). Size classes are multiples of the OS page size,
+/// with 4 classes per power of 2 above 4 pages.
+///
+/// Only arithmetic, complex and VipRGB arrays are pooled. Other types fall back to a standard VipNDArray allocation.
+///
+/// The pool keeps at most maxCachedBytes() of unused buffers: buffers released above this limit are
+/// returned to the OS. Arrays allocated by a VipFrameBufferPool can safely outlive it.
+///
+/// VipFrameBufferPool is thread safe. It is usually not used directly, but through VipProcessingPool::setFrameBufferPoolEnabled()
+/// and VipProcessingObject::createFrame().
+class VIP_CORE_EXPORT VipFrameBufferPool
+{
+public:
+	/// @brief Pool statistics
+	struct Statistics
+	{
+		qint64 hits = 0;	   //! Number of allocations served from the free lists
+		qint64 misses = 0;	   //! Number of allocations that required a new OS allocation
+		qint64 unpooled = 0;	   //! Number of allocations of non poolable types
+		qint64 cachedBytes = 0;	   //! Current amount of unused buffers kept in the pool
+		qint64 usedBytes = 0;	   //! Current amount of buffers in use
+		qint64 maxCachedBytes = 0; //! Maximum amount of unused buffers kept in the pool
+
+		/// @brief Returns the ratio hits / (hits + misses)
+		double hitRate() const { return (hits + misses) ? double(hits) / double(hits + misses) : 0.; }
+	};
+
+	VipFrameBufferPool(qint64 max_cached_bytes = 256000000);
+	~VipFrameBufferPool();
+
+	VipFrameBufferPool(const VipFrameBufferPool&) = delete;
+	VipFrameBufferPool& operator=(const VipFrameBufferPool&) = delete;
+
+	/// @brief Set the maximum amount of unused buffers in bytes kept in the pool
+	void setMaxCachedBytes(qint64 bytes);
+	qint64 maxCachedBytes() const;
+
+	/// @brief Enable/disable the pool. When disabled, allocate() is equivalent to VipNDArray(data_type, shape).
+	void setEnabled(bool enable);
+	bool isEnabled() const;
+
+	/// @brief Allocate a dense, uninitialized VipNDArray of given type and shape
+	VipNDArray allocate(int data_type, const VipNDArrayShape& shape);
+	/// @brief Allocate a dense, uninitialized VipNDArrayType of given shape
+	template<class T>
+	VipNDArrayType<T> allocate(const VipNDArrayShape& shape)
+	{
+		return allocate(qMetaTypeId<T>(), shape);
+	}
+
+	/// @brief Returns the pool statistics
+	Statistics statistics() const;
+	/// @brief Reset hits, misses and unpooled counters
+	void resetStatistics();
+
+	/// @brief Release all unused buffers
+	void clear();
+
+	/// @brief Returns the size class in bytes used for given buffer size
+	static size_t sizeClass(size_t bytes) noexcept;
+
+private:
+	class PrivateData;
+	std::shared_ptr<PrivateData> d_data;
+};
+
+/// @}
+// end Core
+
+#endif
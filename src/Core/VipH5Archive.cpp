@@ -37,7 +37,9 @@
 #include "VipCore.h"
 #include <QBuffer>
 #include <QFile>
+#include <QMutex>
 
+#include <atomic>
 #include <set>
 #include <vector>
 extern "C" {
@@ -609,6 +611,39 @@ public:
 	QVector<Positions> save;
 	QHash<QByteArray, GroupContent> groups_contents; // in read only mode, store the groups contents to avoid recomputing it (as order is wrong the second time)
 	qint64 dpos{ 0 };
+
+	// Movie layout
+	struct Movie
+	{
+		H5Object frames;	     // (count, frame dims...) pixels
+		H5Object times;		     // (count) timestamps
+		H5Object attribute_ranges;   // (count, 2) offset and size of each frame attributes in 'attributes'
+		H5Object attributes;	     // serialized attributes
+		int data_type{ 0 };	     // frame data type
+		hid_t type{ 0 };	     // HDF5 pixel type
+		int rank{ 0 };		     // rank of 'frames'
+		hsize_t dims[VIP_MAX_DIMS + 2]; // current dims of 'frames'
+		qint64 attributes_size{ 0 };
+		QByteArray last_attributes;
+		qint64 last_range[2]{ 0, 0 };
+
+		// Read mode only
+		QVector<qint64> ranges;	 // content of 'attribute_ranges'
+		QVector<qint64> chunks;	 // file address of each chunk of 'frames', empty if frames cannot be copied from the file mapping
+		qint64 chunk_frames{ 0 }; // frames per chunk
+		qint64 frame_bytes{ 0 };
+		qint64 cached_range{ -1 }; // offset of the last decoded attributes
+		QVariantMap cached_attributes;
+	};
+	std::map<QByteArray, Movie> movies;
+	// Set once the movies are listed in Read mode. The movies are not modified afterward and are read without locking vipH5Mutex()
+	std::atomic<bool> movies_listed{ false };
+	QMutex attributes_mutex;
+	// Read only mapping of local files
+	const uchar* mapped{ nullptr };
+	qint64 mapped_size{ 0 };
+	int movie_compression{ 0 };
+	int movie_chunk_frames{ 0 };
 };
 
 VipH5Archive::VipH5Archive()
@@ -693,6 +728,12 @@ bool VipH5Archive::open(QIODevice* d)
 
 		if (mode() == Read) {
 			setRange(0, d->size());
+			// map local files to copy uncompressed movie frames without going through the HDF5 library
+			QFile* f = qobject_cast<QFile*>(d);
+			if (f && vipH5NativeFileAccess() && f->size() > 0) {
+				d_data->mapped = f->map(0, f->size());
+				d_data->mapped_size = d_data->mapped ? f->size() : 0;
+			}
 		}
 		return true;
 	}
@@ -709,6 +750,11 @@ void VipH5Archive::close()
 {
 	if (d_data->device) {
 		VipH5MutexLocker lock(vipH5Mutex());
+		// the mapping is released when the driver closes the device
+		d_data->mapped = nullptr;
+		d_data->mapped_size = 0;
+		d_data->movies.clear();
+		d_data->movies_listed = false;
 		d_data->position.clear();
 		d_data->save.clear();
 		d_data->file = H5Object();
@@ -1329,3 +1375,434 @@ finish:
 	// update last position
 	d_data->position.back().last = bname;
 }
+
+#define MOVIES_GROUP "/_movies"
+
+// Target chunk size of movies frames when the number of frames per chunk is not specified
+static const qint64 movieChunkBytes = 1 << 20;
+// Chunk cache size of movies frames datasets, large enough to keep several chunks when reading consecutive frames
+static const size_t movieChunkCache = 8 << 20;
+
+// Create an extendable dataset of shape (0, item_dims...) chunked along the first dimension
+static H5Object createExtendableDataSet(hid_t loc, const char* name, hid_t type, int rank, const hsize_t* item_dims, hsize_t chunk_items, int compression)
+{
+	hsize_t dims[VIP_MAX_DIMS + 2], max_dims[VIP_MAX_DIMS + 2], chunk[VIP_MAX_DIMS + 2];
+	dims[0] = 0;
+	max_dims[0] = H5S_UNLIMITED;
+	chunk[0] = std::max(chunk_items, (hsize_t)1);
+	for (int i = 1; i < rank; ++i)
+		dims[i] = max_dims[i] = chunk[i] = item_dims[i - 1];
+
+	H5Object space(H5Screate_simple(rank, dims, max_dims), H5Object::Space);
+	if (!space)
+		return H5Object();
+	H5Object plist(H5Pcreate(H5P_DATASET_CREATE), H5Object::Prop);
+	if (H5Pset_chunk(plist, rank, chunk) < 0)
+		return H5Object();
+	if (compression > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+		H5Pset_shuffle(plist);
+		H5Pset_deflate(plist, (unsigned)std::min(compression, 9));
+	}
+	H5Object access(H5Pcreate(H5P_DATASET_ACCESS), H5Object::Prop);
+	H5Pset_chunk_cache(access, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, movieChunkCache, H5D_CHUNK_CACHE_W0_DEFAULT);
+	return H5Object(H5Dcreate(loc, name, type, space, H5P_DEFAULT, plist, access), H5Object::Set);
+}
+
+// Append count items to an extendable dataset of current shape dims, and update dims
+static bool appendToDataSet(const H5Object& set, hid_t type, int rank, hsize_t* dims, hsize_t count, const void* data)
+{
+	hsize_t new_dims[VIP_MAX_DIMS + 2], start[VIP_MAX_DIMS + 2], block[VIP_MAX_DIMS + 2];
+	for (int i = 0; i < rank; ++i) {
+		new_dims[i] = block[i] = dims[i];
+		start[i] = 0;
+	}
+	new_dims[0] = dims[0] + count;
+	start[0] = dims[0];
+	block[0] = count;
+
+	if (H5Dset_extent(set, new_dims) < 0)
+		return false;
+	H5Object file_space(H5Dget_space(set), H5Object::Space);
+	if (!file_space || H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, nullptr, block, nullptr) < 0)
+		return false;
+	H5Object mem_space(H5Screate_simple(rank, block, nullptr), H5Object::Space);
+	if (H5Dwrite(set, type, mem_space, file_space, H5P_DEFAULT, data) < 0)
+		return false;
+	dims[0] = new_dims[0];
+	return true;
+}
+
+// Read count items starting at first from a dataset of shape dims
+static bool readFromDataSet(const H5Object& set, hid_t type, int rank, const hsize_t* dims, hsize_t first, hsize_t count, void* data)
+{
+	if (first + count > dims[0])
+		return false;
+	hsize_t start[VIP_MAX_DIMS + 2], block[VIP_MAX_DIMS + 2];
+	for (int i = 0; i < rank; ++i) {
+		block[i] = dims[i];
+		start[i] = 0;
+	}
+	start[0] = first;
+	block[0] = count;
+
+	H5Object file_space(H5Dget_space(set), H5Object::Space);
+	if (!file_space || H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, nullptr, block, nullptr) < 0)
+		return false;
+	H5Object mem_space(H5Screate_simple(rank, block, nullptr), H5Object::Space);
+	return H5Dread(set, type, mem_space, file_space, H5P_DEFAULT, data) >= 0;
+}
+
+static H5Object createOrderedGroup(hid_t loc, const char* name)
+{
+	H5Object plist(H5Pcreate(H5P_GROUP_CREATE), H5Object::Prop);
+	H5Pset_link_creation_order(plist, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED);
+	return H5Object(H5Gcreate(loc, name, H5P_DEFAULT, plist, H5P_DEFAULT), H5Object::Group);
+}
+
+// Shape of count frames of a movie, without the leading dimension if count is 0
+static VipNDArrayShape movieShape(int data_type, int rank, const hsize_t* dims, qint64 count)
+{
+	// remove the trailing dimension of RGB and complex types
+	if (data_type == qMetaTypeId<VipRGB>() || vipIsComplex(data_type))
+		--rank;
+	VipNDArrayShape sh;
+	if (count)
+		sh.push_back((qsizetype)count);
+	for (int i = 1; i < rank; ++i)
+		sh.push_back((qsizetype)dims[i]);
+	return sh;
+}
+
+void VipH5Archive::setMovieCompression(int level)
+{
+	d_data->movie_compression = qBound(0, level, 9);
+}
+int VipH5Archive::movieCompression() const
+{
+	return d_data->movie_compression;
+}
+
+void VipH5Archive::setMovieChunkFrames(int frames)
+{
+	d_data->movie_chunk_frames = std::max(frames, 0);
+}
+int VipH5Archive::movieChunkFrames() const
+{
+	return d_data->movie_chunk_frames;
+}
+
+bool VipH5Archive::appendMovieFrame(const QByteArray& name, const VipNDArray& frame, qint64 time, const QVariantMap& attributes)
+{
+	if (mode() != Write || name.isEmpty() || name.contains('/') || frame.isEmpty() || frame.shapeCount() >= VIP_MAX_DIMS)
+		return false;
+	if (frame.dataType() == qMetaTypeId<VipRGB>() && frame.shapeCount() != 2)
+		return false;
+
+	const VipNDArray ar = frame.dense();
+	ArraySpace aspace = arraySpaceAndData(ar);
+	if (!aspace.type || !aspace.space)
+		return false;
+	hsize_t frame_dims[VIP_MAX_DIMS + 1];
+	const int frame_rank = H5Sget_simple_extent_ndims(aspace.space);
+	H5Sget_simple_extent_dims(aspace.space, frame_dims, nullptr);
+
+	VipH5MutexLocker lock(vipH5Mutex());
+
+	auto it = d_data->movies.find(name);
+	if (it == d_data->movies.end()) {
+		// Create the movie group and datasets
+		if (H5Lexists(d_data->file, MOVIES_GROUP, H5P_DEFAULT) <= 0) {
+			if (!createOrderedGroup(d_data->file, MOVIES_GROUP))
+				return false;
+		}
+		H5Object gr = createOrderedGroup(d_data->file, (MOVIES_GROUP "/" + name).data());
+		if (!gr)
+			return false;
+		writeAttribute(gr, "type_name", QString(vipTypeName(ar.dataType())));
+
+		PrivateData::Movie m;
+		m.data_type = ar.dataType();
+		m.type = aspace.type;
+		m.rank = frame_rank + 1;
+		m.dims[0] = 0;
+		for (int i = 0; i < frame_rank; ++i)
+			m.dims[i + 1] = frame_dims[i];
+
+		hsize_t chunk_frames = (hsize_t)d_data->movie_chunk_frames;
+		if (chunk_frames == 0)
+			chunk_frames = (hsize_t)std::max(movieChunkBytes / (qint64)(ar.size() * ar.dataSize()), (qint64)1);
+		const hsize_t pair = 2;
+		m.frames = createExtendableDataSet(gr, "frames", m.type, m.rank, frame_dims, chunk_frames, d_data->movie_compression);
+		m.times = createExtendableDataSet(gr, "times", H5T_NATIVE_INT64, 1, nullptr, 1024, 0);
+		m.attribute_ranges = createExtendableDataSet(gr, "attribute_ranges", H5T_NATIVE_INT64, 2, &pair, 1024, 0);
+		m.attributes = createExtendableDataSet(gr, "attributes", H5T_NATIVE_UINT8, 1, nullptr, 1 << 16, d_data->movie_compression);
+		if (!m.frames || !m.times || !m.attribute_ranges || !m.attributes)
+			return false;
+		it = d_data->movies.emplace(name, std::move(m)).first;
+	}
+
+	PrivateData::Movie& m = it->second;
+	if (m.data_type != ar.dataType() || m.rank != frame_rank + 1)
+		return false;
+	for (int i = 0; i < frame_rank; ++i)
+		if (m.dims[i + 1] != frame_dims[i])
+			return false;
+
+	// Serialize the attributes. Consecutive frames with the same attributes share the same bytes.
+	QByteArray bytes;
+	{
+		QDataStream str(&bytes, QIODevice::WriteOnly);
+		str.setByteOrder(QDataStream::LittleEndian);
+		vipSafeVariantMapSave(str, attributes);
+	}
+	if (m.dims[0] == 0 || bytes != m.last_attributes) {
+		hsize_t size = (hsize_t)m.attributes_size;
+		if (!appendToDataSet(m.attributes, H5T_NATIVE_UINT8, 1, &size, (hsize_t)bytes.size(), bytes.data()))
+			return false;
+		m.last_range[0] = m.attributes_size;
+		m.last_range[1] = bytes.size();
+		m.attributes_size = (qint64)size;
+		m.last_attributes = bytes;
+	}
+
+	hsize_t count = m.dims[0];
+	hsize_t range_dims[2] = { count, 2 };
+	if (!appendToDataSet(m.frames, m.type, m.rank, m.dims, 1, aspace.data))
+		return false;
+	if (!appendToDataSet(m.times, H5T_NATIVE_INT64, 1, &count, 1, &time))
+		return false;
+	return appendToDataSet(m.attribute_ranges, H5T_NATIVE_INT64, 2, range_dims, 1, m.last_range);
+}
+
+// Returns the file address of each chunk of a movie if its frames can be directly copied from the file mapping:
+// uncompressed chunks of whole frames, with allocated chunks stored in the native byte order.
+static QVector<qint64> directChunks(const H5Object& frames, hid_t type, int rank, const hsize_t* dims, qint64 mapped_size, qint64* chunk_frames)
+{
+#if H5_VERSION_GE(1, 10, 5)
+	H5Object plist(H5Dget_create_plist(frames), H5Object::Prop);
+	if (!plist || H5Pget_layout(plist) != H5D_CHUNKED || H5Pget_nfilters(plist) != 0)
+		return QVector<qint64>();
+	hsize_t chunk[VIP_MAX_DIMS + 2];
+	if (H5Pget_chunk(plist, rank, chunk) != rank || chunk[0] == 0)
+		return QVector<qint64>();
+	qint64 chunk_bytes = (qint64)H5Tget_size(type) * (qint64)chunk[0];
+	for (int i = 1; i < rank; ++i) {
+		if (chunk[i] != dims[i])
+			return QVector<qint64>();
+		chunk_bytes *= (qint64)dims[i];
+	}
+	H5Object file_type(H5Dget_type(frames), H5Object::H5Type);
+	if (H5Tequal(file_type, type) <= 0)
+		return QVector<qint64>();
+
+	H5Object space(H5Dget_space(frames), H5Object::Space);
+	hsize_t count = 0;
+	const hsize_t expected = (dims[0] + chunk[0] - 1) / chunk[0];
+	if (H5Dget_num_chunks(frames, space, &count) < 0 || count != expected)
+		return QVector<qint64>();
+
+	QVector<qint64> res((qsizetype)count, -1);
+	for (hsize_t i = 0; i < count; ++i) {
+		hsize_t offset[VIP_MAX_DIMS + 2];
+		unsigned mask = 0;
+		haddr_t addr = HADDR_UNDEF;
+		hsize_t size = 0;
+		if (H5Dget_chunk_info(frames, space, i, offset, &mask, &addr, &size) < 0 || addr == HADDR_UNDEF)
+			return QVector<qint64>();
+		const hsize_t c = offset[0] / chunk[0];
+		if (c >= count || (qint64)size != chunk_bytes || (qint64)(addr + size) > mapped_size)
+			return QVector<qint64>();
+		res[(qsizetype)c] = (qint64)addr;
+	}
+	if (res.contains(-1))
+		return QVector<qint64>();
+	*chunk_frames = (qint64)chunk[0];
+	return res;
+#else
+	Q_UNUSED(frames);
+	Q_UNUSED(type);
+	Q_UNUSED(rank);
+	Q_UNUSED(dims);
+	Q_UNUSED(mapped_size);
+	Q_UNUSED(chunk_frames);
+	return QVector<qint64>();
+#endif
+}
+
+QList<QByteArray> VipH5Archive::movies() const
+{
+	if (d_data->movies_listed.load(std::memory_order_acquire)) {
+		QList<QByteArray> res;
+		for (const auto& m : d_data->movies)
+			res.append(m.first);
+		return res;
+	}
+
+	VipH5MutexLocker lock(vipH5Mutex());
+
+	if (mode() == Read && !d_data->movies_listed.load()) {
+		// Open all movies found in the file
+		if (H5Lexists(d_data->file, MOVIES_GROUP, H5P_DEFAULT) > 0) {
+			H5Object movies(H5Gopen(d_data->file, MOVIES_GROUP, H5P_DEFAULT), H5Object::Group);
+			const GroupContent content = listGroupContent(device(), MOVIES_GROUP, movies);
+			for (const Content& c : content) {
+				if (c.second != H5Object::Group)
+					continue;
+				H5Object gr(H5Gopen(movies, c.first.data(), H5P_DEFAULT), H5Object::Group);
+				PrivateData::Movie m;
+				m.data_type = vipIdFromName(readAttribute(gr, "type_name").toString().toLatin1().data());
+				if (m.data_type == 0)
+					continue;
+
+				H5Object access(H5Pcreate(H5P_DATASET_ACCESS), H5Object::Prop);
+				H5Pset_chunk_cache(access, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, movieChunkCache, H5D_CHUNK_CACHE_W0_DEFAULT);
+				m.frames = H5Object(H5Dopen(gr, "frames", access), H5Object::Set);
+				m.times = H5Object(H5Dopen(gr, "times", H5P_DEFAULT), H5Object::Set);
+				m.attribute_ranges = H5Object(H5Dopen(gr, "attribute_ranges", H5P_DEFAULT), H5Object::Set);
+				m.attributes = H5Object(H5Dopen(gr, "attributes", H5P_DEFAULT), H5Object::Set);
+				if (!m.frames || !m.times || !m.attribute_ranges || !m.attributes)
+					continue;
+
+				H5Object type(H5Dget_type(m.frames), H5Object::H5Type);
+				m.type = qtToHDF5(HDF5ToQt(type));
+				H5Object space(H5Dget_space(m.frames), H5Object::Space);
+				m.rank = H5Sget_simple_extent_ndims(space);
+				if (!m.type || m.rank < 2 || m.rank > VIP_MAX_DIMS + 2)
+					continue;
+				H5Sget_simple_extent_dims(space, m.dims, nullptr);
+
+				m.frame_bytes = (qint64)H5Tget_size(m.type);
+				for (int i = 1; i < m.rank; ++i)
+					m.frame_bytes *= (qint64)m.dims[i];
+				m.attributes_size = (qint64)H5Sget_simple_extent_npoints(H5Object(H5Dget_space(m.attributes), H5Object::Space));
+				m.ranges.resize((qsizetype)m.dims[0] * 2);
+				hsize_t range_dims[2] = { m.dims[0], 2 };
+				if (m.dims[0] && !readFromDataSet(m.attribute_ranges, H5T_NATIVE_INT64, 2, range_dims, 0, m.dims[0], m.ranges.data()))
+					continue;
+				if (d_data->mapped)
+					m.chunks = directChunks(m.frames, m.type, m.rank, m.dims, d_data->mapped_size, &m.chunk_frames);
+				d_data->movies.emplace(c.first, std::move(m));
+			}
+		}
+		d_data->movies_listed.store(true, std::memory_order_release);
+	}
+
+	QList<QByteArray> res;
+	for (const auto& m : d_data->movies)
+		res.append(m.first);
+	return res;
+}
+
+qint64 VipH5Archive::movieFrameCount(const QByteArray& name) const
+{
+	movies();
+	VipH5MutexLocker lock(vipH5Mutex());
+	auto it = d_data->movies.find(name);
+	return it == d_data->movies.end() ? 0 : (qint64)it->second.dims[0];
+}
+
+QVector<qint64> VipH5Archive::movieTimes(const QByteArray& name) const
+{
+	movies();
+	VipH5MutexLocker lock(vipH5Mutex());
+	auto it = d_data->movies.find(name);
+	if (it == d_data->movies.end())
+		return QVector<qint64>();
+
+	const PrivateData::Movie& m = it->second;
+	QVector<qint64> res(m.dims[0]);
+	if (res.size() && !readFromDataSet(m.times, H5T_NATIVE_INT64, 1, m.dims, 0, m.dims[0], res.data()))
+		return QVector<qint64>();
+	return res;
+}
+
+VipNDArray VipH5Archive::readMovieFrames(const QByteArray& name, qint64 first, qint64 count) const
+{
+	movies();
+	if (first < 0 || count <= 0)
+		return VipNDArray();
+
+	if (d_data->movies_listed.load(std::memory_order_acquire)) {
+		// Read mode: copy frames directly from the file mapping if possible, without locking vipH5Mutex()
+		auto it = d_data->movies.find(name);
+		if (it == d_data->movies.end() || first + count > (qint64)it->second.dims[0])
+			return VipNDArray();
+		const PrivateData::Movie& m = it->second;
+		if (m.chunks.size()) {
+			VipNDArray ar(m.data_type, movieShape(m.data_type, m.rank, m.dims, count));
+			uchar* dst = (uchar*)ar.data();
+			for (qint64 f = first; f < first + count; ++f, dst += m.frame_bytes)
+				memcpy(dst, d_data->mapped + m.chunks[f / m.chunk_frames] + (f % m.chunk_frames) * m.frame_bytes, (size_t)m.frame_bytes);
+			return ar;
+		}
+	}
+
+	VipH5MutexLocker lock(vipH5Mutex());
+	auto it = d_data->movies.find(name);
+	if (it == d_data->movies.end())
+		return VipNDArray();
+
+	const PrivateData::Movie& m = it->second;
+	VipNDArray ar(m.data_type, movieShape(m.data_type, m.rank, m.dims, count));
+	if (ar.isEmpty() || !readFromDataSet(m.frames, m.type, m.rank, m.dims, (hsize_t)first, (hsize_t)count, ar.data()))
+		return VipNDArray();
+	return ar;
+}
+
+VipNDArray VipH5Archive::readMovieFrame(const QByteArray& name, qint64 index, QVariantMap* attributes) const
+{
+	VipNDArray ar = readMovieFrames(name, index, 1);
+	if (ar.isEmpty())
+		return ar;
+	// remove the leading dimension
+	VipNDArrayShape sh;
+	for (int i = 1; i < ar.shapeCount(); ++i)
+		sh.push_back(ar.shape(i));
+	ar.reshape(sh);
+
+	if (!attributes)
+		return ar;
+
+	PrivateData::Movie* m = nullptr;
+	qint64 range[2] = { 0, 0 };
+	if (d_data->movies_listed.load(std::memory_order_acquire)) {
+		m = &d_data->movies.find(name)->second;
+		range[0] = m->ranges[index * 2];
+		range[1] = m->ranges[index * 2 + 1];
+		// consecutive frames usually share the same attributes
+		QMutexLocker locker(&d_data->attributes_mutex);
+		if (m->cached_range == range[0]) {
+			*attributes = m->cached_attributes;
+			return ar;
+		}
+	}
+
+	QByteArray bytes;
+	{
+		VipH5MutexLocker lock(vipH5Mutex());
+		if (!m) {
+			m = &d_data->movies.find(name)->second;
+			hsize_t range_dims[2] = { m->dims[0], 2 };
+			if (!readFromDataSet(m->attribute_ranges, H5T_NATIVE_INT64, 2, range_dims, (hsize_t)index, 1, range))
+				return ar;
+			m->attributes_size = (qint64)H5Sget_simple_extent_npoints(H5Object(H5Dget_space(m->attributes), H5Object::Space));
+		}
+		if (range[1] > 0) {
+			hsize_t attributes_size = (hsize_t)m->attributes_size;
+			bytes.resize((qsizetype)range[1]);
+			if (!readFromDataSet(m->attributes, H5T_NATIVE_UINT8, 1, &attributes_size, (hsize_t)range[0], (hsize_t)range[1], bytes.data()))
+				return ar;
+		}
+	}
+
+	QDataStream str(bytes);
+	str.setByteOrder(QDataStream::LittleEndian);
+	str >> *attributes;
+
+	if (m->ranges.size()) {
+		QMutexLocker locker(&d_data->attributes_mutex);
+		m->cached_range = range[0];
+		m->cached_attributes = *attributes;
+	}
+	return ar;
+}
@@ -34,6 +34,8 @@
 
 #include "VipArchive.h"
 
+class VipNDArray;
+
 /// @brief Returns the global mutex used to protect all HDF5 library calls
 VIP_CORE_EXPORT std::recursive_mutex & vipH5Mutex();
 
@@ -62,6 +64,14 @@ using VipH5MutexLocker = std::scoped_lock<std::recursive_mutex>;
 /// VipH5Archive performs sequential reading in creation order. A VipH5Archive
 /// cannot be opened in both rad and write modes.
 /// 
+/// VipH5Archive also provides a movie layout used to store sequences of same-shape
+/// images. All frames of a movie are appended to a single extendable dataset
+/// '/_movies/name/frames' of shape (frame count, frame shape...), chunked along the time
+/// axis and optionally compressed with the shuffle and deflate filters. Frame times and
+/// attributes are stored in parallel 1D datasets, and one or several consecutive frames
+/// are read back with a single hyperslab selection.
+/// The '_movies' root group is reserved and is not visible through the VipArchive interface.
+/// 
 class VIP_CORE_EXPORT VipH5Archive : public VipArchive
 {
 	Q_OBJECT
@@ -99,6 +109,31 @@ public:
 	QIODevice* device() const;
 	void close();
 
+	/// @brief Set the deflate compression level (0 to 9) of movies created afterward.
+	/// 0 (default) disables compression, otherwise the shuffle filter is applied before deflate.
+	void setMovieCompression(int level);
+	int movieCompression() const;
+	/// @brief Set the number of frames per chunk of movies created afterward.
+	/// 0 (default) selects the largest chunk below 1MB, with at least one frame.
+	void setMovieChunkFrames(int frames);
+	int movieChunkFrames() const;
+
+	/// @brief Append a frame to movie \a name, creating the movie if needed (Write mode only).
+	/// Supported frame types are arithmetic types (except long double), complex_f, complex_d and VipRGB.
+	/// Returns false if the frame type is not supported or if its type or shape differs from the first movie frame.
+	bool appendMovieFrame(const QByteArray& name, const VipNDArray& frame, qint64 time, const QVariantMap& attributes = QVariantMap());
+	/// @brief Returns the names of all movies in the archive
+	QList<QByteArray> movies() const;
+	/// @brief Returns the number of frames of movie \a name
+	qint64 movieFrameCount(const QByteArray& name) const;
+	/// @brief Returns the frame times of movie \a name
+	QVector<qint64> movieTimes(const QByteArray& name) const;
+	/// @brief Read frame \a index of movie \a name, and optionally its attributes
+	VipNDArray readMovieFrame(const QByteArray& name, qint64 index, QVariantMap* attributes = nullptr) const;
+	/// @brief Read \a count consecutive frames of movie \a name starting at \a first.
+	/// The frames are returned as one array of shape (count, frame shape...).
+	VipNDArray readMovieFrames(const QByteArray& name, qint64 first, qint64 count) const;
+
 protected:
 	virtual void doStart(QString& name, QVariantMap& metadata, bool read_metadata);
 	virtual void doEnd();
@@ -35,6 +35,14 @@ extern "C" {
 #include <hdf5.h>
 }
 #include <qiodevice.h>
+#include <qfile.h>
+
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 #include "VipH5DeviceDriver.h"
 #include "VipLogging.h"
@@ -49,10 +57,96 @@ static hid_t H5FD_DEVICE_g = 0;
 typedef struct H5FD_device_t {
 	H5FD_t	pub;			/*public stuff, must be first	*/
 	QIODevice * device;
+	int	fd;			/*native file descriptor of local files, or -1*/
 	haddr_t	eoa;			/*end of allocated region	*/
 	haddr_t	eof;			/*end of file; current file size*/
 } H5FD_device_t;
 
+static std::atomic<bool> _native_file_access{ true };
+
+void vipH5SetNativeFileAccess(bool enable)
+{
+	_native_file_access.store(enable);
+}
+bool vipH5NativeFileAccess()
+{
+	return _native_file_access.load();
+}
+
+/* Returns the native file descriptor of a local QFile, or -1 */
+static int nativeDescriptor(QIODevice* device)
+{
+#ifdef Q_OS_UNIX
+	if (!vipH5NativeFileAccess())
+		return -1;
+	QFile* file = qobject_cast<QFile*>(device);
+	if (!file)
+		return -1;
+	// pending buffered writes must reach the file before using the descriptor
+	file->flush();
+	return file->handle();
+#else
+	Q_UNUSED(device);
+	return -1;
+#endif
+}
+
+/* Positional read/write on a native descriptor. They do not modify the file offset used by the QFile. */
+static bool nativeRead(int fd, haddr_t addr, size_t size, void* buf)
+{
+#ifdef Q_OS_UNIX
+	char* dst = (char*)buf;
+	while (size > 0) {
+		ssize_t nbytes = pread(fd, dst, size, (off_t)addr);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		if (nbytes == 0) {
+			// end of file: fill the remaining with zeros
+			memset(dst, 0, size);
+			break;
+		}
+		size -= (size_t)nbytes;
+		addr += (haddr_t)nbytes;
+		dst += nbytes;
+	}
+	return true;
+#else
+	Q_UNUSED(fd);
+	Q_UNUSED(addr);
+	Q_UNUSED(size);
+	Q_UNUSED(buf);
+	return false;
+#endif
+}
+
+static bool nativeWrite(int fd, haddr_t addr, size_t size, const void* buf)
+{
+#ifdef Q_OS_UNIX
+	const char* src = (const char*)buf;
+	while (size > 0) {
+		ssize_t nbytes = pwrite(fd, src, size, (off_t)addr);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		size -= (size_t)nbytes;
+		addr += (haddr_t)nbytes;
+		src += nbytes;
+	}
+	return true;
+#else
+	Q_UNUSED(fd);
+	Q_UNUSED(addr);
+	Q_UNUSED(size);
+	Q_UNUSED(buf);
+	return false;
+#endif
+}
+
 
 
 
@@ -275,6 +369,7 @@ H5FD_device_open(const char *name, unsigned /*flags*/, hid_t /*fapl_id*/, haddr_
 	}
 
 	file->device = dev;
+	file->fd = nativeDescriptor(dev);
 	file->eof = dev->size();
 	file->eoa = file->eof;
 	  /* Set return value */
@@ -350,6 +445,14 @@ H5FD_device_read(H5FD_t *_file, H5FD_mem_t  /*type*/, hid_t  /*dxpl_id*/,
 		return -1;
 	}
 
+	if (file->fd >= 0) {
+		if (!nativeRead(file->fd, addr, size, buf)) {
+			VIP_LOG_ERROR("unable to read data");
+			return -1;
+		}
+		return 0;
+	}
+
 	/* Seek to the correct location */
 	if (!file->device->seek(addr))
 	{
@@ -381,6 +484,15 @@ H5FD_device_write(H5FD_t *_file, H5FD_mem_t  /*type*/, hid_t  /*dxpl_id*/, haddr
 		return -1;
 	}
 
+	if (file->fd >= 0) {
+		if (!nativeWrite(file->fd, addr, size, buf)) {
+			VIP_LOG_ERROR("unable to write data");
+			return -1;
+		}
+		file->eof = qMax(file->eof, (haddr_t)(addr + size));
+		return 0;
+	}
+
 	/* Seek to the correct location */
 	if (!file->device->seek(addr))
 	{
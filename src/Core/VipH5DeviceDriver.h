@@ -37,4 +37,12 @@
 
 VIP_CORE_EXPORT qint64 vipH5OpenQIODevice(QIODevice * device);
 
+/// Enable/disable native file access for HDF5 files opened on a local QFile (enabled by default).
+/// When enabled, the HDF5 driver reads and writes local files with positional system calls on the file descriptor
+/// instead of virtual QIODevice seek/read/write calls, and VipH5Archive copies uncompressed movie frames directly
+/// from a memory mapping of the file without locking vipH5Mutex().
+/// This only affects files opened afterward.
+VIP_CORE_EXPORT void vipH5SetNativeFileAccess(bool enable);
+VIP_CORE_EXPORT bool vipH5NativeFileAccess();
+
 #endif
\ No newline at end of file
@@ -30,7 +30,9 @@
  */
 
 #include <QChildEvent>
+#include <QDataStream>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QGuiApplication>
@@ -40,6 +42,8 @@
 #include <QTimer>
 
 #include <cmath>
+#include <cstring>
+#include <memory>
 #include <unordered_set>
 
 #include "VipCore.h"
@@ -50,6 +54,7 @@
 #include "VipSet.h"
 #include "VipSleep.h"
 #include "VipTextOutput.h"
+#include "VipTextParser.h"
 #include "VipHash.h"
 
 // class ReadThread : public QThread
@@ -628,6 +633,18 @@ bool VipIODevice::readInvalidTime(qint64)
 	return false;
 }
 
+qint64 VipIODevice::closestReadTime(qint64 time) const
+{
+	return computeClosestTime(invTransformTime(time));
+}
+
+void VipIODevice::cancelPrefetch()
+{
+	if (VipProcessingPool* pool = parentObjectPool())
+		if (VipPrefetchCache* cache = pool->prefetchCache())
+			cache->clear(this);
+}
+
 bool VipIODevice::read(qint64 time, bool force)
 {
 	if (!isOpen() || !isEnabled())
@@ -689,9 +706,27 @@ bool VipIODevice::read(qint64 time, bool force)
 		d_data->lastReadTime = current_time;
 		Q_EMIT timeChanged(time_transform);
 
+		// use the prefetched data if available
+		VipPrefetchCache* cache = nullptr;
+		if (supportPrefetch())
+			if (VipProcessingPool* pool = parentObjectPool())
+				if (pool->isPlaying())
+					cache = pool->prefetchCache();
+		if (cache) {
+			VipAnyDataList lst;
+			if (cache->take(this, time, lst)) {
+				for (int i = 0; i < lst.size() && i < outputCount(); ++i)
+					outputAt(i)->setData(create(lst[i].data(), lst[i].attributes()));
+				d_data->elapsed_time = vipGetMilliSecondsSinceEpoch() - current_time;
+				return true;
+			}
+		}
+
 		// read the data
 		bool res = readData(time);
 		d_data->elapsed_time = vipGetMilliSecondsSinceEpoch() - current_time;
+		if (cache)
+			cache->addStallTime(d_data->elapsed_time);
 		return res;
 	}
 
@@ -1065,6 +1100,16 @@ public:
 	int maxReadThreadCount;
 	int readMaxFPS;
 	double min_ms;
+
+	// frame buffer pool, created on first enabling and never deleted before the VipProcessingPool
+	std::unique_ptr<VipFrameBufferPool> framePool;
+	std::atomic<bool> framePoolEnabled{ false };
+	qint64 framePoolMaxMemory{ 256000000 };
+
+	// read-ahead cache used while playing, threads are only started on first use
+	std::unique_ptr<VipPrefetchCache> prefetch{ new VipPrefetchCache() };
+	std::atomic<bool> prefetchEnabled{ true };
+	std::atomic<int> prefetchFrameCount{ 8 };
 };
 
 // we need VipProcessingPool::PrivateData to be definied to implement VipIODevice::setEnabled
@@ -1109,6 +1154,8 @@ void VipIODevice::setOutputDataTime(VipAnyData& data)
 void VipIODevice::setOpenMode(VipIODevice::OpenModes mode)
 {
 	if (mode != d_data->mode) {
+		if (mode == NotOpen)
+			cancelPrefetch();
 		if ((mode & ReadOnly) && d_data->mode == NotOpen) {
 			// we open a read-only device that was previously closed: reset the read time
 			d_data->readTime = VipInvalidTime;
@@ -1231,6 +1278,9 @@ VipProcessingPool::VipProcessingPool(QObject* parent)
 	d_data->streamingTimer.setInterval(100);
 	connect(&d_data->streamingTimer, SIGNAL(timeout()), this, SLOT(checkForStreaming()), Qt::DirectConnection);
 
+	// recycle the output frames of the pool processings
+	setFrameBufferPoolEnabled(true);
+
 	// set a unique name to this pool
 	setObjectName(generatePoolObjectName());
 	QMutexLocker lock(&getPoolsMutex());
@@ -1602,6 +1652,129 @@ void VipProcessingPool::setMaxReadThreadCount(int count)
 	d_data->maxReadThreadCount = count;
 }
 
+void VipProcessingPool::setFrameBufferPoolEnabled(bool enable)
+{
+	QMutexLocker lock(&d_data->device_mutex);
+	if (enable && !d_data->framePool)
+		d_data->framePool.reset(new VipFrameBufferPool(d_data->framePoolMaxMemory));
+	if (d_data->framePool)
+		d_data->framePool->setEnabled(enable);
+	d_data->framePoolEnabled.store(enable);
+}
+bool VipProcessingPool::isFrameBufferPoolEnabled() const
+{
+	return d_data->framePoolEnabled.load(std::memory_order_relaxed);
+}
+void VipProcessingPool::setFrameBufferPoolMaxMemory(qint64 bytes)
+{
+	QMutexLocker lock(&d_data->device_mutex);
+	d_data->framePoolMaxMemory = bytes;
+	if (d_data->framePool)
+		d_data->framePool->setMaxCachedBytes(bytes);
+}
+qint64 VipProcessingPool::frameBufferPoolMaxMemory() const
+{
+	return d_data->framePoolMaxMemory;
+}
+VipFrameBufferPool* VipProcessingPool::frameBufferPool() const
+{
+	if (d_data->framePoolEnabled.load(std::memory_order_relaxed))
+		return d_data->framePool.get();
+	return nullptr;
+}
+
+void VipProcessingPool::setPrefetchEnabled(bool enable)
+{
+	d_data->prefetchEnabled.store(enable);
+	if (!enable)
+		d_data->prefetch->clear();
+}
+bool VipProcessingPool::isPrefetchEnabled() const
+{
+	return d_data->prefetchEnabled.load(std::memory_order_relaxed);
+}
+void VipProcessingPool::setPrefetchMaxMemory(qint64 bytes)
+{
+	d_data->prefetch->setMaxMemory(bytes);
+}
+qint64 VipProcessingPool::prefetchMaxMemory() const
+{
+	return d_data->prefetch->maxMemory();
+}
+void VipProcessingPool::setPrefetchFrameCount(int count)
+{
+	d_data->prefetchFrameCount.store(qMax(count, 0));
+}
+int VipProcessingPool::prefetchFrameCount() const
+{
+	return d_data->prefetchFrameCount.load(std::memory_order_relaxed);
+}
+void VipProcessingPool::setPrefetchThreadCount(int count)
+{
+	d_data->prefetch->setThreadCount(count);
+}
+int VipProcessingPool::prefetchThreadCount() const
+{
+	return d_data->prefetch->threadCount();
+}
+VipPrefetchCache* VipProcessingPool::prefetchCache() const
+{
+	if (d_data->prefetchEnabled.load(std::memory_order_relaxed))
+		return d_data->prefetch.get();
+	return nullptr;
+}
+
+void VipProcessingPool::schedulePrefetch()
+{
+	VipPrefetchCache* cache = prefetchCache();
+	const int count = prefetchFrameCount();
+	if (!cache || count == 0)
+		return;
+
+	QVector<VipIODevice*> devices;
+	{
+		QMutexLocker lock(&d_data->device_mutex);
+		for (VipIODevice* dev : d_data->read_devices)
+			if (dev && dev->isOpen() && dev->isEnabled() && dev->deviceType() == Temporal && dev->supportPrefetch())
+				devices.push_back(dev);
+	}
+	if (devices.isEmpty())
+		return;
+
+	// predict the next pool times in the playing direction
+	const bool backward = d_data->parameters.mode & Backward;
+	int stride = 1;
+	if ((d_data->parameters.mode & UsePlaySpeed) && d_data->parameters.enableMissFrames && d_data->parameters.speed > 1)
+		stride = qRound(d_data->parameters.speed);
+
+	QVector<qint64> times;
+	qint64 t = time();
+	for (int i = 0; i < count; ++i) {
+		for (int s = 0; s < stride; ++s) {
+			qint64 next = backward ? previousTime(t) : nextTime(t);
+			if (next == VipInvalidTime || next == t) {
+				t = VipInvalidTime;
+				break;
+			}
+			t = next;
+		}
+		if (t == VipInvalidTime)
+			break;
+		times.push_back(t);
+	}
+
+	for (VipIODevice* dev : devices) {
+		QVector<qint64> dev_times;
+		dev_times.reserve(times.size());
+		for (qint64 pool_time : times) {
+			qint64 dev_time = dev->closestReadTime(pool_time);
+			if (dev_time != VipInvalidTime && (dev_times.isEmpty() || dev_times.last() != dev_time))
+				dev_times.push_back(dev_time);
+		}
+		cache->prefetch(dev, dev_times);
+	}
+}
+
 QList<VipProcessingObject*> VipProcessingPool::leafs(bool children_only) const
 {
 	QMutexLocker lock(&d_data->device_mutex);
@@ -2453,6 +2626,11 @@ void VipProcessingPool::runPlay()
 
 	Q_EMIT playingStarted();
 
+	if (VipPrefetchCache* cache = prefetchCache())
+		cache->resetStatistics();
+	if (VipFrameBufferPool* frame_pool = frameBufferPool())
+		frame_pool->resetStatistics();
+
 	qint64 elapsed = 0;
 	//qint64 prev_elapsed = 0;
 	qint64 st = 0, el = 0;
@@ -2601,6 +2779,24 @@ void VipProcessingPool::runPlay()
 				}
 			}
 
+			// read ahead the next frames
+			schedulePrefetch();
+			if (VipPrefetchCache* cache = prefetchCache()) {
+				const VipPrefetchCache::Statistics stats = cache->statistics();
+				if (stats.hits + stats.misses) {
+					setAttribute("Prefetch hit rate", stats.hitRate());
+					setAttribute("Prefetch stall time", QString::number(stats.stallTime) + " ms");
+				}
+			}
+			if (VipFrameBufferPool* frame_pool = frameBufferPool()) {
+				const VipFrameBufferPool::Statistics stats = frame_pool->statistics();
+				if (stats.hits + stats.misses) {
+					setAttribute("Frame buffer pool hit rate", stats.hitRate());
+					setAttribute("Frame buffer pool hits", stats.hits);
+					setAttribute("Frame buffer pool misses", stats.misses);
+				}
+			}
+
 			// check if we still have valid temporal devices, stop otherwise
 			bool has_temporal_device = false;
 			{
@@ -2628,6 +2824,9 @@ void VipProcessingPool::runPlay()
 		}
 	}
 
+	// discard the prefetched frames, they would not be used by the next read
+	d_data->prefetch->clear();
+
 	// call the callback functions
 	for (QMap<int, callback_function>::iterator it = d_data->playCallbacks.begin(); it != d_data->playCallbacks.end(); ++it)
 		it.value()(StopPlaying);
@@ -3008,6 +3207,18 @@ bool VipTextFileReader::reload()
 	return VipIODevice::reload();
 }
 
+static void readTextArrays(QTextStream& stream, QList<VipNDArray>& arrays)
+{
+	while (true) {
+		VipNDArray ar;
+		stream >> ar;
+		if (!ar.isEmpty())
+			arrays.append(ar);
+		else
+			break;
+	}
+}
+
 bool VipTextFileReader::open(VipIODevice::OpenModes mode)
 {
 	if (mode != VipIODevice::ReadOnly)
@@ -3035,16 +3246,26 @@ bool VipTextFileReader::open(VipIODevice::OpenModes mode)
 	if (!createDevice(p, QFile::ReadOnly | QFile::Text))
 		return false;
 
-	// read all arrays it contains;
+	// read all arrays it contains.
+	// Numeric arrays are parsed in parallel from the mapped file, other formats (complex, RGB...) with QTextStream.
 	m_arrays.clear();
-	QTextStream stream(device());
-	while (true) {
-		VipNDArray ar;
-		stream >> ar;
-		if (!ar.isEmpty())
+	VipMappedFile mapped;
+	QFile* file = qobject_cast<QFile*>(device());
+	if (file && mapped.open(file->fileName())) {
+		const char* const end = mapped.data() + mapped.size();
+		const char* stop = end;
+		const QVector<VipNDArray> arrays = vipParseNumericArrays(mapped.data(), end, &stop);
+		for (const VipNDArray& ar : arrays)
 			m_arrays.append(ar);
-		else
-			break;
+
+		if (stop != end) {
+			QTextStream stream(QByteArray::fromRawData(stop, end - stop));
+			readTextArrays(stream, m_arrays);
+		}
+	}
+	else {
+		QTextStream stream(device());
+		readTextArrays(stream, m_arrays);
 	}
 
 	this->setTimeWindows(0, m_arrays.size(), m_samplingTime);
@@ -3514,6 +3735,20 @@ VipCSVReader::VipCSVReader(QObject* parent)
 }
 VipCSVReader::~VipCSVReader() {}
 
+/// Read a text line from [pos, end) and move pos to the next line
+static QString readTextLine(const char*& pos, const char* end)
+{
+	if (pos == end)
+		return QString();
+	const char* eol = static_cast<const char*>(memchr(pos, '\n', end - pos));
+	if (!eol)
+		eol = end;
+	const char* last = (eol != pos && eol[-1] == '\r') ? eol - 1 : eol;
+	const QString res = QTextStream(QByteArray::fromRawData(pos, last - pos)).readAll();
+	pos = eol == end ? end : eol + 1;
+	return res;
+}
+
 static QStringList extractTitleAndUnit(const QString& value)
 {
 	if (!value.endsWith(")"))
@@ -3545,19 +3780,15 @@ bool VipCSVReader::open(VipIODevice::OpenModes mode)
 	if (mode & VipIODevice::ReadOnly) {
 		m_signals.clear();
 
-		QFile in(removePrefix(path()));
-		if (!in.open(QFile::ReadOnly | QFile::Text))
+		VipMappedFile in(removePrefix(path()));
+		if (!in.isOpen())
 			return false;
 
-		QByteArray data = in.readAll();
-
-		QTextStream stream(data);
-
-		qint64 pos = stream.pos();
-		QLocale locale = QLocale(QLocale::French);
+		const char* const end = in.data() + in.size();
+		const char* data = in.data();
 
 		// read the separator line
-		QString first = stream.readLine();
+		QString first = readTextLine(data, end);
 		QString tmp = first;
 
 		// try to read a number from it
@@ -3573,35 +3804,16 @@ bool VipCSVReader::open(VipIODevice::OpenModes mode)
 			else
 				tmp.replace(" ", "");
 
-			QString float_sep = ",";
-
 			// check separator
 			if (tmp.startsWith("sep=")) {
 				separator = tmp.mid(4);
-				first = stream.readLine();
+				first = readTextLine(data, end);
 			}
 			else if (tmp.contains(";")) {
 				// Excel CSV format using ';' separator, without a header "sep=..."
 				separator = ";";
 			}
 
-			if (separator == ",")
-				float_sep = ".";
-			else {
-				int comma_count = data.count(',');
-				int point_count = data.count('.');
-				if (point_count > comma_count)
-					float_sep = ".";
-				else
-					float_sep = ",";
-			}
-
-			// QLocale locale;
-			if (float_sep == ".")
-				locale = QLocale(QLocale::French);
-			else
-				locale = QLocale(QLocale::German);
-
 			// read the first line
 			lst = first.split(separator);
 			if (lst.size() < 2) {
@@ -3635,33 +3847,13 @@ bool VipCSVReader::open(VipIODevice::OpenModes mode)
 			}
 			for (int i = 0; i < count; ++i)
 				lst.append(QString());
-			stream.seek(pos);
+			data = in.data();
 		}
 
-		// read other lines
-		QVector<VipPointVector> vectors(lst.size() - 1);
-		while (true) {
-			QString line = stream.readLine();
-			line.replace(separator, " ");
-			QTextStream str(line.toLatin1());
-			str.setLocale(locale);
-
-			vip_double x = 0;
-			str >> x;
-			if (str.status() != QTextStream::Ok)
-				break;
-
-			for (int i = 0; i < vectors.size(); ++i) {
-				vip_double y;
-				str >> y;
-				if (str.status() == QTextStream::Ok)
-					vectors[i].append(VipPoint(x, y));
-				else
-					break;
-			}
-			if (str.status() != QTextStream::Ok)
-				break;
-		}
+		// read other lines.
+		// ',' is used as decimal separator unless it is the column separator.
+		const QByteArray sep = separator.toLatin1();
+		const QVector<VipPointVector> vectors = vipParseXYColumns(data, end, lst.size(), sep.isEmpty() ? '\t' : sep[0]);
 
 		for (int i = 0; i < vectors.size(); ++i) {
 			VipAnyData any(QVariant::fromValue(vectors[i]), 0);
@@ -3819,6 +4011,21 @@ void VipCSVWriter::apply()
 	}
 }
 
+/// Resize an image read by a VipDirectoryReader to the fixed output size.
+/// The destination frame is taken from the parent VipProcessingPool frame buffer pool, if any.
+static VipNDArray resizeFrame(const VipProcessingObject* obj, const VipNDArray& ar, const QSize& size, bool smooth)
+{
+	const VipNDArrayShape sh = vipVector(size.height(), size.width());
+	const Vip::InterpolationType type = smooth ? Vip::CubicInterpolation : Vip::NoInterpolation;
+	if (ar.shape() == sh)
+		return ar;
+
+	VipNDArray res = obj->createFrame(ar.dataType(), sh);
+	if (ar.resize(res, type))
+		return res;
+	return VipNDArray();
+}
+
 class VipDirectoryReader::PrivateData
 {
 public:
@@ -3833,6 +4040,12 @@ public:
 	Type type;
 	bool recursive;
 	DeviceType deviceType;
+	bool resourceSequence{ false }; // SequenceOfData with Resource devices only
+	bool decodeAhead{ false };
+	bool lazy{ false };		  // decode-ahead mode is active: files are decoded on demand
+	VipTimeRange lazyRange;		  // time limits of the first file in decode-ahead mode
+	qint64 lazySampling{ VipInvalidTime }; // sampling time of the first file in decode-ahead mode
+	QStringList lazyFiles;		       // files decoded in decode-ahead mode, not modified while open
 
 	// files
 	QStringList files;
@@ -3840,6 +4053,7 @@ public:
 	bool dirtyFiles;
 
 	QMap<QString, QSharedPointer<VipIODevice>> suffix_templates;
+	QMap<QString, VipProcessingObject::Info> suffix_devices; // read device of each suffix without template, resolved in open()
 
 	// devices
 	QList<QSharedPointer<VipIODevice>> devices;
@@ -3919,6 +4133,11 @@ void VipDirectoryReader::setType(Type t)
 	d_data->type = t;
 }
 
+void VipDirectoryReader::setDecodeAhead(bool enable)
+{
+	d_data->decodeAhead = enable;
+}
+
 void VipDirectoryReader::setRecursive(bool r)
 {
 	d_data->recursive = r;
@@ -3953,6 +4172,10 @@ VipDirectoryReader::Type VipDirectoryReader::type() const
 {
 	return d_data->type;
 }
+bool VipDirectoryReader::decodeAhead() const
+{
+	return d_data->decodeAhead;
+}
 bool VipDirectoryReader::recursive() const
 {
 	return d_data->recursive;
@@ -4106,6 +4329,13 @@ VipDirectoryReader::DeviceType VipDirectoryReader::deviceType() const
 
 void VipDirectoryReader::close()
 {
+	// make sure no background read uses the devices
+	cancelPrefetch();
+	d_data->resourceSequence = false;
+	d_data->lazy = false;
+	d_data->lazyFiles.clear();
+	d_data->suffix_devices.clear();
+
 	for (int i = 0; i < d_data->devices.size(); ++i) {
 		d_data->devices[i]->close();
 	}
@@ -4118,6 +4348,23 @@ void VipDirectoryReader::close()
 
 void VipDirectoryReader::recomputeTimestamps()
 {
+	if (d_data->lazy) {
+		// decode-ahead mode: one timestamp per file, based on the first one
+		d_data->deviceType = Temporal;
+		d_data->sampling = d_data->lazySampling != VipInvalidTime ? d_data->lazySampling : 1000000;
+		d_data->timestamps.clear();
+		if (d_data->lazyRange.first != VipInvalidTime && d_data->lazyRange.second != VipInvalidTime)
+			d_data->timestamps.append(d_data->lazyRange);
+		else
+			d_data->timestamps.append(VipTimeRange(0, 0));
+		for (int i = 1; i < d_data->lazyFiles.size(); ++i) {
+			const qint64 t = d_data->timestamps.last().second + d_data->sampling;
+			d_data->timestamps.append(VipTimeRange(t, t));
+		}
+		emitTimestampingChanged();
+		return;
+	}
+
 	d_data->sampling = VipInvalidTime;
 
 	for (int i = 0; i < d_data->devices.size(); ++i) {
@@ -4175,6 +4422,82 @@ void VipDirectoryReader::recomputeTimestamps()
 	emitTimestampingChanged();
 }
 
+VipIODevice* VipDirectoryReader::createFileDevice(const QString& file) const
+{
+	// this function might be called from prefetch threads in decode-ahead mode
+	const QString suffix = QFileInfo(file).suffix().toLower();
+	bool have_template = false;
+	QSharedPointer<VipIODevice> template_device;
+	QMap<QString, QSharedPointer<VipIODevice>>::const_iterator it = d_data->suffix_templates.constFind(suffix);
+	if (it != d_data->suffix_templates.constEnd()) {
+		have_template = true;
+		template_device = it.value();
+	}
+	VipIODevice* device = nullptr;
+
+	// create the device
+	if (have_template) {
+		if (!template_device)
+			return nullptr;
+		device = vipCreateVariant((QByteArray(template_device->metaObject()->className()) + "*").data()).value<VipIODevice*>();
+	}
+	else {
+		// use the device resolved in open() for this suffix
+		QMap<QString, VipProcessingObject::Info>::const_iterator found = d_data->suffix_devices.constFind(suffix);
+		if (found != d_data->suffix_devices.constEnd() && found.value().metatype)
+			device = qobject_cast<VipIODevice*>(found.value().create());
+	}
+
+	if (!device)
+		return nullptr;
+
+	device->setMapFileSystem(this->mapFileSystem());
+
+	if (VipMultiOutput* out = device->topLevelOutputAt(0)->toMultiOutput())
+		out->resize(1);
+
+	// copy the parameters from the template device
+	if (template_device)
+		template_device->copyParameters(device);
+
+	device->setPath(file);
+	if (!device->open(VipIODevice::ReadOnly)) {
+		delete device;
+		return nullptr;
+	}
+	return device;
+}
+
+VipAnyDataList VipDirectoryReader::decodeFile(int index) const
+{
+	VipAnyDataList res;
+	QElapsedTimer timer;
+	timer.start();
+
+	// single data files are decoded when opening
+	std::unique_ptr<VipIODevice> dev(createFileDevice(d_data->lazyFiles[index]));
+	if (!dev)
+		return res;
+
+	for (int o = 0; o < outputCount() && o < dev->outputCount(); ++o) {
+		VipAnyData out = dev->outputAt(o)->data();
+
+		// for image only
+		VipNDArray ar = out.data().value<VipNDArray>();
+		if (!ar.isEmpty() && d_data->fixed_size != QSize()) {
+			ar = resizeFrame(this, ar, d_data->fixed_size, d_data->smooth_resize);
+			out.setData(QVariant::fromValue(ar));
+		}
+		res.append(out);
+	}
+	dev->close();
+
+	const QString decode_time = QString::number(timer.nsecsElapsed() * 1e-6, 'f', 2) + " ms";
+	for (VipAnyData& out : res)
+		out.setAttribute("Decode time", decode_time);
+	return res;
+}
+
 bool VipDirectoryReader::open(VipIODevice::OpenModes mode)
 {
 	close();
@@ -4187,6 +4510,43 @@ bool VipDirectoryReader::open(VipIODevice::OpenModes mode)
 		return false;
 	}
 
+	// resolve the read device once per suffix, instead of probing all devices for each file
+	for (const QString& file : d_data->files) {
+		const QString suffix = QFileInfo(file).suffix().toLower();
+		if (d_data->suffix_templates.contains(suffix) || d_data->suffix_devices.contains(suffix))
+			continue;
+		const QList<VipIODevice::Info> devices = VipIODevice::possibleReadDevices(file, QByteArray());
+		d_data->suffix_devices.insert(suffix, devices.size() ? devices.first() : VipIODevice::Info());
+	}
+
+	if (d_data->decodeAhead && d_data->type == SequenceOfData) {
+		// decode-ahead mode: only open the first valid file to create the outputs, other files are decoded on demand
+		for (int i = 0; i < d_data->files.size(); ++i) {
+			std::unique_ptr<VipIODevice> device(createFileDevice(d_data->files[i]));
+			if (!device)
+				continue;
+			if (device->deviceType() != Resource)
+				break; // not a sequence of single data files: open all files
+
+			d_data->lazy = true;
+			d_data->lazyFiles = d_data->files;
+			d_data->lazyRange = device->timeLimits();
+			d_data->lazySampling = device->estimateSamplingTime();
+
+			this->blockSignals(true);
+			recomputeTimestamps();
+			this->blockSignals(false);
+
+			this->topLevelOutputAt(0)->toMultiOutput()->resize(device->outputCount());
+			for (int o = 0; o < device->outputCount(); ++o)
+				this->outputAt(o)->setData(device->outputAt(o)->data());
+			device->close();
+
+			setOpenMode(ReadOnly);
+			return true;
+		}
+	}
+
 	// create the devices for each file, estimate the minimal sampling time
 
 	VipProgress progress;
@@ -4204,45 +4564,10 @@ bool VipDirectoryReader::open(VipIODevice::OpenModes mode)
 		progress.setValue(i);
 		progress.setText("<b>Read</b> " + QFileInfo(d_data->files[i]).fileName() );
 
-		bool have_template = false;
-		QSharedPointer<VipIODevice> template_device;
-		QMap<QString, QSharedPointer<VipIODevice>>::iterator it = d_data->suffix_templates.find(QFileInfo(d_data->files[i]).suffix().toLower());
-		if (it != d_data->suffix_templates.end()) {
-			have_template = true;
-			template_device = it.value();
-		}
-		VipIODevice* device = nullptr;
-
-		// create the device
-		if (have_template) {
-			if (!template_device)
-				continue;
-			device = vipCreateVariant((QByteArray(template_device->metaObject()->className()) + "*").data()).value<VipIODevice*>();
-		}
-		else {
-			QList<VipIODevice::Info> devices = VipIODevice::possibleReadDevices(d_data->files[i], QByteArray());
-			if (devices.size())
-				device = qobject_cast<VipIODevice*>(devices.first().create());
-		}
-
-		if (!device)
-			continue;
-
-		device->setMapFileSystem(this->mapFileSystem());
-
-		if (VipMultiOutput* out = device->topLevelOutputAt(0)->toMultiOutput())
-			out->resize(1);
-
-		// copy the parameters from the template device
-		if (template_device)
-			template_device->copyParameters(device);
-
 		vip_debug("%s\n", d_data->files[i].toLatin1().data());
-		device->setPath(d_data->files[i]);
-		if (!device->open(VipIODevice::ReadOnly)) {
-			delete device;
+		VipIODevice* device = createFileDevice(d_data->files[i]);
+		if (!device)
 			continue;
-		}
 
 		max_output_per_device = qMax(max_output_per_device, device->outputCount());
 
@@ -4264,6 +4589,13 @@ bool VipDirectoryReader::open(VipIODevice::OpenModes mode)
 
 	// create the ouputs and set their data
 	if (d_data->type == SequenceOfData) {
+		d_data->resourceSequence = d_data->devices.size() > 0;
+		for (int i = 0; i < d_data->devices.size(); ++i)
+			if (d_data->devices[i]->deviceType() != Resource) {
+				d_data->resourceSequence = false;
+				break;
+			}
+
 		this->topLevelOutputAt(0)->toMultiOutput()->resize(max_output_per_device);
 		// for each output, try to set a valid data
 		for (int o = 0; o < max_output_per_device; ++o) {
@@ -4369,6 +4701,15 @@ qint64 VipDirectoryReader::computeNextTime(qint64 intime) const
 
 		return time;
 	}
+	else if (d_data->lazy) {
+		// one timestamp per file
+		int index = closestDeviceIndex(intime);
+		if (index < 0)
+			return VipInvalidTime;
+		if (d_data->timestamps[index].first > intime)
+			return d_data->timestamps[index].first;
+		return index + 1 < d_data->timestamps.size() ? d_data->timestamps[index + 1].first : d_data->timestamps.last().second;
+	}
 	else {
 		qint64 res = VipInvalidTime;
 		qint64 time = (intime);
@@ -4420,6 +4761,15 @@ qint64 VipDirectoryReader::computePreviousTime(qint64 intime) const
 
 		return time;
 	}
+	else if (d_data->lazy) {
+		// one timestamp per file
+		int index = closestDeviceIndex(intime);
+		if (index < 0)
+			return VipInvalidTime;
+		if (d_data->timestamps[index].second < intime)
+			return d_data->timestamps[index].second;
+		return index > 0 ? d_data->timestamps[index - 1].second : d_data->timestamps.first().first;
+	}
 	else {
 		qint64 res = VipInvalidTime;
 		qint64 time = (intime);
@@ -4477,6 +4827,13 @@ qint64 VipDirectoryReader::computeClosestTime(qint64 _time) const
 		else
 			return (time);
 	}
+	else if (d_data->lazy) {
+		qint64 closest = VipInvalidTime;
+		int index = closestDeviceIndex(_time, &closest);
+		if (index < 0)
+			return VipInvalidTime;
+		return closest != VipInvalidTime ? closest : d_data->timestamps[index].first;
+	}
 	else {
 		int index = closestDeviceIndex(_time);
 		if (index < 0)
@@ -4510,8 +4867,7 @@ bool VipDirectoryReader::reload()
 						// for image only
 						VipNDArray ar = out.data().value<VipNDArray>();
 						if (!ar.isEmpty() && d_data->fixed_size != QSize()) {
-							ar = ar.resize(vipVector(d_data->fixed_size.height(), d_data->fixed_size.width()),
-								       d_data->smooth_resize ? Vip::CubicInterpolation : Vip::NoInterpolation);
+							ar = resizeFrame(this, ar, d_data->fixed_size, d_data->smooth_resize);
 							out.setData(QVariant::fromValue(ar));
 						}
 
@@ -4532,6 +4888,36 @@ bool VipDirectoryReader::reload()
 	// return false;
 }
 
+bool VipDirectoryReader::supportPrefetch() const
+{
+	return d_data->type == SequenceOfData && (d_data->resourceSequence || d_data->lazy);
+}
+
+VipAnyDataList VipDirectoryReader::fetchData(qint64 time)
+{
+	// Resource devices are not modified after opening, so their output data can be accessed from any thread
+	VipAnyDataList res;
+	int index = closestDeviceIndex(time);
+	if (index < 0 || !supportPrefetch())
+		return res;
+	if (d_data->lazy)
+		return decodeFile(index);
+
+	VipIODevice* dev = d_data->devices[index].data();
+	for (int o = 0; o < outputCount() && o < dev->outputCount(); ++o) {
+		VipAnyData out = dev->outputAt(o)->data();
+
+		// for image only
+		VipNDArray ar = out.data().value<VipNDArray>();
+		if (!ar.isEmpty() && d_data->fixed_size != QSize()) {
+			ar = resizeFrame(this, ar, d_data->fixed_size, d_data->smooth_resize);
+			out.setData(QVariant::fromValue(ar));
+		}
+		res.append(out);
+	}
+	return res;
+}
+
 bool VipDirectoryReader::readData(qint64 time)
 {
 	if (d_data->type == IndependentData) {
@@ -4552,8 +4938,7 @@ bool VipDirectoryReader::readData(qint64 time)
 						// for image only
 						VipNDArray ar = out.data().value<VipNDArray>();
 						if (!ar.isEmpty() && d_data->fixed_size != QSize()) {
-							ar = ar.resize(vipVector(d_data->fixed_size.height(), d_data->fixed_size.width()),
-								       d_data->smooth_resize ? Vip::CubicInterpolation : Vip::NoInterpolation);
+							ar = resizeFrame(this, ar, d_data->fixed_size, d_data->smooth_resize);
 							out.setData(QVariant::fromValue(ar));
 						}
 
@@ -4583,6 +4968,18 @@ bool VipDirectoryReader::readData(qint64 time)
 		if (index < 0)
 			return false;
 
+		if (d_data->lazy) {
+			const VipAnyDataList lst = decodeFile(index);
+			for (int o = 0; o < lst.size(); ++o) {
+				VipAnyData out = lst[o];
+				out.mergeAttributes(attributes());
+				out.setSource((qint64)this);
+				out.setTime(time);
+				outputAt(o)->setData(out);
+			}
+			return lst.size() > 0;
+		}
+
 		qint64 time_offset_before = 0;
 		bool use_sampling = (d_data->timestamps[index].first != d_data->devices[index]->firstTime());
 
@@ -4600,7 +4997,7 @@ bool VipDirectoryReader::readData(qint64 time)
 			// for image only
 			VipNDArray ar = out.data().value<VipNDArray>();
 			if (!ar.isEmpty() && d_data->fixed_size != QSize()) {
-				ar = ar.resize(vipVector(d_data->fixed_size.height(), d_data->fixed_size.width()), d_data->smooth_resize ? Vip::CubicInterpolation : Vip::NoInterpolation);
+				ar = resizeFrame(this, ar, d_data->fixed_size, d_data->smooth_resize);
 				out.setData(QVariant::fromValue(ar));
 			}
 
@@ -4857,6 +5254,87 @@ static int _registerArchiveStreamOperators =
 #include "VipH5Archive.h"
 #endif
 
+struct ArchFrame
+{
+	qint64 stream;
+	qint64 time;
+	QByteArray name;
+	// frame index within the movie 'name' for frames stored in the movie layout, -1 otherwise
+	qint64 movieFrame = -1;
+};
+
+// Frame index sidecar file (archive path + ".idx") storing, in file order, the (stream, time, group name)
+// of each record of a .arch file. It is written by VipArchiveRecorder when closing the archive,
+// and by VipArchiveReader after scanning a legacy archive (unless disabled with VipArchiveReader::setWriteFrameIndex(false)).
+// The archive size and modification time are stored in the header to detect a stale index.
+
+#define ARCH_INDEX_MAGIC 0x56494458 // 'VIDX'
+#define ARCH_INDEX_VERSION 1
+
+static QString archiveIndexFile(const QString& archive)
+{
+	return archive + ".idx";
+}
+
+static bool writeArchiveIndex(const QString& archive, const QVector<ArchFrame>& frames)
+{
+	QFileInfo info(archive);
+	if (!info.exists())
+		return false;
+
+	QFile file(archiveIndexFile(archive));
+	if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+		VIP_LOG_WARNING("Cannot write archive frame index '" + file.fileName() + "': " + file.errorString());
+		return false;
+	}
+
+	QDataStream str(&file);
+	str.setVersion(QDataStream::Qt_5_0);
+	str << (quint32)ARCH_INDEX_MAGIC << (quint32)ARCH_INDEX_VERSION;
+	str << (qint64)info.size() << (qint64)info.lastModified().toMSecsSinceEpoch() << (qint64)frames.size();
+	for (const ArchFrame& f : frames)
+		str << f.stream << f.time << f.name;
+	if (str.status() != QDataStream::Ok) {
+		VIP_LOG_WARNING("Cannot write archive frame index '" + file.fileName() + "': " + file.errorString());
+		file.close();
+		file.remove();
+		return false;
+	}
+	return true;
+}
+
+static bool readArchiveIndex(const QString& archive, QVector<ArchFrame>& frames)
+{
+	frames.clear();
+	QFileInfo info(archive);
+	QFile file(archiveIndexFile(archive));
+	if (!info.exists() || !file.open(QFile::ReadOnly))
+		return false;
+
+	QDataStream str(&file);
+	str.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0, version = 0;
+	qint64 size = 0, modified = 0, count = 0;
+	str >> magic >> version >> size >> modified >> count;
+	if (str.status() != QDataStream::Ok || magic != ARCH_INDEX_MAGIC || version != ARCH_INDEX_VERSION)
+		return false;
+	// stale index
+	if (size != info.size() || modified != info.lastModified().toMSecsSinceEpoch())
+		return false;
+	// each record uses at least 20 bytes
+	if (count < 0 || count > (file.size() / 20))
+		return false;
+
+	frames.resize(count);
+	for (ArchFrame& f : frames)
+		str >> f.stream >> f.time >> f.name;
+	if (str.status() != QDataStream::Ok) {
+		frames.clear();
+		return false;
+	}
+	return true;
+}
+
 class VipArchiveRecorder::PrivateData
 {
 public:
@@ -4867,6 +5345,19 @@ public:
 #endif
 	Trailer trailer;
 	QMap<qint64, qint64> previousTimes;
+	// frame index written next to the archive on close
+	QVector<ArchFrame> index;
+	QString filename;
+	bool movieMode{ false };
+
+	// Must be called once the archive file is closed, as its size and modification time are stored in the index
+	void writeIndex()
+	{
+		if (!filename.isEmpty())
+			writeArchiveIndex(filename, index);
+		index.clear();
+		filename.clear();
+	}
 };
 
 VipArchiveRecorder::VipArchiveRecorder(QObject* parent)
@@ -4889,6 +5380,9 @@ bool VipArchiveRecorder::open(VipIODevice::OpenModes mode)
 		d_data->archive.content("Streams", d_data->trailer);
 	}
 	d_data->archive.close();
+	if (device())
+		device()->close();
+	d_data->writeIndex();
 	d_data->trailer = ArchiveRecorderTrailer();
 	d_data->previousTimes.clear();
 	setOpenMode(NotOpen);
@@ -4898,6 +5392,11 @@ bool VipArchiveRecorder::open(VipIODevice::OpenModes mode)
 		if (!createDevice(removePrefix(path()), QIODevice::ReadWrite|QIODevice::Truncate))
 			return false;
 
+		// remove a previous index, and write the new one on close
+		QFile::remove(archiveIndexFile(removePrefix(path())));
+		if (qobject_cast<QFile*>(device()))
+			d_data->filename = removePrefix(path());
+
 		if (!d_data->archive.open(device())) { 
 			close();
 			return false;
@@ -4927,6 +5426,7 @@ void VipArchiveRecorder::close()
 	setOpenMode(NotOpen);
 	this->setSize(0);
 	VipIODevice::close();
+	d_data->writeIndex();
 }
 
 VipArchiveRecorder::Trailer VipArchiveRecorder::trailer() const
@@ -4934,6 +5434,24 @@ VipArchiveRecorder::Trailer VipArchiveRecorder::trailer() const
 	return d_data->trailer;
 }
 
+void VipArchiveRecorder::setMovieMode(bool enable)
+{
+	d_data->movieMode = enable;
+}
+bool VipArchiveRecorder::movieMode() const
+{
+	return d_data->movieMode;
+}
+
+void VipArchiveRecorder::setMovieCompression(int level)
+{
+	d_data->archive.setMovieCompression(level);
+}
+int VipArchiveRecorder::movieCompression() const
+{
+	return d_data->archive.movieCompression();
+}
+
 void VipArchiveRecorder::apply()
 {
 	int input_count = inputCount();
@@ -4990,22 +5508,24 @@ void VipArchiveRecorder::apply()
 			else
 				d_data->trailer.endTime = qMax(d_data->trailer.endTime, (qint64)src.value().limits.second);
 
-			// write data
-			saveAnyData(d_data->archive, data);
+			// write data, either in the stream movie or as a separate record
+			if (d_data->movieMode && data.data().userType() == qMetaTypeId<VipNDArray>() &&
+			    d_data->archive.appendMovieFrame(QByteArray::number(data.source()), data.value<VipNDArray>(), data.time(), data.attributes())) {
+				// movie frames are not part of the index file, as their times are read from the movie itself
+			}
+			else {
+				saveAnyData(d_data->archive, data);
+				if (!d_data->filename.isEmpty()) {
+					QByteArray dname = d_data->archive.lastEndGroup();
+					d_data->index.append(ArchFrame{ data.source(), data.time(), dname.mid(dname.lastIndexOf("/") + 1) });
+				}
+			}
 
 			this->setSize(size() + 1);
 		}
 	}
 }
 
-struct ArchFrame
-{
-	qint64 stream;
-	qint64 time;
-	QByteArray name;
-
-};
-
 class VipArchiveReader::PrivateData
 {
 public:
@@ -5039,6 +5559,32 @@ public:
 	VipTimeRangeList ranges;
 
 	unsigned start_pos;
+	// write the frame index sidecar file after scanning a legacy archive
+	bool writeIndex{ true };
+	// protect the archive read position, as records might be loaded from the prefetch threads
+	QMutex archive_mutex;
+
+	// Load a frame, either from its movie or from its record.
+	// Thread safe: movie frames are read without modifying the archive, records are read under archive_mutex.
+	VipAnyData load(const ArchFrame& frame)
+	{
+		VipAnyData any;
+		if (frame.movieFrame >= 0) {
+			QVariantMap attrs;
+			const VipNDArray ar = archive.readMovieFrame(frame.name, frame.movieFrame, &attrs);
+			if (!ar.isEmpty()) {
+				any = VipAnyData(QVariant::fromValue(ar), frame.time);
+				any.setSource(frame.stream);
+				any.setAttributes(attrs);
+			}
+			return any;
+		}
+		QMutexLocker lock(&archive_mutex);
+		archive.restore(start_pos);
+		start_pos = archive.save();
+		loadAnyData(archive, any, frame.name);
+		return any;
+	}
 };
 
 VipArchiveReader::VipArchiveReader(QObject* parent)
@@ -5060,6 +5606,7 @@ void VipArchiveReader::bufferData()
 
 bool VipArchiveReader::open(VipIODevice::OpenModes mode)
 {
+	cancelPrefetch();
 	d_data->archive.close();
 	d_data->trailer = ArchiveRecorderTrailer();
 	d_data->frames.clear();
@@ -5122,24 +5669,61 @@ bool VipArchiveReader::open(VipIODevice::OpenModes mode)
 	d_data->archive.restore(d_data->start_pos);
 	auto pos3 = d_data->archive.currentGroup();
 	d_data->start_pos = d_data->archive.save();
-	d_data->archive.setAttribute("skip_data", true);
+
+	// Frames stored in the movie layout, one movie per stream
+	QVector<ArchFrame> movie_frames;
+	const QList<QByteArray> movies = d_data->archive.movies();
+	for (const QByteArray& movie : movies) {
+		const QVector<qint64> times = d_data->archive.movieTimes(movie);
+		for (qsizetype i = 0; i < times.size(); ++i)
+			movie_frames.append(ArchFrame{ movie.toLongLong(), times[i], movie, (qint64)i });
+	}
+
+	// Try to use the frame index file first
+	QVector<ArchFrame> index;
+	const QString filename = qobject_cast<QFile*>(device()) ? removePrefix(path()) : QString();
+	bool has_index = !filename.isEmpty() && readArchiveIndex(filename, index);
+	if (has_index) {
+		// check the index against the trailer
+		QMap<qint64, qint64> samples;
+		for (const ArchFrame& f : index)
+			samples[f.stream]++;
+		for (const ArchFrame& f : movie_frames)
+			samples[f.stream]++;
+		for (auto it = d_data->trailer.sources.begin(); it != d_data->trailer.sources.end() && has_index; ++it)
+			has_index = samples.value(it.key()) == it.value().samples;
+		has_index = has_index && samples.size() == d_data->trailer.sources.size();
+	}
 
 	qint64 count = 0;
-	while (true) {
-		VipAnyData any;
-		loadAnyData(d_data->archive, any);
-		if (any.source() != 0) {
-			QByteArray dname = d_data->archive.lastEndGroup();
-			int idx = dname.lastIndexOf("/");
-			dname = dname.mid(idx + 1);
-			d_data->frames.insert(any.time(), ArchFrame{ any.source(), any.time(), dname });
-			if (d_data->trailer.sources.size() == 1)
-				++count;
+	if (!has_index) {
+		// Legacy (or stale) index: read all data without their content
+		index.clear();
+		d_data->archive.setAttribute("skip_data", true);
+		while (true) {
+			VipAnyData any;
+			loadAnyData(d_data->archive, any);
+			if (any.source() != 0) {
+				QByteArray dname = d_data->archive.lastEndGroup();
+				int idx = dname.lastIndexOf("/");
+				dname = dname.mid(idx + 1);
+				index.append(ArchFrame{ any.source(), any.time(), dname });
+			}
+			else
+				break;
 		}
-		else
-			break;
+		// cache the index for the next opening
+		if (d_data->writeIndex && !filename.isEmpty() && index.size())
+			writeArchiveIndex(filename, index);
 	}
 
+	for (const ArchFrame& f : index)
+		d_data->frames.insert(f.time, f);
+	for (const ArchFrame& f : movie_frames)
+		d_data->frames.insert(f.time, f);
+	if (d_data->trailer.sources.size() == 1)
+		count = index.size() + movie_frames.size();
+
 	d_data->archive.setAttribute("skip_data", false);
 
 	// affect a valid data to each output
@@ -5147,12 +5731,7 @@ bool VipArchiveReader::open(VipIODevice::OpenModes mode)
 	for (QMultiMap<qint64, ArchFrame>::iterator it = d_data->frames.begin(); it != d_data->frames.end(); ++it) {
 		if (!streams.contains(it.value().stream)) {
 
-			d_data->archive.restore(d_data->start_pos);
-			d_data->start_pos = d_data->archive.save();
-
-			VipAnyData any;
-			loadAnyData(d_data->archive, any, it.value().name);
-
+			VipAnyData any = d_data->load(it.value());
 			if (!any.isEmpty()) {
 				streams.insert(it.value().stream);
 				int index = d_data->indexes[it.value().stream];
@@ -5252,6 +5831,8 @@ VipArchiveReader::DeviceType VipArchiveReader::deviceType() const
 
 void VipArchiveReader::close()
 {
+	// make sure no background read uses the archive
+	cancelPrefetch();
 	d_data->archive.close();
 	d_data->trailer = ArchiveRecorderTrailer();
 	d_data->frames.clear();
@@ -5283,6 +5864,38 @@ VipArchiveRecorder::Trailer VipArchiveReader::trailer() const
 	return d_data->trailer;
 }
 
+bool VipArchiveReader::supportPrefetch() const
+{
+	// With several streams, the outputs without a frame at a given time keep their previous data,
+	// which is only known when reading sequentially
+	return d_data->device_type == Temporal && d_data->trailer.sources.size() == 1;
+}
+
+VipAnyDataList VipArchiveReader::fetchData(qint64 time)
+{
+	// The frame map is not modified after opening, so it can be accessed from any thread
+	VipAnyDataList res;
+	if (!supportPrefetch())
+		return res;
+	QMultiMap<qint64, ArchFrame>::const_iterator it = d_data->frames.constFind(time);
+	if (it == d_data->frames.cend())
+		return res;
+
+	const VipAnyData any = d_data->load(it.value());
+	if (!any.isEmpty())
+		res.append(any);
+	return res;
+}
+
+void VipArchiveReader::setWriteFrameIndex(bool enable)
+{
+	d_data->writeIndex = enable;
+}
+bool VipArchiveReader::writeFrameIndex() const
+{
+	return d_data->writeIndex;
+}
+
 VipTimeRangeList VipArchiveReader::computeTimeWindow() const
 {
 	return d_data->ranges;
@@ -5369,11 +5982,8 @@ bool VipArchiveReader::readData(qint64 time)
 			continue;
 		}
 
-		QByteArray dname = it.value().name;
-		d_data->archive.restore(d_data->start_pos);
-		d_data->start_pos = d_data->archive.save();
-		VipAnyData any;
-		if (loadAnyData(d_data->archive, any, dname)) {
+		VipAnyData any = d_data->load(it.value());
+		if (!any.isEmpty()) {
 			if (!any.hasAttribute("Name"))
 				any.setAttribute("Name", this->name());
 			any.setSource(this);
@@ -5397,13 +6007,17 @@ bool VipArchiveReader::reload()
 		if (!sources.contains(it.value().stream)) {
 
 			VipAnyData any;
-			QByteArray dname = it.value().name;
-			d_data->archive.restore(d_data->start_pos);
-			d_data->start_pos = d_data->archive.save();
-			if (d_data->archive.content(dname, any)) {
-				if (!any.hasAttribute("Name"))
-					any.setAttribute("Name", this->name());
+			if (it.value().movieFrame >= 0)
+				any = d_data->load(it.value());
+			else {
+				QByteArray dname = it.value().name;
+				QMutexLocker lock(&d_data->archive_mutex);
+				d_data->archive.restore(d_data->start_pos);
+				d_data->start_pos = d_data->archive.save();
+				d_data->archive.content(dname, any);
 			}
+			if (!any.isEmpty() && !any.hasAttribute("Name"))
+				any.setAttribute("Name", this->name());
 			any.setSource(qint64(this));
 			outputAt(d_data->indexes[it.value().stream])->setData(any);
 			sources.insert(it.value().stream);
@@ -5413,6 +6027,49 @@ bool VipArchiveReader::reload()
 	return true;
 }
 
+bool vipConvertArchiveToMovie(const QString& input, const QString& output, int level)
+{
+	if (QFileInfo(input).absoluteFilePath() == QFileInfo(output).absoluteFilePath())
+		return false;
+
+	VipArchiveReader reader;
+	reader.setPath(input);
+	if (!reader.open(VipIODevice::ReadOnly))
+		return false;
+
+	VipArchiveRecorder recorder;
+	recorder.setPath(output);
+	recorder.setMovieMode(true);
+	recorder.setMovieCompression(level);
+	recorder.setAttributes(reader.attributes());
+	recorder.topLevelInputAt(0)->toMultiInput()->resize(reader.outputCount());
+	if (!recorder.open(VipIODevice::WriteOnly))
+		return false;
+
+	// The recorder drops the data already saved for a stream (same time), so all outputs can be forwarded after each read
+	const auto forward = [&]() {
+		for (int i = 0; i < reader.outputCount(); ++i)
+			recorder.inputAt(i)->setData(reader.outputAt(i)->data());
+		recorder.update();
+	};
+
+	if (reader.deviceType() == VipIODevice::Resource)
+		forward();
+	else {
+		qint64 time = reader.firstTime();
+		while (time != VipInvalidTime) {
+			reader.read(time, true);
+			forward();
+			const qint64 next = reader.nextTime(time);
+			if (next == VipInvalidTime || next <= time)
+				break;
+			time = next;
+		}
+	}
+
+	recorder.close();
+	return true;
+}
 
 #endif //VIP_WITH_HDF5
 
@@ -5625,6 +6282,7 @@ VipArchive& operator<<(VipArchive& arch, const VipDirectoryReader* r)
 	arch.content("alphabeticalOrder", r->alphabeticalOrder());
 	arch.content("type", (int)r->type());
 	arch.content("recursive", r->recursive());
+	arch.content("decodeAhead", r->decodeAhead());
 	return arch;
 }
 
@@ -5638,6 +6296,12 @@ VipArchive& operator>>(VipArchive& arch, VipDirectoryReader* r)
 	r->setAlphabeticalOrder(arch.read("alphabeticalOrder").value<bool>());
 	r->setType(VipDirectoryReader::Type(arch.read("type").value<int>()));
 	r->setRecursive(arch.read("recursive").value<bool>());
+	arch.save();
+	bool decode_ahead = false;
+	if (arch.content("decodeAhead", decode_ahead))
+		r->setDecodeAhead(decode_ahead);
+	else
+		arch.restore();
 	return arch;
 }
 
@@ -44,6 +44,8 @@
 #include "VipProcessingObject.h"
 #include "VipTimestamping.h"
 #include "VipNDArray.h"
+#include "VipFrameBufferPool.h"
+#include "VipPrefetchCache.h"
 
 /// \addtogroup Core
 /// @{
@@ -327,6 +329,20 @@ public Q_SLOTS:
 	/// This function could be usefull for Sequential devices that just call readCurrentData() periodically and reimplement readData().
 	bool readCurrentData();
 
+	/// Returns true if this device supports read-ahead prefetching through fetchData() (default to false).
+	/// When playing, VipProcessingPool uses a VipPrefetchCache to read upcoming frames of such devices on background threads.
+	virtual bool supportPrefetch() const { return false; }
+	/// Read and return the output data at given device time (as returned by closestReadTime()) without modifying the device outputs.
+	/// This function is called from background threads, possibly concurrently, and must therefore be thread safe.
+	/// The returned list contains one data per output. Returns an empty list on error.
+	virtual VipAnyDataList fetchData(qint64 time)
+	{
+		Q_UNUSED(time);
+		return VipAnyDataList();
+	}
+	/// Returns the device time that VipIODevice::read() would pass to readData() for given time.
+	qint64 closestReadTime(qint64 time) const;
+
 	/// Remove the current device's name prefix to a given path (look for the string 'device_name:' and remove it).
 	QString removePrefix(const QString& path) const { return removePrefix(path, QString(this->metaObject()->className())); }
 
@@ -433,6 +449,10 @@ protected:
 	/// Returns a null device on error.
 	QIODevice* createDevice(const QString& path, QIODevice::OpenMode mode);
 
+	/// @brief Discard the prefetched data of this device and wait for the background reads in progress.
+	/// Devices supporting prefetching must call this function before releasing the resources used by fetchData().
+	void cancelPrefetch();
+
 	/// @brief Emit the signal timestampingFilterChanged()
 	void emitTimestampingFilterChanged();
 	/// @brief Emit the signal timestampingChanged()
@@ -634,6 +654,37 @@ public:
 
 	int maxReadThreadCount() const;
 
+	/// @brief Enable/disable recycling of frame buffers for all processings of this pool (enabled by default).
+	/// When enabled, devices and processings that allocate their output arrays through VipProcessingObject::createFrame()
+	/// draw them from a VipFrameBufferPool owned by this processing pool. Frame buffers go back to the pool when released.
+	/// While playing, the pool statistics are exposed through the pool attributes "Frame buffer pool hit rate",
+	/// "Frame buffer pool hits" and "Frame buffer pool misses".
+	void setFrameBufferPoolEnabled(bool enable);
+	bool isFrameBufferPoolEnabled() const;
+	/// @brief Set the maximum amount of unused frame buffers (in bytes) kept by the frame buffer pool
+	void setFrameBufferPoolMaxMemory(qint64 bytes);
+	qint64 frameBufferPoolMaxMemory() const;
+	/// @brief Returns the frame buffer pool if enabled, nullptr otherwise.
+	VipFrameBufferPool* frameBufferPool() const;
+
+	/// @brief Enable/disable read-ahead prefetching while playing (enabled by default).
+	/// When enabled, upcoming frames of the children devices supporting VipIODevice::supportPrefetch() are read
+	/// on background threads in the playing direction and stored in a VipPrefetchCache.
+	/// Prefetch statistics are exposed through the pool attributes "Prefetch hit rate" and "Prefetch stall time".
+	void setPrefetchEnabled(bool enable);
+	bool isPrefetchEnabled() const;
+	/// @brief Set the maximum amount of prefetched data (in bytes)
+	void setPrefetchMaxMemory(qint64 bytes);
+	qint64 prefetchMaxMemory() const;
+	/// @brief Set the number of frames to read ahead for each device (default to 8)
+	void setPrefetchFrameCount(int count);
+	int prefetchFrameCount() const;
+	/// @brief Set the number of background threads used to read ahead (default to 2)
+	void setPrefetchThreadCount(int count);
+	int prefetchThreadCount() const;
+	/// @brief Returns the prefetch cache if prefetching is enabled, nullptr otherwise.
+	VipPrefetchCache* prefetchCache() const;
+
 	/// Returns all leaf processings for this processing pool.
 	///  If \a children_only is false, this function might look for processings that are not children of this processing pool.
 	QList<VipProcessingObject*> leafs(bool children_only = true) const;
@@ -760,6 +811,7 @@ protected:
 
 private:
 	void runPlay();
+	void schedulePrefetch();
 	void computeChildren();
 	void computeDeviceType();
 	void applyLimitsToChildren();
@@ -1226,6 +1278,13 @@ public:
 	void setAlphabeticalOrder(bool order = true);
 	void setType(Type);
 	void setRecursive(bool);
+	/// Enable/disable the decode-ahead mode (disabled by default), used by SequenceOfData readers of single data files (like images).
+	/// In this mode, only the first file is opened by open(). Other files are decoded on demand in readData() or, while playing,
+	/// ahead of the current time by the VipProcessingPool prefetch threads (see VipProcessingPool::setPrefetchEnabled()).
+	/// The decoded window follows the playing direction and speed, is bounded by VipProcessingPool::prefetchMaxMemory() and is discarded on seek.
+	/// The time spent to open and decode each file is stored in the output attribute "Decode time".
+	/// Since no per-file device is kept, deviceCount() returns 0 in this mode.
+	void setDecodeAhead(bool enable);
 
 	QStringList supportedSuffixes() const;
 	QSize fixedSize() const;
@@ -1235,6 +1294,7 @@ public:
 	bool alphabeticalOrder() const;
 	Type type() const;
 	bool recursive() const;
+	bool decodeAhead() const;
 
 	QStringList files() const;
 	QStringList suffixes() const;
@@ -1258,6 +1318,7 @@ public:
 			d->setAlphabeticalOrder(alphabeticalOrder());
 			d->setType(type());
 			d->setRecursive(recursive());
+			d->setDecodeAhead(decodeAhead());
 		}
 	}
 
@@ -1271,6 +1332,10 @@ public:
 	virtual bool open(VipIODevice::OpenModes mode);
 	virtual bool reload();
 
+	/// Prefetching is supported for SequenceOfData readers whose files are all Resource devices (like single images)
+	virtual bool supportPrefetch() const;
+	virtual VipAnyDataList fetchData(qint64 time);
+
 public Q_SLOTS:
 	void recomputeTimestamps();
 
@@ -1284,6 +1349,8 @@ protected:
 private:
 	void computeFiles();
 	int closestDeviceIndex(qint64 time, qint64* closest = nullptr) const;
+	VipIODevice* createFileDevice(const QString& file) const;
+	VipAnyDataList decodeFile(int index) const;
 	
 	VIP_DECLARE_PRIVATE_DATA();
 	// directory options
@@ -1343,6 +1410,10 @@ VIP_REGISTER_QOBJECT_METATYPE(VipShapeWriter*)
 /// using a #VipArchiveReader.
 ///
 /// An archive saved with \a VipArchiveRecorder has the extension .arch.
+/// When closing, a compact frame index is written next to the archive (archive path + ".idx") to speed up its opening with #VipArchiveReader.
+///
+/// In movie mode (see #VipArchiveRecorder::setMovieMode()), the VipNDArray frames of each stream are appended to a single chunked
+/// and optionally compressed dataset (see #VipH5Archive::appendMovieFrame()) instead of being stored as separate records.
 class VIP_CORE_EXPORT VipArchiveRecorder : public VipIODevice
 {
 	Q_OBJECT
@@ -1383,6 +1454,16 @@ public:
 
 	Trailer trailer() const;
 
+	/// @brief Enable/disable the movie layout (disabled by default).
+	/// When enabled, the VipNDArray frames of a stream are stored in a single movie dataset.
+	/// Frames that cannot be appended to the stream movie (different type or shape) are stored as separate records.
+	void setMovieMode(bool enable);
+	bool movieMode() const;
+
+	/// @brief Set the deflate compression level (0 to 9) of movies, 0 (default) disables compression.
+	void setMovieCompression(int level);
+	int movieCompression() const;
+
 protected:
 	virtual void apply();
 
@@ -1397,8 +1478,12 @@ VIP_REGISTER_QOBJECT_METATYPE(VipArchiveRecorder*)
 ///
 /// The number of outputs (or streams) is set in the #VipArchiveReader::open function.
 ///
-/// \a VipArchiveReader is very fast when reading the data one after the other in forward or backward mode. However, it can be slow
-/// when seeking in the middle of the file.
+/// \a VipArchiveReader is very fast when reading the data one after the other in forward or backward mode.
+///
+/// On opening, the frame index (time, stream and location of each record) is loaded from the sidecar file
+/// written by #VipArchiveRecorder next to the archive (archive path + ".idx"). For legacy archives, or if the
+/// index is stale, the whole archive is scanned and the index file is created for the next opening
+/// (see #VipArchiveReader::setWriteFrameIndex()).
 class VIP_CORE_EXPORT VipArchiveReader : public VipIODevice
 {
 	Q_OBJECT
@@ -1418,6 +1503,17 @@ public:
 
 	VipArchiveRecorder::Trailer trailer() const;
 
+	/// Prefetching is supported for temporal archives containing a single stream.
+	/// Movie frames are read from the file mapping (or under vipH5Mutex() when compressed), records under the archive lock.
+	virtual bool supportPrefetch() const;
+	virtual VipAnyDataList fetchData(qint64 time);
+
+	/// @brief Write the frame index sidecar file after scanning an archive without a valid index (enabled by default).
+	/// Write failures (for instance in a read-only directory) are logged and do not prevent the archive from opening.
+	/// Must be set before calling #VipArchiveReader::open().
+	void setWriteFrameIndex(bool enable);
+	bool writeFrameIndex() const;
+
 protected:
 	virtual qint64 computeNextTime(qint64 time) const;
 	virtual qint64 computePreviousTime(qint64 time) const;
@@ -1435,6 +1531,12 @@ private:
 
 VIP_REGISTER_QOBJECT_METATYPE(VipArchiveReader*)
 
+/// @brief Convert an existing archive (*.arch file) to the movie layout.
+/// All frames of \a input are read with a #VipArchiveReader and written to \a output with a #VipArchiveRecorder in movie mode,
+/// using the deflate compression \a level (0 to 9, 0 disables compression).
+/// Returns false if \a input cannot be read or if \a output cannot be created.
+VIP_CORE_EXPORT bool vipConvertArchiveToMovie(const QString& input, const QString& output, int level = 0);
+
 #endif
 
 /// @}
@@ -195,7 +195,7 @@ VipNDArray VipThresholding::applyProcessing(const VipNDArray& ar)
 		return VipNDArray();
 	}
 
-	VipNDArray out(QMetaType::Int, ar.shape());
+	VipNDArray out = createFrame(QMetaType::Int, ar.shape());
 	double value = propertyAt(0)->data().value<double>();
 
 	if (ar.canConvert<double>()) {
@@ -480,7 +480,7 @@ VipNDArray VipComponentLabelling::applyProcessing(const VipNDArray& ar)
 
 	bool m_connectivity_8 = propertyAt(0)->value<bool>();
 
-	VipNDArrayType<int> out(ar.shape());
+	VipNDArrayType<int> out = createFrame(QMetaType::Int, ar.shape());
 	if (m_buffer.size() != out.size())
 		m_buffer.resize(out.size());
 
@@ -1,4 +1,5 @@
 #include "VipMPEGLoader.h"
+#include "VipMultiNDArray.h"
 
 
 #ifdef _MSC_VER
@@ -16,6 +17,7 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 #include <libavformat/avformat.h>
 #include <libswscale/swscale.h>
+#include <libavutil/pixdesc.h>
 }
 
 #include <sstream>
@@ -29,8 +31,11 @@ extern "C" {
 #include <qmap.h>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QHash>
 #include <qfile.h>
 
+#include <list>
+
 
 
 
@@ -53,10 +58,26 @@ public:
 	AVFormatContext* GetContext() const { return pFormatCtx; }
 
 	const QImage& GetCurrentFrame();
+	// current frame in native format (if any)
+	const VipNDArray& GetCurrentArray() const { return m_array; }
 	const QImage& GetFrameByTime(double time);
 	const QImage& GetFrameByNumber(qint64 num);
 
-	bool MoveNextFrame();
+	// decode next frame, convert it to RGB if convert is true
+	bool MoveNextFrame(bool convert = true);
+
+	// output mode: 0 for RGB images, 1 for the luma plane, 2 for all planes
+	void SetOutputMode(int mode);
+	int OutputMode() const { return m_output_mode; }
+	// returns true if given output mode can be used without conversion for the current pixel format
+	bool SupportOutputMode(int mode) const;
+
+	// decoded frames cache (temporal devices only)
+	void SetCacheMaxMemory(qint64 bytes);
+	qint64 CacheMaxMemory() const { return m_cache_max_bytes; }
+	qint64 CacheHits() const { return m_cache_hits; }
+	qint64 CacheMisses() const { return m_cache_misses; }
+	void ClearCache();
 
 	double GetTimePos() const;
 	qint64 GetCurrentFramePos() const;
@@ -79,11 +100,44 @@ public:
 	// se deplace au temps donne (en s), peut etre approximatif
 	void SeekTime(double time);
 	void SeekTime2(double time);
-	void SeekFrame(qint64 pos);
+	// seek to given frame. If keep_frames is true, all frames decoded from the previous key frame are cached
+	void SeekFrame(qint64 pos, bool keep_frames = false);
 
 protected:
 	double getTime();
 	void toRGB(AVFrame* frame);
+	void convertFrame();
+	void countPacket(const AVPacket* p);
+	VipNDArray nativeArray(AVFrame* frame) const;
+	bool findCachedFrame(qint64 number);
+
+	// decoded frame as a RGB image or native array
+	struct DecodedFrame
+	{
+		QImage image;
+		VipNDArray array;
+		qint64 bytes;
+	};
+	DecodedFrame currentFrame() const;
+	void cacheFrame(qint64 number, const DecodedFrame& frame);
+
+	struct CachedFrame
+	{
+		DecodedFrame frame;
+		std::list<qint64>::iterator lru;
+	};
+	// LRU cache of RGB frames, keyed by frame number
+	QHash<qint64, CachedFrame> m_cache;
+	std::list<qint64> m_lru; // most recently used first
+	qint64 m_cache_bytes{ 0 };
+	qint64 m_cache_max_bytes{ 256 * 1024 * 1024 };
+	qint64 m_cache_hits{ 0 };
+	qint64 m_cache_misses{ 0 };
+	qint64 m_image_number{ -1 }; // frame number of m_image or m_array
+	VipNDArray m_array;	     // current frame in native format
+	int m_output_mode{ 0 };
+	qint64 m_gop_size{ 12 };     // last measured distance between 2 key frames
+	qint64 m_packets_since_key{ 0 };
 
 	uint64_t m_last_dts;
 	QImage m_image;
@@ -295,6 +349,11 @@ void VideoDecoder::Open(const std::string& name, AVInputFormat* iformat, AVDicti
 	pCodecCtx = avcodec_alloc_context3(pCodec);
 	avcodec_parameters_to_context(pCodecCtx, pFormatCtx->streams[videoStream]->codecpar);
 
+	// Enable multithreaded decoding (automatic thread count).
+	// Frame threading introduces a latency of one frame per thread, so only use slice threading for live streams.
+	pCodecCtx->thread_count = 0;
+	pCodecCtx->thread_type = IsSequential() ? FF_THREAD_SLICE : (FF_THREAD_FRAME | FF_THREAD_SLICE);
+
 	// Open codec
 	int res = avcodec_open2(pCodecCtx, pCodec, nullptr);
 	if (res < 0)
@@ -341,6 +400,11 @@ void VideoDecoder::Open(const std::string& name, AVInputFormat* iformat, AVDicti
 
 	m_frame_pos = 0;
 	m_time_pos = 0;
+	m_image_number = -1;
+	m_gop_size = 12;
+	m_packets_since_key = 0;
+	ClearCache();
+	m_cache_hits = m_cache_misses = 0;
 
 	m_total_time = pFormatCtx->duration / AV_TIME_BASE;
 	if (m_total_time < 0.01 && !IsSequential())
@@ -416,6 +480,101 @@ void VideoDecoder::Close()
 	pFrameRGB = nullptr;
 	pSWSCtx = nullptr;
 	m_file_open = false;
+	m_image_number = -1;
+	ClearCache();
+}
+
+void VideoDecoder::SetCacheMaxMemory(qint64 bytes)
+{
+	m_cache_max_bytes = bytes;
+	while (m_cache_bytes > m_cache_max_bytes && m_lru.size()) {
+		auto it = m_cache.find(m_lru.back());
+		m_cache_bytes -= it->frame.bytes;
+		m_cache.erase(it);
+		m_lru.pop_back();
+	}
+}
+
+void VideoDecoder::ClearCache()
+{
+	m_cache.clear();
+	m_lru.clear();
+	m_cache_bytes = 0;
+}
+
+bool VideoDecoder::findCachedFrame(qint64 number)
+{
+	auto it = m_cache.find(number);
+	if (it == m_cache.end())
+		return false;
+	// move to front of the LRU list
+	m_lru.splice(m_lru.begin(), m_lru, it->lru);
+	if (!it->frame.image.isNull())
+		m_image = it->frame.image;
+	m_array = it->frame.array;
+	m_image_number = number;
+	return true;
+}
+
+VideoDecoder::DecodedFrame VideoDecoder::currentFrame() const
+{
+	DecodedFrame res;
+	res.bytes = 0;
+	if (!m_array.isEmpty()) {
+		res.array = m_array;
+		if (vipIsMultiNDArray(m_array)) {
+			const QMap<QString, VipNDArray> planes = VipMultiNDArray(m_array).namedArrays();
+			for (auto it = planes.begin(); it != planes.end(); ++it)
+				res.bytes += it.value().size() * it.value().dataSize();
+		}
+		else
+			res.bytes = m_array.size() * m_array.dataSize();
+	}
+	else {
+		res.image = m_image;
+		res.bytes = m_image.sizeInBytes();
+	}
+	return res;
+}
+
+void VideoDecoder::cacheFrame(qint64 number, const DecodedFrame& frame)
+{
+	if (IsSequential() || number < 0 || frame.bytes > m_cache_max_bytes)
+		return;
+
+	auto it = m_cache.find(number);
+	if (it != m_cache.end()) {
+		m_cache_bytes -= it->frame.bytes;
+		it->frame = frame;
+		m_lru.splice(m_lru.begin(), m_lru, it->lru);
+	}
+	else {
+		m_lru.push_front(number);
+		m_cache.insert(number, CachedFrame{ frame, m_lru.begin() });
+	}
+	m_cache_bytes += frame.bytes;
+
+	// evict least recently used frames
+	while (m_cache_bytes > m_cache_max_bytes) {
+		auto last = m_cache.find(m_lru.back());
+		m_cache_bytes -= last->frame.bytes;
+		m_cache.erase(last);
+		m_lru.pop_back();
+	}
+}
+
+void VideoDecoder::countPacket(const AVPacket* p)
+{
+	// measure the GOP size based on key frame packets
+	if (p->stream_index != videoStream)
+		return;
+	if (p->flags & AV_PKT_FLAG_KEY) {
+		if (m_packets_since_key > 0)
+			m_gop_size = m_packets_since_key;
+		m_packets_since_key = 1;
+	}
+	else if (m_packets_since_key > 0)
+		++m_packets_since_key;
 }
 
 const QImage& VideoDecoder::GetCurrentFrame()
@@ -432,6 +591,10 @@ int VideoDecoder::pixelType() const
 
 void VideoDecoder::toRGB(AVFrame* frame)
 {
+	// the current image might be shared with the frame cache
+	if (!m_image.isDetached())
+		m_image = QImage(m_width, m_height, QImage::Format_ARGB32);
+
 	// m_last_dts = frame->pkt_dts;
 	// int pix1 = frame->data[0][0] | (frame->data[0][1] << 8);
 	// int pix2 = frame->data[0][0] | (frame->data[0][1] << 8);
@@ -480,7 +643,148 @@ static int decode(AVCodecContext* dec_ctx, AVFrame* frame, int* got_frame, AVPac
 	return used;
 }
 
-bool VideoDecoder::MoveNextFrame()
+// Returns the array type of a pixel format component (UChar or UShort),
+// or 0 if the component cannot be exported without conversion.
+static int componentType(const AVPixFmtDescriptor* desc, int c)
+{
+	const AVComponentDescriptor& comp = desc->comp[c];
+	const int bytes = comp.depth > 8 ? 2 : 1;
+	if (comp.depth > 16 || comp.step != bytes || comp.offset != 0 || comp.shift != 0)
+		return 0;
+	return bytes == 2 ? QMetaType::UShort : QMetaType::UChar;
+}
+
+// Returns the array for given frame plane.
+// The frame buffer is shared when possible, copied otherwise.
+// The returned array is a Standard one whose data() never detaches, so the buffer is only shared if the decoder
+// cannot read it back: either the codec is intra only, or the frame holds the only reference on the buffer
+// (it is not kept as a reference picture).
+static VipNDArray planeArray(AVFrame* frame, int plane, int type, int width, int height, bool swap, bool intra_only)
+{
+	const int bytes = type == QMetaType::UShort ? 2 : 1;
+	const int line = width * bytes;
+	AVBufferRef* buf = av_frame_get_plane_buffer(frame, plane);
+	if (!swap && buf && frame->linesize[plane] == line && (intra_only || av_buffer_is_writable(buf))) {
+		// zero copy: keep a reference on the frame buffers
+		if (AVFrame* ref = av_frame_clone(frame)) {
+			VipSharedHandle h = vipCreateArrayHandle(VipNDArrayHandle::Standard, type, ref->data[plane], vipVector(height, width), [ref](void*) mutable { av_frame_free(&ref); });
+			if (h->handleType() == VipNDArrayHandle::Standard)
+				return VipNDArray(h);
+			av_frame_free(&ref);
+		}
+	}
+
+	VipNDArray res(type, vipVector(height, width));
+	uchar* dst = (uchar*)res.data();
+	for (int y = 0; y < height; ++y, dst += line) {
+		const uchar* src = frame->data[plane] + (qsizetype)y * frame->linesize[plane];
+		if (swap) {
+			for (int x = 0; x < line; x += 2) {
+				dst[x] = src[x + 1];
+				dst[x + 1] = src[x];
+			}
+		}
+		else
+			memcpy(dst, src, line);
+	}
+	return res;
+}
+
+bool VideoDecoder::SupportOutputMode(int mode) const
+{
+	if (mode == 0)
+		return true;
+	if (!pCodecCtx)
+		return false;
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(pCodecCtx->pix_fmt);
+	if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL)))
+		return false;
+
+	// luma plane
+	if (desc->comp[0].plane != 0 || !componentType(desc, 0))
+		return false;
+	if (mode == 1)
+		return true;
+
+	// all planes: one plane per component
+	for (int c = 0; c < desc->nb_components; ++c)
+		if (desc->comp[c].plane != c || !componentType(desc, c))
+			return false;
+	return true;
+}
+
+void VideoDecoder::SetOutputMode(int mode)
+{
+	if (mode != m_output_mode) {
+		m_output_mode = mode;
+		// invalidate current frame and cache
+		ClearCache();
+		m_image_number = -1;
+		m_array = VipNDArray();
+	}
+}
+
+VipNDArray VideoDecoder::nativeArray(AVFrame* frame) const
+{
+	if (!SupportOutputMode(m_output_mode))
+		return VipNDArray();
+
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)frame->format);
+	if (!desc)
+		return VipNDArray();
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+	const bool swap = !(desc->flags & AV_PIX_FMT_FLAG_BE);
+#else
+	const bool swap = (desc->flags & AV_PIX_FMT_FLAG_BE) != 0;
+#endif
+
+	const AVCodecDescriptor* codec = avcodec_descriptor_get(pCodecCtx->codec_id);
+	const bool intra_only = codec && (codec->props & AV_CODEC_PROP_INTRA_ONLY);
+
+	const VipNDArray luma = planeArray(frame, 0, componentType(desc, 0), frame->width, frame->height, swap && desc->comp[0].depth > 8, intra_only);
+	if (m_output_mode == 1 || desc->nb_components == 1)
+		return luma;
+
+	static const char* names[4] = { "Y", "U", "V", "A" };
+	VipMultiNDArray res;
+	res.addArray(names[0], luma);
+	for (int c = 1; c < desc->nb_components; ++c) {
+		// chroma planes are subsampled (alpha plane is not)
+		int w = frame->width, h = frame->height;
+		if (c < 3) {
+			w = AV_CEIL_RSHIFT(w, desc->log2_chroma_w);
+			h = AV_CEIL_RSHIFT(h, desc->log2_chroma_h);
+		}
+		res.addArray(names[c], planeArray(frame, c, componentType(desc, c), w, h, swap && desc->comp[c].depth > 8, intra_only));
+	}
+	res.setCurrentArray(names[0]);
+	return res;
+}
+
+void VideoDecoder::convertFrame()
+{
+	if (!pFrame->data[0])
+		return;
+
+	// Native output, no color conversion
+	m_array = VipNDArray();
+	if (m_output_mode != 0) {
+		m_array = nativeArray(pFrame);
+		if (!m_array.isEmpty())
+			return;
+	}
+
+	// Convert YUV->DRGBPixel
+	if (pCodecCtx->pix_fmt != AV_PIX_FMT_GRAY16LE && pCodecCtx->pix_fmt != AV_PIX_FMT_GRAY16BE) {
+		sws_scale(pSWSCtx, pFrame->data, pFrame->linesize, 0, pCodecCtx->height, pFrameRGB->data, pFrameRGB->linesize);
+		toRGB(pFrameRGB);
+	}
+	else {
+		toRGB(pFrame);
+	}
+}
+
+bool VideoDecoder::MoveNextFrame(bool convert)
 {
 	//AVPacket p;
 	//av_init_packet(&p);
@@ -493,6 +797,7 @@ bool VideoDecoder::MoveNextFrame()
 		if (av_read_frame(pFormatCtx, p) < 0) {
 			//av_init_packet(&p);
 		}
+		countPacket(p);
 
 		int ret = decode(pCodecCtx, pFrame, &finish, p);
 		if (ret == AVERROR(EAGAIN))
@@ -507,19 +812,14 @@ bool VideoDecoder::MoveNextFrame()
 		}
 	}
 
-	// Convert YUV->DRGBPixel
-	if (pFrame->data[0]) {
-		if (pCodecCtx->pix_fmt != AV_PIX_FMT_GRAY16LE && pCodecCtx->pix_fmt != AV_PIX_FMT_GRAY16BE) {
-			sws_scale(pSWSCtx, pFrame->data, pFrame->linesize, 0, pCodecCtx->height, pFrameRGB->data, pFrameRGB->linesize);
-			toRGB(pFrameRGB);
-		}
-		else {
-			toRGB(pFrame);
-		}
-	}
 	m_last_dts = pFrame->pkt_dts;
 	m_frame_pos++;
 	m_time_pos = m_frame_pos * 1.0 * m_tech;
+	if (convert) {
+		convertFrame();
+		m_image_number = m_frame_pos - 1;
+		cacheFrame(m_image_number, currentFrame());
+	}
 	//if (p.buf)
 		av_packet_unref(p);
 	av_packet_free(&p);
@@ -552,11 +852,28 @@ const QImage& VideoDecoder::GetFrameByTime(double time)
 
 const QImage& VideoDecoder::GetFrameByNumber(qint64 number)
 {
-	if ((qint64)number + 1 == m_frame_pos)
+	if (number == m_image_number)
+		return m_image;
+
+	if (findCachedFrame(number)) {
+		++m_cache_hits;
 		return m_image;
+	}
+	++m_cache_misses;
+
+	if (m_frame_pos >= 0 && number > m_frame_pos && number - m_frame_pos < m_gop_size) {
+		// target within the current GOP: decode forward without RGB conversion instead of seeking
+		while (m_frame_pos >= 0 && m_frame_pos < number)
+			if (!MoveNextFrame(false))
+				break;
+	}
 
-	if ((qint64)number != m_frame_pos)
-		SeekTime(number / m_fps);
+	if (number != m_frame_pos) {
+		// when moving backward, keep all frames decoded from the key frame
+		// so that the previous frames will be served from the cache
+		const bool backward = m_image_number >= 0 && number < m_image_number;
+		SeekFrame(number, backward);
+	}
 
 	MoveNextFrame();
 
@@ -568,7 +885,7 @@ static int64_t FrameToPts(AVStream* pavStream, int64_t frame)
 	return ((frame)*pavStream->r_frame_rate.den * pavStream->time_base.den) / (int64_t(pavStream->r_frame_rate.num) * pavStream->time_base.num);
 }
 
-void VideoDecoder::SeekFrame(qint64 pos)
+void VideoDecoder::SeekFrame(qint64 pos, bool keep_frames)
 {
 	if (pos == 0) {
 		av_seek_frame(pFormatCtx, videoStream, (int64_t)(pos) * 12800ull, AVSEEK_FLAG_BACKWARD);
@@ -603,6 +920,16 @@ void VideoDecoder::SeekFrame(qint64 pos)
 	AVPacket* p = av_packet_alloc();
 	//av_init_packet(&p);
 
+	// Frame number of a decoded frame, inverse of the target_dts computation.
+	// Used to insert the frames decoded from the key frame (if keep_frames is true) directly in the cache,
+	// which bounds the memory used by a backward seek to the cache budget.
+	AVStream* stream = pFormatCtx->streams[videoStream];
+	auto frameNumber = [&](int64_t dts) -> qint64 {
+		if (!m_use_dts)
+			return static_cast<qint64>(floor(dts / (AV_TIME_BASE * m_tech) + 0.5));
+		return static_cast<qint64>(floor(double(dts) * stream->time_base.num * stream->r_frame_rate.num / (double(stream->time_base.den) * stream->r_frame_rate.den) + 0.5));
+	};
+
 	while (true) {
 		int finish = 0;
 		while (finish == 0) {
@@ -611,6 +938,7 @@ void VideoDecoder::SeekFrame(qint64 pos)
 			if (av_read_frame(pFormatCtx, p) < 0) {
 				//av_init_packet(&p);
 			}
+			countPacket(p);
 
 			int ret = decode(pCodecCtx, pFrame, &finish, p);
 			if (ret == AVERROR(EAGAIN))
@@ -622,6 +950,8 @@ void VideoDecoder::SeekFrame(qint64 pos)
 				av_packet_free(&p);
 				
 				m_frame_pos = -1; // in case of error, invalidate m_frame_pos to be sure to call av_seek_frame next time
+				if (keep_frames)
+					m_image_number = -1; // current image was overwritten
 				return;
 			}
 		}
@@ -629,19 +959,22 @@ void VideoDecoder::SeekFrame(qint64 pos)
 		if (pFrame->pkt_dts >= target_dts) {
 			break;
 		}
-	}
-	// Convert YUV -> RGB
-	if (pFrame->data[0]) {
-		if (pCodecCtx->pix_fmt != AV_PIX_FMT_GRAY16LE && pCodecCtx->pix_fmt != AV_PIX_FMT_GRAY16BE) {
-			sws_scale(pSWSCtx, pFrame->data, pFrame->linesize, 0, pCodecCtx->height, pFrameRGB->data, pFrameRGB->linesize);
-			toRGB(pFrameRGB);
-		}
-		else {
-			toRGB(pFrame);
+		if (keep_frames) {
+			const qint64 number = frameNumber(pFrame->pkt_dts);
+			if (number >= 0 && number < (qint64)pos - 1) {
+				convertFrame();
+				m_image_number = number;
+				cacheFrame(number, currentFrame());
+			}
 		}
 	}
+	// Convert YUV -> RGB
+	convertFrame();
 	m_frame_pos = (qint64)pos;
 	m_time_pos = pos / m_fps;
+	m_image_number = pos - 1;
+
+	cacheFrame(m_image_number, currentFrame());
 	//if (p.buf)
 	//	av_packet_unref(&p);
 	av_packet_unref(p);
@@ -691,6 +1024,7 @@ VipMPEGLoader::VipMPEGLoader(QObject* parent)
   , m_last_dts(0)
   , m_sampling_time(0)
   , m_count(0)
+  , m_output_format(Auto)
 {
 	this->outputAt(0)->setData(QVariant::fromValue(vipToArray(QImage(10, 10, QImage::Format_ARGB32))));
 	m_decoder = new VideoDecoder();
@@ -711,9 +1045,21 @@ qint32 VipMPEGLoader::fullFrameHeight() const
 	return m_decoder->GetHeight();
 }
 
+void VipMPEGLoader::setFrameCacheMemory(qint64 bytes)
+{
+	m_decoder->SetCacheMaxMemory(bytes);
+}
+qint64 VipMPEGLoader::frameCacheMemory() const
+{
+	return m_decoder->CacheMaxMemory();
+}
+
 void VipMPEGLoader::setDrawFunction(const draw_function& f)
 {
 	m_draw_function = f;
+	// the draw function requires RGB images
+	if (isOpen())
+		updateOutputMode();
 }
 const VipMPEGLoader::draw_function& VipMPEGLoader::drawFunction() const
 {
@@ -769,8 +1115,9 @@ bool VipMPEGLoader::open(const QString& name, const QString& format, const QMap<
 		this->setTimeWindows(0, size, qint64(m_sampling_time * qint64(1000000000)));
 		this->setOpenMode(VipIODevice::ReadOnly);
 
+		updateOutputMode();
 		m_decoder->MoveNextFrame();
-		VipAnyData out = create(QVariant::fromValue(fromImage(m_decoder->GetCurrentFrame())));
+		VipAnyData out = create(QVariant::fromValue(currentArray()));
 		if (deviceType() == Sequential) {
 			out.setTime(vipGetNanoSecondsSinceEpoch());
 			out.setAttribute("Number", 0);
@@ -831,8 +1178,9 @@ bool VipMPEGLoader::open(VipIODevice::OpenModes mode)
 		this->setAttribute("Date", info.lastModified().toString());
 		this->setOpenMode(mode);
 
+		updateOutputMode();
 		m_decoder->MoveNextFrame();
-		VipAnyData out = create(QVariant::fromValue(fromImage(m_decoder->GetCurrentFrame())));
+		VipAnyData out = create(QVariant::fromValue(currentArray()));
 		if (deviceType() == Sequential) {
 			out.setTime(vipGetNanoSecondsSinceEpoch());
 			out.setAttribute("Number", 0);
@@ -850,11 +1198,51 @@ bool VipMPEGLoader::open(VipIODevice::OpenModes mode)
 	return false;
 }
 
+void VipMPEGLoader::setOutputFormat(OutputFormat format)
+{
+	m_output_format = format;
+	if (isOpen()) {
+		updateOutputMode();
+		if (deviceType() == Temporal)
+			reload();
+	}
+}
+VipMPEGLoader::OutputFormat VipMPEGLoader::outputFormat() const
+{
+	return m_output_format;
+}
+
+void VipMPEGLoader::updateOutputMode()
+{
+	int mode = 0;
+	if (m_output_format == Luma)
+		mode = 1;
+	else if (m_output_format == Planes)
+		mode = 2;
+	else if (m_output_format == Auto) {
+		// use the luma plane for single channel videos (no color), RGB otherwise
+		const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)m_decoder->pixelType());
+		if (desc && desc->nb_components == 1 && (!m_draw_function || desc->comp[0].depth > 8))
+			mode = 1;
+	}
+	if (!m_decoder->SupportOutputMode(mode))
+		mode = 0;
+	m_decoder->SetOutputMode(mode);
+}
+
+VipNDArray VipMPEGLoader::currentArray() const
+{
+	const VipNDArray ar = m_decoder->GetCurrentArray();
+	if (!ar.isEmpty())
+		return ar;
+	return fromImage(m_decoder->GetCurrentFrame());
+}
+
 VipNDArray VipMPEGLoader::fromImage(const QImage& img) const
 {
 	if (m_decoder->pixelType() == AV_PIX_FMT_GRAY16LE || m_decoder->pixelType() == AV_PIX_FMT_GRAY16BE) {
 
-		VipNDArrayType<unsigned short> res(vipVector(img.height(), img.width()));
+		VipNDArrayType<unsigned short> res = createFrame(QMetaType::UShort, vipVector(img.height(), img.width()));
 		const uint* pix = (const uint*)img.bits();
 		for (int y = 0; y < img.height(); ++y)
 			for (int x = 0; x < img.width(); ++x) {
@@ -900,8 +1288,11 @@ bool VipMPEGLoader::readData(qint64 time)
 	try {
 		// temporal device (mpeg file)
 		if (deviceType() == Temporal) {
-			const QImage img = m_decoder->GetFrameByTime(time * 0.000000001);
-			VipNDArray ar = fromImage(img);
+			m_decoder->GetFrameByTime(time * 0.000000001);
+			VipNDArray ar = currentArray();
+
+			setAttribute("Frame cache hits", m_decoder->CacheHits());
+			setAttribute("Frame cache misses", m_decoder->CacheMisses());
 
 			VipAnyData out = create(QVariant::fromValue(ar));
 			outputAt(0)->setData(out);
@@ -914,7 +1305,7 @@ bool VipMPEGLoader::readData(qint64 time)
 					return false;
 
 				m_last_dts = m_decoder->LastReadDTS();
-				VipNDArray ar = fromImage(m_decoder->GetCurrentFrame());
+				VipNDArray ar = currentArray();
 
 				VipAnyData out = create(QVariant::fromValue(ar));
 				out.setTime(vipGetNanoSecondsSinceEpoch());
@@ -13,6 +13,14 @@ class VideoDecoder;
 /// If the path refers to a local file, VipMPEGLoader will be Temporal.
 /// If the path refers to a network stream or a webcam, VipMPEGLoader will be Sequential.
 ///
+/// Videos are decoded using multiple threads. For Temporal devices, decoded frames are stored
+/// in a LRU cache bounded by frameCacheMemory(). When moving backward, all frames decoded from
+/// the previous key frame are cached, so that backward playback decodes each GOP only once.
+/// Cache hits and misses are reported through the 'Frame cache hits' and 'Frame cache misses' attributes.
+///
+/// By default, single channel videos (gray8, gray16,...) are output as numeric arrays built directly
+/// from the decoded luma plane, and color videos as RGB images. See setOutputFormat() for other options.
+///
 class VIP_CORE_EXPORT VipMPEGLoader : public VipTimeRangeBasedGenerator
 {
 	Q_OBJECT
@@ -23,12 +31,32 @@ class VIP_CORE_EXPORT VipMPEGLoader : public VipTimeRangeBasedGenerator
 public:
 	using draw_function = std::function<void(QImage&)>;
 
+	/// @brief Output format of the video frames
+	enum OutputFormat
+	{
+		Auto,  //! Luma plane for single channel videos, RGB image otherwise
+		RGB,   //! Always convert frames to RGB images
+		Luma,  //! Luma plane as an unsigned 8 or 16 bits array, without color conversion
+		Planes //! All planes (Y, U, V and possibly A) as a VipMultiNDArray, without color conversion
+	};
+
 	VipMPEGLoader(QObject* parent = nullptr);
 	virtual ~VipMPEGLoader();
 
 	qint32 fullFrameWidth() const;
 	qint32 fullFrameHeight() const;
 
+	/// @brief Set/get the maximum memory footprint in bytes of the decoded frames cache (default to 256MB)
+	void setFrameCacheMemory(qint64 bytes);
+	qint64 frameCacheMemory() const;
+
+	/// @brief Set/get the output format.
+	/// Luma and Planes formats are only available for planar YUV or gray pixel formats, and fall back to RGB otherwise.
+	/// With these formats, the output arrays share the decoded frame buffers whenever possible (no copy),
+	/// and the draw function is not applied.
+	void setOutputFormat(OutputFormat format);
+	OutputFormat outputFormat() const;
+
 	void setDrawFunction(const draw_function&);
 	const draw_function& drawFunction() const;
 
@@ -70,6 +98,8 @@ protected:
 	};
 
 	VipNDArray fromImage(const QImage& img) const;
+	VipNDArray currentArray() const;
+	void updateOutputMode();
 
 	ReadThread m_thread;
 	VideoDecoder* m_decoder;
@@ -78,6 +108,7 @@ protected:
 	int m_count;
 	QString m_device_path;
 	draw_function m_draw_function;
+	OutputFormat m_output_format;
 };
 
 VIP_REGISTER_QOBJECT_METATYPE(VipMPEGLoader*)
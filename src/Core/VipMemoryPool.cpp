@@ -155,7 +155,7 @@ void* vipOSAllocatePages(size_t pages) noexcept
 {
 	size_t len = pages * vipOSPageSize();
 	void* p = mmap(0, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-	return p;
+	return p == MAP_FAILED ? nullptr : p;
 }
 
 bool vipOSFreePages(void* p, size_t pages) noexcept
@@ -0,0 +1,696 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QtEndian>
+
+#include <array>
+#include <limits>
+#include <complex>
+
+#include "VipNPZDevice.h"
+
+namespace
+{
+	/// On-disk description of a VipNDArray data type for the NPY and MAT formats
+	struct ArrayFormat
+	{
+		int type;	   // VipNDArray data type
+		const char* descr; // numpy type descriptor, without byte order
+		int size;	   // element size in bytes
+		int mat_class;	   // Matlab array class
+		int mat_type;	   // Matlab data type of the real and imaginary parts
+		bool complex;
+		bool logical;
+	};
+}
+
+static ArrayFormat arrayFormat(int type)
+{
+	switch (type) {
+		case QMetaType::Bool:
+			return ArrayFormat{ type, "b1", 1, 9, 2, false, true };
+		case QMetaType::Char:
+		case QMetaType::SChar:
+			return ArrayFormat{ type, "i1", 1, 8, 1, false, false };
+		case QMetaType::UChar:
+			return ArrayFormat{ type, "u1", 1, 9, 2, false, false };
+		case QMetaType::Short:
+			return ArrayFormat{ type, "i2", 2, 10, 3, false, false };
+		case QMetaType::UShort:
+			return ArrayFormat{ type, "u2", 2, 11, 4, false, false };
+		case QMetaType::Int:
+			return ArrayFormat{ type, "i4", 4, 12, 5, false, false };
+		case QMetaType::UInt:
+			return ArrayFormat{ type, "u4", 4, 13, 6, false, false };
+		case QMetaType::Long:
+			return sizeof(long) == 8 ? ArrayFormat{ type, "i8", 8, 14, 12, false, false } : ArrayFormat{ type, "i4", 4, 12, 5, false, false };
+		case QMetaType::ULong:
+			return sizeof(long) == 8 ? ArrayFormat{ type, "u8", 8, 15, 13, false, false } : ArrayFormat{ type, "u4", 4, 13, 6, false, false };
+		case QMetaType::LongLong:
+			return ArrayFormat{ type, "i8", 8, 14, 12, false, false };
+		case QMetaType::ULongLong:
+			return ArrayFormat{ type, "u8", 8, 15, 13, false, false };
+		case QMetaType::Float:
+			return ArrayFormat{ type, "f4", 4, 7, 7, false, false };
+		case QMetaType::Double:
+			return ArrayFormat{ type, "f8", 8, 6, 9, false, false };
+		default:
+			break;
+	}
+	if (type == qMetaTypeId<complex_f>())
+		return ArrayFormat{ type, "c8", 8, 7, 7, true, false };
+	if (type == qMetaTypeId<complex_d>())
+		return ArrayFormat{ type, "c16", 16, 6, 9, true, false };
+
+	// any other type (long double...) is saved as double
+	return arrayFormat(QMetaType::Double);
+}
+
+/// Returns a contiguous C-ordered version of \a ar with given data type
+static VipNDArray denseArray(const VipNDArray& ar, int type)
+{
+	if (ar.dataType() == type && ar.handle()->handleType() == VipNDArrayHandle::Standard && ar.isUnstrided())
+		return ar;
+	VipNDArray res(type, ar.shape());
+	if (!ar.convert(res))
+		return VipNDArray();
+	return res;
+}
+
+/// Returns a contiguous Fortran-ordered version of \a ar with given data type
+static VipNDArray fortranArray(const VipNDArray& ar, int type)
+{
+	VipNDArray res(type, ar.shape());
+	VipNDArrayShape strides = ar.shape();
+	qsizetype stride = 1;
+	for (qsizetype i = 0; i < strides.size(); ++i) {
+		strides[i] = stride;
+		stride *= ar.shape(i);
+	}
+	if (!ar.convert(res.data(), type, ar.shape(), strides))
+		return VipNDArray();
+	return res;
+}
+
+/// Build a valid array name from an input data name
+static QString arrayName(const QString& name)
+{
+	QString dataname = name;
+	for (int i = 0; i < dataname.size(); ++i)
+		if (!dataname[i].isLetterOrNumber())
+			dataname[i] = '_';
+
+	QString tmp;
+	for (int i = 0; i < dataname.size(); ++i)
+		if (!(i > 0 && dataname[i] == '_' && dataname[i - 1] == '_'))
+			tmp.push_back(dataname[i]);
+	if (tmp.isEmpty())
+		return "arr_0";
+	return "arr_" + tmp;
+}
+
+template<class T>
+static void appendValue(QByteArray& ar, T value)
+{
+	value = qToLittleEndian(value);
+	ar.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static bool writeAt(QFile& file, qint64 pos, const QByteArray& ar)
+{
+	return file.seek(pos) && file.write(ar) == ar.size();
+}
+
+static bool writePadding(QFile& file, int alignment)
+{
+	qint64 pad = (alignment - file.pos() % alignment) % alignment;
+	return pad == 0 || file.write(QByteArray(pad, 0)) == pad;
+}
+
+static const std::array<quint32, 256>& crc32Table()
+{
+	static const std::array<quint32, 256> table = []() {
+		std::array<quint32, 256> res;
+		for (quint32 i = 0; i < 256; ++i) {
+			quint32 c = i;
+			for (int k = 0; k < 8; ++k)
+				c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+			res[i] = c;
+		}
+		return res;
+	}();
+	return table;
+}
+
+/// Zip CRC-32 of \a size bytes, continuing a previous checksum \a crc
+static quint32 crc32Update(quint32 crc, const char* data, qint64 size)
+{
+	const std::array<quint32, 256>& table = crc32Table();
+	crc = ~crc;
+	for (qint64 i = 0; i < size; ++i)
+		crc = table[(crc ^ (quint8)data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static quint32 gf2MatrixTimes(const quint32* mat, quint32 vec)
+{
+	quint32 sum = 0;
+	while (vec) {
+		if (vec & 1)
+			sum ^= *mat;
+		vec >>= 1;
+		++mat;
+	}
+	return sum;
+}
+
+static void gf2MatrixSquare(quint32* square, const quint32* mat)
+{
+	for (int n = 0; n < 32; ++n)
+		square[n] = gf2MatrixTimes(mat, mat[n]);
+}
+
+/// Returns the CRC-32 of the concatenation of 2 blocks given their checksums and the second block size.
+/// This lets us stream the frames checksum while the NPY header (which contains the frame count) is only known on close.
+static quint32 crc32Combine(quint32 crc1, quint32 crc2, qint64 len2)
+{
+	if (len2 <= 0)
+		return crc1;
+
+	quint32 even[32];
+	quint32 odd[32];
+
+	// operator for one zero bit
+	odd[0] = 0xEDB88320U;
+	quint32 row = 1;
+	for (int n = 1; n < 32; ++n) {
+		odd[n] = row;
+		row <<= 1;
+	}
+	gf2MatrixSquare(even, odd); // 2 zero bits
+	gf2MatrixSquare(odd, even); // 4 zero bits
+
+	// apply len2 zeros to crc1
+	do {
+		gf2MatrixSquare(even, odd);
+		if (len2 & 1)
+			crc1 = gf2MatrixTimes(even, crc1);
+		len2 >>= 1;
+		if (len2 == 0)
+			break;
+		gf2MatrixSquare(odd, even);
+		if (len2 & 1)
+			crc1 = gf2MatrixTimes(odd, crc1);
+		len2 >>= 1;
+	} while (len2 != 0);
+
+	return crc1 ^ crc2;
+}
+
+/// NPY (version 1.0) header for \a frames frames of given shape.
+/// If \a reserved is not 0, the header is padded to this size, so that it can be rewritten in place.
+static QByteArray npyHeader(const ArrayFormat& f, qint64 frames, const VipNDArrayShape& shape, qint64 reserved = 0)
+{
+	QByteArrayList dims;
+	if (frames != 1)
+		dims << QByteArray::number(frames);
+	for (qsizetype i = 0; i < shape.size(); ++i)
+		dims << QByteArray::number((qint64)shape[i]);
+	QByteArray shape_str = "(" + dims.join(", ") + (dims.size() == 1 ? ",)" : ")");
+
+	const char order = f.size == 1 ? '|' : (Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? '<' : '>');
+	QByteArray dict = "{'descr': '" + QByteArray(1, order) + f.descr + "', 'fortran_order': False, 'shape': " + shape_str + ", }";
+
+	// magic string + version + header length + dictionary + '\n', aligned on 64 bytes
+	qint64 total = reserved ? reserved : ((10 + dict.size() + 1 + 63) / 64) * 64;
+	dict += QByteArray(total - 10 - dict.size() - 1, ' ');
+	dict += '\n';
+
+	QByteArray res("\x93NUMPY\x01\x00", 8);
+	appendValue<quint16>(res, (quint16)(total - 10));
+	return res + dict;
+}
+
+static void dosDateTime(quint16& time, quint16& date)
+{
+	const QDateTime dt = QDateTime::currentDateTime();
+	time = (quint16)((dt.time().hour() << 11) | (dt.time().minute() << 5) | (dt.time().second() / 2));
+	date = (quint16)(((qMax(dt.date().year(), 1980) - 1980) << 9) | (dt.date().month() << 5) | dt.date().day());
+}
+
+/// Zip local file header for a single stored (uncompressed) entry.
+/// Sizes are always stored in the zip64 extra field, so that the header size does not depend on the final entry size.
+static QByteArray zipLocalHeader(const QByteArray& name, quint32 crc, quint64 size, quint16 time, quint16 date)
+{
+	QByteArray h;
+	appendValue<quint32>(h, 0x04034b50);
+	appendValue<quint16>(h, 45); // version needed: zip64
+	appendValue<quint16>(h, 0);  // flags
+	appendValue<quint16>(h, 0);  // stored
+	appendValue<quint16>(h, time);
+	appendValue<quint16>(h, date);
+	appendValue<quint32>(h, crc);
+	appendValue<quint32>(h, 0xFFFFFFFF);
+	appendValue<quint32>(h, 0xFFFFFFFF);
+	appendValue<quint16>(h, (quint16)name.size());
+	appendValue<quint16>(h, 20);
+	h += name;
+	appendValue<quint16>(h, 0x0001); // zip64 extra field
+	appendValue<quint16>(h, 16);
+	appendValue<quint64>(h, size);
+	appendValue<quint64>(h, size);
+	return h;
+}
+
+/// Zip central directory and end records for a single stored entry located at the beginning of the file
+static QByteArray zipCentralDirectory(const QByteArray& name, quint32 crc, quint64 size, quint16 time, quint16 date, quint64 offset)
+{
+	QByteArray h;
+	appendValue<quint32>(h, 0x02014b50);
+	appendValue<quint16>(h, 45); // version made by
+	appendValue<quint16>(h, 45); // version needed
+	appendValue<quint16>(h, 0);
+	appendValue<quint16>(h, 0);
+	appendValue<quint16>(h, time);
+	appendValue<quint16>(h, date);
+	appendValue<quint32>(h, crc);
+	appendValue<quint32>(h, 0xFFFFFFFF);
+	appendValue<quint32>(h, 0xFFFFFFFF);
+	appendValue<quint16>(h, (quint16)name.size());
+	appendValue<quint16>(h, 20);
+	appendValue<quint16>(h, 0); // comment length
+	appendValue<quint16>(h, 0); // disk number
+	appendValue<quint16>(h, 0); // internal attributes
+	appendValue<quint32>(h, 0); // external attributes
+	appendValue<quint32>(h, 0); // local header offset
+	h += name;
+	appendValue<quint16>(h, 0x0001);
+	appendValue<quint16>(h, 16);
+	appendValue<quint64>(h, size);
+	appendValue<quint64>(h, size);
+
+	const quint64 cd_size = h.size();
+	const bool zip64 = offset >= 0xFFFFFFFF;
+	if (zip64) {
+		// zip64 end of central directory record and locator
+		appendValue<quint32>(h, 0x06064b50);
+		appendValue<quint64>(h, 44);
+		appendValue<quint16>(h, 45);
+		appendValue<quint16>(h, 45);
+		appendValue<quint32>(h, 0);
+		appendValue<quint32>(h, 0);
+		appendValue<quint64>(h, 1);
+		appendValue<quint64>(h, 1);
+		appendValue<quint64>(h, cd_size);
+		appendValue<quint64>(h, offset);
+
+		appendValue<quint32>(h, 0x07064b50);
+		appendValue<quint32>(h, 0);
+		appendValue<quint64>(h, offset + cd_size);
+		appendValue<quint32>(h, 1);
+	}
+
+	appendValue<quint32>(h, 0x06054b50);
+	appendValue<quint16>(h, 0);
+	appendValue<quint16>(h, 0);
+	appendValue<quint16>(h, 1);
+	appendValue<quint16>(h, 1);
+	appendValue<quint32>(h, (quint32)cd_size);
+	appendValue<quint32>(h, zip64 ? 0xFFFFFFFF : (quint32)offset);
+	appendValue<quint16>(h, 0);
+	return h;
+}
+
+class VipNPZDevice::PrivateData
+{
+public:
+	QFile file;
+	ArrayFormat format;
+	VipNDArrayShape shape; // frame shape
+	QByteArray entry;      // npy entry name in the zip archive
+	qint64 frames{ 0 };
+	qint64 headerPos{ 0 };	// npy header position
+	qint64 headerSize{ 0 }; // reserved npy header size
+	qint64 dataBytes{ 0 };
+	quint32 crc{ 0 }; // CRC-32 of the frames data
+	quint16 time{ 0 };
+	quint16 date{ 0 };
+};
+
+VipNPZDevice::VipNPZDevice(QObject* parent)
+  : VipIODevice(parent)
+{
+	VIP_CREATE_PRIVATE_DATA();
+}
+
+VipNPZDevice::~VipNPZDevice()
+{
+	close();
+}
+
+bool VipNPZDevice::open(VipIODevice::OpenModes mode)
+{
+	if (mode != WriteOnly)
+		return false;
+
+	close();
+
+	QString p = removePrefix(path());
+	if (!p.endsWith(".npz"))
+		return false;
+
+	setOpenMode(mode);
+	return true;
+}
+
+void VipNPZDevice::apply()
+{
+	while (inputAt(0)->hasNewData()) {
+		VipAnyData any = inputAt(0)->data();
+		VipNDArray ar = any.value<VipNDArray>();
+		if (ar.isEmpty()) {
+			setError("Empty input array");
+			return;
+		}
+
+		if (!d_data->file.isOpen()) {
+			// first frame: write the zip entry header and a npy header with a placeholder frame count
+			d_data->format = arrayFormat(ar.dataType());
+			d_data->shape = ar.shape();
+			d_data->entry = arrayName(any.name()).toLatin1() + ".npy";
+			d_data->frames = 0;
+			d_data->dataBytes = 0;
+			d_data->crc = 0;
+			dosDateTime(d_data->time, d_data->date);
+
+			d_data->file.setFileName(removePrefix(path()));
+			if (!d_data->file.open(QFile::WriteOnly)) {
+				setError("Unable to open output file " + d_data->file.fileName());
+				return;
+			}
+			const QByteArray local = zipLocalHeader(d_data->entry, 0, 0, d_data->time, d_data->date);
+			const QByteArray header = npyHeader(d_data->format, std::numeric_limits<qint64>::max(), d_data->shape);
+			d_data->headerPos = local.size();
+			d_data->headerSize = header.size();
+			if (d_data->file.write(local) != local.size() || d_data->file.write(header) != header.size()) {
+				setError("Unable to write in output file");
+				return;
+			}
+		}
+		else if (ar.shape() != d_data->shape) {
+			setError("Shape mismatch");
+			return;
+		}
+
+		const VipNDArray dense = denseArray(ar, d_data->format.type);
+		if (dense.isEmpty()) {
+			setError("Unable to convert input array");
+			return;
+		}
+
+		const char* data = static_cast<const char*>(dense.constData());
+		const qint64 bytes = (qint64)dense.size() * d_data->format.size;
+		if (d_data->file.write(data, bytes) != bytes) {
+			setError("Unable to write in output file");
+			return;
+		}
+		d_data->crc = crc32Update(d_data->crc, data, bytes);
+		d_data->dataBytes += bytes;
+		d_data->frames++;
+	}
+}
+
+void VipNPZDevice::close()
+{
+	// wait for the pending input frames
+	VipIODevice::close();
+
+	if (d_data->file.isOpen()) {
+		// patch the npy header with the final frame count, then write the zip central directory
+		const QByteArray header = npyHeader(d_data->format, d_data->frames, d_data->shape, d_data->headerSize);
+		const quint64 size = header.size() + d_data->dataBytes;
+		const quint32 crc = crc32Combine(crc32Update(0, header.data(), header.size()), d_data->crc, d_data->dataBytes);
+		const quint64 cd_offset = d_data->headerPos + size;
+
+		if (!writeAt(d_data->file, cd_offset, zipCentralDirectory(d_data->entry, crc, size, d_data->time, d_data->date, cd_offset)) ||
+		    !writeAt(d_data->file, 0, zipLocalHeader(d_data->entry, crc, size, d_data->time, d_data->date)) ||
+		    !writeAt(d_data->file, d_data->headerPos, header))
+			setError("Unable to write in output file");
+		d_data->file.close();
+	}
+
+	d_data->frames = 0;
+	d_data->dataBytes = 0;
+}
+
+/// Matlab v5 data types and flags used by VipMATDevice
+#define MAT_INT8 1
+#define MAT_INT32 5
+#define MAT_UINT32 6
+#define MAT_MATRIX 14
+#define MAT_COMPLEX_FLAG 0x0800
+#define MAT_LOGICAL_FLAG 0x0200
+
+template<class T>
+static void appendNative(QByteArray& ar, T value)
+{
+	ar.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// Split a Fortran-ordered complex array into its real and imaginary parts
+template<class T>
+static void splitComplex(const VipNDArray& ar, QByteArray& real, QByteArray& imag)
+{
+	const std::complex<T>* src = static_cast<const std::complex<T>*>(ar.constData());
+	real.resize(ar.size() * sizeof(T));
+	imag.resize(ar.size() * sizeof(T));
+	T* re = reinterpret_cast<T*>(real.data());
+	T* im = reinterpret_cast<T*>(imag.data());
+	for (qsizetype i = 0; i < ar.size(); ++i) {
+		re[i] = src[i].real();
+		im[i] = src[i].imag();
+	}
+}
+
+class VipMATDevice::PrivateData
+{
+public:
+	QFile file;
+	QTemporaryFile imag; // imaginary parts, appended to the file on close
+	ArrayFormat format;
+	VipNDArrayShape shape; // frame shape
+	qint64 frames{ 0 };
+	qint64 matrixPos{ 0 }; // position of the matrix element tag
+	qint64 dimsPos{ 0 };   // position of the frame count in the dimensions subelement
+	qint64 realPos{ 0 };   // position of the real part tag
+	qint64 dataBytes{ 0 }; // size of the real part
+};
+
+VipMATDevice::VipMATDevice(QObject* parent)
+  : VipIODevice(parent)
+{
+	VIP_CREATE_PRIVATE_DATA();
+}
+
+VipMATDevice::~VipMATDevice()
+{
+	close();
+}
+
+bool VipMATDevice::open(VipIODevice::OpenModes mode)
+{
+	if (mode != WriteOnly)
+		return false;
+
+	close();
+
+	QString p = removePrefix(path());
+	if (!p.endsWith(".mat"))
+		return false;
+
+	setOpenMode(mode);
+	return true;
+}
+
+void VipMATDevice::apply()
+{
+	while (inputAt(0)->hasNewData()) {
+		VipAnyData any = inputAt(0)->data();
+		VipNDArray ar = any.value<VipNDArray>();
+		if (ar.isEmpty()) {
+			setError("Empty input array");
+			return;
+		}
+
+		if (!d_data->file.isOpen()) {
+			// first frame: write the file header and the matrix element with placeholder sizes
+			d_data->format = arrayFormat(ar.dataType());
+			d_data->shape = ar.shape();
+			d_data->frames = 0;
+			d_data->dataBytes = 0;
+
+			d_data->file.setFileName(removePrefix(path()));
+			if (!d_data->file.open(QFile::WriteOnly) || (d_data->format.complex && !(d_data->imag.open() && d_data->imag.resize(0)))) {
+				setError("Unable to open output file " + d_data->file.fileName());
+				return;
+			}
+
+			QByteArray h = "MATLAB 5.0 MAT-file, Created on: " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss").toLatin1();
+			h = h.leftJustified(116, ' ', true);
+			h += QByteArray(8, 0); // subsystem data offset
+			appendNative<quint16>(h, 0x0100);
+			appendNative<quint16>(h, ('M' << 8) | 'I'); // endian indicator
+
+			d_data->matrixPos = h.size();
+			appendNative<quint32>(h, MAT_MATRIX);
+			appendNative<quint32>(h, 0);
+
+			// array flags
+			quint32 flags = d_data->format.mat_class;
+			if (d_data->format.complex)
+				flags |= MAT_COMPLEX_FLAG;
+			if (d_data->format.logical)
+				flags |= MAT_LOGICAL_FLAG;
+			appendNative<quint32>(h, MAT_UINT32);
+			appendNative<quint32>(h, 8);
+			appendNative<quint32>(h, flags);
+			appendNative<quint32>(h, 0);
+
+			// dimensions: frame dimensions followed by the frame count
+			appendNative<quint32>(h, MAT_INT32);
+			appendNative<quint32>(h, (quint32)(d_data->shape.size() + 1) * 4);
+			for (qsizetype i = 0; i < d_data->shape.size(); ++i)
+				appendNative<qint32>(h, (qint32)d_data->shape[i]);
+			d_data->dimsPos = h.size();
+			appendNative<qint32>(h, 0);
+			h += QByteArray((8 - h.size() % 8) % 8, 0);
+
+			// array name (Matlab names are limited to 63 characters)
+			const QByteArray name = arrayName(any.name()).toLatin1().left(63);
+			appendNative<quint32>(h, MAT_INT8);
+			appendNative<quint32>(h, (quint32)name.size());
+			h += name;
+			h += QByteArray((8 - h.size() % 8) % 8, 0);
+
+			// real part tag
+			d_data->realPos = h.size();
+			appendNative<quint32>(h, d_data->format.mat_type);
+			appendNative<quint32>(h, 0);
+
+			if (d_data->file.write(h) != h.size()) {
+				setError("Unable to write in output file");
+				return;
+			}
+		}
+		else if (ar.shape() != d_data->shape) {
+			setError("Shape mismatch");
+			return;
+		}
+
+		// Matlab arrays are column-major: each frame is transposed, and frames are stacked along the last dimension
+		const VipNDArray fortran = fortranArray(ar, d_data->format.type);
+		if (fortran.isEmpty()) {
+			setError("Unable to convert input array");
+			return;
+		}
+
+		const qint64 bytes = (qint64)fortran.size() * d_data->format.size / (d_data->format.complex ? 2 : 1);
+		const qint64 total = (d_data->dataBytes + bytes + 8) * (d_data->format.complex ? 2 : 1) + d_data->realPos - d_data->matrixPos;
+		if (total > 0xFFFFFFFFLL) {
+			setError("MAT files cannot store more than 4GB per array");
+			return;
+		}
+
+		bool ok = true;
+		if (d_data->format.complex) {
+			QByteArray re, im;
+			if (d_data->format.size == 8)
+				splitComplex<float>(fortran, re, im);
+			else
+				splitComplex<double>(fortran, re, im);
+			ok = d_data->file.write(re) == re.size() && d_data->imag.write(im) == im.size();
+		}
+		else
+			ok = d_data->file.write(static_cast<const char*>(fortran.constData()), bytes) == bytes;
+
+		if (!ok) {
+			setError("Unable to write in output file");
+			return;
+		}
+		d_data->dataBytes += bytes;
+		d_data->frames++;
+	}
+}
+
+void VipMATDevice::close()
+{
+	// wait for the pending input frames
+	VipIODevice::close();
+
+	if (d_data->file.isOpen()) {
+		QFile& file = d_data->file;
+		bool ok = writePadding(file, 8);
+
+		// append the imaginary part
+		if (ok && d_data->format.complex) {
+			QByteArray tag;
+			appendNative<quint32>(tag, d_data->format.mat_type);
+			appendNative<quint32>(tag, (quint32)d_data->dataBytes);
+			ok = file.write(tag) == tag.size() && d_data->imag.seek(0);
+			while (ok && !d_data->imag.atEnd()) {
+				const QByteArray chunk = d_data->imag.read(1 << 20);
+				ok = !chunk.isEmpty() && file.write(chunk) == chunk.size();
+			}
+			ok = ok && writePadding(file, 8);
+		}
+
+		// patch the matrix size, the frame count and the real part size
+		if (ok) {
+			QByteArray matrix_size, frames, real_size;
+			appendNative<quint32>(matrix_size, (quint32)(file.pos() - d_data->matrixPos - 8));
+			appendNative<qint32>(frames, (qint32)d_data->frames);
+			appendNative<quint32>(real_size, (quint32)d_data->dataBytes);
+			ok = writeAt(file, d_data->matrixPos + 4, matrix_size) && writeAt(file, d_data->dimsPos, frames) && writeAt(file, d_data->realPos + 4, real_size);
+		}
+		if (!ok)
+			setError("Unable to write in output file");
+
+		file.close();
+		d_data->imag.close();
+	}
+
+	d_data->frames = 0;
+	d_data->dataBytes = 0;
+}
@@ -29,29 +29,29 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef VIP_PY_NPZ_DEVICE
-#define VIP_PY_NPZ_DEVICE
+#ifndef VIP_NPZ_DEVICE
+#define VIP_NPZ_DEVICE
 
-#include "VipPyOperation.h"
 #include "VipIODevice.h"
 
 /// @brief Save 2D array objects in NPZ file format.
 ///
-/// VipPyNPZDevice will vertically stack all 2D arrays given as input,
-/// and save the 3D array in the close() member.
-/// 
+/// VipNPZDevice will vertically stack all 2D arrays given as input.
+/// Frames are streamed to the file as they arrive, and the array shape is
+/// patched in the close() member. This does not require the Python interpreter,
+/// and the memory footprint does not depend on the number of frames.
+///
 /// The array name in the NPZ file will  be 'arr_...'
 /// where '...' is deduced from input names.
 /// 
-/// 
-class VIP_CORE_EXPORT VipPyNPZDevice : public VipIODevice
+class VIP_CORE_EXPORT VipNPZDevice : public VipIODevice
 {
 	Q_OBJECT
 	VIP_IO(VipInput input)
 
 public:
-	VipPyNPZDevice(QObject* parent = nullptr);
-	~VipPyNPZDevice();
+	VipNPZDevice(QObject* parent = nullptr);
+	~VipNPZDevice();
 
 	virtual bool probe(const QString& filename, const QByteArray&) const { return supportFilename(filename) || VipIODevice::probe(filename); }
 	virtual bool acceptInput(int, const QVariant& v) const
@@ -67,7 +67,7 @@ public:
 	virtual bool open(VipIODevice::OpenModes mode);
 	virtual DeviceType deviceType() const { return Temporal; }
 	virtual VipIODevice::OpenModes supportedModes() const { return WriteOnly; }
-	virtual QString fileFilters() const { return "Python files (*.npz)"; }
+	virtual QString fileFilters() const { return "Numpy files (*.npz)"; }
 	virtual void close();
 
 protected:
@@ -77,22 +77,27 @@ private:
 	VIP_DECLARE_PRIVATE_DATA();
 };
 
-VIP_REGISTER_QOBJECT_METATYPE(VipPyNPZDevice*)
+VIP_REGISTER_QOBJECT_METATYPE(VipNPZDevice*)
 
 
 /// @brief Save 2D array objects in Matlab format.
 ///
-/// VipPyMATDevice behaves in the same way as VipPyNPZDevice,
-/// but save the resulting 3D array in a Matlab file.
+/// VipMATDevice behaves in the same way as VipNPZDevice,
+/// but save the resulting 3D array in a Matlab (v5) file.
+///
+/// Since Matlab arrays are column-major, frames are stacked along
+/// the last dimension: a sequence of N frames of shape (height, width)
+/// is saved as a height x width x N array.
+/// Matlab v5 files are limited to 4GB per array.
 ///
-class VIP_CORE_EXPORT VipPyMATDevice : public VipIODevice
+class VIP_CORE_EXPORT VipMATDevice : public VipIODevice
 {
 	Q_OBJECT
 	VIP_IO(VipInput input)
 
 public:
-	VipPyMATDevice(QObject* parent = nullptr);
-	~VipPyMATDevice();
+	VipMATDevice(QObject* parent = nullptr);
+	~VipMATDevice();
 
 	virtual bool probe(const QString& filename, const QByteArray&) const { return supportFilename(filename) || VipIODevice::probe(filename); }
 	virtual bool acceptInput(int, const QVariant& v) const
@@ -118,6 +123,6 @@ private:
 	VIP_DECLARE_PRIVATE_DATA();
 };
 
-VIP_REGISTER_QOBJECT_METATYPE(VipPyMATDevice*)
+VIP_REGISTER_QOBJECT_METATYPE(VipMATDevice*)
 
 #endif
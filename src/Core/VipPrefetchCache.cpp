@@ -0,0 +1,295 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "VipPrefetchCache.h"
+#include "VipIODevice.h"
+#include "VipCore.h"
+
+class VipPrefetchCache::PrivateData
+{
+public:
+	using Key = std::pair<VipIODevice*, qint64>;
+
+	struct Entry
+	{
+		VipAnyDataList data;
+		qint64 bytes;
+	};
+	struct Request
+	{
+		Key key;
+		quint64 generation;
+	};
+
+	std::mutex mutex;
+	std::condition_variable requestCond; // signaled on new requests and stop
+	std::condition_variable doneCond;    // signaled when a request is finished
+
+	std::deque<Request> queue;
+	std::set<Key> inProgress;
+	std::map<Key, Entry> cache;
+	std::vector<std::thread> threads;
+	quint64 generation{ 0 };
+	bool stop{ false };
+
+	qint64 maxMemory;
+	int threadCount;
+	qint64 cachedBytes{ 0 };
+	qint64 hits{ 0 };
+	qint64 misses{ 0 };
+	qint64 stallTime{ 0 };
+
+	void startThreads()
+	{
+		// called with the lock held
+		while ((int)threads.size() < threadCount)
+			threads.emplace_back([this]() { run(); });
+	}
+
+	void stopThreads()
+	{
+		{
+			std::lock_guard<std::mutex> ll(mutex);
+			stop = true;
+			queue.clear();
+		}
+		requestCond.notify_all();
+		for (std::thread& th : threads)
+			th.join();
+		threads.clear();
+		stop = false;
+	}
+
+	void run()
+	{
+		std::unique_lock<std::mutex> ll(mutex);
+		while (true) {
+			requestCond.wait(ll, [this]() { return stop || !queue.empty(); });
+			if (stop)
+				return;
+
+			Request req = queue.front();
+			queue.pop_front();
+
+			// drop the request if the memory budget is exhausted
+			if (cachedBytes >= maxMemory)
+				continue;
+
+			inProgress.insert(req.key);
+			ll.unlock();
+
+			VipAnyDataList data;
+			if (req.key.first->isOpen())
+				data = req.key.first->fetchData(req.key.second);
+
+			ll.lock();
+			inProgress.erase(req.key);
+			if (req.generation == generation && data.size() && cache.find(req.key) == cache.end()) {
+				qint64 bytes = 0;
+				for (const VipAnyData& d : data)
+					bytes += d.memoryFootprint();
+				cache[req.key] = Entry{ data, bytes };
+				cachedBytes += bytes;
+			}
+			doneCond.notify_all();
+		}
+	}
+
+	void removeQueued(VipIODevice* device)
+	{
+		queue.erase(std::remove_if(queue.begin(), queue.end(), [device](const Request& r) { return r.key.first == device; }), queue.end());
+	}
+
+	bool hasInProgress(VipIODevice* device) const
+	{
+		for (const Key& k : inProgress)
+			if (k.first == device)
+				return true;
+		return false;
+	}
+};
+
+VipPrefetchCache::VipPrefetchCache(qint64 max_memory, int thread_count)
+  : d_data(new PrivateData())
+{
+	d_data->maxMemory = max_memory;
+	d_data->threadCount = std::max(thread_count, 1);
+}
+
+VipPrefetchCache::~VipPrefetchCache()
+{
+	d_data->stopThreads();
+}
+
+void VipPrefetchCache::setMaxMemory(qint64 bytes)
+{
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	d_data->maxMemory = bytes;
+}
+qint64 VipPrefetchCache::maxMemory() const
+{
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	return d_data->maxMemory;
+}
+
+void VipPrefetchCache::setThreadCount(int count)
+{
+	count = std::max(count, 1);
+	{
+		std::lock_guard<std::mutex> ll(d_data->mutex);
+		if (count == d_data->threadCount)
+			return;
+		d_data->threadCount = count;
+		if (d_data->threads.empty())
+			return;
+	}
+	// restart the threads
+	d_data->stopThreads();
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	d_data->startThreads();
+}
+int VipPrefetchCache::threadCount() const
+{
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	return d_data->threadCount;
+}
+
+void VipPrefetchCache::prefetch(VipIODevice* device, const QVector<qint64>& device_times)
+{
+	{
+		std::lock_guard<std::mutex> ll(d_data->mutex);
+		d_data->startThreads();
+
+		// discard requests and cached data that are not wanted anymore
+		d_data->removeQueued(device);
+		for (auto it = d_data->cache.lower_bound(PrivateData::Key(device, std::numeric_limits<qint64>::min()));
+		     it != d_data->cache.end() && it->first.first == device;) {
+			if (!device_times.contains(it->first.second)) {
+				d_data->cachedBytes -= it->second.bytes;
+				it = d_data->cache.erase(it);
+			}
+			else
+				++it;
+		}
+
+		// queue the missing times
+		for (qint64 t : device_times) {
+			const PrivateData::Key key(device, t);
+			if (d_data->cache.find(key) == d_data->cache.end() && d_data->inProgress.find(key) == d_data->inProgress.end())
+				d_data->queue.push_back(PrivateData::Request{ key, d_data->generation });
+		}
+	}
+	d_data->requestCond.notify_all();
+}
+
+bool VipPrefetchCache::take(VipIODevice* device, qint64 device_time, VipAnyDataList& data)
+{
+	const PrivateData::Key key(device, device_time);
+	std::unique_lock<std::mutex> ll(d_data->mutex);
+
+	// the data is being read: wait for it
+	if (d_data->inProgress.find(key) != d_data->inProgress.end()) {
+		qint64 start = vipGetMilliSecondsSinceEpoch();
+		d_data->doneCond.wait(ll, [&]() { return d_data->inProgress.find(key) == d_data->inProgress.end(); });
+		d_data->stallTime += vipGetMilliSecondsSinceEpoch() - start;
+	}
+
+	auto it = d_data->cache.find(key);
+	if (it == d_data->cache.end()) {
+		// remove the queued request (if any) since the caller will read the data
+		d_data->queue.erase(
+		  std::remove_if(d_data->queue.begin(), d_data->queue.end(), [&key](const PrivateData::Request& r) { return r.key == key; }), d_data->queue.end());
+		++d_data->misses;
+		return false;
+	}
+
+	data = std::move(it->second.data);
+	d_data->cachedBytes -= it->second.bytes;
+	d_data->cache.erase(it);
+	++d_data->hits;
+	return true;
+}
+
+void VipPrefetchCache::addStallTime(qint64 milli)
+{
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	d_data->stallTime += milli;
+}
+
+void VipPrefetchCache::clear(VipIODevice* device)
+{
+	std::unique_lock<std::mutex> ll(d_data->mutex);
+	++d_data->generation;
+	d_data->removeQueued(device);
+	for (auto it = d_data->cache.lower_bound(PrivateData::Key(device, std::numeric_limits<qint64>::min())); it != d_data->cache.end() && it->first.first == device;) {
+		d_data->cachedBytes -= it->second.bytes;
+		it = d_data->cache.erase(it);
+	}
+	d_data->doneCond.wait(ll, [&]() { return !d_data->hasInProgress(device); });
+}
+
+void VipPrefetchCache::clear()
+{
+	std::unique_lock<std::mutex> ll(d_data->mutex);
+	++d_data->generation;
+	d_data->queue.clear();
+	d_data->cache.clear();
+	d_data->cachedBytes = 0;
+	d_data->doneCond.wait(ll, [&]() { return d_data->inProgress.empty(); });
+}
+
+VipPrefetchCache::Statistics VipPrefetchCache::statistics() const
+{
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	Statistics res;
+	res.hits = d_data->hits;
+	res.misses = d_data->misses;
+	res.stallTime = d_data->stallTime;
+	res.cachedBytes = d_data->cachedBytes;
+	res.pending = (qint64)(d_data->queue.size() + d_data->inProgress.size());
+	return res;
+}
+
+void VipPrefetchCache::resetStatistics()
+{
+	std::lock_guard<std::mutex> ll(d_data->mutex);
+	d_data->hits = d_data->misses = d_data->stallTime = 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef VIP_PREFETCH_CACHE_H
+#define VIP_PREFETCH_CACHE_H
+
+#include <memory>
+
+#include "VipProcessingObject.h"
+
+class VipIODevice;
+
+/// \addtogroup Core
+/// @{
+
+/// @brief Read-ahead cache of device data used by VipProcessingPool while playing.
+///
+/// VipPrefetchCache reads upcoming frames of temporal VipIODevice objects on background I/O threads
+/// using VipIODevice::fetchData(), and keeps them until they are consumed by VipIODevice::read().
+/// Only devices returning true from VipIODevice::supportPrefetch() are prefetched.
+///
+/// Each call to prefetch() defines the new list of wanted times for a device: queued requests and cached
+/// data outside this list are discarded, which invalidates the cache after a seek. The amount of cached data
+/// is bounded by maxMemory(): requests exceeding this budget are dropped.
+///
+/// VipPrefetchCache is thread safe. It is usually not used directly, but through VipProcessingPool::setPrefetchEnabled().
+class VIP_CORE_EXPORT VipPrefetchCache
+{
+public:
+	/// @brief Cache statistics
+	struct Statistics
+	{
+		qint64 hits = 0;	//! Number of reads served from the cache
+		qint64 misses = 0;	//! Number of reads that required a synchronous device read
+		qint64 stallTime = 0;	//! Total time in milliseconds spent waiting for device reads
+		qint64 cachedBytes = 0; //! Current memory footprint of cached data
+		qint64 pending = 0;	//! Number of queued or in progress requests
+
+		/// @brief Returns the ratio hits / (hits + misses)
+		double hitRate() const { return (hits + misses) ? double(hits) / double(hits + misses) : 0.; }
+	};
+
+	VipPrefetchCache(qint64 max_memory = 256000000, int thread_count = 2);
+	~VipPrefetchCache();
+
+	VipPrefetchCache(const VipPrefetchCache&) = delete;
+	VipPrefetchCache& operator=(const VipPrefetchCache&) = delete;
+
+	/// @brief Set/get the maximum memory footprint in bytes of cached data
+	void setMaxMemory(qint64 bytes);
+	qint64 maxMemory() const;
+
+	/// @brief Set/get the number of background I/O threads (at least 1)
+	void setThreadCount(int count);
+	int threadCount() const;
+
+	/// @brief Request the prefetching of given device times, ordered by priority.
+	/// Queued requests and cached data of this device for other times are discarded.
+	void prefetch(VipIODevice* device, const QVector<qint64>& device_times);
+
+	/// @brief Retrieve and remove the prefetched data for given device and device time.
+	/// If the data is currently being read by a background thread, wait for it.
+	/// Returns false if the data is not available, in which case the caller should read it synchronously
+	/// and report the time spent with addStallTime().
+	bool take(VipIODevice* device, qint64 device_time, VipAnyDataList& data);
+
+	/// @brief Add a stall time in milliseconds to the statistics
+	void addStallTime(qint64 milli);
+
+	/// @brief Discard all requests and cached data of given device, and wait for the device reads in progress.
+	/// After this call, the device can be safely closed or destroyed.
+	void clear(VipIODevice* device);
+	/// @brief Discard all requests and cached data, and wait for the device reads in progress
+	void clear();
+
+	/// @brief Returns the cache statistics
+	Statistics statistics() const;
+	/// @brief Reset hits, misses and stall time
+	void resetStatistics();
+
+private:
+	class PrivateData;
+	std::unique_ptr<PrivateData> d_data;
+};
+
+/// @}
+// end Core
+
+#endif
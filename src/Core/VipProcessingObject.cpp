@@ -31,6 +31,10 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <QDateTime>
@@ -879,6 +883,11 @@ void VipInput::setListType(VipDataList::Type t, int list_limit_type, int max_lis
 		m_input_list = QSharedPointer<VipDataList>(new VipLIFOList());
 	else if (t == VipDataList::LastAvailable)
 		m_input_list = QSharedPointer<VipDataList>(new VipLastAvailableList());
+	else if (t == VipDataList::RingBuffer) {
+		// The cells are preallocated: only size the ring after the Number limit if it is an actual bound (the default limit is INT_MAX)
+		const bool bounded = (list_limit_type & VipDataList::Number) && max_list_size <= VipRingBufferList::MaxCapacity;
+		m_input_list = QSharedPointer<VipDataList>(new VipRingBufferList(bounded ? max_list_size : VipRingBufferList::DefaultCapacity));
+	}
 
 	m_input_list->setListLimitType(list_limit_type);
 	m_input_list->setMaxListSize(max_list_size);
@@ -1070,6 +1079,7 @@ public:
 	  , _max_list_size(INT_MAX)
 	  , _max_list_memory(50000000)
 	  , _lock_list_manager(false)
+	  , shared_executor(false)
 	  , list_limit_type(_list_limit_type)
 	  , max_list_size(_max_list_size)
 	  , max_list_memory(_max_list_memory)
@@ -1088,6 +1098,7 @@ public:
 	int _max_list_memory;
 	QSet<int> _log_errors;
 	bool _lock_list_manager;
+	std::atomic<bool> shared_executor;
 
 	QMutex mutex;
 	int list_limit_type;
@@ -1252,6 +1263,17 @@ void VipProcessingManager::setMaxListMemory(int size)
 	Q_EMIT instance().changed();
 }
 
+void VipProcessingManager::setSharedExecutorEnabled(bool enable)
+{
+	instance().d_data->shared_executor.store(enable);
+	Q_EMIT instance().changed();
+}
+
+bool VipProcessingManager::sharedExecutorEnabled()
+{
+	return instance().d_data->shared_executor.load(std::memory_order_relaxed);
+}
+
 int VipProcessingManager::listLimitType()
 {
 	return instance().d_data->list_limit_type;
@@ -1765,6 +1787,281 @@ void VipLastAvailableList::clear()
 	m_has_new_data = false;
 }
 
+// The ring buffer is a bounded MPMC queue based on per-cell sequence numbers (D. Vyukov design).
+// The consumer side is shared by the owning processing (next(), readAll()) and by producers dropping the oldest data.
+// probe() and time() read the front cell without removing it: they increment the cell readers count
+// so that a concurrent pop waits for them before moving the cell content.
+
+VipRingBufferList::VipRingBufferList(int capacity)
+  : VipDataList()
+  , m_enqueue_pos(0)
+  , m_dequeue_pos(0)
+  , m_count(0)
+  , m_bytes(0)
+{
+	size_t cap = 2;
+	while (cap < (size_t)capacity)
+		cap *= 2;
+	m_mask = cap - 1;
+	m_cells.reset(new Cell[cap]);
+	for (size_t i = 0; i < cap; ++i) {
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		m_cells[i].readers.store(0, std::memory_order_relaxed);
+		m_cells[i].footprint.store(0, std::memory_order_relaxed);
+	}
+}
+
+VipRingBufferList::~VipRingBufferList() {}
+
+void VipRingBufferList::checkCapacity()
+{
+	// the cells cannot be reallocated while producers and consumer access them, so reject larger sizes
+	if ((listLimitType() & Number) && maxListSize() > capacity()) {
+		// do not warn for the default unbounded size
+		if (maxListSize() != INT_MAX)
+			VIP_LOG_WARNING("Ring buffer input list: maximum list size " + QString::number(maxListSize()) + " reduced to the ring capacity " + QString::number(capacity()));
+		VipDataList::setMaxListSize(capacity());
+	}
+}
+
+void VipRingBufferList::setMaxListSize(int size)
+{
+	VipDataList::setMaxListSize(size);
+	checkCapacity();
+}
+
+void VipRingBufferList::setListLimitType(int type)
+{
+	VipDataList::setListLimitType(type);
+	checkCapacity();
+}
+
+bool VipRingBufferList::tryPush(VipAnyData& data, int footprint)
+{
+	size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell& cell = m_cells[pos & m_mask];
+		const size_t seq = cell.sequence.load(std::memory_order_acquire);
+		const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+		if (diff == 0) {
+			if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell.data = std::move(data);
+				cell.footprint.store(footprint, std::memory_order_relaxed);
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+			// full
+			return false;
+		else
+			pos = m_enqueue_pos.load(std::memory_order_relaxed);
+	}
+}
+
+bool VipRingBufferList::tryPop(VipAnyData* data, size_t expected_pos)
+{
+	size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+	for (;;) {
+		if (expected_pos != size_t(-1) && pos != expected_pos)
+			// the front cell was already removed
+			return false;
+
+		Cell& cell = m_cells[pos & m_mask];
+		const size_t seq = cell.sequence.load(std::memory_order_acquire);
+		const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+		if (diff == 0) {
+			if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1)) {
+				// wait for probe() readers
+				while (cell.readers.load() > 0)
+					std::this_thread::yield();
+
+				m_bytes.fetch_sub(cell.footprint.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				m_count.fetch_sub(1, std::memory_order_relaxed);
+				if (data)
+					*data = std::move(cell.data);
+				cell.data = VipAnyData();
+				cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+			// empty
+			return false;
+		else
+			pos = m_dequeue_pos.load(std::memory_order_relaxed);
+	}
+}
+
+bool VipRingBufferList::tryProbe(VipAnyData& data) const
+{
+	for (;;) {
+		const size_t pos = m_dequeue_pos.load();
+		const Cell& cell = m_cells[pos & m_mask];
+		if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+			return false;
+
+		const_cast<Cell&>(cell).readers.fetch_add(1);
+		// check that the cell was not popped in the meantime
+		if (m_dequeue_pos.load() == pos && cell.sequence.load(std::memory_order_acquire) == pos + 1) {
+			data = cell.data;
+			const_cast<Cell&>(cell).readers.fetch_sub(1);
+			return true;
+		}
+		const_cast<Cell&>(cell).readers.fetch_sub(1);
+	}
+}
+
+void VipRingBufferList::applyLimits()
+{
+	const int limits = listLimitType();
+	if (limits & Number) {
+		while (m_count.load(std::memory_order_relaxed) > this->maxListSize())
+			if (!tryPop(nullptr))
+				break;
+	}
+	if (limits & MemorySize) {
+		// Same behavior as VipFIFOList: keep the most recent data whose cumulated footprint
+		// just exceeds the maximum memory.
+		for (;;) {
+			const size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			const Cell& cell = m_cells[pos & m_mask];
+			if (m_count.load(std::memory_order_relaxed) < 2 || cell.sequence.load(std::memory_order_acquire) != pos + 1)
+				break;
+			const qint64 remaining = m_bytes.load(std::memory_order_relaxed) - cell.footprint.load(std::memory_order_relaxed);
+			if (remaining < maxListMemory())
+				break;
+			tryPop(nullptr, pos);
+		}
+	}
+}
+
+int VipRingBufferList::pushInternal(VipAnyData& data, int* previous)
+{
+	const int footprint = data.memoryFootprint();
+	if (previous)
+		*previous = m_count.load(std::memory_order_relaxed);
+
+	m_bytes.fetch_add(footprint, std::memory_order_relaxed);
+	while (!tryPush(data, footprint)) {
+		// full ring buffer: drop the oldest data
+		tryPop(nullptr);
+	}
+	m_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (listLimitType())
+		applyLimits();
+	return m_count.load(std::memory_order_relaxed);
+}
+
+int VipRingBufferList::push(const VipAnyData& data, int* previous)
+{
+	VipAnyData tmp = data;
+	return pushInternal(tmp, previous);
+}
+
+int VipRingBufferList::push(VipAnyData&& data, int* previous)
+{
+	return pushInternal(data, previous);
+}
+
+void VipRingBufferList::reset(const VipAnyData& data)
+{
+	clear();
+	push(data);
+}
+
+void VipRingBufferList::reset(VipAnyData&& data)
+{
+	clear();
+	push(std::move(data));
+}
+
+VipAnyData VipRingBufferList::next()
+{
+	VipAnyData res;
+	VipUniqueLock<VipSpinlock> lock(m_last_mutex);
+	if (tryPop(&res))
+		m_last = res;
+	else
+		res = m_last;
+	return res;
+}
+
+bool VipRingBufferList::readAll(VipAnyDataList& lst)
+{
+	int count = m_count.load(std::memory_order_relaxed);
+	if (count <= 0)
+		return false;
+
+	lst.clear();
+	lst.reserve(count);
+	VipAnyData tmp;
+	while (tryPop(&tmp))
+		lst.push_back(std::move(tmp));
+	if (lst.isEmpty())
+		return false;
+
+	VipUniqueLock<VipSpinlock> lock(m_last_mutex);
+	m_last = lst.back();
+	return true;
+}
+
+VipAnyData VipRingBufferList::probe()
+{
+	VipAnyData res;
+	if (tryProbe(res))
+		return res;
+	VipUniqueLock<VipSpinlock> lock(m_last_mutex);
+	return m_last;
+}
+
+qint64 VipRingBufferList::time() const
+{
+	VipAnyData res;
+	if (tryProbe(res))
+		return res.time();
+	VipUniqueLock<VipSpinlock> lock(const_cast<VipSpinlock&>(m_last_mutex));
+	return m_last.isValid() ? m_last.time() : VipInvalidTime;
+}
+
+bool VipRingBufferList::empty() const
+{
+	if (m_count.load(std::memory_order_relaxed) > 0)
+		return false;
+	VipUniqueLock<VipSpinlock> lock(const_cast<VipSpinlock&>(m_last_mutex));
+	return !m_last.isValid();
+}
+
+bool VipRingBufferList::hasNewData() const
+{
+	return m_count.load(std::memory_order_relaxed) > 0;
+}
+
+int VipRingBufferList::status() const
+{
+	const int count = m_count.load(std::memory_order_relaxed);
+	if (count > 0)
+		return count;
+	return empty() ? -1 : 0;
+}
+
+int VipRingBufferList::remaining() const
+{
+	return std::max(0, m_count.load(std::memory_order_relaxed));
+}
+
+int VipRingBufferList::memoryFootprint() const
+{
+	return (int)m_bytes.load(std::memory_order_relaxed);
+}
+
+void VipRingBufferList::clear()
+{
+	while (tryPop(nullptr))
+		;
+}
+
 class MyLock
 {
 	std::atomic<bool> d_lock{ false };
@@ -1883,13 +2180,85 @@ struct MutexLocker
 	void wait_for(UniqueLock&, unsigned ms) { d_cond.wait(&d_lock, ms); }
 };
 
+class TaskPool;
+
+/// @brief ProcessingExecutor is a work-stealing thread pool shared by all asynchronous VipProcessingObject.
+///
+/// It is only used when VipProcessingManager::sharedExecutorEnabled() is true. In this case, asynchronous
+/// processings do not own a dedicated thread anymore: their TaskPool is scheduled on one of the executor workers
+/// (one worker per core by default).
+///
+/// Each worker owns a queue per thread priority. A worker first pops its own queues (highest priority first),
+/// then steals from the other workers queues. A TaskPool is present at most once in the executor, and runs its
+/// processing under VipProcessingObject::runLock(), so apply() and resetProcessing() of a same object never run concurrently.
+///
+class ProcessingExecutor
+{
+	struct Worker : QThread
+	{
+		ProcessingExecutor* parent;
+		int index;
+		Worker(ProcessingExecutor* p, int idx)
+		  : parent(p)
+		  , index(idx)
+		{
+		}
+
+	protected:
+		virtual void run() { parent->run(index); }
+	};
+
+	// Priorities are QThread::Priority values without InheritPriority
+	static constexpr int PriorityCount = QThread::TimeCriticalPriority + 1;
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<TaskPool*> tasks[PriorityCount];
+	};
+
+	std::vector<std::unique_ptr<Queue>> m_queues;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::atomic<int> m_pending{ 0 };
+	std::atomic<unsigned> m_next{ 0 };
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_sleep;
+	bool m_stop{ false };
+
+	static int& workerIndex()
+	{
+		static thread_local int index = -1;
+		return index;
+	}
+
+	TaskPool* pop(int index);
+	void run(int index);
+
+public:
+	ProcessingExecutor(int threads);
+	~ProcessingExecutor();
+
+	/// @brief Returns the global executor, created on first call
+	static ProcessingExecutor& instance();
+
+	/// @brief Schedule a TaskPool with given priority
+	void schedule(TaskPool* pool, int priority);
+
+	int threadCount() const { return (int)m_workers.size(); }
+};
+
 /// @brief TaskPool is a thread that asynchronously executes VipProcessingObject::run().
 ///
 /// When a VipProcessingObject is Asynchronous, it uses internally a TaskPool to schedule its processing.
 /// QThreadPool is not used due to observed dead locks in certain situations.
 ///
+/// If the TaskPool is created in shared mode (see VipProcessingManager::setSharedExecutorEnabled()),
+/// it does not own a thread and is scheduled on the global ProcessingExecutor instead.
+///
 class TaskPool
 {
+	friend class ProcessingExecutor;
+
 	struct Thread : QThread
 	{
 		TaskPool* parent;
@@ -1909,27 +2278,66 @@ class TaskPool
 	std::atomic<int> m_run;
 	std::atomic<bool> m_clear{ false };
 	VipProcessingObject* m_parent;
-	Thread m_thread;
+	std::unique_ptr<Thread> m_thread;
 	bool m_stop;
+
+	// shared mode only
+	std::atomic<int> m_priority{ QThread::NormalPriority };
+	std::atomic<int> m_in_executor{ 0 };
+	std::atomic<bool> m_parked{ false }; // waiting for the parent run lock
+
+	// scheduling latency statistics
+	std::atomic<qint64> m_push_time{ 0 };
+	std::atomic<qint64> m_latency{ 0 };
+
 	void atomWait(UniqueLock& ll, int milli);
+	void schedule();
+	void updateLatency();
+	int runBatch();
+	void runShared();
+	static qint64 now() noexcept { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
 
 protected:
 	void run();
 
 public:
-	/// @brief Construct from a parent object and a thread priority
-	TaskPool(VipProcessingObject* parent = nullptr, QThread::Priority p = QThread::InheritPriority);
+	/// @brief Construct from a parent object and a thread priority.
+	/// If shared is true, the TaskPool is scheduled on the global ProcessingExecutor.
+	TaskPool(VipProcessingObject* parent = nullptr, QThread::Priority p = QThread::InheritPriority, bool shared = false);
 	~TaskPool();
 
 	/// @brief Schedule a VipProcessingObject launch
 	VIP_ALWAYS_INLINE void push()
 	{
-		if (m_run.fetch_add(1) == 0)
-			lock.notify_all();
+		if (m_run.fetch_add(1) == 0) {
+			m_push_time.store(now(), std::memory_order_relaxed);
+			if (m_thread)
+				lock.notify_all();
+			else
+				schedule();
+		}
 	}
 
-	void setPriority(QThread::Priority p) { m_thread.setPriority(p); }
-	QThread::Priority priority() const { return m_thread.priority(); }
+	/// @brief Reschedule the TaskPool if it was parked waiting for the parent run lock.
+	/// Must be called after releasing VipProcessingObject::runLock().
+	VIP_ALWAYS_INLINE void unpark()
+	{
+		if (m_thread)
+			return;
+		// pairs with the store in runShared(): either the parked flag is seen here, or the released lock is seen there
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_parked.load(std::memory_order_relaxed) && m_parked.exchange(false))
+			ProcessingExecutor::instance().schedule(this, m_priority.load(std::memory_order_relaxed));
+	}
+
+	void setPriority(QThread::Priority p);
+	QThread::Priority priority() const;
+
+	/// @brief Returns true if this TaskPool is scheduled on the global ProcessingExecutor
+	bool isShared() const noexcept { return !m_thread; }
+
+	/// @brief Returns the averaged latency in nanoseconds between a push() and the start of the corresponding processing
+	qint64 latency() const noexcept { return m_latency.load(std::memory_order_relaxed); }
 
 	/// @brief Wait until the task list is empty or until timeout
 	bool waitForDone(int milli = -1);
@@ -1942,6 +2350,217 @@ public:
 	void clearNoLock() { clear(); }
 };
 
+ProcessingExecutor::ProcessingExecutor(int threads)
+{
+	threads = std::max(threads, 1);
+	for (int i = 0; i < threads; ++i)
+		m_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+	for (int i = 0; i < threads; ++i) {
+		m_workers.push_back(std::unique_ptr<Worker>(new Worker(this, i)));
+		m_workers.back()->start();
+	}
+}
+
+ProcessingExecutor::~ProcessingExecutor()
+{
+	{
+		std::lock_guard<std::mutex> ll(m_sleep_mutex);
+		m_stop = true;
+	}
+	m_sleep.notify_all();
+	for (size_t i = 0; i < m_workers.size(); ++i)
+		m_workers[i]->wait();
+}
+
+ProcessingExecutor& ProcessingExecutor::instance()
+{
+	// The executor is never destroyed: TaskPool objects might be deleted after static destruction,
+	// and they need the workers to release their pending tasks.
+	static ProcessingExecutor* inst = new ProcessingExecutor(std::max(QThread::idealThreadCount(), 2));
+	return *inst;
+}
+
+int VipProcessingManager::sharedExecutorThreadCount()
+{
+	return ProcessingExecutor::instance().threadCount();
+}
+
+void ProcessingExecutor::schedule(TaskPool* pool, int priority)
+{
+	if (priority < 0 || priority >= PriorityCount)
+		priority = QThread::NormalPriority;
+
+	// Push to the calling worker queue (better cache locality for processing chains),
+	// or to the next queue in a round robin fashion for external threads.
+	int index = workerIndex();
+	if (index < 0)
+		index = (int)(m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+
+	{
+		Queue& q = *m_queues[index];
+		std::lock_guard<std::mutex> ll(q.mutex);
+		q.tasks[priority].push_back(pool);
+	}
+	m_pending.fetch_add(1);
+
+	// Wake up a sleeping worker
+	{
+		std::lock_guard<std::mutex> ll(m_sleep_mutex);
+	}
+	m_sleep.notify_one();
+}
+
+TaskPool* ProcessingExecutor::pop(int index)
+{
+	const int count = (int)m_queues.size();
+	for (int prio = PriorityCount - 1; prio >= 0; --prio) {
+		// first look into our own queue (FIFO order)
+		{
+			Queue& q = *m_queues[index];
+			std::lock_guard<std::mutex> ll(q.mutex);
+			if (!q.tasks[prio].empty()) {
+				TaskPool* p = q.tasks[prio].front();
+				q.tasks[prio].pop_front();
+				m_pending.fetch_sub(1);
+				return p;
+			}
+		}
+		// steal from other queues, starting from the back
+		for (int i = 1; i < count; ++i) {
+			Queue& q = *m_queues[(index + i) % count];
+			std::unique_lock<std::mutex> ll(q.mutex, std::try_to_lock);
+			if (ll.owns_lock() && !q.tasks[prio].empty()) {
+				TaskPool* p = q.tasks[prio].back();
+				q.tasks[prio].pop_back();
+				m_pending.fetch_sub(1);
+				return p;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void ProcessingExecutor::run(int index)
+{
+	workerIndex() = index;
+	int current_priority = QThread::InheritPriority;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> ll(m_sleep_mutex);
+			m_sleep.wait(ll, [this]() { return m_stop || m_pending.load() > 0; });
+			if (m_stop)
+				return;
+		}
+
+		TaskPool* p = pop(index);
+		if (!p) {
+			// A queue was busy while stealing (m_pending is decremented under the queue lock, so the task is still there).
+			// Sleep until the next schedule() instead of spinning, the timeout covers the busy queue case.
+			std::unique_lock<std::mutex> ll(m_sleep_mutex);
+			m_sleep.wait_for(ll, std::chrono::milliseconds(1));
+			continue;
+		}
+
+		// Apply the TaskPool priority to the worker
+		int prio = p->m_priority.load(std::memory_order_relaxed);
+		if (prio != current_priority) {
+			current_priority = prio;
+			QThread::currentThread()->setPriority((QThread::Priority)prio);
+		}
+
+		p->runShared();
+	}
+}
+
+void TaskPool::schedule()
+{
+	m_in_executor.fetch_add(1);
+	ProcessingExecutor::instance().schedule(this, m_priority.load(std::memory_order_relaxed));
+}
+
+void TaskPool::updateLatency()
+{
+	// exponential moving average of the scheduling latency
+	qint64 lat = now() - m_push_time.load(std::memory_order_relaxed);
+	qint64 prev = m_latency.load(std::memory_order_relaxed);
+	m_latency.store(prev == 0 ? lat : (prev * 7 + lat) / 8, std::memory_order_relaxed);
+}
+
+int TaskPool::runBatch()
+{
+	// Run all scheduled processing, must be called with the parent run lock held.
+	// Returns the number of consumed tasks.
+	int count = m_run.load(std::memory_order_relaxed);
+	int saved = count;
+	updateLatency();
+	while (!m_stop && count-- && !m_clear.load(std::memory_order_relaxed)) {
+		try {
+			// Avoid exiting task pool thread on unhandled exception
+			m_parent->runNoLock();
+		}
+		catch (const std::exception& e) {
+			if (VipProcessingObject* o = qobject_cast<VipProcessingObject*>(m_parent))
+				o->setError("Unhandled exception: " + QString(e.what()));
+			else
+				qWarning() << "Unhandled exception: " << e.what() << "\n";
+		}
+		catch (...) {
+			if (VipProcessingObject* o = qobject_cast<VipProcessingObject*>(m_parent))
+				o->setError("Unhandled unknown exception");
+			else
+				qWarning() << "Unhandled unknown exception\n";
+		}
+	}
+	return saved;
+}
+
+void TaskPool::runShared()
+{
+	int remaining = 0;
+	if (!m_stop) {
+		// Do not block the worker if the processing is already running in another thread (direct call to run() or reset()):
+		// park the TaskPool, it is rescheduled by unpark() when the run lock is released.
+		if (!m_parent->runLock().try_lock()) {
+			m_parked.store(true);
+			if (!m_parent->runLock().try_lock())
+				return;
+			// the lock was released in the meantime
+			if (!m_parked.exchange(false)) {
+				// already rescheduled by unpark()
+				m_parent->runLock().unlock();
+				return;
+			}
+		}
+		int saved;
+		{
+			std::unique_lock<VipSpinlock> ll(m_parent->runLock(), std::adopt_lock_t{});
+			saved = runBatch();
+		}
+		// On clear(), only drop the tasks counted by runBatch(): storing 0 would erase concurrent push() calls
+		if (VIP_UNLIKELY(m_clear.load(std::memory_order_relaxed)))
+			m_clear.store(false);
+		remaining = m_run.fetch_sub(saved) - saved;
+	}
+	else
+		m_run.store(0);
+
+	if (remaining > 0 && !m_stop) {
+		{
+			auto ll = lock.lock();
+			lock.notify_all();
+		}
+		// new data arrived in the meantime: go back to the end of the queue
+		ProcessingExecutor::instance().schedule(this, m_priority.load(std::memory_order_relaxed));
+	}
+	else {
+		// last access to this object
+		auto ll = lock.lock();
+		m_in_executor.fetch_sub(1);
+		lock.notify_all();
+	}
+}
+
 void TaskPool::run()
 {
 	// notify that the thread started
@@ -1961,35 +2580,14 @@ void TaskPool::run()
 			lock.notify_all();
 		}
 
-		int count = m_run.load(std::memory_order_relaxed);
-		int saved = count;
+		int saved = 0;
 		if (!m_stop) {
 			SPIN_LOCK(m_parent->runLock());
-			while (!m_stop && count-- && !m_clear.load(std::memory_order_relaxed)) {
-				try {
-					// Avoid exiting task pool thread on unhandled exception
-					m_parent->runNoLock();
-				}
-				catch (const std::exception& e) {
-					if (VipProcessingObject* o = qobject_cast<VipProcessingObject*>(m_parent))
-						o->setError("Unhandled exception: " + QString(e.what()));
-					else
-						qWarning() << "Unhandled exception: " << e.what() << "\n";
-				}
-				catch (...) {
-					if (VipProcessingObject* o = qobject_cast<VipProcessingObject*>(m_parent))
-						o->setError("Unhandled unknown exception");
-					else
-						qWarning() << "Unhandled unknown exception\n";
-				}
-			}
+			saved = runBatch();
 		}
-		if (VIP_UNLIKELY(m_clear.load(std::memory_order_relaxed))) {
-			m_run.store(0);
+		if (VIP_UNLIKELY(m_clear.load(std::memory_order_relaxed)))
 			m_clear.store(false);
-		}
-		else
-			m_run.fetch_sub(saved);
+		m_run.fetch_sub(saved);
 
 		lock.notify_all();
 	}
@@ -1997,22 +2595,55 @@ void TaskPool::run()
 	lock.notify_all();
 }
 
-TaskPool::TaskPool(VipProcessingObject* parent, QThread::Priority p)
+TaskPool::TaskPool(VipProcessingObject* parent, QThread::Priority p, bool shared)
   : m_run(0)
   , m_parent(parent)
-  , m_thread(this)
   , m_stop(false)
 {
+	if (shared) {
+		if (p != QThread::InheritPriority && p != QThread::IdlePriority)
+			m_priority.store(p);
+		return;
+	}
+
+	m_thread.reset(new Thread(this));
 	auto ll = lock.lock();
-	m_thread.start(p);
+	m_thread->start(p);
 	lock.wait(ll);
 }
 
 TaskPool::~TaskPool()
 {
 	m_stop = true;
-	lock.notify_all();
-	m_thread.wait();
+	if (m_thread) {
+		lock.notify_all();
+		m_thread->wait();
+	}
+	else {
+		// a parked TaskPool is not referenced by the executor anymore
+		if (m_parked.exchange(false))
+			m_in_executor.fetch_sub(1);
+
+		// wait for the executor to release this TaskPool
+		auto ll = lock.lock();
+		while (m_in_executor.load() > 0)
+			lock.wait(ll);
+	}
+}
+
+void TaskPool::setPriority(QThread::Priority p)
+{
+	if (m_thread)
+		m_thread->setPriority(p);
+	else if (p != QThread::InheritPriority && p != QThread::IdlePriority)
+		m_priority.store(p);
+}
+
+QThread::Priority TaskPool::priority() const
+{
+	if (m_thread)
+		return m_thread->priority();
+	return (QThread::Priority)m_priority.load(std::memory_order_relaxed);
 }
 
 void TaskPool::atomWait(UniqueLock& ll, int milli)
@@ -2170,7 +2801,10 @@ public:
 	{
 		TaskPool* p = nullptr;
 		QThread::Priority prio = thread_priority == 0 ? (QThread::Priority)VipProcessingManager::instance().defaultPriority(_this->metaObject()) : (QThread::Priority)thread_priority;
-		TaskPool* _new = new TaskPool(_this, prio);
+		// Only asynchronous processings can use the shared executor:
+		// synchronous threaded processings must always run in the same thread.
+		bool shared = VipProcessingManager::sharedExecutorEnabled() && (parameters.schedule_strategies & Asynchronous);
+		TaskPool* _new = new TaskPool(_this, prio, shared);
 
 		if (!pool.compare_exchange_strong(p, _new)) {
 			delete _new;
@@ -2400,6 +3034,14 @@ VipProcessingPool* VipProcessingObject::parentObjectPool() const
 	return qobject_cast<VipProcessingPool*>(parent());
 }
 
+VipNDArray VipProcessingObject::createFrame(int data_type, const VipNDArrayShape& shape) const
+{
+	if (VipProcessingPool* pool = parentObjectPool())
+		if (VipFrameBufferPool* frames = pool->frameBufferPool())
+			return frames->allocate(data_type, shape);
+	return VipNDArray(data_type, shape);
+}
+
 QList<VipProcessingObject*> VipProcessingObject::directSources() const
 {
 	initialize();
@@ -3286,9 +3928,14 @@ void VipProcessingObject::resetProcessing() {}
 
 void VipProcessingObject::reset()
 {
-	SPIN_LOCK(d_data->run_mutex);
-	this->resetError();
-	this->resetProcessing();
+	{
+		SPIN_LOCK(d_data->run_mutex);
+		this->resetError();
+		this->resetProcessing();
+	}
+	// wake up the shared executor task waiting for the run lock
+	if (TaskPool* p = d_data->getPool())
+		p->unpark();
 }
 
 bool VipProcessingObject::isUpdating() const
@@ -3409,6 +4056,13 @@ int VipProcessingObject::scheduledUpdates() const
 	return 0;
 }
 
+qint64 VipProcessingObject::schedulingLatency() const
+{
+	if (const TaskPool* p = d_data->getPool())
+		return p->latency();
+	return 0;
+}
+
 void VipProcessingObject::emitProcessingChanged()
 {
 	Q_EMIT processingChanged(this);
@@ -3457,9 +4111,14 @@ VipAnyDataList VipProcessingObject::allInputs()
 
 void VipProcessingObject::run()
 {
-	// lock to avoid concurrent calls
-	SPIN_LOCK(d_data->run_mutex);
-	runNoLock();
+	{
+		// lock to avoid concurrent calls
+		SPIN_LOCK(d_data->run_mutex);
+		runNoLock();
+	}
+	// wake up the shared executor task waiting for the run lock
+	if (TaskPool* p = d_data->getPool())
+		p->unpark();
 }
 VipSpinlock& VipProcessingObject::runLock() noexcept
 {
@@ -4910,6 +5569,15 @@ void serialize_VipDataListManager(VipArchive& arch)
 			else
 				arch.restore();
 
+			arch.save();
+			bool sharedExecutor = false;
+			if (arch.content("sharedExecutor", sharedExecutor)) {
+				if (!VipProcessingManager::instance().d_data->_lock_list_manager)
+					VipProcessingManager::setSharedExecutorEnabled(sharedExecutor);
+			}
+			else
+				arch.restore();
+
 			int limit_type = arch.read("listLimitType").toInt();
 			int max_list_size = arch.read("maxListSize").toInt();
 			int max_memory = arch.read("maxListMemory").toInt();
@@ -4933,6 +5601,7 @@ void serialize_VipDataListManager(VipArchive& arch)
 	else if (arch.mode() == VipArchive::Write) {
 		if (arch.start("VipProcessingManager")) {
 			arch.content("arrayThreads", vipIterateThreadCount());
+			arch.content("sharedExecutor", VipProcessingManager::sharedExecutorEnabled());
 			arch.content("listLimitType", VipProcessingManager::listLimitType());
 			arch.content("maxListSize", VipProcessingManager::maxListSize());
 			arch.content("maxListMemory", VipProcessingManager::maxListMemory());
@@ -32,7 +32,9 @@
 #ifndef VIP_PROCESSING_OBJECT_H
 #define VIP_PROCESSING_OBJECT_H
 
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <type_traits>
 
 #include <QIcon>
@@ -309,6 +311,17 @@ public:
 	/// Error management for all processings
 	static QSet<int> logErrors();
 
+	/// @brief Enable/disable the shared executor for asynchronous processings (disabled by default).
+	/// When enabled, asynchronous VipProcessingObject do not own a dedicated thread anymore, but are scheduled
+	/// on a global work-stealing thread pool sized to the number of cores. The processing thread priority and
+	/// the SkipIfBusy strategy are still honored, and apply()/resetProcessing() of a same object never run concurrently.
+	/// This only affects processing objects scheduled for the first time after this call.
+	static void setSharedExecutorEnabled(bool enable);
+	/// @brief Returns true if the shared executor is enabled
+	static bool sharedExecutorEnabled();
+	/// @brief Returns the number of worker threads of the shared executor
+	static int sharedExecutorThreadCount();
+
 	/// Lock the VipProcessingManager settings so that it cannot be loaded from a session file. The parameters can still be modified through the
 	/// related functions. This is usefull when setting the parameters in a plugin and you don't want them to be overwritten when loading the last session.
 	static void setLocked(bool locked);
@@ -351,11 +364,12 @@ public:
 		NULLType,     //! nullptr list
 		FIFO,	      //! A First In First Out list
 		LIFO,	      //! A Last In First Out list
-		LastAvailable //! Always returns the last data
+		LastAvailable, //! Always returns the last data
+		RingBuffer     //! A lock-free, bounded First In First Out list
 	};
 
 	/// This enum describes which kind of unit is used to determine the input list maximum size.
-	/// This is currently only used by VipFIFOList and VipLIFOList
+	/// This is currently only used by VipFIFOList, VipLIFOList and VipRingBufferList
 	enum DataLimitType
 	{
 		None = 0,	  //! The list does not have a maximum size
@@ -404,12 +418,12 @@ public:
 	virtual int memoryFootprint() const = 0;
 
 	/// Set the maximum list size
-	void setMaxListSize(int size) { m_max_size = size; }
+	virtual void setMaxListSize(int size) { m_max_size = size; }
 	/// Set the maximum list memory footprint
 	void setMaxListMemory(int memory) { m_max_memory = memory; }
 
 	/// Set the list limit type (combination of Number and MemorySize, or None)
-	void setListLimitType(int type) { m_data_limit_type = type; }
+	virtual void setListLimitType(int type) { m_data_limit_type = type; }
 	/// Returns the list limit type
 	int listLimitType() const { return m_data_limit_type; }
 
@@ -507,6 +521,75 @@ public:
 	virtual void clear();
 };
 
+/// @brief A lock-free, bounded FIFO VipDataList
+///
+/// VipRingBufferList is a ring buffer of fixed capacity (rounded up to a power of 2) that can be fed by multiple producers
+/// and consumed by a single VipProcessingObject without taking any lock in push(), next() and readAll().
+/// The list keeps a running count of its memory footprint, so that push(), next() and the memory limit check are all O(1).
+///
+/// Like VipFIFOList, the oldest data are dropped when the Number or MemorySize limits are reached.
+/// The oldest data is also dropped when pushing into a full ring buffer, whatever the list limit type.
+/// The capacity cannot change after construction: a Number limit above the capacity is reduced to the capacity with a warning.
+/// VipInput sizes the ring after its Number limit when it is at most MaxCapacity, and uses DefaultCapacity otherwise
+/// (including the default INT_MAX limit), so that the cells are not preallocated for an unbounded list.
+class VIP_CORE_EXPORT VipRingBufferList : public VipDataList
+{
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		std::atomic<int> readers;
+		std::atomic<int> footprint;
+		VipAnyData data;
+	};
+
+	std::unique_ptr<Cell[]> m_cells;
+	size_t m_mask;
+	alignas(64) std::atomic<size_t> m_enqueue_pos;
+	alignas(64) std::atomic<size_t> m_dequeue_pos;
+	alignas(64) std::atomic<int> m_count;
+	std::atomic<qint64> m_bytes;
+
+	VipAnyData m_last;
+	VipSpinlock m_last_mutex;
+
+	bool tryPush(VipAnyData& data, int footprint);
+	bool tryPop(VipAnyData* data, size_t expected_pos = size_t(-1));
+	bool tryProbe(VipAnyData& data) const;
+	int pushInternal(VipAnyData& data, int* previous);
+	void applyLimits();
+	void checkCapacity();
+
+public:
+	/// @brief Default ring buffer capacity
+	static constexpr int DefaultCapacity = 1024;
+	/// @brief Maximum ring buffer capacity
+	static constexpr int MaxCapacity = 1 << 16;
+
+	VipRingBufferList(int capacity = DefaultCapacity);
+	~VipRingBufferList();
+	/// @brief Returns the ring buffer capacity
+	int capacity() const noexcept { return (int)(m_mask + 1); }
+
+	virtual void setMaxListSize(int size);
+	virtual void setListLimitType(int type);
+
+	virtual int push(const VipAnyData&, int* previous = nullptr);
+	virtual int push(VipAnyData&&, int* previous = nullptr);
+	virtual void reset(const VipAnyData&);
+	virtual void reset(VipAnyData&&);
+	virtual VipAnyData next();
+	virtual bool readAll(VipAnyDataList& lst);
+	virtual VipAnyData probe();
+	virtual qint64 time() const;
+	virtual bool empty() const;
+	virtual bool hasNewData() const;
+	virtual int status() const;
+	virtual VipDataList::Type listType() const { return RingBuffer; }
+	virtual int remaining() const;
+	virtual int memoryFootprint() const;
+	virtual void clear();
+};
+
 // Forward declarations
 class UniqueProcessingIO;
 class VipInput;
@@ -1424,7 +1507,7 @@ Q_DECLARE_METATYPE(VipMultiOutput)
 /// on the strategy flags. If the processing execution is not fast enough compared to the pace at which its inputs
 /// are set, the input data are buffered in each VipInput buffer (VipDataList object) and processing executions are
 /// scheduled inside the internal task pool. By default, each input uses a VipFIFOList, but the buffer type can be set
-/// to VipLIFOList or VipLastAvailableList (no buffering, always use the last data).
+/// to VipLIFOList, VipLastAvailableList (no buffering, always use the last data) or VipRingBufferList (lock-free bounded FIFO).
 ///
 /// Each input buffer can have a maximum size based either on a number of inputs or on the size in Bytes of buffered
 /// inputs. Use VipDataList::setMaxListSize(), VipDataList::setMaxListMemory() and VipDataList::setListLimitType()
@@ -1587,6 +1670,10 @@ public:
 
 	/// @brief Returns the parent VipProcessingPool, if any
 	VipProcessingPool* parentObjectPool() const;
+	/// @brief Allocate a dense, uninitialized output array of given type and shape.
+	/// If the parent VipProcessingPool has its frame buffer pool enabled, the array buffer is drawn from it
+	/// (see VipProcessingPool::setFrameBufferPoolEnabled()). Otherwise, this is equivalent to VipNDArray(data_type, shape).
+	VipNDArray createFrame(int data_type, const VipNDArrayShape& shape) const;
 	/// @brief Returns the direct VipProcessingObject sources for this processing.
 	/// The direct sources are all VipProcessingObject with at least on output connected to one of this processing's inputs.
 	virtual QList<VipProcessingObject*> directSources() const;
@@ -1901,6 +1988,9 @@ public:
 
 	/// @brief Returns the number of pending processing in the TaskPool
 	int scheduledUpdates() const;
+	/// @brief Returns the averaged latency in nanoseconds between the scheduling of a processing and its actual start.
+	/// Only relevant for threaded processings, returns 0 otherwise.
+	qint64 schedulingLatency() const;
 
 	/// @brief Retrieve the number of inputs, properties and/or outputs that declares a given QMetaObject.
 	/// The QMetaObject must be related to a class inheriting VipProcessingObject.
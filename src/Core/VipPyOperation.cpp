@@ -241,6 +241,75 @@ int vipQtToNumpy(int type)
 	return -1;
 }
 
+// Name of the capsules holding a VipNDArray used as base object of numpy arrays
+static const char* _vip_array_capsule = "VipNDArray";
+
+static void deleteArrayCapsule(PyObject* capsule)
+{
+	delete static_cast<VipNDArray*>(PyCapsule_GetPointer(capsule, _vip_array_capsule));
+}
+
+// Wrap a dense standard VipNDArray into a read-only numpy array sharing its data.
+// The numpy array keeps a reference to the VipNDArray handle through a capsule base object.
+// Since VipNDArray uses copy on write, the shared data will never be modified from the C++ side.
+static PyObject* shareToNumpy(const VipNDArray& ar, int numpy_type)
+{
+	std::vector<npy_intp> shape(ar.shape().begin(), ar.shape().end());
+	VipNDArray* owner = new VipNDArray(ar);
+	PyObject* res = PyArray_SimpleNewFromData((int)shape.size(), shape.data(), numpy_type, const_cast<void*>(owner->constData()));
+	if (!res) {
+		delete owner;
+		return nullptr;
+	}
+	PyObject* capsule = PyCapsule_New(owner, _vip_array_capsule, deleteArrayCapsule);
+	if (!capsule) {
+		delete owner;
+		Py_DECREF(res);
+		return nullptr;
+	}
+	// steals the capsule reference, even on failure
+	if (PyArray_SetBaseObject((PyArrayObject*)res, capsule) < 0) {
+		Py_DECREF(res);
+		return nullptr;
+	}
+	PyArray_CLEARFLAGS((PyArrayObject*)res, NPY_ARRAY_WRITEABLE);
+	return res;
+}
+
+// Returns the VipNDArray owning the data of a numpy array created with shareToNumpy() (possibly through views), or nullptr
+static const VipNDArray* sharedArrayOwner(PyArrayObject* array)
+{
+	PyObject* base = PyArray_BASE(array);
+	while (base && PyArray_Check(base))
+		base = PyArray_BASE((PyArrayObject*)base);
+	if (base && PyCapsule_IsValid(base, _vip_array_capsule))
+		return static_cast<const VipNDArray*>(PyCapsule_GetPointer(base, _vip_array_capsule));
+	return nullptr;
+}
+
+// Create a VipNDArray pointing to the data of a C-contiguous numpy array.
+// The standard handle keeps a reference to the numpy array, released (with the GIL) when the handle is destroyed.
+// The handle is the only owner of the data on the C++ side, so writes through the VipNDArray modify the numpy buffer:
+// only use it for numpy arrays that cannot be accessed from anywhere else.
+static VipNDArray shareFromNumpy(PyArrayObject* array, int type, const VipNDArrayShape& shape)
+{
+	PyObject* obj = (PyObject*)array;
+	Py_INCREF(obj);
+	VipSharedHandle h = vipCreateArrayHandle(VipNDArrayHandle::Standard, type, PyArray_DATA(array), shape, [obj](void*) {
+		if (__python_closed)
+			return;
+		VipGILLocker lock;
+		Py_DECREF(obj);
+	});
+	if (h->handleType() == VipNDArrayHandle::Null) {
+		Py_DECREF(obj);
+		return VipNDArray();
+	}
+	return VipNDArray(h);
+}
+
+static VipNDArray fromNumpyArray(void* obj, bool owned);
+
 // Vector of Python to QVariant converters
 static QVector<python_to_variant>& getToVariant()
 {
@@ -413,7 +482,7 @@ static QVariant stdToVariant(void* pyobject)
 		PyObject* new_object = PyArray_FromAny(res_object, nullptr, 0, 0, NPY_ARRAY_ENSUREARRAY | NPY_ARRAY_C_CONTIGUOUS, nullptr);
 		if (new_object) {
 			// res = QVariant::fromValue(PyNDArray(new_object).copy());
-			res = QVariant::fromValue(vipFromNumpyArray(new_object));
+			res = QVariant::fromValue(fromNumpyArray(new_object, true));
 			Py_DECREF(new_object);
 		}
 	}
@@ -541,27 +610,25 @@ static void* stdToPython(const QVariant& obj)
 
 			if (info.isRGB() && info.shapeCount() == 2) {
 				// convert QImage to 3 dims array
-				npy_intp shape[20] = { info.shape(0),info.shape(1), 3 };
-				std::vector<uchar> image(info.size() * 3);
-				const uint* pixels = (const uint*)info.constData();
-				for (int i = 0; i < info.size(); ++i) {
-					image[i * 3] = qRed(pixels[i]);
-					image[i * 3 + 1] = qGreen(pixels[i]);
-					image[i * 3 + 2] = qBlue(pixels[i]);
+				const VipNDArray dense = info.dense();
+				VipNDArray image(QMetaType::UChar, vipVector(info.shape(0), info.shape(1), 3));
+				uchar* pix = (uchar*)image.data();
+				const uint* pixels = (const uint*)dense.constData();
+				for (qsizetype i = 0; i < dense.size(); ++i) {
+					pix[i * 3] = qRed(pixels[i]);
+					pix[i * 3 + 1] = qGreen(pixels[i]);
+					pix[i * 3 + 2] = qBlue(pixels[i]);
 				}
-				PyObject* ref = PyArray_SimpleNewFromData(3, shape, NPY_UBYTE, (void*)image.data());
-				obj_object = PyArray_NewCopy((PyArrayObject*)ref, NPY_CORDER);
-				Py_DECREF(ref);
+				obj_object = shareToNumpy(image, NPY_UBYTE);
 			}
 			else {
 				int numpy_type = vipQtToNumpy(info.dataType());
-				if (numpy_type >= 0 && info.data()) {
-					npy_intp shape[20];
-					std::copy(info.shape().begin(), info.shape().end(), shape);
-					int nd = info.shape().size();
-					PyObject* ref = PyArray_SimpleNewFromData(nd, shape, numpy_type, (void*)info.constData());
-					obj_object = PyArray_NewCopy((PyArrayObject*)ref, NPY_CORDER);
-					Py_DECREF(ref);
+				if (numpy_type >= 0 && info.constData()) {
+					// share the data of dense arrays, copy the others only once
+					if (info.constHandle()->handleType() == VipNDArrayHandle::Standard && info.isUnstrided())
+						obj_object = shareToNumpy(info, numpy_type);
+					else
+						obj_object = shareToNumpy(info.copy(), numpy_type);
 				}
 			}
 		}
@@ -1342,7 +1409,10 @@ VipGILLocker::~VipGILLocker()
 		PyEval_SaveThread();
 }
 
-VipNDArray vipFromNumpyArray(void* obj)
+// Convert a numpy array to VipNDArray.
+// If \a owned is true, the caller holds the only reference to \a obj (like a PyArray_FromAny() result) and releases it afterward,
+// so its buffer can be shared instead of copied.
+static VipNDArray fromNumpyArray(void* obj, bool owned)
 {
 	PyArrayObject* array = (PyArrayObject*)obj;
 	if (obj && PyArray_Check((PyObject*)obj)) {
@@ -1370,11 +1440,31 @@ VipNDArray vipFromNumpyArray(void* obj)
 
 		void* opaque = PyArray_DATA(array);
 
+		// zero copy for aligned C-contiguous arrays whose data cannot be modified from Python afterward
+		if (ndims && PyArray_ISCARRAY_RO(array) && PyArray_ISNOTSWAPPED(array) && PyArray_ITEMSIZE(array) == QMetaType(type).sizeOf()) {
+			// data owned by a VipNDArray sent to Python: share its handle (copy on write).
+			// Views on a part of its data are copied, since a new handle would not detach on write.
+			if (const VipNDArray* owner = sharedArrayOwner(array)) {
+				if (owner->constData() == opaque && owner->dataType() == type && owner->shape() == shape)
+					return *owner;
+			}
+			// temporary Python array only referenced by the caller, which releases it afterward
+			else if (owned && PyArray_CHKFLAGS(array, NPY_ARRAY_OWNDATA) && Py_REFCNT((PyObject*)obj) == 1) {
+				PyArray_CLEARFLAGS(array, NPY_ARRAY_WRITEABLE);
+				return shareFromNumpy(array, type, shape);
+			}
+		}
+
 		return VipNDArray::makeView(opaque, type, shape, strides).copy();
 	}
 	return VipNDArray();
 }
 
+VipNDArray vipFromNumpyArray(void* obj)
+{
+	return fromNumpyArray(obj, false);
+}
+
 void VipPyLocal::writeBytesFromProcess()
 {
 	if (QProcess* p = qobject_cast<QProcess*>(sender())) {
@@ -69,6 +69,8 @@ VIP_CORE_EXPORT void vipRegisterToPythonConverter(variant_to_python);
 VIP_CORE_EXPORT QVariant vipPythonToVariant(void*);
 /// @brief Convert a QVariant to a PyObject*  based on registered converters.
 /// Default converter manages numeric, complex, string, byte and numpy array objects.
+/// VipNDArray objects are converted to read-only numpy arrays sharing the array data (no copy).
+/// Python code must therefore copy these arrays before modifying them in place.
 /// The GIL must be held.
 VIP_CORE_EXPORT void* vipVariantToPython(const QVariant&);
 /// @brief Convert numpy type to Qt meta type id
@@ -76,6 +78,8 @@ VIP_CORE_EXPORT int vipNumpyToQt(int);
 /// @brief Convert Qt meta type id to numpy type
 VIP_CORE_EXPORT int vipQtToNumpy(int);
 /// @brief Convert numpy_array to VipNDArray. The GIL must be held.
+/// C-contiguous arrays created by vipVariantToPython() share the original VipNDArray data without copy.
+/// Other arrays are copied, and numpy_array is never modified.
 VIP_CORE_EXPORT VipNDArray vipFromNumpyArray(void* numpy_array);
 /// @brief Convert any Python object to string. The GIL must be held.
 VIP_CORE_EXPORT QString vipFromPyString(void* obj);
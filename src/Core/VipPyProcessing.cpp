@@ -58,6 +58,7 @@ extern "C" {
 #include "VipArchive.h"
 
 #include <QPointer>
+#include <QDateTime>
 #include <qcoreapplication.h>
 
 static int registerPyProcessingPtr()
@@ -67,6 +68,49 @@ static int registerPyProcessingPtr()
 }
 static int _registerPyProcessingPtr = vipStaticInit("registerPyProcessingPtr",registerPyProcessingPtr);
 
+class VipPyBaseProcessing::PrivateData
+{
+public:
+	PrivateData()
+	  : batchSize(1)
+	  , maxBatchLatency(100)
+	  , frameCost(0)
+	{
+	}
+	int batchSize;
+	int maxBatchLatency;
+	double frameCost; // average processing time per frame in batch mode (ms)
+};
+
+VipPyBaseProcessing::VipPyBaseProcessing(QObject* parent)
+  : VipBaseDataFusion(parent)
+{
+	VIP_CREATE_PRIVATE_DATA();
+}
+
+VipPyBaseProcessing::~VipPyBaseProcessing() {}
+
+void VipPyBaseProcessing::setBatchSize(int count)
+{
+	d_data->batchSize = std::max(count, 1);
+	d_data->frameCost = 0;
+	emitProcessingChanged();
+}
+int VipPyBaseProcessing::batchSize() const
+{
+	return d_data->batchSize;
+}
+
+void VipPyBaseProcessing::setMaxBatchLatency(int milli)
+{
+	d_data->maxBatchLatency = milli;
+	emitProcessingChanged();
+}
+int VipPyBaseProcessing::maxBatchLatency() const
+{
+	return d_data->maxBatchLatency;
+}
+
 void VipPyBaseProcessing::newError(const VipErrorData& error)
 {
 	VipBaseDataFusion::newError(error);
@@ -74,6 +118,108 @@ void VipPyBaseProcessing::newError(const VipErrorData& error)
 		QMetaObject::invokeMethod(interp, "showAndRaise", Qt::QueuedConnection);
 }
 
+static bool sameFrameLayout(const VipAnyData& a, const VipAnyData& b)
+{
+	if (b.data().userType() != qMetaTypeId<VipNDArray>())
+		return false;
+	const VipNDArray ar1 = a.value<VipNDArray>();
+	const VipNDArray ar2 = b.value<VipNDArray>();
+	return ar1.dataType() == ar2.dataType() && ar1.shape() == ar2.shape();
+}
+
+void VipPyBaseProcessing::apply()
+{
+	VipInput* in = inputCount() == 1 ? inputAt(0) : nullptr;
+	if (d_data->batchSize < 2 || !in || !supportBatch()) {
+		VipBaseDataFusion::apply();
+		return;
+	}
+
+	// the processing is scheduled once per input frame, but a previous batch might have drained them all.
+	// Do not process the last frame again.
+	if (!in->hasNewData()) {
+		excludeFromProcessingRateComputation();
+		return;
+	}
+
+	const VipAnyData first = in->probe();
+	const VipNDArray ar = first.value<VipNDArray>();
+	if (first.data().userType() != qMetaTypeId<VipNDArray>() || ar.isEmpty() || !(ar.isNumeric() || ar.isComplex())) {
+		VipBaseDataFusion::apply();
+		return;
+	}
+
+	// compute the maximum batch size based on the latency cap
+	int max_count = d_data->batchSize;
+	if (d_data->maxBatchLatency > 0 && d_data->frameCost > 0)
+		max_count = qBound(1, (int)(d_data->maxBatchLatency / d_data->frameCost), max_count);
+
+	// drain pending frames with the same shape and type.
+	// Only FIFO lists provide the frames in the right order.
+	VipAnyDataList frames;
+	frames.append(in->data());
+	const bool fifo = in->listType() == VipDataList::FIFO || in->listType() == VipDataList::RingBuffer;
+	while (fifo && frames.size() < max_count && in->buffer()->remaining() > 0) {
+		if (!sameFrameLayout(frames.first(), in->probe()))
+			break;
+		frames.append(in->data());
+	}
+
+	// build the stacked array and times
+	const VipNDArrayShape sh = ar.shape();
+	VipNDArrayShape stack_shape;
+	stack_shape.push_back(frames.size());
+	for (qsizetype s : sh)
+		stack_shape.push_back(s);
+	VipNDArray stack(ar.dataType(), stack_shape);
+	VipNDArrayType<qint64> times(vipVector(frames.size()));
+	uchar* ptr = (uchar*)stack.data();
+	const qsizetype frame_bytes = ar.size() * stack.dataSize();
+	for (int i = 0; i < frames.size(); ++i) {
+		VipNDArray slot = VipNDArray::makeView(ptr + i * frame_bytes, stack.dataType(), sh);
+		frames[i].value<VipNDArray>().convert(slot);
+		times(vipVector(i)) = frames[i].time();
+	}
+
+	qint64 start = QDateTime::currentMSecsSinceEpoch();
+	applyBatch(frames, stack, times);
+	double cost = (QDateTime::currentMSecsSinceEpoch() - start) / (double)frames.size();
+	d_data->frameCost = d_data->frameCost > 0 ? d_data->frameCost * 0.7 + cost * 0.3 : cost;
+}
+
+void VipPyBaseProcessing::applyBatch(const VipAnyDataList&, const VipNDArray&, const VipNDArray&)
+{
+	setError("batch mode not supported by this processing");
+}
+
+bool VipPyBaseProcessing::setBatchOutputs(const VipAnyDataList& frames, const VipNDArray& stack, const QVariantMap& attributes, const QVariantList& units)
+{
+	if (stack.shapeCount() < 2 || stack.shape(0) != frames.size()) {
+		setError("wrong batch result (should be an array of " + QString::number(frames.size()) + " frames)", WrongInput);
+		return false;
+	}
+
+	const VipNDArray dense = stack.dense();
+	VipNDArrayShape sh;
+	for (int i = 1; i < dense.shapeCount(); ++i)
+		sh.push_back(dense.shape(i));
+	const qsizetype frame_bytes = (dense.size() / frames.size()) * dense.dataSize();
+	const uchar* ptr = (const uchar*)dense.constData();
+	for (int i = 0; i < frames.size(); ++i) {
+		const VipNDArray frame = VipNDArray::makeView(const_cast<uchar*>(ptr + i * frame_bytes), dense.dataType(), sh).copy();
+		VipAnyData out = VipProcessingObject::create(QVariant::fromValue(frame), frames[i].attributes());
+		out.setTime(frames[i].time());
+		out.mergeAttributes(attributes);
+		if (units.size() > 2) {
+			out.setXUnit(units[0].toString());
+			out.setYUnit(units[1].toString());
+			out.setZUnit(units[2].toString());
+		}
+		outputAt(0)->setData(out);
+	}
+	return true;
+}
+
 class VipPyFunctionProcessing::PrivateData
 {
 public:
@@ -213,6 +359,49 @@ void VipPyFunctionProcessing::mergeData(int, int)
 	outputAt(0)->setData(out);
 }
 
+void VipPyFunctionProcessing::applyBatch(const VipAnyDataList& frames, const VipNDArray& stack, const VipNDArray& times)
+{
+	if (!d_data->function) {
+		setBatchOutputs(frames, stack);
+		return;
+	}
+
+	// send function
+	{
+		VipGILLocker lock;
+		PyObject* __main__ = PyImport_ImportModule("__main__");
+		PyObject* globals = PyModule_GetDict(__main__);
+		Py_DECREF(__main__);
+		if (PyDict_SetItemString(globals, "fun", d_data->function) != 0) {
+			d_data->lastError = VipPyError(compute_error_t{});
+			setError("cannot send objects to the Python interpreter", VipProcessingObject::WrongInput);
+			return;
+		}
+	}
+
+	const VipAnyData& first = frames.first();
+	QStringList units = QStringList() << first.xUnit() << first.yUnit() << first.zUnit();
+
+	VipPyCommandList cmds;
+	cmds << vipCSendObject("names", QStringList() << first.name()) << vipCSendObject("units", units) << vipCSendObject("input_count", 1)
+	     << vipCSendObject("this", QVariant::fromValue(stack)) << vipCSendObject("time", QVariant::fromValue(times)) << vipCSendObject("batch_count", frames.size())
+	     << vipCSendObject("attributes", first.attributes()) << vipCSendObject("stylesheet", QString()) << vipCExecCode("this = fun(this)", "code")
+	     << vipCRetrieveObject("units") << vipCRetrieveObject("this") << vipCRetrieveObject("stylesheet");
+	QVariant ret = VipPyInterpreter::instance()->sendCommands(cmds).value(int(d_data->maxExecutionTime * frames.size()));
+
+	d_data->lastError = ret.value<VipPyError>();
+	if (!d_data->lastError.isNull()) {
+		vip_debug("err: %s\n", d_data->lastError.traceback.toLatin1().data());
+		setError(d_data->lastError.traceback);
+		return;
+	}
+
+	const QVariantMap out_vars = ret.value<QVariantMap>();
+	QVariantMap attributes;
+	attributes["stylesheet"] = out_vars["stylesheet"].toString();
+	setBatchOutputs(frames, out_vars["this"].value<VipNDArray>(), attributes, out_vars["units"].value<QVariantList>());
+}
+
 class VipPyProcessing::PrivateData
 {
 public:
@@ -762,12 +951,58 @@ void VipPyProcessing::mergeData(int, int)
 	d_data->lastExecutedCode = code;
 }
 
+bool VipPyProcessing::supportBatch() const
+{
+	// Python processing classes inheriting 'ThermavipPyProcessing' work frame by frame
+	return d_data->std_proc_name.isEmpty() && d_data->initialize.toString().isEmpty();
+}
+
+void VipPyProcessing::applyBatch(const VipAnyDataList& frames, const VipNDArray& stack, const VipNDArray& times)
+{
+	const VipAnyData& first = frames.first();
+	const QString name = first.name();
+
+	VipPyCommandList cmds;
+	cmds << vipCSendObject("units", QStringList() << first.xUnit() << first.yUnit() << first.zUnit());
+	cmds << vipCSendObject("names", QStringList() << name);
+	cmds << vipCSendObject("time", QVariant::fromValue(times));
+	cmds << vipCSendObject("batch_count", frames.size());
+	cmds << vipCSendObject("input_count", 1);
+	cmds << vipCSendObject("stylesheet", QString());
+	cmds << vipCSendObject("name", name);
+	cmds << vipCSendObject("attributes", first.attributes());
+	cmds << vipCSendObject("this", QVariant::fromValue(stack));
+
+	// execute actual processing code
+	QString code = propertyAt(1)->data().value<QString>();
+	cmds << vipCExecCode(code, "code");
+	cmds << vipCRetrieveObject("this");
+	cmds << vipCRetrieveObject("units");
+	cmds << vipCRetrieveObject("stylesheet");
+	cmds << vipCRetrieveObject("attributes");
+
+	QVariant res = VipPyInterpreter::instance()->sendCommands(cmds).value(int(d_data->maxExecutionTime * frames.size()));
+	d_data->lastError = res.value<VipPyError>();
+	if (!d_data->lastError.isNull()) {
+		vip_debug("err: %s\n", d_data->lastError.traceback.toLatin1().data());
+		setError(d_data->lastError.traceback);
+		return;
+	}
+
+	const QVariantMap map = res.value<QVariantMap>();
+	QVariantMap attributes = map["attributes"].value<QVariantMap>();
+	attributes["stylesheet"] = map["stylesheet"].toString();
+	if (setBatchOutputs(frames, map["this"].value<VipNDArray>(), attributes, map["units"].value<QVariantList>()))
+		d_data->lastExecutedCode = code;
+}
 
 VipArchive& operator<<(VipArchive& ar, VipPyProcessing* p)
 {
 	ar.content("maxExecutionTime", p->maxExecutionTime());
 	ar.content("stdPyProcessingFile", p->stdPyProcessingFile());
 	ar.content("stdProcessingParameters", p->stdProcessingParameters());
+	ar.content("batchSize", p->batchSize());
+	ar.content("maxBatchLatency", p->maxBatchLatency());
 	return ar;
 }
 
@@ -777,6 +1012,17 @@ VipArchive& operator>>(VipArchive& ar, VipPyProcessing* p)
 	p->setStdPyProcessingFile(ar.read("stdPyProcessingFile").toString());
 	p->setStdProcessingParameters(ar.read("stdProcessingParameters").value<QVariantMap>());
 
+	// batch mode parameters (not present in older sessions)
+	int batchSize = 1, maxBatchLatency = 100;
+	ar.save();
+	if (ar.content("batchSize", batchSize)) {
+		ar.content("maxBatchLatency", maxBatchLatency);
+		p->setBatchSize(batchSize);
+		p->setMaxBatchLatency(maxBatchLatency);
+	}
+	else
+		ar.restore();
+
 	QVariantMap std = p->stdProcessingParameters();
 	VipOtherPlayerData data;
 	for (QVariantMap::iterator it = std.begin(); it != std.end(); ++it) {
@@ -37,23 +37,65 @@
 
 /// @brief Base class for Python processings.
 ///
-/// The only interest of this class is to make sure that
-/// all Python errors will be displayed in the global
-/// Python shell.
+/// This class makes sure that all Python errors will be displayed
+/// in the global Python shell.
 /// Sub classes must reimplement mergeData() function.
 ///
+/// VipPyBaseProcessing also provides an optional batch mode (disabled by default).
+/// When the batch size is greater than 1 and the processing has a single VipNDArray input,
+/// up to batchSize() pending frames are drained from the input buffer (FIFO or ring buffer)
+/// and processed in one Python call through applyBatch(). The frames are sent as a single stacked
+/// array of shape (count, ...) along with a vector of times, and the Python code must return
+/// an array with the same first dimension. This removes most of the per-frame overhead
+/// (GIL acquisition, variables transfer) for cheap vectorized Python code.
+///
+/// The number of frames in a batch is also limited by maxBatchLatency(): the batch size is
+/// reduced so that the estimated batch execution time stays below this value, which keeps
+/// live displays refreshing.
+///
+/// Sub classes supporting batch mode must reimplement applyBatch() and supportBatch().
+///
 class VIP_CORE_EXPORT VipPyBaseProcessing : public VipBaseDataFusion
 {
 	Q_OBJECT
 public:
-	VipPyBaseProcessing(QObject* parent = nullptr)
-	  : VipBaseDataFusion(parent)
-	{
-	}
+	VipPyBaseProcessing(QObject* parent = nullptr);
+	~VipPyBaseProcessing();
+
+	/// @brief Set/get the maximum number of frames processed in one Python call.
+	/// A value below 2 disables the batch mode (default).
+	void setBatchSize(int count);
+	int batchSize() const;
+
+	/// @brief Set/get the maximum time in milliseconds spent to process one batch (default to 100ms).
+	/// A value <= 0 disables the latency cap.
+	void setMaxBatchLatency(int milli);
+	int maxBatchLatency() const;
 
 protected:
 	/// @brief Reimplemented from VipProcessingObject
 	virtual void newError(const VipErrorData& error);
+	/// @brief Reimplemented from VipBaseDataFusion, drain the input buffer in batch mode
+	virtual void apply();
+
+	/// @brief Returns true if the processing can currently work in batch mode
+	virtual bool supportBatch() const { return false; }
+	/// @brief Process a batch of frames of same shape and type.
+	/// \a stack is the stacked input array and \a times the input times.
+	/// Sub classes must call setBatchOutputs() with the stacked result.
+	virtual void applyBatch(const VipAnyDataList& frames, const VipNDArray& stack, const VipNDArray& times);
+
+	/// @brief Split \a stack along its first dimension and set one output data per frame.
+	/// The output times and attributes are those of the corresponding input frames, merged with \a attributes.
+	/// If \a units contains at least 3 values, they are used as X, Y and Z units of all outputs.
+	/// Returns false if the stack does not contain one element per input frame.
+	bool setBatchOutputs(const VipAnyDataList& frames,
+			     const VipNDArray& stack,
+			     const QVariantMap& attributes = QVariantMap(),
+			     const QVariantList& units = QVariantList());
+
+private:
+	VIP_DECLARE_PRIVATE_DATA();
 };
 
 /// @biref Processing with one input and output that applies a python function.
@@ -89,6 +131,9 @@ public:
 
 protected:
 	virtual void mergeData(int, int);
+	virtual bool supportBatch() const { return true; }
+	/// @brief In batch mode, the function is called once with the stacked input frames
+	virtual void applyBatch(const VipAnyDataList& frames, const VipNDArray& stack, const VipNDArray& times);
 
 private:
 	VIP_DECLARE_PRIVATE_DATA();
@@ -111,6 +156,11 @@ private:
 /// -	'input_count': number of inputs
 /// -	'this': input value (if one input), or list of inputs values.
 ///
+/// In batch mode (see VipPyBaseProcessing::setBatchSize()), 'this' is a stacked array
+/// of shape (batch_count, ...), 'time' is an array of batch_count times and the additional variable
+/// 'batch_count' is exported. The code must set 'this' to an array of batch_count frames.
+/// Batch mode is not used for Python processing classes inheriting ThermavipPyProcessing.
+///
 /// A usefull VipPyProcessing can be resitered using registerThisProcessing()
 /// to make it available as a global processing object within Thermavip.
 /// Registered VipPyProcessing are serialized/deserialized on Thermavip
@@ -216,6 +266,8 @@ public:
 
 protected:
 	virtual void mergeData(int, int);
+	virtual bool supportBatch() const;
+	virtual void applyBatch(const VipAnyDataList& frames, const VipNDArray& stack, const VipNDArray& times);
 	virtual void resetProcessing();
 	/// @brief Initialize the processing with:
 	/// -	the name of a Python processing class inheriting 'ThermavipPyProcessing', without the 'Thermavip' prefix, or
@@ -30,7 +30,9 @@
  */
 
 #include <complex>
+#include <deque>
 
+#include "VipIterator.h"
 #include "VipLogging.h"
 #include "VipMath.h"
 #include "VipStandardProcessing.h"
@@ -850,7 +852,7 @@ void FastMedian3x3::apply()
 		return;
 	}
 
-	VipNDArray out(ar.dataType(), ar.shape());
+	VipNDArray out = createFrame(ar.dataType(), ar.shape());
 	int this_type = ar.dataType();
 	if (this_type == QMetaType::Bool)
 		median_filter((bool*)ar.constData(), (bool*)out.data(), ar.shape(1), ar.shape(0));
@@ -1651,16 +1653,148 @@ void VipSamplesFeature::mergeData(int data_type, int sub_data_type)
 	}
 }
 
+namespace
+{
+	/// Returns the input image, or the y values of the input curve, as a dense array
+	VipNDArray runningInput(const QVariant& v)
+	{
+		VipNDArray ar;
+		if (v.userType() == qMetaTypeId<VipPointVector>())
+			ar = vipExtractYValues(v.value<VipPointVector>());
+		else
+			ar = v.value<VipNDArray>();
+		if (!ar.isEmpty() && (ar.isView() || !ar.isUnstrided()))
+			ar = ar.copy();
+		return ar;
+	}
+
+	/// Output type for a given input array type, same as VipSamplesFeature
+	int runningOutputType(int data_type)
+	{
+		if (vipIsComplex(data_type))
+			return qMetaTypeId<complex_d>();
+		if (data_type == QMetaType::Float || data_type == QMetaType::Double || data_type == qMetaTypeId<long double>())
+			return QMetaType::Double;
+		return QMetaType::Int;
+	}
+
+	/// Build the output value based on the last input (image or curve)
+	QVariant runningOutput(const VipAnyData& any, const VipNDArray& res)
+	{
+		if (any.data().userType() == qMetaTypeId<VipPointVector>()) {
+			VipPointVector vec = any.value<VipPointVector>();
+			vipSetYValues(vec, res);
+			return QVariant::fromValue(vec);
+		}
+		const int type = runningOutputType(res.dataType());
+		return QVariant::fromValue(res.dataType() == type ? res : res.convert(type));
+	}
+
+	/// Call f((T*)nullptr) with the C++ type T corresponding to data_type.
+	/// Returns false for unsupported types.
+	template<class F>
+	bool runningDispatch(int data_type, F&& f)
+	{
+		switch (data_type) {
+			case QMetaType::Bool:
+				f((bool*)nullptr);
+				return true;
+			case QMetaType::Char:
+				f((char*)nullptr);
+				return true;
+			case QMetaType::SChar:
+				f((signed char*)nullptr);
+				return true;
+			case QMetaType::UChar:
+				f((unsigned char*)nullptr);
+				return true;
+			case QMetaType::Short:
+				f((short*)nullptr);
+				return true;
+			case QMetaType::UShort:
+				f((unsigned short*)nullptr);
+				return true;
+			case QMetaType::Int:
+				f((int*)nullptr);
+				return true;
+			case QMetaType::UInt:
+				f((unsigned int*)nullptr);
+				return true;
+			case QMetaType::Long:
+				f((long*)nullptr);
+				return true;
+			case QMetaType::ULong:
+				f((unsigned long*)nullptr);
+				return true;
+			case QMetaType::LongLong:
+				f((qint64*)nullptr);
+				return true;
+			case QMetaType::ULongLong:
+				f((quint64*)nullptr);
+				return true;
+			case QMetaType::Float:
+				f((float*)nullptr);
+				return true;
+			case QMetaType::Double:
+				f((double*)nullptr);
+				return true;
+			default:
+				break;
+		}
+		if (data_type == qMetaTypeId<long double>())
+			f((long double*)nullptr);
+		else if (data_type == qMetaTypeId<complex_f>())
+			f((complex_f*)nullptr);
+		else if (data_type == qMetaTypeId<complex_d>())
+			f((complex_d*)nullptr);
+		else
+			return false;
+		return true;
+	}
+
+	/// Running sum type: 64 bits integers of the input signedness for integer inputs, double or complex_d otherwise.
+	/// Integer sums are exact as long as the window sum fits in 64 bits (unsigned wrap around cancels when removing frames).
+	template<class T>
+	struct RunningSum
+	{
+		using integer = std::conditional_t<std::is_unsigned_v<T>, quint64, qint64>;
+		using type = std::conditional_t<std::is_integral_v<T>, integer, std::conditional_t<std::is_floating_point_v<T>, double, complex_d>>;
+	};
+
+	/// Pixels processed by each thread
+	static constexpr qsizetype _running_block = 16384;
+
+	template<class Fun>
+	void runningParallelFor(qsizetype size, Fun&& fun)
+	{
+		const qsizetype blocks = (size + _running_block - 1) / _running_block;
+		VIP_PARALLEL_FOR_NUM_THREADS(vipLoopThreadCount((int)std::min(size, (qsizetype)INT_MAX)))
+		for (qsizetype b = 0; b < blocks; ++b) {
+			const qsizetype start = b * _running_block;
+			fun(start, std::min(start + _running_block, size));
+		}
+	}
+}
+
+class VipRunningAverage::PrivateData
+{
+public:
+	QMutex mutex;
+	std::deque<VipNDArray> frames;
+	VipNDArray sum;
+	// floating point sums are recomputed from scratch periodically to avoid rounding drift
+	int updates = 0;
+};
+
 VipRunningAverage::VipRunningAverage()
   : VipProcessingObject()
 {
+	VIP_CREATE_PRIVATE_DATA();
 	propertyName("Window")->setData(3);
-	// m_extract.topLevelInputAt(0)->toMultiInput()->resize(3);
-	m_extract.propertyName("Feature")->setData(QString("mean"));
-	m_extract.topLevelInputAt(0)->toMultiInput()->setMinSize(1);
-	m_extract.topLevelInputAt(0)->toMultiInput()->setMaxSize(INT_MAX);
 }
 
+VipRunningAverage::~VipRunningAverage() {}
+
 void VipRunningAverage::apply()
 {
 	VipAnyData any = inputAt(0)->data();
@@ -1670,44 +1804,175 @@ void VipRunningAverage::apply()
 	if (window <= 0)
 		window = 1;
 
-	{
-		QMutexLocker lock(&m_mutex);
-		m_lst.push_back(any);
-		while (m_lst.size() > window)
-			m_lst.pop_front();
-
-		m_extract.topLevelInputAt(0)->toMultiInput()->resize(m_lst.size());
-		for (int i = 0; i < m_lst.size(); ++i)
-			m_extract.inputAt(i)->setData(m_lst[i]);
+	const VipNDArray ar = runningInput(any.data());
+	if (ar.isEmpty()) {
+		setError("wrong input type", VipProcessingObject::WrongInput);
+		return;
 	}
 
-	m_extract.update();
+	QMutexLocker lock(&d_data->mutex);
+	std::deque<VipNDArray>& frames = d_data->frames;
+	if (!frames.empty() && (frames.back().dataType() != ar.dataType() || frames.back().shape() != ar.shape()))
+		frames.clear();
+
+	VipNDArray res;
+	const bool supported = runningDispatch(ar.dataType(), [&](auto* tag) {
+		using T = std::remove_pointer_t<decltype(tag)>;
+		using S = typename RunningSum<T>::type;
+		const qsizetype size = ar.size();
+
+		if (frames.empty()) {
+			d_data->sum = VipNDArray(qMetaTypeId<S>(), ar.shape());
+			d_data->updates = 0;
+		}
+		S* sum = (S*)d_data->sum.data();
+
+		// add the new frame and remove the oldest ones
+		std::vector<const T*> removed;
+		frames.push_back(ar);
+		while ((int)frames.size() > window) {
+			removed.push_back((const T*)frames.front().constData());
+			frames.pop_front();
+		}
+		const T* added = (const T*)ar.constData();
+		const bool reset = frames.size() == 1 || (!std::is_integral_v<T> && ++d_data->updates >= std::max(window, 64));
+
+		if (reset) {
+			d_data->updates = 0;
+			std::vector<const T*> all;
+			for (const VipNDArray& f : frames)
+				all.push_back((const T*)f.constData());
+			runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+				for (qsizetype i = start; i < end; ++i) {
+					S s = S();
+					for (const T* f : all)
+						s += (S)f[i];
+					sum[i] = s;
+				}
+			});
+		}
+		else {
+			runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+				for (qsizetype i = start; i < end; ++i) {
+					S s = sum[i] + (S)added[i];
+					for (const T* f : removed)
+						s -= (S)f[i];
+					sum[i] = s;
+				}
+			});
+		}
 
-	VipAnyData out = m_extract.outputAt(0)->data();
-	out.mergeAttributes(this->attributes());
+		// compute the mean, integer inputs output integer values as VipSamplesFeature
+		const double count = (double)frames.size();
+		if constexpr (std::is_integral_v<T>) {
+			res = VipNDArray(QMetaType::Int, ar.shape());
+			int* out = (int*)res.data();
+			runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+				for (qsizetype i = start; i < end; ++i)
+					out[i] = (int)(sum[i] / count);
+			});
+		}
+		else {
+			res = VipNDArray(qMetaTypeId<S>(), ar.shape());
+			S* out = (S*)res.data();
+			runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+				for (qsizetype i = start; i < end; ++i)
+					out[i] = sum[i] / count;
+			});
+		}
+	});
+	lock.unlock();
+
+	if (!supported) {
+		setError("unsupported input type", VipProcessingObject::WrongInput);
+		return;
+	}
+	VipAnyData out = create(runningOutput(any, res));
 	out.mergeAttributes(any.attributes());
-	out.setSource((qint64)this);
 	out.setTime(any.time());
-
+	out.setName(any.name());
+	out.setXUnit(any.xUnit());
+	out.setYUnit(any.yUnit());
+	out.setZUnit(any.zUnit());
 	outputAt(0)->setData(out);
 }
 
 void VipRunningAverage::resetProcessing()
 {
-	QMutexLocker lock(&m_mutex);
-	m_lst.clear();
+	QMutexLocker lock(&d_data->mutex);
+	d_data->frames.clear();
+	d_data->sum = VipNDArray();
 }
 
+namespace
+{
+	/// Strict ordering used by the running median: NaN values are sorted last, complex values are sorted by magnitude
+	template<class T>
+	inline bool runningLess(const T& a, const T& b)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+			return (b != b) ? (a == a) : (a < b);
+		else if constexpr (std::is_integral_v<T>)
+			return a < b;
+		else
+			return runningLess(std::abs(a), std::abs(b));
+	}
+	template<class T>
+	inline bool runningSame(const T& a, const T& b)
+	{
+		return a == b || (a != a && b != b);
+	}
+
+	/// Replace value old by value v in the sorted run r of size n
+	template<class T>
+	inline void runningReplace(T* r, int n, T old, T v)
+	{
+		int p = (int)(std::lower_bound(r, r + n, old, runningLess<T>) - r);
+		// values with the same magnitude might be different (complex)
+		while (p < n - 1 && !runningSame(r[p], old))
+			++p;
+		if (runningLess(v, old)) {
+			const int q = (int)(std::upper_bound(r, r + p, v, runningLess<T>) - r);
+			std::copy_backward(r + q, r + p, r + p + 1);
+			r[q] = v;
+		}
+		else {
+			const int q = (int)(std::lower_bound(r + p + 1, r + n, v, runningLess<T>) - r);
+			std::copy(r + p + 1, r + q, r + p);
+			r[q - 1] = v;
+		}
+	}
+
+	/// Insert value v in the sorted run r of size n
+	template<class T>
+	inline void runningInsert(T* r, int n, T v)
+	{
+		const int q = (int)(std::upper_bound(r, r + n, v, runningLess<T>) - r);
+		std::copy_backward(r + q, r + n, r + n + 1);
+		r[q] = v;
+	}
+}
+
+class VipRunningMedian::PrivateData
+{
+public:
+	QMutex mutex;
+	std::deque<VipNDArray> frames;
+	// for each pixel, the sorted values of the last frames (capacity values per pixel)
+	VipNDArray sorted;
+	int capacity = 0;
+};
+
 VipRunningMedian::VipRunningMedian()
   : VipProcessingObject()
 {
+	VIP_CREATE_PRIVATE_DATA();
 	propertyName("Window")->setData(3);
-	// m_extract.topLevelInputAt(0)->toMultiInput()->resize(3);
-	m_extract.propertyName("Feature")->setData(QString("median"));
-	m_extract.topLevelInputAt(0)->toMultiInput()->setMinSize(1);
-	m_extract.topLevelInputAt(0)->toMultiInput()->setMaxSize(INT_MAX);
+	propertyName("Percentile")->setData(50.);
 }
 
+VipRunningMedian::~VipRunningMedian() {}
+
 void VipRunningMedian::apply()
 {
 	VipAnyData any = inputAt(0)->data();
@@ -1716,33 +1981,98 @@ void VipRunningMedian::apply()
 	int window = propertyName("Window")->value<int>();
 	if (window <= 0)
 		window = 1;
+	const double percentile = qBound(0., propertyName("Percentile")->value<double>(), 100.);
 
-	{
-		QMutexLocker lock(&m_mutex);
-		m_lst.push_back(any);
-		while (m_lst.size() > window)
-			m_lst.pop_front();
-
-		m_extract.topLevelInputAt(0)->toMultiInput()->resize(m_lst.size());
-		for (int i = 0; i < m_lst.size(); ++i)
-			m_extract.inputAt(i)->setData(m_lst[i]);
+	const VipNDArray ar = runningInput(any.data());
+	if (ar.isEmpty()) {
+		setError("wrong input type", VipProcessingObject::WrongInput);
+		return;
 	}
 
-	m_extract.update();
-
-	VipAnyData out = m_extract.outputAt(0)->data();
-	out.mergeAttributes(this->attributes());
+	QMutexLocker lock(&d_data->mutex);
+	std::deque<VipNDArray>& frames = d_data->frames;
+	if (!frames.empty() && (frames.back().dataType() != ar.dataType() || frames.back().shape() != ar.shape()))
+		frames.clear();
+
+	VipNDArray res;
+	const bool supported = runningDispatch(ar.dataType(), [&](auto* tag) {
+		using T = std::remove_pointer_t<decltype(tag)>;
+		const qsizetype size = ar.size();
+
+		const T* added = (const T*)ar.constData();
+		const T* removed = nullptr;
+		bool rebuild = frames.empty() || d_data->capacity != window;
+
+		frames.push_back(ar);
+		if ((int)frames.size() > window) {
+			if (!rebuild)
+				removed = (const T*)frames.front().constData();
+			while ((int)frames.size() > window)
+				frames.pop_front();
+		}
+		const int count = (int)frames.size();
+
+		if (rebuild) {
+			// window changed or first frame: sort the remaining frames
+			d_data->capacity = window;
+			d_data->sorted = VipNDArray(ar.dataType(), vipVector(size, (qsizetype)window));
+			T* sorted = (T*)d_data->sorted.data();
+			std::vector<const T*> all;
+			for (const VipNDArray& f : frames)
+				all.push_back((const T*)f.constData());
+			runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+				for (qsizetype i = start; i < end; ++i) {
+					T* r = sorted + i * window;
+					for (int j = 0; j < count; ++j)
+						r[j] = all[j][i];
+					std::sort(r, r + count, runningLess<T>);
+				}
+			});
+		}
+		else {
+			T* sorted = (T*)d_data->sorted.data();
+			runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+				for (qsizetype i = start; i < end; ++i) {
+					if (removed)
+						runningReplace(sorted + i * window, count, removed[i], added[i]);
+					else
+						runningInsert(sorted + i * window, count - 1, added[i]);
+				}
+			});
+		}
+
+		// for an even count, the 50 percentile gives the upper median like VipSamplesFeature
+		const qsizetype rank = std::min(count - 1, (int)(percentile / 100. * count));
+		res = VipNDArray(ar.dataType(), ar.shape());
+		T* out = (T*)res.data();
+		const T* sorted = (const T*)d_data->sorted.constData();
+		runningParallelFor(size, [&](qsizetype start, qsizetype end) {
+			for (qsizetype i = start; i < end; ++i)
+				out[i] = sorted[i * window + rank];
+		});
+	});
+	lock.unlock();
+
+	if (!supported) {
+		setError("unsupported input type", VipProcessingObject::WrongInput);
+		return;
+	}
+	VipAnyData out = create(runningOutput(any, res));
 	out.mergeAttributes(any.attributes());
-	out.setSource((qint64)this);
 	out.setTime(any.time());
-
+	out.setName(any.name());
+	out.setXUnit(any.xUnit());
+	out.setYUnit(any.yUnit());
+	out.setZUnit(any.zUnit());
 	outputAt(0)->setData(out);
 }
 
 void VipRunningMedian::resetProcessing()
 {
-	QMutexLocker lock(&m_mutex);
-	m_lst.clear();
+	QMutexLocker lock(&d_data->mutex);
+	d_data->frames.clear();
+	d_data->sorted = VipNDArray();
+	d_data->capacity = 0;
 }
 
 VipExtractBoundingBox::VipExtractBoundingBox(QObject* parent)
@@ -407,6 +407,11 @@ private:
 VIP_REGISTER_QOBJECT_METATYPE(VipSamplesFeature*)
 
 /// @brief Running average working on images or curves
+///
+/// The average is computed over the last Window input frames.
+/// A running sum (in 64 bits integers for integer inputs, in double otherwise) is updated for each new frame:
+/// the new frame is added and the oldest one is subtracted, so that the cost per frame does not depend on the window size.
+/// The window restarts when the input type or shape changes.
 class VIP_CORE_EXPORT VipRunningAverage : public VipProcessingObject
 {
 	Q_OBJECT
@@ -415,12 +420,9 @@ class VIP_CORE_EXPORT VipRunningAverage : public VipProcessingObject
 	VIP_IO(VipProperty Window)
 	Q_CLASSINFO("category", "Filters")
 
-	VipSamplesFeature m_extract;
-	VipAnyDataList m_lst;
-	QMutex m_mutex;
-
 public:
 	VipRunningAverage();
+	~VipRunningAverage();
 	virtual DisplayHint displayHint() const { return InputTransform; }
 	virtual bool acceptInput(int // index
 				 ,
@@ -432,24 +434,31 @@ public:
 protected:
 	virtual void apply();
 	virtual void resetProcessing();
+
+private:
+	VIP_DECLARE_PRIVATE_DATA();
 };
 VIP_REGISTER_QOBJECT_METATYPE(VipRunningAverage*)
 
 /// @brief Running median working on images or curves
+///
+/// Compute the median (or any other percentile given by the Percentile property) of the last Window input frames.
+/// Each pixel keeps a sorted copy of its last Window values which is updated incrementally for each new frame
+/// (the oldest value is replaced by the new one), so that the output is directly available.
+/// The window restarts when the input type or shape changes.
 class VIP_CORE_EXPORT VipRunningMedian : public VipProcessingObject
 {
 	Q_OBJECT
 	VIP_IO(VipInput input)
 	VIP_IO(VipOutput output)
 	VIP_IO(VipProperty Window)
+	VIP_IO(VipProperty Percentile)
 	Q_CLASSINFO("category", "Filters")
-
-	VipSamplesFeature m_extract;
-	QList<VipAnyData> m_lst;
-	QMutex m_mutex;
+	Q_CLASSINFO("Percentile", "Percentile to extract in [0, 100], default to 50 (median)")
 
 public:
 	VipRunningMedian();
+	~VipRunningMedian();
 	virtual DisplayHint displayHint() const { return InputTransform; }
 	virtual bool acceptInput(int // index
 				 ,
@@ -461,6 +470,9 @@ public:
 protected:
 	virtual void apply();
 	virtual void resetProcessing();
+
+private:
+	VIP_DECLARE_PRIVATE_DATA();
 };
 VIP_REGISTER_QOBJECT_METATYPE(VipRunningMedian*)
 
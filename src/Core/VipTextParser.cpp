@@ -0,0 +1,448 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "VipTextParser.h"
+#include "VipIterator.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+VipMappedFile::VipMappedFile()
+  : m_data(nullptr)
+  , m_size(0)
+{
+}
+
+VipMappedFile::VipMappedFile(const QString& filename)
+  : VipMappedFile()
+{
+	open(filename);
+}
+
+VipMappedFile::~VipMappedFile()
+{
+	close();
+}
+
+bool VipMappedFile::open(const QString& filename)
+{
+	close();
+	m_file.setFileName(filename);
+	if (!m_file.open(QFile::ReadOnly))
+		return false;
+
+	const qint64 size = m_file.size();
+	if (size > 0) {
+		if (uchar* map = m_file.map(0, size)) {
+			m_data = reinterpret_cast<const char*>(map);
+			m_size = size;
+			return true;
+		}
+	}
+	// not mappable: read the whole content
+	m_content = m_file.readAll();
+	m_data = m_content.constData();
+	m_size = m_content.size();
+	return true;
+}
+
+void VipMappedFile::close()
+{
+	// closing the file unmaps it
+	m_file.close();
+	m_content.clear();
+	m_data = nullptr;
+	m_size = 0;
+}
+
+namespace
+{
+	// Approximative size of the text chunks parsed in parallel
+	static constexpr qint64 _chunkSize = 1 << 20;
+
+	// Line classification for vipParseNumericArrays()
+	enum LineType
+	{
+		InvalidLine = -2,
+		CommentLine = -1,
+		EmptyLine = 0
+	};
+
+	VIP_ALWAYS_INLINE bool isDigit(char c) noexcept
+	{
+		return static_cast<unsigned>(c - '0') < 10u;
+	}
+	VIP_ALWAYS_INLINE bool isBlank(char c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+	VIP_ALWAYS_INLINE bool matchNoCase(const char* p, const char* end, const char* word) noexcept
+	{
+		for (; *word; ++word, ++p)
+			if (p == end || (*p | 0x20) != *word)
+				return false;
+		return true;
+	}
+
+	// Exactly representable powers of 10
+	static const double _powers10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+					    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	VIP_ALWAYS_INLINE const char* parseDouble(const char* begin, const char* end, double& value, char decimal)
+	{
+		const char* p = begin;
+		bool negative = false;
+		if (p != end && (*p == '-' || *p == '+')) {
+			negative = *p == '-';
+			++p;
+		}
+
+		// mantissa, keeping at most 19 significant digits
+		quint64 mantissa = 0;
+		int digits = 0;
+		int exp10 = 0;
+		bool truncated = false;
+		bool has_digits = false;
+		for (; p != end && isDigit(*p); ++p) {
+			has_digits = true;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0;
+			}
+			else {
+				++exp10;
+				truncated = true;
+			}
+		}
+		if (p != end && (*p == '.' || *p == decimal)) {
+			++p;
+			for (; p != end && isDigit(*p); ++p) {
+				has_digits = true;
+				if (digits < 19) {
+					mantissa = mantissa * 10 + (*p - '0');
+					digits += mantissa != 0;
+					--exp10;
+				}
+				else
+					truncated = true;
+			}
+		}
+
+		if (!has_digits) {
+			// nan or inf
+			if (matchNoCase(p, end, "nan")) {
+				value = std::numeric_limits<double>::quiet_NaN();
+				return p + 3;
+			}
+			if (matchNoCase(p, end, "inf")) {
+				value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+				return matchNoCase(p, end, "infinity") ? p + 8 : p + 3;
+			}
+			return begin;
+		}
+
+		// exponent, only consumed if followed by digits
+		if (p != end && (*p == 'e' || *p == 'E')) {
+			const char* e = p + 1;
+			bool negative_exp = false;
+			if (e != end && (*e == '-' || *e == '+')) {
+				negative_exp = *e == '-';
+				++e;
+			}
+			if (e != end && isDigit(*e)) {
+				int exp = 0;
+				for (; e != end && isDigit(*e); ++e)
+					if (exp < 100000)
+						exp = exp * 10 + (*e - '0');
+				exp10 += negative_exp ? -exp : exp;
+				p = e;
+			}
+		}
+
+		if (!truncated && mantissa <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+			// exact conversion: both the mantissa and the power of 10 are exactly representable
+			double v = static_cast<double>(mantissa);
+			v = exp10 < 0 ? v / _powers10[-exp10] : v * _powers10[exp10];
+			value = negative ? -v : v;
+			return p;
+		}
+
+		// slow path, correctly rounded
+		QByteArray tmp(begin, p - begin);
+		if (decimal != '.')
+			tmp.replace(decimal, '.');
+		value = tmp.toDouble();
+		return p;
+	}
+
+	VIP_ALWAYS_INLINE const char* skipDelimiters(const char* p, const char* eol, char separator) noexcept
+	{
+		while (p != eol && (isBlank(*p) || *p == separator))
+			++p;
+		return p;
+	}
+
+	// Parse the number at p and skip the following delimiters.
+	// Returns nullptr if p does not start with a number followed by a delimiter or the end of line.
+	VIP_ALWAYS_INLINE const char* nextNumber(const char* p, const char* eol, double& value, char separator, char decimal)
+	{
+		const char* n = parseDouble(p, eol, value, decimal);
+		if (n == p || (n != eol && !isBlank(*n) && *n != separator))
+			return nullptr;
+		return skipDelimiters(n, eol, separator);
+	}
+
+	VIP_ALWAYS_INLINE const char* endOfLine(const char* p, const char* end) noexcept
+	{
+		const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+		return eol ? eol : end;
+	}
+
+	// Split [begin, end) in chunks of roughly _chunkSize bytes starting on a new line.
+	// Returns the chunk boundaries.
+	std::vector<const char*> splitChunks(const char* begin, const char* end)
+	{
+		std::vector<const char*> res{ begin };
+		const char* p = begin;
+		while (end - p > _chunkSize) {
+			p = static_cast<const char*>(memchr(p + _chunkSize, '\n', end - (p + _chunkSize)));
+			if (!p)
+				break;
+			if (++p != end)
+				res.push_back(p);
+		}
+		if (begin != end)
+			res.push_back(end);
+		return res;
+	}
+
+	int threadCount(const char* begin, const char* end)
+	{
+		return vipLoopThreadCount(static_cast<int>(std::min<qint64>(end - begin, INT_MAX)));
+	}
+}
+
+const char* vipParseDouble(const char* begin, const char* end, double& value, char decimal)
+{
+	return parseDouble(begin, end, value, decimal);
+}
+
+QVector<VipPointVector> vipParseXYColumns(const char* begin, const char* end, qsizetype columns, char separator)
+{
+	if (columns < 2)
+		return QVector<VipPointVector>();
+
+	QVector<VipPointVector> res(columns - 1);
+	const std::vector<const char*> chunks = splitChunks(begin, end);
+	const qsizetype count = static_cast<qsizetype>(chunks.size()) - 1;
+	if (count <= 0)
+		return res;
+
+	const char decimal = separator == ',' ? '.' : ',';
+	const int threads = threadCount(begin, end);
+
+	// count the lines of each chunk to preallocate the output vectors
+	std::vector<qsizetype> offsets(count + 1, 0);
+	VIP_PARALLEL_FOR_NUM_THREADS(threads)
+	for (qsizetype c = 0; c < count; ++c) {
+		const char* e = chunks[c + 1];
+		offsets[c + 1] = std::count(chunks[c], e, '\n') + (e == end && e[-1] != '\n');
+	}
+	for (qsizetype c = 0; c < count; ++c)
+		offsets[c + 1] += offsets[c];
+	for (VipPointVector& v : res)
+		v.resize(offsets[count]);
+
+	VipPointVector* vectors = res.data();
+	std::vector<qsizetype> parsed(count, 0);
+
+	VIP_PARALLEL_FOR_NUM_THREADS(threads)
+	for (qsizetype c = 0; c < count; ++c) {
+		std::vector<double> values(columns);
+		const char* p = chunks[c];
+		const char* e = chunks[c + 1];
+		qsizetype row = offsets[c];
+		while (p < e) {
+			const char* eol = endOfLine(p, e);
+			const char* q = skipDelimiters(p, eol, separator);
+			bool ok = true;
+			for (qsizetype i = 0; i < columns && ok; ++i) {
+				q = q != eol ? nextNumber(q, eol, values[i], separator, decimal) : nullptr;
+				ok = q != nullptr;
+			}
+			if (!ok)
+				break;
+			for (qsizetype i = 1; i < columns; ++i)
+				vectors[i - 1][row] = VipPoint(values[0], values[i]);
+			++row;
+			p = eol == e ? e : eol + 1;
+		}
+		parsed[c] = row - offsets[c];
+	}
+
+	// stop at the first incomplete chunk
+	qsizetype size = 0;
+	for (qsizetype c = 0; c < count; ++c) {
+		size = offsets[c] + parsed[c];
+		if (size < offsets[c + 1])
+			break;
+	}
+	for (VipPointVector& v : res)
+		v.resize(size);
+	return res;
+}
+
+QVector<VipNDArray> vipParseNumericArrays(const char* begin, const char* end, const char** stop)
+{
+	const std::vector<const char*> chunks = splitChunks(begin, end);
+	const qsizetype count = static_cast<qsizetype>(chunks.size()) - 1;
+
+	// classify each line (see LineType, or number of columns) and extract the values
+	std::vector<std::vector<int>> lines(std::max<qsizetype>(count, 0));
+	std::vector<std::vector<double>> values(std::max<qsizetype>(count, 0));
+
+	VIP_PARALLEL_FOR_NUM_THREADS(threadCount(begin, end))
+	for (qsizetype c = 0; c < count; ++c) {
+		std::vector<int>& types = lines[c];
+		std::vector<double>& vals = values[c];
+		const char* p = chunks[c];
+		const char* e = chunks[c + 1];
+		while (p < e) {
+			const char* eol = endOfLine(p, e);
+			const char* q = skipDelimiters(p, eol, ' ');
+			if (q == eol)
+				types.push_back(EmptyLine);
+			else if (*q == '#' || *q == '/' || *q == '*' || *q == 'C')
+				types.push_back(CommentLine);
+			else {
+				const size_t first = vals.size();
+				int cols = 0;
+				double v;
+				while (q && q != eol) {
+					q = nextNumber(q, eol, v, ' ', ',');
+					if (q) {
+						vals.push_back(v);
+						++cols;
+					}
+				}
+				if (!q) {
+					vals.resize(first);
+					cols = InvalidLine;
+				}
+				types.push_back(cols);
+			}
+			p = eol == e ? e : eol + 1;
+		}
+	}
+
+	// gather lines in blocks of identical column count
+	struct Block
+	{
+		qsizetype chunk, value, rows, cols;
+	};
+	std::vector<Block> blocks;
+	Block current{ 0, 0, 0, 0 };
+	// first line of the array being read, including its comments
+	qsizetype start_chunk = 0, start_line = 0;
+	bool failed = false;
+
+	for (qsizetype c = 0; c < count && !failed; ++c) {
+		qsizetype value = 0;
+		const std::vector<int>& types = lines[c];
+		for (qsizetype l = 0; l < static_cast<qsizetype>(types.size()); ++l) {
+			const int type = types[l];
+			if (current.rows == 0) {
+				if (type == InvalidLine) {
+					failed = true;
+					break;
+				}
+				if (type == EmptyLine) {
+					start_chunk = c;
+					start_line = l + 1;
+				}
+				else if (type > 0)
+					current = Block{ c, value, 1, type };
+			}
+			else if (type == current.cols)
+				++current.rows;
+			else if (type == EmptyLine) {
+				blocks.push_back(current);
+				current.rows = 0;
+				start_chunk = c;
+				start_line = l + 1;
+			}
+			else {
+				// unsupported content inside an array
+				failed = true;
+				break;
+			}
+			if (type > 0)
+				value += type;
+		}
+	}
+	if (!failed && current.rows)
+		blocks.push_back(current);
+
+	if (stop) {
+		*stop = end;
+		if (failed) {
+			const char* p = chunks[start_chunk];
+			for (qsizetype l = 0; l < start_line && p != end; ++l) {
+				p = endOfLine(p, end);
+				if (p != end)
+					++p;
+			}
+			*stop = p;
+		}
+	}
+
+	// copy the values, contiguous within each chunk
+	QVector<VipNDArray> res;
+	res.reserve(static_cast<qsizetype>(blocks.size()));
+	for (const Block& b : blocks) {
+		VipNDArrayType<double> ar(vipVector(b.rows, b.cols));
+		double* dst = ar.ptr();
+		qsizetype remaining = b.rows * b.cols;
+		qsizetype value = b.value;
+		for (qsizetype c = b.chunk; remaining > 0; ++c, value = 0) {
+			const qsizetype n = std::min<qsizetype>(remaining, static_cast<qsizetype>(values[c].size()) - value);
+			memcpy(dst, values[c].data() + value, n * sizeof(double));
+			dst += n;
+			remaining -= n;
+		}
+		res.append(ar);
+	}
+	return res;
+}
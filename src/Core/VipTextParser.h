@@ -0,0 +1,98 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_TEXT_PARSER_H
+#define VIP_TEXT_PARSER_H
+
+#include <QFile>
+
+#include "VipNDArray.h"
+#include "VipVectors.h"
+#include "VipConfig.h"
+
+/// \addtogroup Core
+/// @{
+
+/// @brief Read only access to the content of a file, memory mapped when possible.
+///
+/// If the file cannot be mapped (empty file, Qt resource...), its content is read in memory.
+class VIP_CORE_EXPORT VipMappedFile
+{
+public:
+	VipMappedFile();
+	explicit VipMappedFile(const QString& filename);
+	~VipMappedFile();
+	VipMappedFile(const VipMappedFile&) = delete;
+	VipMappedFile& operator=(const VipMappedFile&) = delete;
+
+	bool open(const QString& filename);
+	void close();
+	bool isOpen() const noexcept { return m_file.isOpen(); }
+
+	const char* data() const noexcept { return m_data; }
+	qint64 size() const noexcept { return m_size; }
+
+private:
+	QFile m_file;
+	QByteArray m_content;
+	const char* m_data;
+	qint64 m_size;
+};
+
+/// @brief Locale independent parsing of a floating point number at the beginning of [begin, end).
+///
+/// Leading spaces are not skipped. Both '.' and \a decimal are accepted as decimal separator, and nan/inf values are supported.
+/// Numbers with a mantissa below 2^53 and an exponent within [-22, 22] are converted with a fast exact path, others
+/// through QByteArray::toDouble().
+/// Returns the pointer past the parsed number, or \a begin if no number could be read.
+VIP_CORE_EXPORT const char* vipParseDouble(const char* begin, const char* end, double& value, char decimal = '.');
+
+/// @brief Parse a text of lines containing at least \a columns numbers (x, y1, y2...) and returns columns - 1 vectors of (x, yi) points.
+///
+/// Numbers are separated by any number of \a separator, spaces or tabulations, and ',' is accepted as decimal separator if
+/// \a separator is not ','. Parsing stops at the first line that does not contain enough numbers.
+/// The text is split in fixed size chunks parsed in parallel, and the points are written to preallocated vectors.
+VIP_CORE_EXPORT QVector<VipPointVector> vipParseXYColumns(const char* begin, const char* end, qsizetype columns, char separator);
+
+/// @brief Parse a text containing numeric 2D arrays separated by empty lines, each array being optionally preceded by comment lines
+/// (starting with '#', '/', '*' or 'C'), and returns them as double VipNDArray.
+///
+/// This is the numeric subset of the format read by operator>>(QTextStream&, VipNDArray&).
+/// Parsing stops at the first line that cannot be interpreted (non numeric values, wrong column count); \a stop is then set
+/// to the beginning of the array containing this line, or to \a end if the whole text was parsed.
+/// The text is split in fixed size chunks parsed in parallel.
+VIP_CORE_EXPORT QVector<VipNDArray> vipParseNumericArrays(const char* begin, const char* end, const char** stop = nullptr);
+
+/// @}
+// end Core
+
+#endif
@@ -134,181 +134,7 @@ VipPointVector vipWarping(QVector<QPoint> pts1, QVector<QPoint> pts2, int width,
 	return res;
 }
 
-// used float for complex_f, double otherwise
-template<class T>
-struct select_type
-{
-	typedef double type;
-};
-template<>
-struct select_type<complex_f>
-{
-	typedef float type;
-};
-
-template<class T, class U>
-void applyWarping(const T* src, U* dst, int w, int h, const VipPointVector& warping)
-{
-	typedef typename select_type<T>::type type;
-
-	int i = 0;
-	for (int y = 0; y < h; ++y) {
-		for (int x = 0; x < w; ++x, ++i) {
-			const QPointF src_pt = warping[i];
-			const int leftCellEdge = src_pt.x();
-			int rightCellEdge = (src_pt.x()) + 1;
-			if (rightCellEdge == w)
-				rightCellEdge = leftCellEdge;
-			const int topCellEdge = src_pt.y();
-			int bottomCellEdge = (src_pt.y() + 1);
-			if (bottomCellEdge == h)
-				bottomCellEdge = topCellEdge;
-			const T p1 = src[bottomCellEdge * w + leftCellEdge];
-			const T p2 = src[topCellEdge * w + leftCellEdge];
-			const T p3 = src[bottomCellEdge * w + rightCellEdge];
-			const T p4 = src[topCellEdge * w + rightCellEdge];
-			const type u = (src_pt.x() - leftCellEdge);   // / (rightCellEdge - leftCellEdge);
-			const type v = (src_pt.y() - bottomCellEdge); // / (topCellEdge - bottomCellEdge);
-			U value = (p1 * (1 - v) + p2 * v) * (1 - u) + (p3 * (1 - v) + p4 * v) * u;
-			dst[i] = value;
-		}
-	}
-}
-
-template<class T, class U>
-void applyWarpingNoInterpolation(const T* src, U* dst, int w, int h, const VipPointVector& warping)
-{
-	int i = 0;
-	for (int y = 0; y < h; ++y) {
-		for (int x = 0; x < w; ++x, ++i) {
-			const QPointF src_pt = warping[i];
-			const int leftCellEdge = qRound(src_pt.x());
-			const int topCellEdge = qRound(src_pt.y());
-			dst[i] = src[topCellEdge * w + leftCellEdge];
-		}
-	}
-}
-
-inline int clipRGB(double v)
-{
-	return v < 0 ? 0 : (v > 255 ? 255 : (int)v);
-}
-inline void applyWarpingRGB(const QRgb* src, QRgb* dst, int w, int h, const VipPointVector& warping)
-{
-	int size = w * h;
-#pragma omp parallel for
-	for (int i = 0; i < size; ++i) {
-		const QPointF src_pt = warping[i];
-		int leftCellEdge = src_pt.x();
-		if (leftCellEdge < 0)
-			leftCellEdge = 0;
-		else if (leftCellEdge >= w)
-			leftCellEdge = w - 1;
-		int rightCellEdge = (src_pt.x()) + 1;
-		if (rightCellEdge >= w)
-			rightCellEdge = leftCellEdge;
-		int topCellEdge = src_pt.y();
-		if (topCellEdge < 0)
-			topCellEdge = 0;
-		else if (topCellEdge >= h)
-			topCellEdge = h - 1;
-		int bottomCellEdge = (src_pt.y() + 1);
-		if (bottomCellEdge >= h)
-			bottomCellEdge = topCellEdge;
-		const QRgb p1 = src[bottomCellEdge * w + leftCellEdge];
-		const QRgb p2 = src[topCellEdge * w + leftCellEdge];
-		const QRgb p3 = src[bottomCellEdge * w + rightCellEdge];
-		const QRgb p4 = src[topCellEdge * w + rightCellEdge];
-		const double u = (src_pt.x() - leftCellEdge);	/// (rightCellEdge - leftCellEdge);
-		const double v = (src_pt.y() - bottomCellEdge); /// (topCellEdge - bottomCellEdge);
-		int a = clipRGB((qAlpha(p1) * (1 - v) + qAlpha(p2) * v) * (1 - u) + (qAlpha(p3) * (1 - v) + qAlpha(p4) * v) * u);
-		int r = clipRGB((qRed(p1) * (1 - v) + qRed(p2) * v) * (1 - u) + (qRed(p3) * (1 - v) + qRed(p4) * v) * u);
-		int g = clipRGB((qGreen(p1) * (1 - v) + qGreen(p2) * v) * (1 - u) + (qGreen(p3) * (1 - v) + qGreen(p4) * v) * u);
-		int b = clipRGB((qBlue(p1) * (1 - v) + qBlue(p2) * v) * (1 - u) + (qBlue(p3) * (1 - v) + qBlue(p4) * v) * u);
-
-		dst[i] = qRgba(r, g, b, a);
-	}
-}
-
-inline VipNDArray warpSimpleArray(const VipNDArray& ar, const VipPointVector& warping)
-{
-	if (warping.size() != ar.size())
-		return VipNDArray();
-
-	if (ar.isNumeric()) {
-		VipNDArray out = ar;
-		switch (ar.dataType()) {
-			case QMetaType::Bool:
-				applyWarpingNoInterpolation((bool*)ar.data(), (bool*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::SChar:
-				applyWarpingNoInterpolation((signed char*)ar.data(), (signed char*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::Char:
-				applyWarpingNoInterpolation((char*)ar.data(), (char*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::UChar:
-				applyWarpingNoInterpolation((unsigned char*)ar.data(), (unsigned char*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::UShort:
-				applyWarpingNoInterpolation((unsigned short*)ar.data(), (unsigned short*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::Short:
-				applyWarpingNoInterpolation((short*)ar.data(), (short*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::UInt:
-				applyWarpingNoInterpolation((quint32*)ar.data(), (quint32*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::Int:
-				applyWarpingNoInterpolation((qint32*)ar.data(), (qint32*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::ULong:
-				applyWarpingNoInterpolation((unsigned long*)ar.data(), (unsigned long*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::Long:
-				applyWarpingNoInterpolation((long*)ar.data(), (long*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::ULongLong:
-				applyWarpingNoInterpolation((quint64*)ar.data(), (quint64*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::LongLong:
-				applyWarpingNoInterpolation((qint64*)ar.data(), (qint64*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::Double:
-				applyWarping((double*)ar.data(), (double*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-			case QMetaType::Float:
-				applyWarping((float*)ar.data(), (float*)out.data(), ar.shape(1), ar.shape(0), warping);
-				break;
-		}
-		return out;
-	}
-	else if (ar.dataType() == qMetaTypeId<long double>()) {
-		VipNDArray out = ar;
-		applyWarping((long double*)ar.data(), (long double*)out.data(), ar.shape(1), ar.shape(0), warping);
-	}
-	else if (ar.isComplex()) {
-		VipNDArray out = ar;
-		if (ar.dataType() == qMetaTypeId<complex_f>())
-			applyWarping((complex_f*)ar.data(), (complex_f*)out.data(), ar.shape(1), ar.shape(0), warping);
-		else
-			applyWarping((complex_d*)ar.data(), (complex_d*)out.data(), ar.shape(1), ar.shape(0), warping);
-		return out;
-	}
-	else if (ar.isRGB()) {
-		const QImage in = vipToImage(ar);
-		QImage out(in.width(), in.height(), QImage::Format_ARGB32);
-
-		const QRgb* in_p = (QRgb*)in.bits();
-		QRgb* out_p = (QRgb*)out.bits();
-
-		applyWarpingRGB(in_p, out_p, ar.shape(1), ar.shape(0), warping);
-		return vipToArray(out);
-	}
-	return VipNDArray();
-}
-
-inline VipNDArray warpAnyArray(const VipNDArray& ar, const VipPointVector& warping)
+inline VipNDArray warpAnyArray(const VipNDArray& ar, const VipWarpingLUT& lut, const VipProcessingObject* alloc)
 {
 	if (vipIsMultiNDArray(ar)) {
 		VipMultiNDArray multi(ar);
@@ -316,23 +142,41 @@ inline VipNDArray warpAnyArray(const VipNDArray& ar, const VipPointVector& warpi
 		const QMap<QString, VipNDArray> arrays = multi.namedArrays();
 
 		for (QMap<QString, VipNDArray>::const_iterator it = arrays.begin(); it != arrays.end(); ++it) {
-			VipNDArray tmp = warpAnyArray(it.value(), warping);
+			VipNDArray tmp = warpAnyArray(it.value(), lut, alloc);
 			if (!tmp.isEmpty())
 				res.addArray(it.key(), tmp);
 		}
 		return res;
 	}
 	else {
-		return warpSimpleArray(ar, warping);
+		return lut.apply(ar, alloc);
 	}
 }
 
 VipWarping::VipWarping(QObject* parent)
   : VipSceneModelBasedProcessing(parent)
+  , m_version(0)
 {
 	outputAt(0)->setData(QVariant::fromValue(VipNDArray()));
 }
 
+VipPointVector VipWarping::warping() const
+{
+	QMutexLocker lock(&m_mutex);
+	return m_warping;
+}
+
+void VipWarping::setWarping(const VipPointVector& warp)
+{
+	{
+		QMutexLocker lock(&m_mutex);
+		m_warping = warp;
+		m_lut = VipWarpingLUT();
+		++m_version;
+	}
+	emitProcessingChanged();
+}
+
 void VipWarping::apply()
 {
 	VipAnyData any = inputAt(0)->data();
@@ -343,13 +187,32 @@ void VipWarping::apply()
 		return;
 	}
 
-	if (!m_warping.size() || m_warping.size() != ar.size()) {
+	// work on copies (implicitly shared) so that setWarping() can be called concurrently
+	VipPointVector warping;
+	VipWarpingLUT lut;
+	quint64 version;
+	{
+		QMutexLocker lock(&m_mutex);
+		warping = m_warping;
+		lut = m_lut;
+		version = m_version;
+	}
+
+	if (!warping.size() || warping.size() != ar.size()) {
 		// setError("wrong warping size");
 		outputAt(0)->setData(any);
 		return;
 	}
 
-	ar = warpAnyArray(ar, m_warping);
+	if (lut.width() != ar.shape(1) || lut.height() != ar.shape(0)) {
+		// compile the field outside the lock, and only keep it if the field did not change in the meantime
+		lut = VipWarpingLUT(warping, ar.shape(1), ar.shape(0));
+		QMutexLocker lock(&m_mutex);
+		if (version == m_version)
+			m_lut = lut;
+	}
+
+	ar = warpAnyArray(ar, lut, this);
 	VipAnyData out = create(QVariant::fromValue(ar));
 	out.setTime(any.time());
 	outputAt(0)->setData(out);
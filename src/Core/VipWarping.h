@@ -35,6 +35,9 @@
 #include "VipImageProcessing.h"
 #include "VipMultiNDArray.h"
 #include "VipNDArray.h"
+#include "VipWarpingKernels.h"
+
+#include <QMutex>
 
 VIP_CORE_EXPORT VipPointVector vipWarping(QVector<QPoint> pts1, QVector<QPoint> pts2, int width, int height);
 
@@ -47,7 +50,13 @@ class VIP_CORE_EXPORT VipWarping : public VipSceneModelBasedProcessing
 	Q_CLASSINFO("category", "Miscellaneous")
 	Q_CLASSINFO("description", "Image warping based on Delaunay triangulation")
 
+	// m_warping and m_lut are shared between setWarping() and apply() which run on different threads
+	mutable QMutex m_mutex;
 	VipPointVector m_warping;
+	// m_warping compiled on the first frame
+	VipWarpingLUT m_lut;
+	// incremented by setWarping(), used to discard a LUT compiled from a previous field
+	quint64 m_version;
 
 public:
 	VipWarping(QObject* parent = nullptr);
@@ -55,12 +64,11 @@ public:
 	virtual DisplayHint displayHint() const { return InputTransform; }
 	virtual bool acceptInput(int /*index*/, const QVariant& v) const { return v.userType() == qMetaTypeId<VipNDArray>(); }
 
-	const VipPointVector& warping() const { return m_warping; }
-	void setWarping(const VipPointVector& warp)
-	{
-		m_warping = warp;
-		emitProcessingChanged();
-	}
+	VipPointVector warping() const;
+	/// Set the deformation field: for each pixel of the output image, the position of the pixel to sample in the input image
+	/// (as returned by vipWarping()). The field is compiled into a VipWarpingLUT when processing the first frame.
+	/// This function is thread safe and can be called while the processing is running.
+	void setWarping(const VipPointVector& warp);
 
 protected:
 	virtual void apply();
@@ -0,0 +1,486 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "VipWarpingKernels.h"
+#include "VipIterator.h"
+#include "VipProcessingObject.h"
+#include "VipSIMD.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VIP_WARPING_X86
+#include <immintrin.h>
+#endif
+
+// Kernels are compiled for their own instruction set and selected at runtime,
+// so that the library can still be built without -mavx2.
+#if defined(__GNUC__) || defined(__clang__)
+#define VIP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VIP_TARGET_AVX2
+#endif
+
+// Pixel count processed by each thread
+static constexpr qsizetype _block_size = 16384;
+
+namespace
+{
+	static constexpr quint32 _weight_mask = 0x7FFF;
+
+	// used float for float and complex_f, double otherwise
+	template<class T>
+	struct select_type
+	{
+		typedef double type;
+	};
+	template<>
+	struct select_type<float>
+	{
+		typedef float type;
+	};
+	template<>
+	struct select_type<complex_f>
+	{
+		typedef float type;
+	};
+
+	/// Scalar kernels, the vectorized ones must produce exactly the same output
+
+	inline qint32 nearestOffset(qint32 offset, quint32 w, qint32 dx, qint32 dy)
+	{
+		return offset + ((w & _weight_mask) >= VipWarpingLUT::WeightOne / 2 ? dx : 0) + (((w >> 16) & _weight_mask) >= VipWarpingLUT::WeightOne / 2 ? dy : 0);
+	}
+
+	template<class T>
+	void nearestScalar(const T* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, T* dst)
+	{
+		for (qsizetype i = 0; i < size; ++i)
+			dst[i] = src[nearestOffset(offsets[i], weights[i], dx, dy)];
+	}
+
+	template<class T>
+	void bilinearScalar(const T* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, T* dst)
+	{
+		typedef typename select_type<T>::type type;
+		const type scale = type(1) / VipWarpingLUT::WeightOne;
+		for (qsizetype i = 0; i < size; ++i) {
+			const T* p = src + offsets[i];
+			const type fx = (type)(weights[i] & _weight_mask) * scale;
+			const type fy = (type)((weights[i] >> 16) & _weight_mask) * scale;
+			const T top = p[0] + (p[dx] - p[0]) * fx;
+			const T bottom = p[dy] + (p[dy + dx] - p[dy]) * fx;
+			dst[i] = top + (bottom - top) * fy;
+		}
+	}
+
+	/// Interpolate the 4 channels of 2 QRgb with a weight in [0, 256]
+	inline quint32 lerpRGB(quint32 a, quint32 b, quint32 w)
+	{
+		const quint32 m = 0x00FF00FF;
+		const quint32 even = (((a & m) * (256 - w) + (b & m) * w) >> 8) & m;
+		const quint32 odd = ((((a >> 8) & m) * (256 - w) + ((b >> 8) & m) * w) >> 8) & m;
+		return even | (odd << 8);
+	}
+
+	inline quint32 weightRGB(quint32 w) { return (w + 32) >> 6; }
+
+	void bilinearRGBScalar(const quint32* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, quint32* dst)
+	{
+		for (qsizetype i = 0; i < size; ++i) {
+			const quint32* p = src + offsets[i];
+			const quint32 wx = weightRGB(weights[i] & _weight_mask);
+			const quint32 wy = weightRGB((weights[i] >> 16) & _weight_mask);
+			dst[i] = lerpRGB(lerpRGB(p[0], p[dx], wx), lerpRGB(p[dy], p[dy + dx], wx), wy);
+		}
+	}
+
+#ifdef VIP_WARPING_X86
+
+	//
+	// AVX2 kernels based on gather instructions
+	//
+
+	VIP_TARGET_AVX2 inline __m256i nearestOffsets(const qint32* offsets, const quint32* weights, __m256i dx, __m256i dy)
+	{
+		const __m256i mask = _mm256_set1_epi32(_weight_mask);
+		const __m256i half = _mm256_set1_epi32(VipWarpingLUT::WeightOne / 2 - 1);
+		const __m256i w = _mm256_loadu_si256((const __m256i*)weights);
+		const __m256i wx = _mm256_and_si256(w, mask);
+		const __m256i wy = _mm256_and_si256(_mm256_srli_epi32(w, 16), mask);
+		__m256i o = _mm256_loadu_si256((const __m256i*)offsets);
+		o = _mm256_add_epi32(o, _mm256_and_si256(_mm256_cmpgt_epi32(wx, half), dx));
+		return _mm256_add_epi32(o, _mm256_and_si256(_mm256_cmpgt_epi32(wy, half), dy));
+	}
+
+	VIP_TARGET_AVX2 void nearestAVX2(const qint32* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, qint32* dst)
+	{
+		const __m256i vdx = _mm256_set1_epi32(dx);
+		const __m256i vdy = _mm256_set1_epi32(dy);
+		qsizetype i = 0;
+		for (; i + 8 <= size; i += 8) {
+			const __m256i o = nearestOffsets(offsets + i, weights + i, vdx, vdy);
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_i32gather_epi32((const int*)src, o, 4));
+		}
+		nearestScalar(src, offsets + i, weights + i, size - i, dx, dy, dst + i);
+	}
+
+	VIP_TARGET_AVX2 void nearestAVX2(const qint64* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, qint64* dst)
+	{
+		const __m256i vdx = _mm256_set1_epi32(dx);
+		const __m256i vdy = _mm256_set1_epi32(dy);
+		qsizetype i = 0;
+		for (; i + 8 <= size; i += 8) {
+			const __m256i o = nearestOffsets(offsets + i, weights + i, vdx, vdy);
+			const __m256i lo = _mm256_i32gather_epi64((const long long*)src, _mm256_castsi256_si128(o), 8);
+			const __m256i hi = _mm256_i32gather_epi64((const long long*)src, _mm256_extracti128_si256(o, 1), 8);
+			_mm256_storeu_si256((__m256i*)(dst + i), lo);
+			_mm256_storeu_si256((__m256i*)(dst + i + 4), hi);
+		}
+		nearestScalar(src, offsets + i, weights + i, size - i, dx, dy, dst + i);
+	}
+
+	VIP_TARGET_AVX2 void bilinearAVX2(const float* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, float* dst)
+	{
+		const __m256i vdx = _mm256_set1_epi32(dx);
+		const __m256i vdy = _mm256_set1_epi32(dy);
+		const __m256i mask = _mm256_set1_epi32(_weight_mask);
+		const __m256 scale = _mm256_set1_ps(1.f / VipWarpingLUT::WeightOne);
+		qsizetype i = 0;
+		for (; i + 8 <= size; i += 8) {
+			const __m256i o00 = _mm256_loadu_si256((const __m256i*)(offsets + i));
+			const __m256i o10 = _mm256_add_epi32(o00, vdy);
+			const __m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+			const __m256 fx = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(w, mask)), scale);
+			const __m256 fy = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(w, 16), mask)), scale);
+			const __m256 p00 = _mm256_i32gather_ps(src, o00, 4);
+			const __m256 p01 = _mm256_i32gather_ps(src, _mm256_add_epi32(o00, vdx), 4);
+			const __m256 p10 = _mm256_i32gather_ps(src, o10, 4);
+			const __m256 p11 = _mm256_i32gather_ps(src, _mm256_add_epi32(o10, vdx), 4);
+			const __m256 top = _mm256_add_ps(p00, _mm256_mul_ps(_mm256_sub_ps(p01, p00), fx));
+			const __m256 bottom = _mm256_add_ps(p10, _mm256_mul_ps(_mm256_sub_ps(p11, p10), fx));
+			_mm256_storeu_ps(dst + i, _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), fy)));
+		}
+		bilinearScalar(src, offsets + i, weights + i, size - i, dx, dy, dst + i);
+	}
+
+	VIP_TARGET_AVX2 void bilinearAVX2(const double* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, double* dst)
+	{
+		const __m128i vdx = _mm_set1_epi32(dx);
+		const __m128i vdy = _mm_set1_epi32(dy);
+		const __m128i mask = _mm_set1_epi32(_weight_mask);
+		const __m256d scale = _mm256_set1_pd(1. / VipWarpingLUT::WeightOne);
+		qsizetype i = 0;
+		for (; i + 4 <= size; i += 4) {
+			const __m128i o00 = _mm_loadu_si128((const __m128i*)(offsets + i));
+			const __m128i o10 = _mm_add_epi32(o00, vdy);
+			const __m128i w = _mm_loadu_si128((const __m128i*)(weights + i));
+			const __m256d fx = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_and_si128(w, mask)), scale);
+			const __m256d fy = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_and_si128(_mm_srli_epi32(w, 16), mask)), scale);
+			const __m256d p00 = _mm256_i32gather_pd(src, o00, 8);
+			const __m256d p01 = _mm256_i32gather_pd(src, _mm_add_epi32(o00, vdx), 8);
+			const __m256d p10 = _mm256_i32gather_pd(src, o10, 8);
+			const __m256d p11 = _mm256_i32gather_pd(src, _mm_add_epi32(o10, vdx), 8);
+			const __m256d top = _mm256_add_pd(p00, _mm256_mul_pd(_mm256_sub_pd(p01, p00), fx));
+			const __m256d bottom = _mm256_add_pd(p10, _mm256_mul_pd(_mm256_sub_pd(p11, p10), fx));
+			_mm256_storeu_pd(dst + i, _mm256_add_pd(top, _mm256_mul_pd(_mm256_sub_pd(bottom, top), fy)));
+		}
+		bilinearScalar(src, offsets + i, weights + i, size - i, dx, dy, dst + i);
+	}
+
+	/// Interpolate the 4 channels of 8 QRgb, w and iw contain the weights and 256 - weights replicated in both 16 bits halves
+	VIP_TARGET_AVX2 inline __m256i lerpRGB(__m256i a, __m256i b, __m256i w, __m256i iw)
+	{
+		const __m256i m = _mm256_set1_epi32(0x00FF00FF);
+		const __m256i even = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(a, m), iw), _mm256_mullo_epi16(_mm256_and_si256(b, m), w)), 8);
+		const __m256i odd = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(a, 8), iw), _mm256_mullo_epi16(_mm256_srli_epi16(b, 8), w)), 8);
+		return _mm256_or_si256(even, _mm256_slli_epi16(odd, 8));
+	}
+
+	VIP_TARGET_AVX2 void bilinearRGBAVX2(const quint32* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, quint32* dst)
+	{
+		const __m256i vdx = _mm256_set1_epi32(dx);
+		const __m256i vdy = _mm256_set1_epi32(dy);
+		const __m256i mask = _mm256_set1_epi32(_weight_mask);
+		const __m256i round = _mm256_set1_epi32(32);
+		const __m256i one = _mm256_set1_epi16(256);
+		const int* s = (const int*)src;
+		qsizetype i = 0;
+		for (; i + 8 <= size; i += 8) {
+			const __m256i o00 = _mm256_loadu_si256((const __m256i*)(offsets + i));
+			const __m256i o10 = _mm256_add_epi32(o00, vdy);
+			const __m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+			__m256i wx = _mm256_srli_epi32(_mm256_add_epi32(_mm256_and_si256(w, mask), round), 6);
+			__m256i wy = _mm256_srli_epi32(_mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(w, 16), mask), round), 6);
+			wx = _mm256_or_si256(wx, _mm256_slli_epi32(wx, 16));
+			wy = _mm256_or_si256(wy, _mm256_slli_epi32(wy, 16));
+			const __m256i iwx = _mm256_sub_epi16(one, wx);
+			const __m256i iwy = _mm256_sub_epi16(one, wy);
+			const __m256i p00 = _mm256_i32gather_epi32(s, o00, 4);
+			const __m256i p01 = _mm256_i32gather_epi32(s, _mm256_add_epi32(o00, vdx), 4);
+			const __m256i p10 = _mm256_i32gather_epi32(s, o10, 4);
+			const __m256i p11 = _mm256_i32gather_epi32(s, _mm256_add_epi32(o10, vdx), 4);
+			const __m256i top = lerpRGB(p00, p01, wx, iwx);
+			const __m256i bottom = lerpRGB(p10, p11, wx, iwx);
+			_mm256_storeu_si256((__m256i*)(dst + i), lerpRGB(top, bottom, wy, iwy));
+		}
+		bilinearRGBScalar(src, offsets + i, weights + i, size - i, dx, dy, dst + i);
+	}
+
+#endif
+
+	VipWarpingKernels::Level computeSupportedLevel()
+	{
+#ifdef VIP_WARPING_X86
+		if (vipCPUFeatures().HAS_AVX2)
+			return VipWarpingKernels::AVX2;
+#endif
+		return VipWarpingKernels::Scalar;
+	}
+
+	std::atomic<int>& currentLevel()
+	{
+		static std::atomic<int> level{ (int)VipWarpingKernels::supportedLevel() };
+		return level;
+	}
+
+	template<class T>
+	void nearestBlock(VipWarpingKernels::Level level, const T* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, T* dst)
+	{
+#ifdef VIP_WARPING_X86
+		if (level == VipWarpingKernels::AVX2) {
+			if constexpr (sizeof(T) == 4)
+				return nearestAVX2((const qint32*)src, offsets, weights, size, dx, dy, (qint32*)dst);
+			else if constexpr (sizeof(T) == 8)
+				return nearestAVX2((const qint64*)src, offsets, weights, size, dx, dy, (qint64*)dst);
+		}
+#else
+		(void)level;
+#endif
+		nearestScalar(src, offsets, weights, size, dx, dy, dst);
+	}
+
+	template<class T>
+	void bilinearBlock(VipWarpingKernels::Level level, const T* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, T* dst)
+	{
+#ifdef VIP_WARPING_X86
+		if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+			if (level == VipWarpingKernels::AVX2)
+				return bilinearAVX2(src, offsets, weights, size, dx, dy, dst);
+		}
+#endif
+		(void)level;
+		bilinearScalar(src, offsets, weights, size, dx, dy, dst);
+	}
+
+	void bilinearRGBBlock(VipWarpingKernels::Level level, const quint32* src, const qint32* offsets, const quint32* weights, qsizetype size, qint32 dx, qint32 dy, quint32* dst)
+	{
+#ifdef VIP_WARPING_X86
+		if (level == VipWarpingKernels::AVX2)
+			return bilinearRGBAVX2(src, offsets, weights, size, dx, dy, dst);
+#else
+		(void)level;
+#endif
+		bilinearRGBScalar(src, offsets, weights, size, dx, dy, dst);
+	}
+
+	enum Mode
+	{
+		Nearest,
+		Bilinear,
+		BilinearRGB
+	};
+
+	template<Mode mode, class T>
+	void warpTyped(const VipWarpingLUT& lut, const void* _src, void* _dst)
+	{
+		const T* src = static_cast<const T*>(_src);
+		T* dst = static_cast<T*>(_dst);
+		const VipWarpingKernels::Level level = VipWarpingKernels::level();
+		const qsizetype size = (qsizetype)lut.width() * lut.height();
+		const qsizetype blocks = (size + _block_size - 1) / _block_size;
+
+		VIP_PARALLEL_FOR_NUM_THREADS(vipLoopThreadCount((int)std::min(size, (qsizetype)INT_MAX)))
+		for (qsizetype b = 0; b < blocks; ++b) {
+			const qsizetype start = b * _block_size;
+			const qsizetype count = std::min(_block_size, size - start);
+			const qint32* offsets = lut.offsets() + start;
+			const quint32* weights = lut.weights() + start;
+			if constexpr (mode == Nearest)
+				nearestBlock(level, src, offsets, weights, count, lut.rightOffset(), lut.bottomOffset(), dst + start);
+			else if constexpr (mode == Bilinear)
+				bilinearBlock(level, src, offsets, weights, count, lut.rightOffset(), lut.bottomOffset(), dst + start);
+			else
+				bilinearRGBBlock(level, src, offsets, weights, count, lut.rightOffset(), lut.bottomOffset(), dst + start);
+		}
+	}
+}
+
+VipWarpingLUT::VipWarpingLUT()
+  : m_width(0)
+  , m_height(0)
+  , m_dx(0)
+  , m_dy(0)
+  , m_outOfBounds(0)
+{
+}
+
+VipWarpingLUT::VipWarpingLUT(const VipPointVector& field, int width, int height)
+  : VipWarpingLUT()
+{
+	const qsizetype size = (qsizetype)width * height;
+	if (width <= 0 || height <= 0 || field.size() != size || size > INT_MAX)
+		return;
+
+	m_width = width;
+	m_height = height;
+	m_dx = width > 1 ? 1 : 0;
+	m_dy = height > 1 ? width : 0;
+	m_offsets.resize(size);
+	m_weights.resize(size);
+
+	const double max_x = width - 1;
+	const double max_y = height - 1;
+	for (qsizetype i = 0; i < size; ++i) {
+		double x = field[i].x();
+		double y = field[i].y();
+
+		// clamp source positions outside the image (or NaN) to the image border
+		quint32 flag = 0;
+		if (!(x >= 0 && x <= max_x && y >= 0 && y <= max_y)) {
+			flag = OutOfBoundsFlag;
+			++m_outOfBounds;
+			x = (x > 0) ? std::min(x, max_x) : 0;
+			y = (y > 0) ? std::min(y, max_y) : 0;
+		}
+
+		// the cell top left pixel is moved inside the image on the last column/row,
+		// so that the right and bottom neighbours are always valid
+		const int x0 = std::max(0, std::min((int)x, width - 2));
+		const int y0 = std::max(0, std::min((int)y, height - 2));
+		const quint32 wx = (quint32)std::lround((x - x0) * WeightOne);
+		const quint32 wy = (quint32)std::lround((y - y0) * WeightOne);
+
+		m_offsets[i] = y0 * width + x0;
+		m_weights[i] = wx | flag | (wy << 16);
+	}
+}
+
+VipNDArray VipWarpingLUT::apply(const VipNDArray& input, const VipProcessingObject* alloc) const
+{
+	if (isEmpty() || input.shapeCount() != 2 || input.shape(0) != m_height || input.shape(1) != m_width)
+		return VipNDArray();
+
+	// all output pixels are written, so we can use an uninitialized (possibly recycled) frame
+	const auto create = [&](int data_type) { return alloc ? alloc->createFrame(data_type, input.shape()) : VipNDArray(data_type, input.shape()); };
+
+	if (input.isRGB()) {
+		const QImage in = vipToImage(input);
+		VipNDArray out = create(qMetaTypeId<VipRGB>());
+		warpTyped<BilinearRGB, quint32>(*this, in.constBits(), out.data());
+		return out;
+	}
+
+	// kernels work on dense arrays
+	const VipNDArray ar = (input.isView() || !input.isUnstrided()) ? input.copy() : input;
+	VipNDArray out = create(ar.dataType());
+	const void* src = ar.constData();
+	void* dst = out.data();
+
+	switch (ar.dataType()) {
+		case QMetaType::Bool:
+			warpTyped<Nearest, bool>(*this, src, dst);
+			break;
+		case QMetaType::SChar:
+		case QMetaType::Char:
+		case QMetaType::UChar:
+			warpTyped<Nearest, quint8>(*this, src, dst);
+			break;
+		case QMetaType::UShort:
+		case QMetaType::Short:
+			warpTyped<Nearest, quint16>(*this, src, dst);
+			break;
+		case QMetaType::UInt:
+		case QMetaType::Int:
+			warpTyped<Nearest, quint32>(*this, src, dst);
+			break;
+		case QMetaType::ULong:
+		case QMetaType::Long:
+			if (sizeof(long) == 8)
+				warpTyped<Nearest, quint64>(*this, src, dst);
+			else
+				warpTyped<Nearest, quint32>(*this, src, dst);
+			break;
+		case QMetaType::ULongLong:
+		case QMetaType::LongLong:
+			warpTyped<Nearest, quint64>(*this, src, dst);
+			break;
+		case QMetaType::Float:
+			warpTyped<Bilinear, float>(*this, src, dst);
+			break;
+		case QMetaType::Double:
+			warpTyped<Bilinear, double>(*this, src, dst);
+			break;
+		default:
+			if (ar.dataType() == qMetaTypeId<long double>())
+				warpTyped<Bilinear, long double>(*this, src, dst);
+			else if (ar.dataType() == qMetaTypeId<complex_f>())
+				warpTyped<Bilinear, complex_f>(*this, src, dst);
+			else if (ar.dataType() == qMetaTypeId<complex_d>())
+				warpTyped<Bilinear, complex_d>(*this, src, dst);
+			else
+				return VipNDArray();
+	}
+	return out;
+}
+
+namespace VipWarpingKernels
+{
+	Level supportedLevel()
+	{
+		static const Level level = computeSupportedLevel();
+		return level;
+	}
+
+	Level level()
+	{
+		return (Level)currentLevel().load(std::memory_order_relaxed);
+	}
+
+	void setLevel(Level l)
+	{
+		currentLevel().store((int)std::min(l, supportedLevel()));
+	}
+}
@@ -0,0 +1,124 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_WARPING_KERNELS_H
+#define VIP_WARPING_KERNELS_H
+
+#include "VipNDArray.h"
+
+#include <QVector>
+
+/// \addtogroup Core
+/// @{
+
+class VipProcessingObject;
+
+/// @brief Compiled deformation field used by VipWarping.
+///
+/// A deformation field gives, for each output pixel, the (floating point) position of the pixel to sample in the input image.
+/// VipWarpingLUT compiles it once into 8 bytes per pixel:
+/// - the int32 offset of the top left source pixel, always clamped inside the image,
+/// - the horizontal and vertical bilinear weights in 14 bits fixed point, packed in a single uint32 along with an out-of-bounds flag.
+///
+/// Frames are then sampled with kernels vectorized per pixel type (see VipWarpingKernels).
+/// Integer images use the nearest neighbour, floating point and complex images use a bilinear interpolation
+/// and RGB images use a per-channel bilinear interpolation with 8 bits weights.
+/// Source positions outside the image are clamped to the image border and flagged as out of bounds.
+class VIP_CORE_EXPORT VipWarpingLUT
+{
+public:
+	/// Fixed point precision of the bilinear weights
+	static constexpr int WeightBits = 14;
+	static constexpr quint32 WeightOne = 1u << WeightBits;
+	static constexpr quint32 OutOfBoundsFlag = 1u << 15;
+
+	VipWarpingLUT();
+	/// Compile a deformation field of size width * height (row major)
+	VipWarpingLUT(const VipPointVector& field, int width, int height);
+
+	bool isEmpty() const { return m_offsets.isEmpty(); }
+	int width() const { return m_width; }
+	int height() const { return m_height; }
+	/// Number of output pixels whose source position lies outside the input image
+	qsizetype outOfBoundsCount() const { return m_outOfBounds; }
+	/// Returns true if the source position of given output pixel lies outside the input image
+	bool isOutOfBounds(qsizetype index) const { return m_weights[index] & OutOfBoundsFlag; }
+
+	/// Source offsets (top left pixel of the bilinear cell)
+	const qint32* offsets() const { return m_offsets.constData(); }
+	/// Packed weights: horizontal weight in bits [0, 14], vertical weight in bits [16, 30], out-of-bounds flag in bit 15
+	const quint32* weights() const { return m_weights.constData(); }
+	/// Offset of the right and bottom neighbours (0 for single column or single row images)
+	qint32 rightOffset() const { return m_dx; }
+	qint32 bottomOffset() const { return m_dy; }
+
+	/// Warp a 2D array of the LUT size.
+	/// The output is allocated with alloc->createFrame() if alloc is not null.
+	/// Returns a null array if the array type is not supported or if its shape does not match the LUT.
+	VipNDArray apply(const VipNDArray& ar, const VipProcessingObject* alloc = nullptr) const;
+
+private:
+	QVector<qint32> m_offsets;
+	QVector<quint32> m_weights;
+	int m_width;
+	int m_height;
+	qint32 m_dx;
+	qint32 m_dy;
+	qsizetype m_outOfBounds;
+};
+
+/// @brief Vectorized sampling kernels used by VipWarpingLUT::apply().
+///
+/// The AVX2 kernels rely on gather instructions and produce exactly the same output as the scalar ones.
+/// The instruction set is selected at runtime based on vipCPUFeatures().
+namespace VipWarpingKernels
+{
+	/// Instruction set used by the kernels
+	enum Level
+	{
+		Scalar,
+		AVX2
+	};
+
+	/// Returns the best instruction set supported by the CPU
+	VIP_CORE_EXPORT Level supportedLevel();
+	/// Returns the instruction set currently used (default to supportedLevel())
+	VIP_CORE_EXPORT Level level();
+	/// Set the instruction set to use. The level is clamped to supportedLevel().
+	/// This is mainly used for benchmarking.
+	VIP_CORE_EXPORT void setLevel(Level);
+}
+
+/// @}
+// end Core
+
+#endif
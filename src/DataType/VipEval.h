@@ -33,7 +33,10 @@
 #define VIP_EVAL_H
 
 
+#include <algorithm>
+#include <climits>
 #include <optional>
+#include <vector>
 
 #include "VipNDArray.h"
 #include "VipNDArrayOperations.h"
@@ -70,46 +73,48 @@ namespace detail
 		constexpr bool isUnstrided() const noexcept { return true; }
 	};
 
+	/// Detect reduction algorithms that can be evaluated in parallel.
+	/// Such reductors provide:
+	/// - bool joinable() const: tells if the reductor can be split at runtime,
+	/// - Reductor fork() const: returns an empty reductor with the same configuration,
+	/// - void join(const Reductor&): merges the result of a forked reductor that processed the elements following the ones of this reductor.
+	template<class Reductor, class = void>
+	struct IsJoinableReductor : std::false_type
+	{
+	};
+	template<class Reductor>
+	struct IsJoinableReductor<Reductor,
+				  std::void_t<decltype(std::declval<const Reductor&>().joinable()),
+					      decltype(std::declval<const Reductor&>().fork()),
+					      decltype(std::declval<Reductor&>().join(std::declval<const Reductor&>()))>> : std::true_type
+	{
+	};
+
 	template<class OverRoi>
 	struct Eval
 	{
+		/// Evaluate src into dst for the outer coordinates (flat index if flat is true, first dimension otherwise) in [begin, end)
 		template<class Dst, class Src>
-		static bool apply(Dst& dst, const Src& src, const OverRoi& roi)
+		static void applyRange(Dst& dst, ValueType_t<Dst>* ptr, const Src& src, const OverRoi& roi, bool flat, qsizetype begin, qsizetype end)
 		{
 			static constexpr auto reduce = std::is_base_of_v<BaseReductor, Dst>;
 
-			using dtype = ValueType_t<Dst>;
-
-			qsizetype size = 0;
-			dtype* ptr = nullptr;
-			if constexpr (!reduce) {
-				size = dst.size();
-				ptr = (dtype*)dst.constPtr();
-				if (!ptr)
-					return false;
-			}
-			else
-				size = vipCumMultiply(src.shape());
-
-			if ((Dst::access_type & Vip::Flat) && (Src::access_type & Vip::Flat) && (OverRoi::access_type & Vip::Flat) && dst.isUnstrided() && src.isUnstrided() && roi.isUnstrided()) {
+			if (flat) {
 				if constexpr ((Dst::access_type & Vip::Flat) && (Src::access_type & Vip::Flat) && (OverRoi::access_type & Vip::Flat)) {
 
 					const Src s = src;
-					for (qsizetype i = 0; i < size; ++i)
+					for (qsizetype i = begin; i < end; ++i)
 						if (roi[i]) {
 							if constexpr (!reduce)
 								ptr[i] = (s[i]);
 							else
 								dst.setAt(i, (s[i]));
 						}
-					return true;
 				}
 			}
-
-			if (src.shape().size() == 1) {
-				const qsizetype w = src.shape()[0];
+			else if (src.shape().size() == 1) {
 				VipCoordinate<1> p = { { 0 } };
-				for (p[0] = 0; p[0] < w; ++p[0])
+				for (p[0] = begin; p[0] < end; ++p[0])
 					if (roi(p)) {
 						if constexpr (!reduce)
 							ptr[dst.stride(0) * p[0]] = (src(p));
@@ -118,10 +123,9 @@ namespace detail
 					}
 			}
 			else if (src.shape().size() == 2) {
-				const qsizetype h = src.shape()[0];
 				const qsizetype w = src.shape()[1];
 				VipCoordinate<2> p = { { 0, 0 } };
-				for (p[0] = 0; p[0] < h; ++p[0])
+				for (p[0] = begin; p[0] < end; ++p[0])
 					for (p[1] = 0; p[1] < w; ++p[1])
 						if (roi(p)) {
 							if constexpr (!reduce)
@@ -131,11 +135,10 @@ namespace detail
 						}
 			}
 			else if (src.shape().size() == 3) {
-				const qsizetype z = src.shape()[0];
 				const qsizetype h = src.shape()[1];
 				const qsizetype w = src.shape()[2];
 				VipCoordinate<3> p = { { 0, 0, 0 } };
-				for (p[0] = 0; p[0] < z; ++p[0])
+				for (p[0] = begin; p[0] < end; ++p[0])
 					for (p[1] = 0; p[1] < h; ++p[1])
 						for (p[2] = 0; p[2] < w; ++p[2])
 							if (roi(p)) {
@@ -146,6 +149,7 @@ namespace detail
 							}
 			}
 			else {
+				// higher dimensions are always walked at once
 				vip_iter_fmajor(src.shape(), c)
 				{
 					if (roi(c)) {
@@ -156,6 +160,81 @@ namespace detail
 					}
 				}
 			}
+		}
+
+		template<class Dst, class Src>
+		static bool apply(Dst& dst, const Src& src, const OverRoi& roi)
+		{
+			static constexpr auto reduce = std::is_base_of_v<BaseReductor, Dst>;
+
+			using dtype = ValueType_t<Dst>;
+
+			qsizetype size = 0;
+			dtype* ptr = nullptr;
+			if constexpr (!reduce) {
+				size = dst.size();
+				ptr = (dtype*)dst.constPtr();
+				if (!ptr)
+					return false;
+			}
+			else
+				size = vipCumMultiply(src.shape());
+
+			bool flat = false;
+			if ((Dst::access_type & Vip::Flat) && (Src::access_type & Vip::Flat) && (OverRoi::access_type & Vip::Flat) && dst.isUnstrided() && src.isUnstrided() && roi.isUnstrided())
+				flat = true;
+
+			// Outer iteration space: flat indexes or first dimension.
+			// Dimensions above 3 are walked at once.
+			const qsizetype dims = src.shape().size();
+			const qsizetype outer = flat ? size : (dims <= 3 ? (dims ? src.shape()[0] : 0) : 1);
+			if (outer <= 0)
+				return true;
+			const qsizetype inner = std::max(size / outer, (qsizetype)1);
+
+			int threads = 1;
+#ifdef _OPENMP
+			if (outer > 1)
+				threads = vipLoopThreadCount((int)std::min(size, (qsizetype)INT_MAX));
+#endif
+			if constexpr (reduce) {
+				if constexpr (IsJoinableReductor<Dst>::value) {
+					if (threads > 1 && dst.joinable()) {
+						// Split the iteration space in cache-sized tiles, each one being reduced by a forked reductor.
+						// Tiles are merged back in order, so the result does not depend on the thread count.
+						const qsizetype tile = std::max((qsizetype)vipParallelTileSize() / inner, (qsizetype)1);
+						const qsizetype tiles = (outer + tile - 1) / tile;
+						if (tiles > 1) {
+							std::vector<Dst> reductors;
+							reductors.reserve(tiles);
+							for (qsizetype t = 0; t < tiles; ++t)
+								reductors.push_back(dst.fork());
+
+							VIP_PARALLEL_FOR_NUM_THREADS(threads)
+							for (qsizetype t = 0; t < tiles; ++t)
+								applyRange(reductors[t], ptr, src, roi, flat, t * tile, std::min(outer, (t + 1) * tile));
+
+							for (qsizetype t = 0; t < tiles; ++t)
+								dst.join(reductors[t]);
+							return true;
+						}
+					}
+				}
+				// Generic reductors are order dependant: use a single thread
+				applyRange(dst, ptr, src, roi, flat, 0, outer);
+			}
+			else {
+				if (threads > 1) {
+					// Each tile writes its own part of dst: the result is the same as the serial path
+					const qsizetype tile = std::max((qsizetype)vipParallelTileSize() / inner, (qsizetype)1);
+					const qsizetype tiles = (outer + tile - 1) / tile;
+					VIP_PARALLEL_FOR_NUM_THREADS(threads)
+					for (qsizetype t = 0; t < tiles; ++t)
+						applyRange(dst, ptr, src, roi, flat, t * tile, std::min(outer, (t + 1) * tile));
+				}
+				else
+					applyRange(dst, ptr, src, roi, flat, 0, outer);
+			}
 			return true;
 		}
 	};
@@ -590,6 +669,51 @@ bool vipEval(const Dst& _dst, const Src& src, const OverRoi& roi , detail::CErro
 	return false;
 }
 
+/// @brief Evaluation policy that forces vipEval() to use multiple threads, whatever the value of vipIterateThreadCount().
+///
+/// The iteration space (flat indexes or first dimension) is split in tiles of roughly vipParallelTileSize() elements
+/// evaluated by OpenMP threads. Results are bit-identical to the single-threaded path for functor expressions.
+/// Reduction algorithms are only parallelized if they provide the joinable()/fork()/join() members,
+/// in which case tiles are reduced independently and merged in order.
+///
+/// Usage: vipEval(dst, src, roi, VipParallel{}) or vipEval(dst, src, VipParallel{}).
+/// Arrays smaller than vipParallelSizeThreshold() are still evaluated by the calling thread.
+struct VipParallel
+{
+	/// Number of threads, 0 means all available cores
+	int threads = 0;
+};
+
+namespace detail
+{
+	/// RAII helper setting the calling thread iterate thread count
+	struct LocalThreadCount
+	{
+		int previous;
+		LocalThreadCount(int threads) noexcept
+		  : previous(vipSetLocalIterateThreadCount(threads > 0 ? threads : INT_MAX))
+		{
+		}
+		~LocalThreadCount() noexcept { vipSetLocalIterateThreadCount(previous); }
+	};
+}
+
+/// @brief Evaluate functor expression src into array dst over the Region Of Interest roi using multiple threads.
+/// See VipParallel for more details.
+template<class Dst, class Src, class OverRoi>
+bool vipEval(const Dst& dst, const Src& src, const OverRoi& roi, VipParallel policy)
+{
+	detail::LocalThreadCount guard(policy.threads);
+	return vipEval(dst, src, roi);
+}
+/// @brief Evaluate functor expression src into array dst using multiple threads.
+/// See VipParallel for more details.
+template<class Dst, class Src>
+bool vipEval(const Dst& dst, const Src& src, VipParallel policy)
+{
+	return vipEval(dst, src, VipInfinitRoi{}, policy);
+}
+
 
 
 
@@ -0,0 +1,803 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "VipFFT.h"
+#include "VipIterator.h"
+
+namespace detail
+{
+	/// Kind of transform stored in a FFTPlan
+	enum FFTKind
+	{
+		ComplexForward,
+		ComplexBackward,
+		RealForward, // half length complex plan + post-processing twiddles
+		RealBackward
+	};
+
+	/// Prime factors above this value are handled with the Bluestein algorithm
+	static const int max_generic_radix = 61;
+
+	template<class T>
+	VIP_ALWAYS_INLINE std::complex<T> cmul(const std::complex<T>& a, const std::complex<T>& b)
+	{
+		// avoid the NaN/Inf checks of std::complex multiplication
+		return std::complex<T>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+	}
+
+	/// Unnormalized 1D complex transform plan for a given length and direction.
+	/// Uses a recursive decimation in time mixed radix algorithm, or the Bluestein algorithm
+	/// if the length has a prime factor greater than max_generic_radix.
+	template<class T>
+	struct FFTPlan
+	{
+		using C = std::complex<T>;
+
+		qsizetype n{ 0 };
+		bool inverse{ false };
+		std::vector<qsizetype> factors; // (radix, remaining length) pairs
+		std::vector<C> twiddles;
+
+		// Bluestein
+		qsizetype m{ 0 };
+		std::vector<C> chirp;
+		std::vector<C> chirp_fft; // transform of the conjugated chirp, scaled by 1/m
+		std::shared_ptr<const FFTPlan> forward_m;
+		std::shared_ptr<const FFTPlan> backward_m;
+
+		// real transforms: complex plan of length n/2 and post/pre-processing twiddles
+		std::shared_ptr<const FFTPlan> half;
+		std::vector<C> real_twiddles;
+
+		/// Transform \a n values read from \a in with given stride into \a out.
+		/// \a out must not overlap \a in. \a work is a scratch buffer resized as needed.
+		void transform(const C* in, qsizetype in_stride, C* out, std::vector<C>& work) const
+		{
+			if (n == 1) {
+				out[0] = in[0];
+				return;
+			}
+			if (m) {
+				bluestein(in, in_stride, out, work);
+				return;
+			}
+			qsizetype max_radix = 0;
+			for (size_t i = 0; i < factors.size(); i += 2)
+				max_radix = std::max(max_radix, factors[i]);
+			if ((qsizetype)work.size() < max_radix)
+				work.resize(max_radix);
+			recurse(out, in, 1, in_stride, factors.data(), work.data());
+		}
+
+	private:
+		void bluestein(const C* in, qsizetype in_stride, C* out, std::vector<C>& work) const
+		{
+			if ((qsizetype)work.size() < 2 * m + 8)
+				work.resize(2 * m + 8);
+			C* a = work.data();
+			C* b = a + m;
+			for (qsizetype k = 0; k < n; ++k)
+				a[k] = cmul(in[k * in_stride], chirp[k]);
+			std::fill(a + n, a + m, C(0));
+
+			// sub plans are power of 2 transforms: they only use 4 scratch values
+			std::vector<C> scratch(4);
+			forward_m->recurse(b, a, 1, 1, forward_m->factors.data(), scratch.data());
+			for (qsizetype k = 0; k < m; ++k)
+				b[k] = cmul(b[k], chirp_fft[k]);
+			backward_m->recurse(a, b, 1, 1, backward_m->factors.data(), scratch.data());
+			for (qsizetype k = 0; k < n; ++k)
+				out[k] = cmul(a[k], chirp[k]);
+		}
+
+		void recurse(C* out, const C* in, qsizetype fstride, qsizetype in_stride, const qsizetype* f, C* scratch) const
+		{
+			const qsizetype p = *f++; // radix
+			const qsizetype s = *f++; // stage length
+			C* const beg = out;
+			C* const end = out + p * s;
+
+			if (s == 1) {
+				do {
+					*out = *in;
+					in += fstride * in_stride;
+				} while (++out != end);
+			}
+			else {
+				do {
+					recurse(out, in, fstride * p, in_stride, f, scratch);
+					in += fstride * in_stride;
+				} while ((out += s) != end);
+			}
+
+			switch (p) {
+				case 2:
+					butterfly2(beg, fstride, s);
+					break;
+				case 3:
+					butterfly3(beg, fstride, s);
+					break;
+				case 4:
+					butterfly4(beg, fstride, s);
+					break;
+				case 5:
+					butterfly5(beg, fstride, s);
+					break;
+				default:
+					butterflyGeneric(beg, fstride, s, p, scratch);
+					break;
+			}
+		}
+
+		void butterfly2(C* out, qsizetype fstride, qsizetype s) const
+		{
+			C* out2 = out + s;
+			const C* tw = twiddles.data();
+			for (qsizetype k = 0; k < s; ++k) {
+				const C t = cmul(out2[k], *tw);
+				tw += fstride;
+				out2[k] = out[k] - t;
+				out[k] += t;
+			}
+		}
+
+		void butterfly3(C* out, qsizetype fstride, qsizetype s) const
+		{
+			const T epi3 = twiddles[fstride * s].imag();
+			const C* tw1 = twiddles.data();
+			const C* tw2 = twiddles.data();
+			const qsizetype s2 = 2 * s;
+			for (qsizetype k = 0; k < s; ++k, ++out) {
+				const C s1 = cmul(out[s], *tw1);
+				const C s2v = cmul(out[s2], *tw2);
+				const C s3 = s1 + s2v;
+				const C s0 = (s1 - s2v) * epi3;
+				tw1 += fstride;
+				tw2 += 2 * fstride;
+
+				out[s] = C(out[0].real() - s3.real() * T(0.5), out[0].imag() - s3.imag() * T(0.5));
+				out[0] += s3;
+				out[s2] = C(out[s].real() + s0.imag(), out[s].imag() - s0.real());
+				out[s] = C(out[s].real() - s0.imag(), out[s].imag() + s0.real());
+			}
+		}
+
+		void butterfly4(C* out, qsizetype fstride, qsizetype s) const
+		{
+			const C* tw1 = twiddles.data();
+			const C* tw2 = twiddles.data();
+			const C* tw3 = twiddles.data();
+			const qsizetype s2 = 2 * s;
+			const qsizetype s3 = 3 * s;
+			for (qsizetype k = 0; k < s; ++k, ++out) {
+				const C c0 = cmul(out[s], *tw1);
+				const C c1 = cmul(out[s2], *tw2);
+				const C c2 = cmul(out[s3], *tw3);
+				const C c5 = out[0] - c1;
+				out[0] += c1;
+				const C c3 = c0 + c2;
+				const C c4 = c0 - c2;
+				out[s2] = out[0] - c3;
+				tw1 += fstride;
+				tw2 += 2 * fstride;
+				tw3 += 3 * fstride;
+				out[0] += c3;
+				if (inverse) {
+					out[s] = C(c5.real() - c4.imag(), c5.imag() + c4.real());
+					out[s3] = C(c5.real() + c4.imag(), c5.imag() - c4.real());
+				}
+				else {
+					out[s] = C(c5.real() + c4.imag(), c5.imag() - c4.real());
+					out[s3] = C(c5.real() - c4.imag(), c5.imag() + c4.real());
+				}
+			}
+		}
+
+		void butterfly5(C* out, qsizetype fstride, qsizetype s) const
+		{
+			const C ya = twiddles[fstride * s];
+			const C yb = twiddles[fstride * 2 * s];
+			C* o0 = out;
+			C* o1 = o0 + s;
+			C* o2 = o0 + 2 * s;
+			C* o3 = o0 + 3 * s;
+			C* o4 = o0 + 4 * s;
+			const C* tw = twiddles.data();
+			for (qsizetype u = 0; u < s; ++u) {
+				const C c0 = *o0;
+				const C c1 = cmul(*o1, tw[u * fstride]);
+				const C c2 = cmul(*o2, tw[2 * u * fstride]);
+				const C c3 = cmul(*o3, tw[3 * u * fstride]);
+				const C c4 = cmul(*o4, tw[4 * u * fstride]);
+
+				const C c7 = c1 + c4;
+				const C c10 = c1 - c4;
+				const C c8 = c2 + c3;
+				const C c9 = c2 - c3;
+
+				*o0 += c7 + c8;
+
+				const C c5(c0.real() + c7.real() * ya.real() + c8.real() * yb.real(), c0.imag() + c7.imag() * ya.real() + c8.imag() * yb.real());
+				const C c6(c10.imag() * ya.imag() + c9.imag() * yb.imag(), -c10.real() * ya.imag() - c9.real() * yb.imag());
+				*o1 = c5 - c6;
+				*o4 = c5 + c6;
+
+				const C c11(c0.real() + c7.real() * yb.real() + c8.real() * ya.real(), c0.imag() + c7.imag() * yb.real() + c8.imag() * ya.real());
+				const C c12(-c10.imag() * yb.imag() + c9.imag() * ya.imag(), c10.real() * yb.imag() - c9.real() * ya.imag());
+				*o2 = c11 + c12;
+				*o3 = c11 - c12;
+
+				++o0;
+				++o1;
+				++o2;
+				++o3;
+				++o4;
+			}
+		}
+
+		void butterflyGeneric(C* out, qsizetype fstride, qsizetype s, qsizetype p, C* scratch) const
+		{
+			for (qsizetype u = 0; u < s; ++u) {
+				qsizetype k = u;
+				for (qsizetype q1 = 0; q1 < p; ++q1) {
+					scratch[q1] = out[k];
+					k += s;
+				}
+				k = u;
+				for (qsizetype q1 = 0; q1 < p; ++q1) {
+					qsizetype twidx = 0;
+					C acc = scratch[0];
+					for (qsizetype q = 1; q < p; ++q) {
+						twidx += fstride * k;
+						if (twidx >= n)
+							twidx -= n;
+						acc += cmul(scratch[q], twiddles[twidx]);
+					}
+					out[k] = acc;
+					k += s;
+				}
+			}
+		}
+
+	};
+
+	template<class T>
+	static std::complex<T> unitRoot(double num, double den, bool inverse)
+	{
+		const double angle = (inverse ? 2 : -2) * M_PI * num / den;
+		return std::complex<T>((T)std::cos(angle), (T)std::sin(angle));
+	}
+
+	/// Thread safe cache of FFT plans, keyed by length and kind
+	template<class T>
+	struct FFTPlanCache
+	{
+		using Plan = FFTPlan<T>;
+		using PlanPtr = std::shared_ptr<const Plan>;
+		using C = std::complex<T>;
+
+		std::mutex mutex;
+		std::map<std::pair<qsizetype, int>, PlanPtr> plans;
+
+		static FFTPlanCache& instance()
+		{
+			static FFTPlanCache inst;
+			return inst;
+		}
+
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			plans.clear();
+		}
+
+		PlanPtr plan(qsizetype n, FFTKind kind)
+		{
+			const std::pair<qsizetype, int> key(n, (int)kind);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto it = plans.find(key);
+				if (it != plans.end())
+					return it->second;
+			}
+
+			// create the plan outside the lock, as it might require other plans
+			PlanPtr p = create(n, kind);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			// avoid unbounded growth when transforming many different lengths
+			if (plans.size() > 256)
+				plans.clear();
+			return plans.emplace(key, p).first->second;
+		}
+
+	private:
+		PlanPtr create(qsizetype n, FFTKind kind)
+		{
+			std::shared_ptr<Plan> p(new Plan());
+			p->n = n;
+			p->inverse = (kind == ComplexBackward || kind == RealBackward);
+
+			if (kind == RealForward || kind == RealBackward) {
+				// n is even: complex transform of length n/2 plus twiddles exp(-+2i*pi*k/n)
+				p->half = plan(n / 2, p->inverse ? ComplexBackward : ComplexForward);
+				p->real_twiddles.resize(n / 2 + 1);
+				for (qsizetype k = 0; k <= n / 2; ++k)
+					p->real_twiddles[k] = unitRoot<T>((double)k, (double)n, p->inverse);
+				return p;
+			}
+
+			// factorize: radix 4 first, then 2, 3, 5, 7...
+			qsizetype remaining = n;
+			qsizetype radix = 4;
+			const double floor_sqrt = std::floor(std::sqrt((double)n));
+			bool large_prime = false;
+			do {
+				while (remaining % radix) {
+					switch (radix) {
+						case 4:
+							radix = 2;
+							break;
+						case 2:
+							radix = 3;
+							break;
+						default:
+							radix += 2;
+							break;
+					}
+					if (radix > floor_sqrt)
+						radix = remaining;
+				}
+				remaining /= radix;
+				p->factors.push_back(radix);
+				p->factors.push_back(remaining);
+				if (radix > max_generic_radix)
+					large_prime = true;
+			} while (remaining > 1);
+
+			if (large_prime) {
+				// Bluestein: express the transform as a convolution of power of 2 length
+				p->factors.clear();
+				qsizetype m = 1;
+				while (m < 2 * n - 1)
+					m *= 2;
+				p->m = m;
+				p->forward_m = plan(m, ComplexForward);
+				p->backward_m = plan(m, ComplexBackward);
+
+				p->chirp.resize(n);
+				for (qsizetype k = 0; k < n; ++k) {
+					// k*k modulo 2n keeps the angle accurate for large lengths
+					const qsizetype k2 = (qsizetype)(((unsigned long long)k * (unsigned long long)k) % (unsigned long long)(2 * n));
+					p->chirp[k] = unitRoot<T>((double)k2, (double)(2 * n), p->inverse);
+				}
+
+				std::vector<C> b(m, C(0));
+				b[0] = std::conj(p->chirp[0]);
+				for (qsizetype k = 1; k < n; ++k)
+					b[k] = b[m - k] = std::conj(p->chirp[k]);
+				p->chirp_fft.resize(m);
+				std::vector<C> work;
+				p->forward_m->transform(b.data(), 1, p->chirp_fft.data(), work);
+				const T scale = T(1) / (T)m;
+				for (qsizetype k = 0; k < m; ++k)
+					p->chirp_fft[k] *= scale;
+				return p;
+			}
+
+			p->twiddles.resize(n);
+			for (qsizetype i = 0; i < n; ++i)
+				p->twiddles[i] = unitRoot<T>((double)i, (double)n, p->inverse);
+			return p;
+		}
+	};
+
+	template<class T>
+	static std::shared_ptr<const FFTPlan<T>> fftPlan(qsizetype n, FFTKind kind)
+	{
+		return FFTPlanCache<T>::instance().plan(n, kind);
+	}
+
+	/// Forward real transform of \a n values read with given stride. Writes n/2+1 complex values to \a out.
+	template<class T>
+	static void rfftLine(const T* in, qsizetype in_stride, qsizetype n, std::complex<T>* out, std::vector<std::complex<T>>& buf, std::vector<std::complex<T>>& work)
+	{
+		using C = std::complex<T>;
+		if (n == 1) {
+			out[0] = C(in[0]);
+			return;
+		}
+		if (n % 2) {
+			// odd length: plain complex transform
+			buf.resize(2 * n);
+			for (qsizetype k = 0; k < n; ++k)
+				buf[k] = C(in[k * in_stride]);
+			fftPlan<T>(n, ComplexForward)->transform(buf.data(), 1, buf.data() + n, work);
+			std::copy(buf.begin() + n, buf.begin() + n + n / 2 + 1, out);
+			return;
+		}
+
+		// even length: pack even/odd samples in a complex sequence of length n/2
+		const auto plan = fftPlan<T>(n, RealForward);
+		const qsizetype h = n / 2;
+		buf.resize(2 * h);
+		C* z = buf.data();
+		C* Z = z + h;
+		for (qsizetype k = 0; k < h; ++k)
+			z[k] = C(in[2 * k * in_stride], in[(2 * k + 1) * in_stride]);
+		plan->half->transform(z, 1, Z, work);
+
+		for (qsizetype k = 0; k <= h; ++k) {
+			const C zk = Z[k == h ? 0 : k];
+			const C zc = std::conj(Z[k == 0 ? 0 : h - k]);
+			const C e = (zk + zc) * T(0.5);
+			const C d = zk - zc;
+			const C o(d.imag() * T(0.5), -d.real() * T(0.5)); // (zk - zc) / 2i
+			out[k] = e + cmul(plan->real_twiddles[k], o);
+		}
+	}
+
+	/// Backward real transform: reads n/2+1 complex values and writes \a n real values with given stride.
+	/// The output is normalized by 1/n.
+	template<class T>
+	static void irfftLine(const std::complex<T>* in, qsizetype n, T* out, qsizetype out_stride, std::vector<std::complex<T>>& buf, std::vector<std::complex<T>>& work)
+	{
+		using C = std::complex<T>;
+		if (n == 1) {
+			out[0] = in[0].real();
+			return;
+		}
+		if (n % 2) {
+			// odd length: rebuild the full hermitian spectrum
+			buf.resize(2 * n);
+			for (qsizetype k = 0; k <= n / 2; ++k)
+				buf[k] = in[k];
+			for (qsizetype k = n / 2 + 1; k < n; ++k)
+				buf[k] = std::conj(in[n - k]);
+			fftPlan<T>(n, ComplexBackward)->transform(buf.data(), 1, buf.data() + n, work);
+			const T scale = T(1) / (T)n;
+			for (qsizetype k = 0; k < n; ++k)
+				out[k * out_stride] = buf[n + k].real() * scale;
+			return;
+		}
+
+		const auto plan = fftPlan<T>(n, RealBackward);
+		const qsizetype h = n / 2;
+		buf.resize(2 * h);
+		C* Z = buf.data();
+		C* z = Z + h;
+		for (qsizetype k = 0; k < h; ++k) {
+			const C xk = in[k];
+			const C xc = std::conj(in[h - k]);
+			const C e = xk + xc;
+			const C o = cmul(xk - xc, plan->real_twiddles[k]);
+			Z[k] = C(e.real() - o.imag(), e.imag() + o.real()); // e + i*o
+		}
+		plan->half->transform(Z, 1, z, work);
+
+		const T scale = T(1) / (T)n;
+		for (qsizetype k = 0; k < h; ++k) {
+			out[2 * k * out_stride] = z[k].real() * scale;
+			out[(2 * k + 1) * out_stride] = z[k].imag() * scale;
+		}
+	}
+
+	/// Geometry of the lines of an axis inside a C-ordered array
+	struct AxisLines
+	{
+		qsizetype n;	  // axis length
+		qsizetype stride; // axis stride
+		qsizetype count;  // number of lines
+
+		AxisLines(const VipNDArrayShape& shape, int axis)
+		  : n(shape[axis])
+		  , stride(1)
+		  , count(1)
+		{
+			for (int i = axis + 1; i < shape.size(); ++i)
+				stride *= shape[i];
+			for (int i = 0; i < shape.size(); ++i)
+				if (i != axis)
+					count *= shape[i];
+		}
+		/// Offset of the first element of line \a l
+		qsizetype start(qsizetype l) const { return (l / stride) * n * stride + (l % stride); }
+	};
+
+	/// In place complex transform of all lines along \a axis
+	template<class T>
+	static void fftAxis(std::complex<T>* data, const VipNDArrayShape& shape, int axis, bool inverse)
+	{
+		using C = std::complex<T>;
+		const AxisLines lines(shape, axis);
+		if (lines.n <= 1)
+			return;
+
+		const auto plan = fftPlan<T>(lines.n, inverse ? ComplexBackward : ComplexForward);
+		const T scale = inverse ? T(1) / (T)lines.n : T(1);
+		const int threads = vipLoopThreadCount((int)std::min(lines.n * lines.count, (qsizetype)INT_MAX));
+
+		VIP_PARALLEL_FOR_NUM_THREADS(threads)
+		for (qsizetype l = 0; l < lines.count; ++l) {
+			static thread_local std::vector<C> buf;
+			static thread_local std::vector<C> work;
+			if ((qsizetype)buf.size() < lines.n)
+				buf.resize(lines.n);
+			C* line = data + lines.start(l);
+			plan->transform(line, lines.stride, buf.data(), work);
+			for (qsizetype k = 0; k < lines.n; ++k)
+				line[k * lines.stride] = buf[k] * scale;
+		}
+	}
+}
+
+using namespace detail;
+
+void vipFFT(const complex_d* in, complex_d* out, qsizetype n, Vip::FFTDirection dir)
+{
+	if (n <= 0)
+		return;
+	std::vector<complex_d> buf(n), work;
+	fftPlan<double>(n, dir == Vip::FFTBackward ? ComplexBackward : ComplexForward)->transform(in, 1, buf.data(), work);
+	const double scale = dir == Vip::FFTBackward ? 1. / n : 1.;
+	for (qsizetype i = 0; i < n; ++i)
+		out[i] = buf[i] * scale;
+}
+
+void vipFFT(const complex_f* in, complex_f* out, qsizetype n, Vip::FFTDirection dir)
+{
+	if (n <= 0)
+		return;
+	std::vector<complex_f> buf(n), work;
+	fftPlan<float>(n, dir == Vip::FFTBackward ? ComplexBackward : ComplexForward)->transform(in, 1, buf.data(), work);
+	const float scale = dir == Vip::FFTBackward ? 1.f / n : 1.f;
+	for (qsizetype i = 0; i < n; ++i)
+		out[i] = buf[i] * scale;
+}
+
+/// Returns a dense copy of \a ar converted to given type
+static VipNDArray denseCopy(const VipNDArray& ar, int type)
+{
+	VipNDArray res(type, ar.shape());
+	if (res.isEmpty() || !ar.convert(res))
+		return VipNDArray();
+	return res;
+}
+
+/// Returns \a ar if it is already a dense standard array of given type, or a dense copy
+static VipNDArray denseArray(const VipNDArray& ar, int type)
+{
+	if (ar.dataType() == type && ar.handle()->handleType() == VipNDArrayHandle::Standard && ar.isUnstrided())
+		return ar;
+	return denseCopy(ar, type);
+}
+
+static bool isSinglePrecision(int type)
+{
+	return type == QMetaType::Float || type == qMetaTypeId<complex_f>();
+}
+
+VipNDArray vipFFT(const VipNDArray& ar, Vip::FFTDirection dir)
+{
+	if (ar.isEmpty() || !(ar.isNumeric() || ar.isComplex()))
+		return VipNDArray();
+
+	const bool single = isSinglePrecision(ar.dataType());
+	VipNDArray res = denseCopy(ar, single ? qMetaTypeId<complex_f>() : qMetaTypeId<complex_d>());
+	if (res.isEmpty())
+		return res;
+
+	for (int axis = 0; axis < res.shapeCount(); ++axis) {
+		if (single)
+			fftAxis(static_cast<complex_f*>(res.data()), res.shape(), axis, dir == Vip::FFTBackward);
+		else
+			fftAxis(static_cast<complex_d*>(res.data()), res.shape(), axis, dir == Vip::FFTBackward);
+	}
+	return res;
+}
+
+VipNDArray vipIFFT(const VipNDArray& ar)
+{
+	return vipFFT(ar, Vip::FFTBackward);
+}
+
+template<class T>
+static VipNDArray rfftN(const VipNDArray& input)
+{
+	using C = std::complex<T>;
+	const int last = input.shapeCount() - 1;
+	const qsizetype n = input.shape(last);
+
+	VipNDArrayShape out_shape = input.shape();
+	out_shape[last] = n / 2 + 1;
+	VipNDArray res(qMetaTypeId<C>(), out_shape);
+
+	// real transform along the last axis
+	const T* src = static_cast<const T*>(input.constData());
+	C* dst = static_cast<C*>(res.data());
+	const qsizetype rows = input.size() / n;
+	const int threads = vipLoopThreadCount((int)std::min(input.size(), (qsizetype)INT_MAX));
+
+	VIP_PARALLEL_FOR_NUM_THREADS(threads)
+	for (qsizetype r = 0; r < rows; ++r) {
+		static thread_local std::vector<C> buf;
+		static thread_local std::vector<C> work;
+		rfftLine(src + r * n, 1, n, dst + r * out_shape[last], buf, work);
+	}
+
+	// complex transforms along the other axes
+	for (int axis = 0; axis < last; ++axis)
+		fftAxis(dst, out_shape, axis, false);
+	return res;
+}
+
+template<class T>
+static VipNDArray irfftN(VipNDArray& input, qsizetype n)
+{
+	using C = std::complex<T>;
+	const int last = input.shapeCount() - 1;
+	C* src = static_cast<C*>(input.data());
+
+	// complex transforms along all axes but the last one (in place on our private copy)
+	for (int axis = 0; axis < last; ++axis)
+		fftAxis(src, input.shape(), axis, true);
+
+	VipNDArrayShape out_shape = input.shape();
+	out_shape[last] = n;
+	VipNDArray res(qMetaTypeId<T>(), out_shape);
+	T* dst = static_cast<T*>(res.data());
+
+	// the backward real transform needs n/2+1 input values: pad with zeros if required
+	const qsizetype m = input.shape(last);
+	const qsizetype needed = n / 2 + 1;
+	const qsizetype rows = input.size() / m;
+	const int threads = vipLoopThreadCount((int)std::min(res.size(), (qsizetype)INT_MAX));
+
+	VIP_PARALLEL_FOR_NUM_THREADS(threads)
+	for (qsizetype r = 0; r < rows; ++r) {
+		static thread_local std::vector<C> line;
+		static thread_local std::vector<C> buf;
+		static thread_local std::vector<C> work;
+		line.assign(needed, C(0));
+		std::copy(src + r * m, src + r * m + std::min(m, needed), line.begin());
+		irfftLine(line.data(), n, dst + r * n, 1, buf, work);
+	}
+	return res;
+}
+
+VipNDArray vipRFFT(const VipNDArray& ar)
+{
+	if (ar.isEmpty() || !ar.isNumeric())
+		return VipNDArray();
+
+	if (ar.dataType() == QMetaType::Float) {
+		const VipNDArray input = denseArray(ar, QMetaType::Float);
+		return input.isEmpty() ? input : rfftN<float>(input);
+	}
+	const VipNDArray input = denseArray(ar, QMetaType::Double);
+	return input.isEmpty() ? input : rfftN<double>(input);
+}
+
+VipNDArray vipIRFFT(const VipNDArray& ar, qsizetype last_size)
+{
+	if (ar.isEmpty() || !(ar.isNumeric() || ar.isComplex()))
+		return VipNDArray();
+
+	if (last_size <= 0)
+		last_size = 2 * (ar.shape(ar.shapeCount() - 1) - 1);
+	if (last_size <= 0)
+		return VipNDArray();
+
+	if (ar.dataType() == qMetaTypeId<complex_f>()) {
+		VipNDArray input = denseCopy(ar, qMetaTypeId<complex_f>());
+		return input.isEmpty() ? input : irfftN<float>(input, last_size);
+	}
+	VipNDArray input = denseCopy(ar, qMetaTypeId<complex_d>());
+	return input.isEmpty() ? input : irfftN<double>(input, last_size);
+}
+
+/// Roll each axis of \a ar by shape[i]/2 (forward) or -shape[i]/2 (backward)
+static VipNDArray fftShift(const VipNDArray& ar, bool backward)
+{
+	if (ar.isEmpty() || !(ar.isNumeric() || ar.isComplex()))
+		return VipNDArray();
+
+	const VipNDArray src = denseArray(ar, ar.dataType());
+	VipNDArray res(src.dataType(), src.shape());
+	if (res.isEmpty())
+		return VipNDArray();
+
+	const VipNDArrayShape& shape = src.shape();
+	const int dims = shape.size();
+	const qsizetype elem = src.dataSize();
+
+	// destination index of each source index, per axis
+	std::vector<std::vector<qsizetype>> maps(dims);
+	for (int d = 0; d < dims; ++d) {
+		const qsizetype n = shape[d];
+		const qsizetype shift = backward ? n - n / 2 : n / 2;
+		maps[d].resize(n);
+		for (qsizetype i = 0; i < n; ++i)
+			maps[d][i] = (i + shift) % n;
+	}
+
+	// copy the last axis by at most 2 contiguous blocks
+	const qsizetype n = shape[dims - 1];
+	const qsizetype split = n - maps[dims - 1][0]; // source index going to destination 0
+	const qsizetype rows = src.size() / n;
+	const char* s = static_cast<const char*>(src.constData());
+	char* dst = static_cast<char*>(res.data());
+
+	VipNDArrayShape pos = shape;
+	for (int d = 0; d < dims; ++d)
+		pos[d] = 0;
+	for (qsizetype r = 0; r < rows; ++r) {
+		qsizetype dst_row = 0;
+		for (int d = 0; d < dims - 1; ++d)
+			dst_row = dst_row * shape[d] + maps[d][pos[d]];
+		char* drow = dst + dst_row * n * elem;
+		const char* srow = s + r * n * elem;
+		// source [0, split) goes to [n - split, n), source [split, n) goes to [0, n - split)
+		memcpy(drow + (n - split) * elem, srow, split * elem);
+		memcpy(drow, srow + split * elem, (n - split) * elem);
+
+		// next row coordinates
+		for (int d = dims - 2; d >= 0; --d) {
+			if (++pos[d] < shape[d])
+				break;
+			pos[d] = 0;
+		}
+	}
+	return res;
+}
+
+VipNDArray vipFFTShift(const VipNDArray& ar)
+{
+	return fftShift(ar, false);
+}
+
+VipNDArray vipIFFTShift(const VipNDArray& ar)
+{
+	return fftShift(ar, true);
+}
+
+void vipClearFFTPlans()
+{
+	FFTPlanCache<float>::instance().clear();
+	FFTPlanCache<double>::instance().clear();
+}
@@ -0,0 +1,88 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_FFT_H
+#define VIP_FFT_H
+
+#include "VipNDArray.h"
+
+/// \addtogroup DataType
+/// @{
+
+namespace Vip
+{
+	/// Direction of a discrete Fourier transform, used with #vipFFT
+	enum FFTDirection
+	{
+		FFTForward, //! forward transform (negative exponent)
+		FFTBackward //! inverse transform (positive exponent), normalized by 1/N
+	};
+}
+
+/// @brief Compute the 1D discrete Fourier transform of \a n complex values.
+/// \a in and \a out might be the same buffer.
+/// The transform uses a mixed radix algorithm (radix 2, 3, 4, 5 and generic radix), and falls back to
+/// the Bluestein algorithm for lengths containing large prime factors, so that any length runs in O(n log n).
+/// Plans (factorization and twiddle factors) are cached based on the transform length.
+VIP_DATA_TYPE_EXPORT void vipFFT(const complex_d* in, complex_d* out, qsizetype n, Vip::FFTDirection dir = Vip::FFTForward);
+VIP_DATA_TYPE_EXPORT void vipFFT(const complex_f* in, complex_f* out, qsizetype n, Vip::FFTDirection dir = Vip::FFTForward);
+
+/// @brief Compute the N-dimensional discrete Fourier transform of \a ar, like numpy.fft.fftn.
+/// Returns a complex_f array for float or complex_f input, a complex_d array for any other numerical input,
+/// and a null array if \a ar cannot be converted to complex.
+/// Each axis is transformed in turn, and the lines of a given axis are processed in parallel based on vipIterateThreadCount().
+VIP_DATA_TYPE_EXPORT VipNDArray vipFFT(const VipNDArray& ar, Vip::FFTDirection dir = Vip::FFTForward);
+/// @brief Compute the N-dimensional inverse discrete Fourier transform of \a ar, like numpy.fft.ifftn.
+VIP_DATA_TYPE_EXPORT VipNDArray vipIFFT(const VipNDArray& ar);
+
+/// @brief Compute the N-dimensional discrete Fourier transform of a real array, like numpy.fft.rfftn.
+/// The real transform is performed over the last axis, whose size becomes n/2+1, and the remaining transforms are complex.
+/// Returns a complex_f array for float input, a complex_d array for other real input, and a null array for complex input.
+VIP_DATA_TYPE_EXPORT VipNDArray vipRFFT(const VipNDArray& ar);
+/// @brief Inverse of #vipRFFT, like numpy.fft.irfftn.
+/// \a last_size is the size of the last axis of the output. If <= 0, it is set to 2*(m-1), where m is the size of the input last axis.
+/// Returns a float array for complex_f input, a double array otherwise.
+VIP_DATA_TYPE_EXPORT VipNDArray vipIRFFT(const VipNDArray& ar, qsizetype last_size = 0);
+
+/// @brief Shift the zero-frequency component to the center of the spectrum, like numpy.fft.fftshift.
+/// Works on any numerical or complex array.
+VIP_DATA_TYPE_EXPORT VipNDArray vipFFTShift(const VipNDArray& ar);
+/// @brief Inverse of #vipFFTShift, like numpy.fft.ifftshift.
+VIP_DATA_TYPE_EXPORT VipNDArray vipIFFTShift(const VipNDArray& ar);
+
+/// @brief Clear the cache of FFT plans
+VIP_DATA_TYPE_EXPORT void vipClearFFTPlans();
+
+/// @}
+// end DataType
+
+#endif
@@ -0,0 +1,895 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "VipFilters.h"
+#include "VipIterator.h"
+
+namespace
+{
+	/// Call \a fun with a default constructed value of the C++ type matching \a type.
+	/// Returns false for non numerical types.
+	template<class Fun>
+	bool dispatchNumeric(int type, Fun&& fun)
+	{
+		switch (type) {
+			case QMetaType::Char:
+				fun(char());
+				return true;
+			case QMetaType::SChar:
+				fun((signed char)0);
+				return true;
+			case QMetaType::UChar:
+				fun(quint8());
+				return true;
+			case QMetaType::Short:
+				fun(qint16());
+				return true;
+			case QMetaType::UShort:
+				fun(quint16());
+				return true;
+			case QMetaType::Int:
+				fun(qint32());
+				return true;
+			case QMetaType::UInt:
+				fun(quint32());
+				return true;
+			case QMetaType::Long:
+				fun(long());
+				return true;
+			case QMetaType::ULong:
+				fun((unsigned long)0);
+				return true;
+			case QMetaType::LongLong:
+				fun(qint64());
+				return true;
+			case QMetaType::ULongLong:
+				fun(quint64());
+				return true;
+			case QMetaType::Float:
+				fun(float());
+				return true;
+			case QMetaType::Double:
+				fun(double());
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	/// Returns a dense copy of \a ar converted to given type.
+	/// Boolean arrays are converted to unsigned char ones.
+	VipNDArray denseCopy(const VipNDArray& ar, int type)
+	{
+		if (type == QMetaType::Bool)
+			type = QMetaType::UChar;
+		VipNDArray res(type, ar.shape());
+		if (res.isEmpty() || !ar.convert(res))
+			return VipNDArray();
+		return res;
+	}
+
+	/// Work type of the linear filters
+	int linearFilterType(const VipNDArray& ar)
+	{
+		return ar.dataType() == QMetaType::Float ? (int)QMetaType::Float : (int)QMetaType::Double;
+	}
+
+	/// Map a coordinate outside [0, n) inside it based on given border mode
+	qsizetype borderIndex(qsizetype i, qsizetype n, Vip::FilterBorderMode mode)
+	{
+		if (i >= 0 && i < n)
+			return i;
+		switch (mode) {
+			case Vip::FilterNearest:
+				return i < 0 ? 0 : n - 1;
+			case Vip::FilterWrap: {
+				const qsizetype r = i % n;
+				return r < 0 ? r + n : r;
+			}
+			case Vip::FilterMirror: {
+				if (n == 1)
+					return 0;
+				const qsizetype period = 2 * n - 2;
+				qsizetype r = i % period;
+				if (r < 0)
+					r += period;
+				return r < n ? r : period - r;
+			}
+			default: {
+				const qsizetype period = 2 * n;
+				qsizetype r = i % period;
+				if (r < 0)
+					r += period;
+				return r < n ? r : period - 1 - r;
+			}
+		}
+	}
+
+	/// Geometry of the lines of an axis inside a C-ordered array
+	struct FilterLines
+	{
+		qsizetype n;	  // axis length
+		qsizetype stride; // axis stride
+		qsizetype count;  // number of lines
+
+		FilterLines(const VipNDArrayShape& shape, int axis)
+		  : n(shape[axis])
+		  , stride(1)
+		  , count(1)
+		{
+			for (int i = axis + 1; i < shape.size(); ++i)
+				stride *= shape[i];
+			for (int i = 0; i < shape.size(); ++i)
+				if (i != axis)
+					count *= shape[i];
+		}
+		/// Offset of the first element of line \a l
+		qsizetype start(qsizetype l) const { return (l / stride) * n * stride + (l % stride); }
+	};
+
+	/// In place filtering of all lines of a dense array along \a axis.
+	/// Each line is copied with \a left and \a right border elements to a buffer, and \a op(padded, out, n) computes the n filtered values.
+	template<class T, class Op>
+	void filterAxis(T* data, const VipNDArrayShape& shape, int axis, qsizetype left, qsizetype right, Vip::FilterBorderMode mode, const Op& op)
+	{
+		const FilterLines lines(shape, axis);
+		const qsizetype n = lines.n;
+		const int threads = vipLoopThreadCount((int)std::min(n * lines.count, (qsizetype)INT_MAX));
+
+		VIP_PARALLEL_FOR_NUM_THREADS(threads)
+		for (qsizetype l = 0; l < lines.count; ++l) {
+			static thread_local std::vector<T> padded;
+			static thread_local std::vector<T> out;
+			padded.resize(n + left + right);
+			out.resize(n);
+
+			T* line = data + lines.start(l);
+			for (qsizetype i = 0; i < left; ++i)
+				padded[i] = line[borderIndex(i - left, n, mode) * lines.stride];
+			for (qsizetype i = 0; i < n; ++i)
+				padded[i + left] = line[i * lines.stride];
+			for (qsizetype i = 0; i < right; ++i)
+				padded[n + left + i] = line[borderIndex(n + i, n, mode) * lines.stride];
+
+			op(padded.data(), out.data(), n);
+			for (qsizetype i = 0; i < n; ++i)
+				line[i * lines.stride] = out[i];
+		}
+	}
+
+	/// van Herk/Gil-Werman running min/max of window \a k over a padded line of n + k - 1 elements
+	template<class T, class Select>
+	void vanHerk(const T* p, T* out, qsizetype n, qsizetype k, const Select& select)
+	{
+		static thread_local std::vector<T> g;
+		static thread_local std::vector<T> h;
+		const qsizetype len = n + k - 1;
+		g.resize(len);
+		h.resize(len);
+		// g: prefix inside blocks of k elements, h: suffix inside blocks
+		for (qsizetype i = 0; i < len; ++i)
+			g[i] = (i % k == 0) ? p[i] : select(g[i - 1], p[i]);
+		for (qsizetype i = len - 1; i >= 0; --i)
+			h[i] = (i == len - 1 || (i + 1) % k == 0) ? p[i] : select(h[i + 1], p[i]);
+		for (qsizetype i = 0; i < n; ++i)
+			out[i] = select(h[i], g[i + k - 1]);
+	}
+
+	template<class T>
+	struct SelectMin
+	{
+		T operator()(T a, T b) const { return b < a ? b : a; }
+	};
+	template<class T>
+	struct SelectMax
+	{
+		T operator()(T a, T b) const { return a < b ? b : a; }
+	};
+
+	/// Apply a running min/max of \a size elements along \a axis of a dense array
+	template<class T>
+	void minMaxAxis(T* data, const VipNDArrayShape& shape, int axis, qsizetype size, bool max, Vip::FilterBorderMode mode)
+	{
+		const qsizetype left = size / 2;
+		const qsizetype right = size - 1 - left;
+		if (max)
+			filterAxis(data, shape, axis, left, right, mode, [size](const T* p, T* out, qsizetype n) { vanHerk(p, out, n, size, SelectMax<T>()); });
+		else
+			filterAxis(data, shape, axis, left, right, mode, [size](const T* p, T* out, qsizetype n) { vanHerk(p, out, n, size, SelectMin<T>()); });
+	}
+
+	/// Separable min/max filter over all axes (full == true) or union of the lines along each axis (full == false)
+	VipNDArray minMaxFilter(const VipNDArray& ar, int size, bool max, bool full, Vip::FilterBorderMode mode)
+	{
+		if (ar.isEmpty() || size < 1)
+			return VipNDArray();
+		VipNDArray res = denseCopy(ar, ar.dataType());
+		if (res.isEmpty() || size == 1)
+			return res;
+
+		const bool ok = dispatchNumeric(res.dataType(), [&](auto v) {
+			using T = decltype(v);
+			T* data = static_cast<T*>(res.data());
+			if (full || res.shapeCount() == 1) {
+				for (int axis = 0; axis < res.shapeCount(); ++axis)
+					minMaxAxis(data, res.shape(), axis, size, max, mode);
+				return;
+			}
+			// cross structuring element: combine the 1D filters along each axis
+			const VipNDArray input = res.copy();
+			for (int axis = 0; axis < res.shapeCount(); ++axis) {
+				VipNDArray line = axis == 0 ? res : input.copy();
+				T* ldata = static_cast<T*>(line.data());
+				minMaxAxis(ldata, line.shape(), axis, size, max, mode);
+				if (axis > 0) {
+					const qsizetype count = res.size();
+					for (qsizetype i = 0; i < count; ++i)
+						data[i] = max ? SelectMax<T>()(data[i], ldata[i]) : SelectMin<T>()(data[i], ldata[i]);
+				}
+			}
+		});
+		return ok ? res : VipNDArray();
+	}
+
+	/// Apply the correlation of given kernel along \a axis of a dense array.
+	/// The kernel is centered on its element size/2, like scipy.ndimage.correlate1d.
+	template<class T>
+	void correlateAxis(T* data, const VipNDArrayShape& shape, int axis, const std::vector<T>& kernel, Vip::FilterBorderMode mode)
+	{
+		const qsizetype size = kernel.size();
+		const qsizetype left = size / 2;
+		const qsizetype right = size - 1 - left;
+		filterAxis(data, shape, axis, left, right, mode, [&kernel, size](const T* p, T* out, qsizetype n) {
+			const T* k = kernel.data();
+			for (qsizetype i = 0; i < n; ++i) {
+				T sum = 0;
+				for (qsizetype j = 0; j < size; ++j)
+					sum += k[j] * p[i + j];
+				out[i] = sum;
+			}
+		});
+	}
+
+	/// Apply a separable correlation, with one kernel per axis (empty kernels are skipped)
+	VipNDArray separableCorrelation(const VipNDArray& ar, const std::vector<std::vector<double>>& kernels, Vip::FilterBorderMode mode)
+	{
+		if (ar.isEmpty() || !ar.isNumeric())
+			return VipNDArray();
+		VipNDArray res = denseCopy(ar, linearFilterType(ar));
+		if (res.isEmpty())
+			return res;
+
+		for (int axis = 0; axis < res.shapeCount() && axis < (int)kernels.size(); ++axis) {
+			if (kernels[axis].empty())
+				continue;
+			if (res.dataType() == QMetaType::Float) {
+				const std::vector<float> kernel(kernels[axis].begin(), kernels[axis].end());
+				correlateAxis(static_cast<float*>(res.data()), res.shape(), axis, kernel, mode);
+			}
+			else
+				correlateAxis(static_cast<double*>(res.data()), res.shape(), axis, kernels[axis], mode);
+		}
+		return res;
+	}
+
+	/// 1D Gaussian kernel (or Gaussian derivative of given order) reversed for correlation, like scipy.ndimage.gaussian_filter1d
+	std::vector<double> gaussianKernel(double sigma, int order, qsizetype radius)
+	{
+		const double sigma2 = sigma * sigma;
+		const qsizetype size = 2 * radius + 1;
+		std::vector<double> phi(size);
+		double sum = 0;
+		for (qsizetype i = 0; i < size; ++i) {
+			const double x = double(i - radius);
+			sum += (phi[i] = std::exp(-0.5 / sigma2 * x * x));
+		}
+		for (double& v : phi)
+			v /= sum;
+
+		if (order > 0) {
+			// phi^(order)(x) = q(x) * phi(x), with q a polynomial computed by recurrence: q' = q_derived + q * (-x/sigma2)
+			std::vector<double> q(order + 1, 0.);
+			q[0] = 1;
+			for (int o = 0; o < order; ++o) {
+				std::vector<double> next(order + 1, 0.);
+				for (int e = 0; e <= order; ++e) {
+					if (e + 1 <= order)
+						next[e] += (e + 1) * q[e + 1];
+					if (e > 0)
+						next[e] += -q[e - 1] / sigma2;
+				}
+				q = next;
+			}
+			for (qsizetype i = 0; i < size; ++i) {
+				const double x = double(i - radius);
+				double poly = 0, xe = 1;
+				for (int e = 0; e <= order; ++e, xe *= x)
+					poly += q[e] * xe;
+				phi[i] *= poly;
+			}
+		}
+		std::reverse(phi.begin(), phi.end());
+		return phi;
+	}
+
+	/// Shape of a 1D or 2D array as (rows, columns)
+	bool shape2D(const VipNDArray& ar, qsizetype& rows, qsizetype& cols)
+	{
+		if (ar.shapeCount() == 1) {
+			rows = 1;
+			cols = ar.shape(0);
+			return true;
+		}
+		if (ar.shapeCount() == 2) {
+			rows = ar.shape(0);
+			cols = ar.shape(1);
+			return true;
+		}
+		return false;
+	}
+
+	/// Copy a rows x cols image to a padded image of (rows + wh - 1) x (cols + ww - 1) elements, border elements following given mode
+	template<class T>
+	std::vector<T> padImage(const T* src, qsizetype rows, qsizetype cols, qsizetype wh, qsizetype ww, Vip::FilterBorderMode mode)
+	{
+		const qsizetype top = wh / 2, left = ww / 2;
+		const qsizetype prows = rows + wh - 1, pcols = cols + ww - 1;
+		std::vector<qsizetype> xmap(pcols);
+		for (qsizetype x = 0; x < pcols; ++x)
+			xmap[x] = borderIndex(x - left, cols, mode);
+
+		std::vector<T> res(prows * pcols);
+		for (qsizetype y = 0; y < prows; ++y) {
+			const T* row = src + borderIndex(y - top, rows, mode) * cols;
+			T* dst = res.data() + y * pcols;
+			for (qsizetype x = 0; x < pcols; ++x)
+				dst[x] = row[xmap[x]];
+		}
+		return res;
+	}
+
+	/// Strict weak ordering putting NaN values at the end
+	template<class T>
+	struct OrdinalLess
+	{
+		bool operator()(T a, T b) const
+		{
+			if constexpr (std::is_floating_point<T>::value)
+				return a < b || (a == a && b != b);
+			else
+				return a < b;
+		}
+	};
+
+	/// Convert values to their ordinal position inside the sorted list of distinct values
+	template<class T>
+	void ordinals(const T* src, qsizetype size, std::vector<quint32>& ord, std::vector<T>& values)
+	{
+		ord.resize(size);
+		if constexpr (std::is_integral<T>::value) {
+			const auto mm = std::minmax_element(src, src + size);
+			const T min = *mm.first;
+			if ((double)*mm.second - (double)min < 65536.) {
+				values.resize((qsizetype)(*mm.second - min) + 1);
+				for (qsizetype i = 0; i < (qsizetype)values.size(); ++i)
+					values[i] = (T)(min + i);
+				for (qsizetype i = 0; i < size; ++i)
+					ord[i] = (quint32)(src[i] - min);
+				return;
+			}
+		}
+		const OrdinalLess<T> less;
+		values.assign(src, src + size);
+		std::sort(values.begin(), values.end(), less);
+		values.erase(std::unique(values.begin(), values.end(), [&less](T a, T b) { return !less(a, b) && !less(b, a); }), values.end());
+
+		const int threads = vipLoopThreadCount((int)std::min(size, (qsizetype)INT_MAX));
+		VIP_PARALLEL_FOR_NUM_THREADS(threads)
+		for (qsizetype i = 0; i < size; ++i)
+			ord[i] = (quint32)(std::lower_bound(values.begin(), values.end(), src[i], less) - values.begin());
+	}
+
+	/// Rank filter on a rows x cols image with a window of wh x ww elements
+	template<class T>
+	void rankFilter(const T* src, T* dst, qsizetype rows, qsizetype cols, qsizetype wh, qsizetype ww, qsizetype rank, Vip::FilterBorderMode mode)
+	{
+		const qsizetype wsize = wh * ww;
+		const OrdinalLess<T> less;
+
+		if (wsize <= 25) {
+			// small window: direct selection
+			const std::vector<T> pad = padImage(src, rows, cols, wh, ww, mode);
+			const qsizetype pcols = cols + ww - 1;
+			const int threads = vipLoopThreadCount((int)std::min(rows * cols, (qsizetype)INT_MAX));
+			VIP_PARALLEL_FOR_NUM_THREADS(threads)
+			for (qsizetype y = 0; y < rows; ++y) {
+				T window[25];
+				for (qsizetype x = 0; x < cols; ++x) {
+					T* w = window;
+					for (qsizetype dy = 0; dy < wh; ++dy) {
+						const T* p = pad.data() + (y + dy) * pcols + x;
+						for (qsizetype dx = 0; dx < ww; ++dx)
+							*w++ = p[dx];
+					}
+					// insertion sort, faster than std::nth_element for such small windows
+					for (qsizetype i = 1; i < wsize; ++i) {
+						const T v = window[i];
+						qsizetype j = i;
+						for (; j > 0 && less(v, window[j - 1]); --j)
+							window[j] = window[j - 1];
+						window[j] = v;
+					}
+					dst[y * cols + x] = window[rank];
+				}
+			}
+			return;
+		}
+
+		// large window: sliding histogram of ordinal values, traversing the rows in a snake order
+		std::vector<quint32> ord;
+		std::vector<T> values;
+		ordinals(src, rows * cols, ord, values);
+		const std::vector<quint32> pad = padImage(ord.data(), rows, cols, wh, ww, mode);
+		ord = std::vector<quint32>();
+
+		const qsizetype pcols = cols + ww - 1;
+		const qsizetype bins = values.size();
+		const int threads = std::max(1, vipLoopThreadCount((int)std::min(rows * cols * ww, (qsizetype)INT_MAX)));
+		const int chunks = (int)std::min((qsizetype)threads, rows);
+
+		VIP_PARALLEL_FOR_NUM_THREADS(threads)
+		for (int chunk = 0; chunk < chunks; ++chunk) {
+			const qsizetype r0 = chunk * rows / chunks;
+			const qsizetype r1 = (chunk + 1) * rows / chunks;
+			if (r0 >= r1)
+				continue;
+
+			// fine histogram, and coarse histogram of 256 bins blocks to move quickly across sparse ranges
+			std::vector<int> hist(bins, 0);
+			std::vector<int> coarse((bins + 255) / 256, 0);
+			qsizetype m = 0;     // current output bin
+			qsizetype below = 0; // number of window elements in bins < m
+
+			auto add = [&](quint32 v) {
+				++hist[v];
+				++coarse[v >> 8];
+				if ((qsizetype)v < m)
+					++below;
+			};
+			auto remove = [&](quint32 v) {
+				--hist[v];
+				--coarse[v >> 8];
+				if ((qsizetype)v < m)
+					--below;
+			};
+			auto seek = [&]() {
+				while (below > rank) {
+					if ((m & 255) == 0 && below - coarse[(m >> 8) - 1] > rank) {
+						m -= 256;
+						below -= coarse[m >> 8];
+					}
+					else
+						below -= hist[--m];
+				}
+				for (;;) {
+					if ((m & 255) == 0 && below + coarse[m >> 8] <= rank) {
+						below += coarse[m >> 8];
+						m += 256;
+					}
+					else if (below + hist[m] <= rank)
+						below += hist[m++];
+					else
+						break;
+				}
+			};
+			auto at = [&](qsizetype y, qsizetype x) { return pad[y * pcols + x]; };
+
+			for (qsizetype dy = 0; dy < wh; ++dy)
+				for (qsizetype dx = 0; dx < ww; ++dx)
+					add(at(r0 + dy, dx));
+			seek();
+
+			qsizetype x = 0;
+			int dir = 1;
+			for (qsizetype y = r0; y < r1; ++y) {
+				if (y > r0) {
+					// move the window down
+					for (qsizetype dx = 0; dx < ww; ++dx) {
+						remove(at(y - 1, x + dx));
+						add(at(y + wh - 1, x + dx));
+					}
+					seek();
+				}
+				dst[y * cols + x] = values[m];
+
+				for (qsizetype step = 1; step < cols; ++step) {
+					if (dir > 0) {
+						for (qsizetype dy = 0; dy < wh; ++dy) {
+							remove(at(y + dy, x));
+							add(at(y + dy, x + ww));
+						}
+					}
+					else {
+						for (qsizetype dy = 0; dy < wh; ++dy) {
+							remove(at(y + dy, x + ww - 1));
+							add(at(y + dy, x - 1));
+						}
+					}
+					x += dir;
+					seek();
+					dst[y * cols + x] = values[m];
+				}
+				dir = -dir;
+			}
+		}
+	}
+
+	/// Bit-packed 2D binary mask
+	struct BitMask
+	{
+		qsizetype rows = 0;
+		qsizetype cols = 0;
+		qsizetype words = 0;
+		quint64 tail = 0; // valid bits of the last word of each row
+		std::vector<quint64> bits;
+
+		BitMask(qsizetype r, qsizetype c)
+		  : rows(r)
+		  , cols(c)
+		  , words((c + 63) / 64)
+		  , tail((c % 64) ? ((quint64(1) << (c % 64)) - 1) : ~quint64(0))
+		  , bits(r * words, 0)
+		{
+		}
+		quint64* row(qsizetype r) { return bits.data() + r * words; }
+		const quint64* row(qsizetype r) const { return bits.data() + r * words; }
+	};
+
+	/// Word \a i of a row where bit x is set if element x - 1 is set
+	VIP_ALWAYS_INLINE quint64 fromLeft(const quint64* row, qsizetype i)
+	{
+		return (row[i] << 1) | (i > 0 ? row[i - 1] >> 63 : 0);
+	}
+	/// Word \a i of a row where bit x is set if element x + 1 is set
+	VIP_ALWAYS_INLINE quint64 fromRight(const quint64* row, qsizetype i, qsizetype words)
+	{
+		return (row[i] >> 1) | (i + 1 < words ? row[i + 1] << 63 : 0);
+	}
+
+	/// Single binary dilation or erosion step with a 3x3 (or 3 for 1D masks) structuring element
+	void morphologyStep(const BitMask& in, BitMask& out, bool dilate, bool full, bool vertical)
+	{
+		const qsizetype words = in.words;
+		const int threads = vipLoopThreadCount((int)std::min(in.rows * in.cols, (qsizetype)INT_MAX));
+
+		VIP_PARALLEL_FOR_NUM_THREADS(threads)
+		for (qsizetype r = 0; r < in.rows; ++r) {
+			const quint64* cur = in.row(r);
+			const quint64* prev = (vertical && r > 0) ? in.row(r - 1) : nullptr;
+			const quint64* next = (vertical && r + 1 < in.rows) ? in.row(r + 1) : nullptr;
+			quint64* dst = out.row(r);
+
+			for (qsizetype i = 0; i < words; ++i) {
+				quint64 v;
+				if (dilate) {
+					auto line = [i, words](const quint64* row) { return row[i] | fromLeft(row, i) | fromRight(row, i, words); };
+					v = line(cur);
+					if (vertical) {
+						if (full)
+							v |= (prev ? line(prev) : 0) | (next ? line(next) : 0);
+						else
+							v |= (prev ? prev[i] : 0) | (next ? next[i] : 0);
+					}
+				}
+				else {
+					// outside elements are 0
+					auto line = [i, words](const quint64* row) { return row[i] & fromLeft(row, i) & fromRight(row, i, words); };
+					v = line(cur);
+					if (vertical) {
+						if (full)
+							v &= (prev ? line(prev) : 0) & (next ? line(next) : 0);
+						else
+							v &= (prev ? prev[i] : 0) & (next ? next[i] : 0);
+					}
+				}
+				if (i == words - 1)
+					v &= in.tail;
+				dst[i] = v;
+			}
+		}
+	}
+
+	/// Apply \a iterations dilation or erosion steps (until convergence if iterations < 1)
+	void morphology(BitMask& mask, int iterations, bool dilate, bool full, bool vertical)
+	{
+		BitMask tmp(mask.rows, mask.cols);
+		const int max_iter = iterations < 1 ? INT_MAX : iterations;
+		for (int it = 0; it < max_iter; ++it) {
+			morphologyStep(mask, tmp, dilate, full, vertical);
+			const bool changed = tmp.bits != mask.bits;
+			std::swap(mask.bits, tmp.bits);
+			if (!changed)
+				break;
+		}
+	}
+
+	/// Apply a sequence of binary dilations/erosions to the non zero elements of \a ar
+	VipNDArray binaryMorphology(const VipNDArray& ar, int iterations, bool full, std::initializer_list<bool> dilate_steps)
+	{
+		qsizetype rows = 0, cols = 0;
+		if (ar.isEmpty() || !ar.isNumeric() || !shape2D(ar, rows, cols))
+			return VipNDArray();
+
+		VipNDArray input(QMetaType::Bool, ar.shape());
+		if (input.isEmpty() || !ar.convert(input))
+			return VipNDArray();
+
+		// pack
+		BitMask mask(rows, cols);
+		const bool* src = static_cast<const bool*>(input.constData());
+		for (qsizetype r = 0; r < rows; ++r) {
+			quint64* dst = mask.row(r);
+			for (qsizetype c = 0; c < cols; ++c)
+				if (src[r * cols + c])
+					dst[c / 64] |= quint64(1) << (c % 64);
+		}
+
+		for (bool dilate : dilate_steps)
+			morphology(mask, iterations, dilate, full, ar.shapeCount() == 2);
+
+		// unpack
+		bool* dst = static_cast<bool*>(input.data());
+		for (qsizetype r = 0; r < rows; ++r) {
+			const quint64* row = mask.row(r);
+			for (qsizetype c = 0; c < cols; ++c)
+				dst[r * cols + c] = (row[c / 64] >> (c % 64)) & 1;
+		}
+		return input;
+	}
+}
+
+Vip::FilterBorderMode vipFilterBorderMode(const QString& name)
+{
+	const QString n = name.toLower().trimmed();
+	if (n == "nearest")
+		return Vip::FilterNearest;
+	if (n == "mirror")
+		return Vip::FilterMirror;
+	if (n == "wrap")
+		return Vip::FilterWrap;
+	return Vip::FilterReflect;
+}
+
+VipNDArray vipMinimumFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode)
+{
+	return minMaxFilter(ar, size, false, true, mode);
+}
+
+VipNDArray vipMaximumFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode)
+{
+	return minMaxFilter(ar, size, true, true, mode);
+}
+
+VipNDArray vipUniformFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode)
+{
+	if (ar.isEmpty() || !ar.isNumeric() || size < 1)
+		return VipNDArray();
+	VipNDArray res = denseCopy(ar, linearFilterType(ar));
+	if (res.isEmpty() || size == 1)
+		return res;
+
+	const qsizetype left = size / 2;
+	const qsizetype right = size - 1 - left;
+	auto apply = [&](auto* data) {
+		using T = typename std::remove_pointer<decltype(data)>::type;
+		for (int axis = 0; axis < res.shapeCount(); ++axis) {
+			filterAxis(data, res.shape(), axis, left, right, mode, [size](const T* p, T* out, qsizetype n) {
+				// running sum accumulated in double precision
+				double sum = 0;
+				for (qsizetype j = 0; j < size; ++j)
+					sum += p[j];
+				const double factor = 1. / size;
+				for (qsizetype i = 0; i < n; ++i) {
+					out[i] = (T)(sum * factor);
+					sum += (double)p[i + size] - (double)p[i];
+				}
+			});
+		}
+	};
+	if (res.dataType() == QMetaType::Float)
+		apply(static_cast<float*>(res.data()));
+	else
+		apply(static_cast<double*>(res.data()));
+	return res;
+}
+
+VipNDArray vipGaussianFilter(const VipNDArray& ar, double sigma, int order, Vip::FilterBorderMode mode, double truncate)
+{
+	if (ar.isEmpty() || !ar.isNumeric() || order < 0)
+		return VipNDArray();
+
+	std::vector<std::vector<double>> kernels(ar.shapeCount());
+	if (sigma > 1e-15) {
+		const qsizetype radius = (qsizetype)(truncate * sigma + 0.5);
+		const std::vector<double> kernel = gaussianKernel(sigma, order, radius);
+		for (auto& k : kernels)
+			k = kernel;
+	}
+	return separableCorrelation(ar, kernels, mode);
+}
+
+static VipNDArray derivativeFilter(const VipNDArray& ar, int axis, const std::vector<double>& smooth, Vip::FilterBorderMode mode)
+{
+	if (ar.isEmpty() || !ar.isNumeric())
+		return VipNDArray();
+	if (axis < 0)
+		axis += ar.shapeCount();
+	if (axis < 0 || axis >= ar.shapeCount())
+		return VipNDArray();
+
+	std::vector<std::vector<double>> kernels(ar.shapeCount(), smooth);
+	kernels[axis] = { -1., 0., 1. };
+	return separableCorrelation(ar, kernels, mode);
+}
+
+VipNDArray vipSobelFilter(const VipNDArray& ar, int axis, Vip::FilterBorderMode mode)
+{
+	return derivativeFilter(ar, axis, { 1., 2., 1. }, mode);
+}
+
+VipNDArray vipPrewittFilter(const VipNDArray& ar, int axis, Vip::FilterBorderMode mode)
+{
+	return derivativeFilter(ar, axis, { 1., 1., 1. }, mode);
+}
+
+VipNDArray vipLaplaceFilter(const VipNDArray& ar, Vip::FilterBorderMode mode)
+{
+	if (ar.isEmpty() || !ar.isNumeric())
+		return VipNDArray();
+
+	VipNDArray res;
+	for (int axis = 0; axis < ar.shapeCount(); ++axis) {
+		std::vector<std::vector<double>> kernels(ar.shapeCount());
+		kernels[axis] = { 1., -2., 1. };
+		const VipNDArray d2 = separableCorrelation(ar, kernels, mode);
+		if (d2.isEmpty())
+			return VipNDArray();
+		if (res.isEmpty()) {
+			res = d2;
+			continue;
+		}
+		const qsizetype size = res.size();
+		if (res.dataType() == QMetaType::Float) {
+			float* dst = static_cast<float*>(res.data());
+			const float* src = static_cast<const float*>(d2.constData());
+			for (qsizetype i = 0; i < size; ++i)
+				dst[i] += src[i];
+		}
+		else {
+			double* dst = static_cast<double*>(res.data());
+			const double* src = static_cast<const double*>(d2.constData());
+			for (qsizetype i = 0; i < size; ++i)
+				dst[i] += src[i];
+		}
+	}
+	return res;
+}
+
+VipNDArray vipRankFilter(const VipNDArray& ar, int rank, int size, Vip::FilterBorderMode mode)
+{
+	qsizetype rows = 0, cols = 0;
+	if (ar.isEmpty() || size < 1 || !shape2D(ar, rows, cols))
+		return VipNDArray();
+
+	const qsizetype wh = ar.shapeCount() == 2 ? size : 1;
+	const qsizetype ww = size;
+	const qsizetype wsize = wh * ww;
+	if (rank < 0)
+		rank += (int)wsize;
+	if (rank < 0 || rank >= wsize)
+		return VipNDArray();
+
+	const VipNDArray input = denseCopy(ar, ar.dataType());
+	if (input.isEmpty())
+		return VipNDArray();
+	VipNDArray res(input.dataType(), input.shape());
+
+	const bool ok = dispatchNumeric(input.dataType(), [&](auto v) {
+		using T = decltype(v);
+		rankFilter(static_cast<const T*>(input.constData()), static_cast<T*>(res.data()), rows, cols, wh, ww, rank, mode);
+	});
+	return ok ? res : VipNDArray();
+}
+
+VipNDArray vipPercentileFilter(const VipNDArray& ar, double percentile, int size, Vip::FilterBorderMode mode)
+{
+	if (percentile < 0)
+		percentile += 100;
+	if (percentile < 0 || percentile > 100 || size < 1)
+		return VipNDArray();
+
+	const qsizetype wsize = (ar.shapeCount() == 2 ? size : 1) * (qsizetype)size;
+	const int rank = percentile == 100. ? (int)wsize - 1 : (int)(double(wsize) * percentile / 100.);
+	return vipRankFilter(ar, rank, size, mode);
+}
+
+VipNDArray vipMedianFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode)
+{
+	const qsizetype wsize = (ar.shapeCount() == 2 ? size : 1) * (qsizetype)size;
+	return vipRankFilter(ar, (int)(wsize / 2), size, mode);
+}
+
+VipNDArray vipBinaryDilation(const VipNDArray& ar, int iterations, bool full_connectivity)
+{
+	return binaryMorphology(ar, iterations, full_connectivity, { true });
+}
+
+VipNDArray vipBinaryErosion(const VipNDArray& ar, int iterations, bool full_connectivity)
+{
+	return binaryMorphology(ar, iterations, full_connectivity, { false });
+}
+
+VipNDArray vipBinaryOpening(const VipNDArray& ar, int iterations, bool full_connectivity)
+{
+	return binaryMorphology(ar, iterations, full_connectivity, { false, true });
+}
+
+VipNDArray vipBinaryClosing(const VipNDArray& ar, int iterations, bool full_connectivity)
+{
+	return binaryMorphology(ar, iterations, full_connectivity, { true, false });
+}
+
+VipNDArray vipGreyDilation(const VipNDArray& ar, int size, bool full_connectivity, Vip::FilterBorderMode mode)
+{
+	return minMaxFilter(ar, size, true, full_connectivity, mode);
+}
+
+VipNDArray vipGreyErosion(const VipNDArray& ar, int size, bool full_connectivity, Vip::FilterBorderMode mode)
+{
+	return minMaxFilter(ar, size, false, full_connectivity, mode);
+}
+
+VipNDArray vipGreyOpening(const VipNDArray& ar, int size, bool full_connectivity, Vip::FilterBorderMode mode)
+{
+	return minMaxFilter(minMaxFilter(ar, size, false, full_connectivity, mode), size, true, full_connectivity, mode);
+}
+
+VipNDArray vipGreyClosing(const VipNDArray& ar, int size, bool full_connectivity, Vip::FilterBorderMode mode)
+{
+	return minMaxFilter(minMaxFilter(ar, size, true, full_connectivity, mode), size, false, full_connectivity, mode);
+}
@@ -0,0 +1,125 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_FILTERS_H
+#define VIP_FILTERS_H
+
+#include "VipNDArray.h"
+
+/// \addtogroup DataType
+/// @{
+
+namespace Vip
+{
+	/// Border handling of the filtering functions, following scipy.ndimage conventions
+	enum FilterBorderMode
+	{
+		FilterReflect, //! (d c b a | a b c d | d c b a)
+		FilterNearest, //! (a a a a | a b c d | d d d d)
+		FilterMirror,  //! (d c b | a b c d | c b a)
+		FilterWrap     //! (a b c d | a b c d | a b c d)
+	};
+}
+
+/// @brief Returns the border mode corresponding to given name ('reflect', 'nearest', 'mirror' or 'wrap').
+/// Returns Vip::FilterReflect for unknown names.
+VIP_DATA_TYPE_EXPORT Vip::FilterBorderMode vipFilterBorderMode(const QString& name);
+
+/// @brief Minimum filter over a window of \a size elements along each axis.
+/// Uses the van Herk/Gil-Werman algorithm on each axis, which costs 3 comparisons per element whatever the window size.
+/// Works on any numerical (non complex) array and returns an array of the same type, or a null array for unsupported input.
+VIP_DATA_TYPE_EXPORT VipNDArray vipMinimumFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Maximum filter over a window of \a size elements along each axis. See #vipMinimumFilter.
+VIP_DATA_TYPE_EXPORT VipNDArray vipMaximumFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode = Vip::FilterReflect);
+
+/// @brief Mean filter over a window of \a size elements along each axis, computed with a running sum on each axis.
+/// Returns a float array for float input, and a double array for any other numerical input.
+VIP_DATA_TYPE_EXPORT VipNDArray vipUniformFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode = Vip::FilterReflect);
+
+/// @brief Separable Gaussian filter, like scipy.ndimage.gaussian_filter.
+/// \a order is the derivative order of the Gaussian kernel (0 for a standard smoothing), applied on each axis.
+/// The kernel radius is truncated to \a truncate standard deviations.
+/// Returns a float array for float input, and a double array for any other numerical input.
+VIP_DATA_TYPE_EXPORT VipNDArray vipGaussianFilter(const VipNDArray& ar, double sigma, int order = 0, Vip::FilterBorderMode mode = Vip::FilterReflect, double truncate = 4.);
+
+/// @brief Sobel filter along \a axis (last axis if negative), like scipy.ndimage.sobel.
+/// Returns a float array for float input, and a double array for any other numerical input.
+VIP_DATA_TYPE_EXPORT VipNDArray vipSobelFilter(const VipNDArray& ar, int axis = -1, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Prewitt filter along \a axis (last axis if negative), like scipy.ndimage.prewitt.
+VIP_DATA_TYPE_EXPORT VipNDArray vipPrewittFilter(const VipNDArray& ar, int axis = -1, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Laplace filter based on approximate second derivatives, like scipy.ndimage.laplace.
+VIP_DATA_TYPE_EXPORT VipNDArray vipLaplaceFilter(const VipNDArray& ar, Vip::FilterBorderMode mode = Vip::FilterReflect);
+
+/// @brief Rank filter over a window of \a size x \a size elements, like scipy.ndimage.rank_filter.
+///
+/// \a rank is the index of the output element in the sorted window (negative values count from the end).
+/// Large windows use a sliding histogram (Huang algorithm) on the ordinal values of the input, so the cost per element
+/// grows linearly with the window size instead of quadratically. Small windows use a direct selection.
+/// Only works on 1D and 2D numerical arrays, and returns an array of the same type.
+VIP_DATA_TYPE_EXPORT VipNDArray vipRankFilter(const VipNDArray& ar, int rank, int size, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Percentile filter, like scipy.ndimage.percentile_filter. \a percentile is in [-100, 100], negative values counting from the end.
+VIP_DATA_TYPE_EXPORT VipNDArray vipPercentileFilter(const VipNDArray& ar, double percentile, int size, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Median filter over a window of \a size x \a size elements
+VIP_DATA_TYPE_EXPORT VipNDArray vipMedianFilter(const VipNDArray& ar, int size, Vip::FilterBorderMode mode = Vip::FilterReflect);
+
+/// @brief Binary dilation of the non zero elements of \a ar with a 3x3 structuring element.
+///
+/// If \a full_connectivity is true, diagonally-connected elements are considered neighbors (square structuring element),
+/// otherwise a cross structuring element is used. The dilation is repeated \a iterations times, or until the result
+/// does not change anymore if \a iterations is less than 1. Outside elements are considered as 0.
+/// The mask is processed as bit-packed rows, 64 elements at a time.
+/// Only works on 1D and 2D numerical arrays, and returns a boolean array.
+VIP_DATA_TYPE_EXPORT VipNDArray vipBinaryDilation(const VipNDArray& ar, int iterations = 1, bool full_connectivity = true);
+/// @brief Binary erosion, see #vipBinaryDilation
+VIP_DATA_TYPE_EXPORT VipNDArray vipBinaryErosion(const VipNDArray& ar, int iterations = 1, bool full_connectivity = true);
+/// @brief Binary opening (erosion followed by a dilation), see #vipBinaryDilation
+VIP_DATA_TYPE_EXPORT VipNDArray vipBinaryOpening(const VipNDArray& ar, int iterations = 1, bool full_connectivity = true);
+/// @brief Binary closing (dilation followed by an erosion), see #vipBinaryDilation
+VIP_DATA_TYPE_EXPORT VipNDArray vipBinaryClosing(const VipNDArray& ar, int iterations = 1, bool full_connectivity = true);
+
+/// @brief Greyscale dilation with a flat structuring element of \a size elements along each axis.
+///
+/// If \a full_connectivity is true, the structuring element is a full square (or cube), and the dilation is a maximum filter.
+/// Otherwise, the structuring element is a cross made of the lines of \a size elements along each axis.
+/// Works on any numerical (non complex) array and returns an array of the same type.
+VIP_DATA_TYPE_EXPORT VipNDArray vipGreyDilation(const VipNDArray& ar, int size = 3, bool full_connectivity = true, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Greyscale erosion, see #vipGreyDilation
+VIP_DATA_TYPE_EXPORT VipNDArray vipGreyErosion(const VipNDArray& ar, int size = 3, bool full_connectivity = true, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Greyscale opening (erosion followed by a dilation), see #vipGreyDilation
+VIP_DATA_TYPE_EXPORT VipNDArray vipGreyOpening(const VipNDArray& ar, int size = 3, bool full_connectivity = true, Vip::FilterBorderMode mode = Vip::FilterReflect);
+/// @brief Greyscale closing (dilation followed by an erosion), see #vipGreyDilation
+VIP_DATA_TYPE_EXPORT VipNDArray vipGreyClosing(const VipNDArray& ar, int size = 3, bool full_connectivity = true, Vip::FilterBorderMode mode = Vip::FilterReflect);
+
+/// @}
+// end DataType
+
+#endif
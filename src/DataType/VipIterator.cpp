@@ -29,17 +29,33 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <thread>
 #include "VipIterator.h"
 
 static std::atomic<int> _threads{ 1 };
+static thread_local int _local_threads = 0;
 
 int vipIterateThreadCount() noexcept
 {
+	if (_local_threads > 0)
+		return _local_threads;
 	return _threads.load(std::memory_order_relaxed);
 }
 
+int vipSetLocalIterateThreadCount(int threads) noexcept
+{
+	static int concurrency = (int)std::thread::hardware_concurrency();
+	int prev = _local_threads;
+	if (threads < 0)
+		threads = 0;
+	else if (threads > concurrency)
+		threads = concurrency;
+	_local_threads = threads;
+	return prev;
+}
+
 void vipSetIterateThreadCount(int threads) noexcept
 {
 	static int concurrency = (int)std::thread::hardware_concurrency();
@@ -61,6 +77,17 @@ void vipSetParallelSizeThreshold(int threshold) noexcept
 	_threshold.store(threshold);
 }
 
+static std::atomic<int> _tile_size{ 16384 };
+
+int vipParallelTileSize() noexcept
+{
+	return _tile_size.load(std::memory_order_relaxed);
+}
+void vipSetParallelTileSize(int size) noexcept
+{
+	_tile_size.store(std::max(size, 1));
+}
+
 int vipLoopThreadCount(int size) noexcept
 {
 #ifndef _OPENMP
@@ -68,6 +95,6 @@ int vipLoopThreadCount(int size) noexcept
 #else
 	if (size < _threshold.load(std::memory_order_relaxed))
 		return 1;
-	return std::min( _threads.load(std::memory_order_relaxed), size);
+	return std::min(vipIterateThreadCount(), size);
 #endif
 }
\ No newline at end of file
@@ -50,6 +50,16 @@ VIP_DATA_TYPE_EXPORT void vipSetIterateThreadCount(int threads) noexcept;
 VIP_DATA_TYPE_EXPORT int vipParallelSizeThreshold() noexcept;
 VIP_DATA_TYPE_EXPORT void vipSetParallelSizeThreshold(int) noexcept;
 
+/// @brief Set/get the tile size (in elements) used by vipEval() to split the iteration space
+/// when evaluating a reduction algorithm using multiple threads. Defaults to 16384.
+VIP_DATA_TYPE_EXPORT int vipParallelTileSize() noexcept;
+VIP_DATA_TYPE_EXPORT void vipSetParallelTileSize(int) noexcept;
+
+/// @brief Override vipIterateThreadCount() for the calling thread only.
+/// Passing 0 removes the override. Returns the previous override value.
+/// This is used by the VipParallel policy of vipEval().
+VIP_DATA_TYPE_EXPORT int vipSetLocalIterateThreadCount(int threads) noexcept;
+
 VIP_DATA_TYPE_EXPORT int vipLoopThreadCount(int size) noexcept;
 
 #ifdef _OPENMP
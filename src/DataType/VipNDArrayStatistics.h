@@ -183,7 +183,7 @@ namespace detail
 			if (first) {
 				ret.min = ret.max = value;
 				ret.sum = (sum_type)value;
-				ret.multiply = 1;
+				ret.multiply = (sum_type)value;
 				first = false;
 				if (!std::is_integral_v<Coord> && (stats & Vip::MinPos))
 					ret.minPos = pos;
@@ -250,6 +250,43 @@ namespace detail
 
 			return ;
 		}
+
+		/// Parallel evaluation is supported unless higher order moments or entropy are requested
+		bool joinable() const noexcept { return !((stats & Vip::Skewness) || (stats & Vip::Kurtosis) || (stats & Vip::Entropy)); }
+		/// Returns an empty reductor with the same configuration
+		ExtractArrayStatistics fork() const
+		{
+			ExtractArrayStatistics res(stats);
+			res.ret.minPos = ret.minPos;
+			res.ret.maxPos = ret.maxPos;
+			return res;
+		}
+		/// Merge the statistics of a reductor that processed the elements following this one's
+		void join(const ExtractArrayStatistics& other)
+		{
+			if (other.first)
+				return;
+			if (first) {
+				ret = other.ret;
+				sum2 = other.sum2;
+				first = false;
+				return;
+			}
+			ret.count += other.ret.count;
+			// strict comparisons keep the first occurrence, like the serial path
+			if (other.ret.min < ret.min) {
+				ret.min = other.ret.min;
+				ret.minPos = other.ret.minPos;
+			}
+			if (other.ret.max > ret.max) {
+				ret.max = other.ret.max;
+				ret.maxPos = other.ret.maxPos;
+			}
+			ret.sum += other.ret.sum;
+			ret.multiply *= other.ret.multiply;
+			sum2 += other.sum2;
+		}
+
 		bool finish()
 		{
 			if ((stats & Vip::Mean) || stats & Vip::Std) {
@@ -34,6 +34,7 @@
 #include "VipSceneModel.h"
 
 #include <QDataStream>
+#include <QtEndian>
 #include <QTextStream>
 
 // helper macro to read data from a QTextSTream
@@ -500,8 +501,137 @@ QTextStream& operator>>(QTextStream& stream, VipComplexPointVector& p)
 }
 
 
+/// Tag written in place of the handle type for the raw array format (version 1).
+/// Legacy streams start with a handle type (>= VipNDArrayHandle::Null) or a data type (> 0).
+static constexpr int _raw_array_format = -1;
+/// Maximum bytes given to a single QDataStream::readRawData()/writeRawData() call
+static constexpr qint64 _raw_chunk_size = 1 << 30;
+
+/// For data types stored as a raw little endian memory block, returns the size of the scalar to byte swap.
+/// Returns 0 for types using the legacy per element format (long, long double, custom types...).
+static int rawArrayUnitSize(int data_type)
+{
+	switch (data_type) {
+		case QMetaType::Bool:
+		case QMetaType::Char:
+		case QMetaType::SChar:
+		case QMetaType::UChar:
+			return 1;
+		case QMetaType::Short:
+		case QMetaType::UShort:
+			return 2;
+		case QMetaType::Int:
+		case QMetaType::UInt:
+		case QMetaType::Float:
+			return 4;
+		case QMetaType::LongLong:
+		case QMetaType::ULongLong:
+		case QMetaType::Double:
+			return 8;
+		default:
+			break;
+	}
+	if (data_type == qMetaTypeId<VipRGB>())
+		return 1;
+	if (data_type == qMetaTypeId<complex_f>() || data_type == qMetaTypeId<VipRGBf>())
+		return 4;
+	if (data_type == qMetaTypeId<complex_d>())
+		return 8;
+	return 0;
+}
+
+/// Convert count scalars of size unit between host and little endian byte order (in place).
+/// This is a no-op on little endian hosts.
+static void rawArraySwap(char* data, qint64 count, int unit)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+	Q_UNUSED(data);
+	Q_UNUSED(count);
+	Q_UNUSED(unit);
+#else
+	if (unit == 2)
+		qToLittleEndian<quint16>(data, count, data);
+	else if (unit == 4)
+		qToLittleEndian<quint32>(data, count, data);
+	else if (unit == 8)
+		qToLittleEndian<quint64>(data, count, data);
+#endif
+}
+
+static bool writeRawArray(QDataStream& stream, const VipNDArray& ar)
+{
+	const int unit = rawArrayUnitSize(ar.dataType());
+	const int handle_type = ar.handle()->handleType();
+	if (!unit || (handle_type != VipNDArrayHandle::Standard && handle_type != VipNDArrayHandle::View))
+		return false;
+
+	const VipNDArray dense = (ar.isView() || !ar.isUnstrided()) ? ar.copy() : ar;
+	const qint64 bytes = (qint64)dense.size() * dense.dataSize();
+	stream << _raw_array_format;
+	stream << QByteArray(dense.dataName());
+	stream << dense.shape();
+	stream << bytes;
+
+	const char* data = static_cast<const char*>(dense.constData());
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+	for (qint64 pos = 0; pos < bytes; pos += _raw_chunk_size)
+		stream.writeRawData(data + pos, (int)qMin(_raw_chunk_size, bytes - pos));
+#else
+	// swap through a small buffer to avoid copying the full array
+	QByteArray tmp(qMin(bytes, (qint64)(1 << 16)), Qt::Uninitialized);
+	for (qint64 pos = 0; pos < bytes; pos += tmp.size()) {
+		const int len = (int)qMin((qint64)tmp.size(), bytes - pos);
+		memcpy(tmp.data(), data + pos, len);
+		rawArraySwap(tmp.data(), len / unit, unit);
+		stream.writeRawData(tmp.data(), len);
+	}
+#endif
+	return true;
+}
+
+static void readRawArray(QDataStream& stream, VipNDArray& ar)
+{
+	QByteArray type_name;
+	VipNDArrayShape shape;
+	qint64 bytes = 0;
+	stream >> type_name;
+	stream >> shape;
+	stream >> bytes;
+	if (stream.status() != QDataStream::Ok)
+		return;
+
+	const int data_type = vipIdFromName(type_name.data());
+	const int unit = rawArrayUnitSize(data_type);
+	VipSharedHandle h = unit ? vipCreateArrayHandle(VipNDArrayHandle::Standard, data_type, shape) : VipSharedHandle();
+	if (!unit || vipIsNullArray(h.constData())) {
+		stream.setStatus(QDataStream::ReadCorruptData);
+		return;
+	}
+	h->size = vipComputeDefaultStrides<Vip::FirstMajor>(shape, h->strides);
+	if (bytes != (qint64)h->size * h->dataSize()) {
+		stream.setStatus(QDataStream::ReadCorruptData);
+		return;
+	}
+
+	char* data = static_cast<char*>(h->opaque);
+	for (qint64 pos = 0; pos < bytes; pos += _raw_chunk_size) {
+		const int len = (int)qMin(_raw_chunk_size, bytes - pos);
+		if (stream.readRawData(data + pos, len) != len) {
+			stream.setStatus(QDataStream::ReadPastEnd);
+			return;
+		}
+	}
+	rawArraySwap(data, bytes / unit, unit);
+	ar = VipNDArray(h);
+}
+
 QDataStream& operator<<(QDataStream& stream, const VipNDArray& ar)
 {
+	// fast path: POD and complex arrays are written as a single raw memory block
+	if (writeRawArray(stream, ar))
+		return stream;
+
+	// legacy per element format
 	stream << ar.handle()->handleType();
 	stream << ar.dataType();
 	stream << ar.shape();
@@ -518,7 +648,11 @@ QDataStream& operator>>(QDataStream& stream, VipNDArray& ar)
 	VipNDArrayShape shape;
 
 	stream >> handle_type;
-	if (handle_type >= VipNDArrayHandle::Null) {
+	if (handle_type == _raw_array_format) {
+		readRawArray(stream, ar);
+		return stream;
+	}
+	else if (handle_type >= VipNDArrayHandle::Null) {
 		// this is the new format with a handle type
 		stream >> data_type;
 		stream >> shape;
@@ -53,11 +53,8 @@ public:
 			 
 			for (int i = 0; i < curves.size(); ++i) {
 
-				curves[i]->updateSamples([x, y](VipPointVector& vec) {
-					vec.push_back(VipPoint(x, y));
-					if (vec.size() > 500)
-						vec.erase(vec.begin());
-				});
+				// append one point and keep the last 500 ones
+				curves[i]->addSample(VipPoint(x, y), 500);
 			}
 
 			qint64 current = QDateTime::currentMSecsSinceEpoch(); 
@@ -763,6 +763,7 @@ public:
 	QComboBox* procPriority;
 	QComboBox* displayPriority;
 	QCheckBox* printDebug;
+	QCheckBox* sharedExecutor;
 
 	QCheckBox* maxSizeEnable;
 	QSpinBox* maxSize;
@@ -789,6 +790,9 @@ ProcessingSettings::ProcessingSettings(QWidget* parent)
 	d_data->displayPriority = new QComboBox();
 	d_data->printDebug = new QCheckBox();
 	d_data->printDebug->setText("Print debug informations");
+	d_data->sharedExecutor = new QCheckBox();
+	d_data->sharedExecutor->setText("Use a shared thread pool for asynchronous processings");
+	d_data->sharedExecutor->setToolTip("Schedule asynchronous processings on a global thread pool sized to the number of cores<br>instead of one thread per processing.<br>Only affects new processings.");
 
 	d_data->procPriority->setToolTip("Set the default processing thread priority used within Thermavip");
 	d_data->procPriority->addItem("Idle Priority");
@@ -818,6 +822,7 @@ ProcessingSettings::ProcessingSettings(QWidget* parent)
 	glay->addWidget(new QLabel("Display processing thread priority"), 2, 0);
 	glay->addWidget(d_data->displayPriority, 2, 1);
 	glay->addWidget(d_data->printDebug, 3, 0, 1, 2);
+	glay->addWidget(d_data->sharedExecutor, 4, 0, 1, 2);
 
 	d_data->maxSizeEnable = new QCheckBox();
 	d_data->maxSize = new QSpinBox();
@@ -880,6 +885,8 @@ void ProcessingSettings::applyPage()
 	disconnect(&VipProcessingManager::instance(), SIGNAL(changed()), this, SLOT(updatePage()));
 
 	vipSetIterateThreadCount(d_data->arrayThreads->value());
+	if (d_data->sharedExecutor->isChecked() != VipProcessingManager::sharedExecutorEnabled())
+		VipProcessingManager::setSharedExecutorEnabled(d_data->sharedExecutor->isChecked());
 
 	int type = 0;
 	if (d_data->maxSizeEnable->isChecked())
@@ -924,6 +931,7 @@ void ProcessingSettings::applyPage()
 void ProcessingSettings::updatePage()
 {
 	d_data->arrayThreads->setValue(vipIterateThreadCount());
+	d_data->sharedExecutor->setChecked(VipProcessingManager::sharedExecutorEnabled());
 
 	d_data->maxSizeEnable->setChecked(VipProcessingManager::listLimitType() & VipDataList::Number);
 	d_data->maxMemoryEnable->setChecked(VipProcessingManager::listLimitType() & VipDataList::MemorySize);
@@ -4465,159 +4465,185 @@ QList<VipProcessingObject*> extractTimeEvolutionFromPlayer2(VipVideoPlayer* play
 	progress.setCancelable(true);
 	progress.setText("Extract time trace...");
 
-	// now, save the current VipProcessingPool state, because we are going to modify it heavily
-	pool->save();
-
-	// disable all processing except the sources, remove the Automatic flag from the sources
-	pool->disableExcept(sources);
-	foreach (VipProcessingObject* obj, sources) {
-		obj->setScheduleStrategy(VipProcessingObject::Asynchronous, false);
-	}
-
-	// create the VipExtractStatistics object and connect it to the display source object
-	for (int i = 0; i < extracts.size(); ++i) {
-		VipExtractStatistics* extract = extracts[i];
-		extract->setLogErrors(QSet<int>());
-		src_output->setConnection(extract->inputAt(0));
-		extract->inputAt(0)->setData(player->viewer()->area()->array());
-		extract->update();
-	}
-
-	// extract the values
-
 	// vector of vector of VipPointVector
 	// first vector has size of extracts (one per shape)
 	// second vector has a size of 8 (one per stat)
 	QVector<QVector<VipPointVector>> stats_values(extracts.size());
 	for (int i = 0; i < extracts.size(); ++i)
 		stats_values[i].resize(8);
-	
+
 	QVector<VipPointVector> maxPos(extracts.size());
 	QVector<VipPointVector> minPos(extracts.size());
 
 	qint64 pool_time = pool->time();
-	qint64 time = pool->firstTime();
-	if (time < intersect_time.first)
-		time = intersect_time.first;
-	qint64 end_time = pool->lastTime();
-	if (end_time > intersect_time.second)
-		end_time = intersect_time.second;
-	// qint64 current_time = pool->time();
-	int skip = one_frame_out_of;
-	progress.setRange(time, end_time);
 
-	// block signals
-	pool->blockSignals(true);
-	for (int i = 0; i < infos.shapes.size(); ++i)
-		if (infos.shapes[i].shapeSignals())
-			infos.shapes[i].shapeSignals()->blockSignals(true);
+	// Static shapes on a single temporal device: split the movie in segments processed in parallel
+	// by private copies of the pipeline. The processing pool is left untouched.
+	bool extracted = false;
+	if (!has_dynamic_shapes && infos.identifiers.isEmpty()) {
+		VipShapeList shapes;
+		for (int i = 0; i < extracts.size(); ++i)
+			shapes.append(extracts[i]->shape());
+
+		QVector<VipTimeTrace> traces;
+		if (vipExtractTimeTraces(src_output, shapes, stats, traces, intersect_time, one_frame_out_of, 0, &progress)) {
+			for (int i = 0; i < traces.size(); ++i) {
+				stats_values[i] = traces[i].values;
+				minPos[i] = traces[i].minPos;
+				maxPos[i] = traces[i].maxPos;
+			}
+			extracted = true;
+		}
+		else if (progress.canceled()) {
+			qDeleteAll(extracts);
+			return QList<VipProcessingObject*>();
+		}
+	}
 
-	// TEST: Asynchronous strategy
-	//  We launch the pipeline in a synchronous way, except the VipExtractStatistics objects
-	//  which are Asynchronous.
-	//
-	//  We tell the outputs of each VipExtractStatistics to bufferize their data.
-	//  Then, every 20 frames, we collect the buffered outputs and add them to the final
-	//  curves.
-	//
-	//  This way we fasten the statistics extraction by using each VipExtractStatistics own
-	//  internal task pool. This is especially relevant when using multiple ROIs (and therefore
-	//  multiple VipExtractStatistics objects).
-	//
-	//  The previous synchronous version is commented below.
+	if (!extracted) {
+		// now, save the current VipProcessingPool state, because we are going to modify it heavily
+		pool->save();
 
-	{
-		// Asynchronous strategy with buffered outputs
+		// disable all processing except the sources, remove the Automatic flag from the sources
+		pool->disableExcept(sources);
+		foreach (VipProcessingObject* obj, sources) {
+			obj->setScheduleStrategy(VipProcessingObject::Asynchronous, false);
+		}
+
+		// create the VipExtractStatistics object and connect it to the display source object
 		for (int i = 0; i < extracts.size(); ++i) {
 			VipExtractStatistics* extract = extracts[i];
-			extract->setScheduleStrategy(VipProcessingObject::Asynchronous);
-			extract->inputAt(0)->setListType(VipDataList::FIFO, VipDataList::Number);
-			for (int j = 0; j < extract->outputCount(); ++j)
-				extract->outputAt(j)->setBufferDataEnabled(true);
-		}
-
-		int count = 0;
-		while (time != VipInvalidTime && time <= end_time) {
-			progress.setValue(time);
-
-			pool->read(time, true);
-			// update all leafs
-			for (int i = 0; i < leafs.size(); ++i)
-				leafs[i]->update();
-
-			// update statistics every 10 frames
-			if (count % 20 == 0)
-				for (int i = 0; i < extracts.size(); ++i) {
-					VipExtractStatistics* extract = extracts[i];
-					extract->wait();
-					if (!extract->hasError()) {
-
-						VipAnyDataList lst = extract->outputAt(0)->clearBufferedData();
-						for (const VipAnyData& any : lst) {
-							minPos[i].push_back(any.attribute("Pos").toPoint());
-							stats_values[i][0].append(QPointF(any.time(), any.value<double>()));
-						}
-						lst = extract->outputAt(1)->clearBufferedData();
-						for (const VipAnyData& any : lst) {
-							maxPos[i].push_back(any.attribute("Pos").toPoint());
-							stats_values[i][1].append(QPointF(any.time(), any.value<double>()));
-						}
-						for (int index = 2; index < 8; ++index) {
-							lst = extract->outputAt(index)->clearBufferedData();
-							for (const VipAnyData& any : lst)
-								stats_values[i][index].append(QPointF(any.time(), any.value<double>()));
-						}
+			extract->setLogErrors(QSet<int>());
+			src_output->setConnection(extract->inputAt(0));
+			extract->inputAt(0)->setData(player->viewer()->area()->array());
+			extract->update();
+		}
+
+		// extract the values
+
+		qint64 time = pool->firstTime();
+		if (time < intersect_time.first)
+			time = intersect_time.first;
+		qint64 end_time = pool->lastTime();
+		if (end_time > intersect_time.second)
+			end_time = intersect_time.second;
+		// qint64 current_time = pool->time();
+		int skip = one_frame_out_of;
+		progress.setRange(time, end_time);
+
+		// block signals
+		pool->blockSignals(true);
+		for (int i = 0; i < infos.shapes.size(); ++i)
+			if (infos.shapes[i].shapeSignals())
+				infos.shapes[i].shapeSignals()->blockSignals(true);
+
+		// TEST: Asynchronous strategy
+		//  We launch the pipeline in a synchronous way, except the VipExtractStatistics objects
+		//  which are Asynchronous.
+		//
+		//  We tell the outputs of each VipExtractStatistics to bufferize their data.
+		//  Then, every 20 frames, we collect the buffered outputs and add them to the final
+		//  curves.
+		//
+		//  This way we fasten the statistics extraction by using each VipExtractStatistics own
+		//  internal task pool. This is especially relevant when using multiple ROIs (and therefore
+		//  multiple VipExtractStatistics objects).
+		//
+		//  The previous synchronous version is commented below.
+
+		{
+			// Asynchronous strategy with buffered outputs
+			for (int i = 0; i < extracts.size(); ++i) {
+				VipExtractStatistics* extract = extracts[i];
+				extract->setScheduleStrategy(VipProcessingObject::Asynchronous);
+				extract->inputAt(0)->setListType(VipDataList::FIFO, VipDataList::Number);
+				for (int j = 0; j < extract->outputCount(); ++j)
+					extract->outputAt(j)->setBufferDataEnabled(true);
+			}
+
+			int count = 0;
+			while (time != VipInvalidTime && time <= end_time) {
+				progress.setValue(time);
+
+				pool->read(time, true);
+				// update all leafs
+				for (int i = 0; i < leafs.size(); ++i)
+					leafs[i]->update();
+
+				// update statistics every 10 frames
+				if (count % 20 == 0)
+					for (int i = 0; i < extracts.size(); ++i) {
+						VipExtractStatistics* extract = extracts[i];
+						extract->wait();
+						if (!extract->hasError()) {
+
+							VipAnyDataList lst = extract->outputAt(0)->clearBufferedData();
+							for (const VipAnyData& any : lst) {
+								minPos[i].push_back(any.attribute("Pos").toPoint());
+								stats_values[i][0].append(QPointF(any.time(), any.value<double>()));
+							}
+							lst = extract->outputAt(1)->clearBufferedData();
+							for (const VipAnyData& any : lst) {
+								maxPos[i].push_back(any.attribute("Pos").toPoint());
+								stats_values[i][1].append(QPointF(any.time(), any.value<double>()));
+							}
+							for (int index = 2; index < 8; ++index) {
+								lst = extract->outputAt(index)->clearBufferedData();
+								for (const VipAnyData& any : lst)
+									stats_values[i][index].append(QPointF(any.time(), any.value<double>()));
+							}
 						
+						}
 					}
-				}
 
-			// skip frames
-			bool end_loop = false;
-			for (int i = 0; i < skip; ++i) {
-				qint64 next = pool->nextTime(time);
-				if (next == time || progress.canceled() || next == VipInvalidTime) {
-					end_loop = true;
-					break;
+				// skip frames
+				bool end_loop = false;
+				for (int i = 0; i < skip; ++i) {
+					qint64 next = pool->nextTime(time);
+					if (next == time || progress.canceled() || next == VipInvalidTime) {
+						end_loop = true;
+						break;
+					}
+					time = next;
 				}
-				time = next;
-			}
-			if (end_loop)
-				break;
+				if (end_loop)
+					break;
 
-			++count;
-		}
+				++count;
+			}
 
-		// finish
-		for (int i = 0; i < extracts.size(); ++i) {
-			VipExtractStatistics* extract = extracts[i];
-			extract->wait();
-			if (!extract->hasError()) {
+			// finish
+			for (int i = 0; i < extracts.size(); ++i) {
+				VipExtractStatistics* extract = extracts[i];
+				extract->wait();
+				if (!extract->hasError()) {
 
-				VipAnyDataList lst = extract->outputAt(0)->clearBufferedData();
-				for (const VipAnyData& any : lst) {
-					minPos[i].push_back(any.attribute("Pos").toPoint());
-					stats_values[i][0].append(QPointF(any.time(), any.value<double>()));
-				}
-				lst = extract->outputAt(1)->clearBufferedData();
-				for (const VipAnyData& any : lst) {
-					maxPos[i].push_back(any.attribute("Pos").toPoint());
-					stats_values[i][1].append(QPointF(any.time(), any.value<double>()));
-				}
-				for (int index = 2; index < 8; ++index) {
-					lst = extract->outputAt(index)->clearBufferedData();
-					for (const VipAnyData& any : lst)
-						stats_values[i][index].append(QPointF(any.time(), any.value<double>()));
-				}
+					VipAnyDataList lst = extract->outputAt(0)->clearBufferedData();
+					for (const VipAnyData& any : lst) {
+						minPos[i].push_back(any.attribute("Pos").toPoint());
+						stats_values[i][0].append(QPointF(any.time(), any.value<double>()));
+					}
+					lst = extract->outputAt(1)->clearBufferedData();
+					for (const VipAnyData& any : lst) {
+						maxPos[i].push_back(any.attribute("Pos").toPoint());
+						stats_values[i][1].append(QPointF(any.time(), any.value<double>()));
+					}
+					for (int index = 2; index < 8; ++index) {
+						lst = extract->outputAt(index)->clearBufferedData();
+						for (const VipAnyData& any : lst)
+							stats_values[i][index].append(QPointF(any.time(), any.value<double>()));
+					}
 				
+				}
 			}
 		}
-	}
 
-	// Unblock signals
-	pool->blockSignals(false);
-	for (int i = 0; i < infos.shapes.size(); ++i)
-		if (infos.shapes[i].shapeSignals())
-			infos.shapes[i].shapeSignals()->blockSignals(false);
+		// Unblock signals
+		pool->blockSignals(false);
+		for (int i = 0; i < infos.shapes.size(); ++i)
+			if (infos.shapes[i].shapeSignals())
+				infos.shapes[i].shapeSignals()->blockSignals(false);
+	}
 
 	// store the result
 	QList<VipProcessingObject*> res;
@@ -4730,8 +4756,10 @@ QList<VipProcessingObject*> extractTimeEvolutionFromPlayer2(VipVideoPlayer* play
 	}
 
 	// restore the VipProcessingPool
-	pool->restore();
-	pool->read(pool_time);
+	if (!extracted) {
+		pool->restore();
+		pool->read(pool_time);
+	}
 
 	return res;
 }
@@ -30,6 +30,7 @@
  */
 
 #include "VipColorMap.h"
+#include "VipColorMapKernels.h"
 #include "VipHistogram.h"
 #include "VipNDArray.h"
 #include "VipScaleMap.h"
@@ -745,6 +746,9 @@ void VipLinearColorMap::applyColorMap(const VipInterval& interval, const VipNDAr
 			  const double min_value = interval.minValue();
 			  const double factor = one_on_width * multiply;
 			  if (!this->useFlatHistogram()) {
+				  // use the vectorized kernels if possible
+				  if (VipColorMapKernels::applyLinear(ar, min_value, factor, palette, num_colors, out))
+					  return true;
 				  vipEval(imout,
 					  vipFunction(
 					    [&](auto v) {
@@ -789,20 +793,22 @@ void VipLinearColorMap::applyColorMap(const VipInterval& interval, const VipNDAr
 					  // small histogram, expand to num_colors
 					  double f = num_colors / (double)(this->d_data->histogram.size());
 
-					  vipEval(imout,
-						  vipFunction(
-						    [&](auto index) {
-							    if (index < max_index && index > 1)
-								    index = (int)(((index - 2) * f) + 2.5);
-								else if(index >= num_colors )
-									return qRgba(0, 0, 0, 0);
-							    return palette[index];
-						    },
-						    VipArrayView<int>(this->d_data->indexes.data(), array.shape())));
+					  if (!VipColorMapKernels::applyIndexes(this->d_data->indexes.data(), size, palette, num_colors, true, f, out))
+						  vipEval(imout,
+							  vipFunction(
+							    [&](auto index) {
+								    if (index < max_index && index > 1)
+									    index = (int)(((index - 2) * f) + 2.5);
+									else if(index >= num_colors )
+										return qRgba(0, 0, 0, 0);
+								    return palette[index];
+							    },
+							    VipArrayView<int>(this->d_data->indexes.data(), array.shape())));
 				  }
 				  else {
 					  // histogram of size num_colors
-					  vipEval(imout, vipFunction([&](auto index) { return palette[index]; }, VipArrayView<int>(this->d_data->indexes.data(), array.shape())));
+					  if (!VipColorMapKernels::applyIndexes(this->d_data->indexes.data(), size, palette, num_colors, false, 0., out))
+						  vipEval(imout, vipFunction([&](auto index) { return palette[index]; }, VipArrayView<int>(this->d_data->indexes.data(), array.shape())));
 				  }
 			  }
 
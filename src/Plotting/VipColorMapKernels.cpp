@@ -0,0 +1,357 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "VipColorMapKernels.h"
+#include "VipIterator.h"
+#include "VipNDArray.h"
+#include "VipSIMD.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VIP_COLOR_MAP_X86
+#include <immintrin.h>
+#endif
+
+// Kernels are compiled for their own instruction set and selected at runtime,
+// so that the library can still be built without -mavx2.
+#if defined(__GNUC__) || defined(__clang__)
+#define VIP_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define VIP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VIP_TARGET_SSE41
+#define VIP_TARGET_AVX2
+#endif
+
+// Pixel count processed by each thread
+static constexpr qsizetype _block_size = 16384;
+
+namespace
+{
+	/// Scalar version used for tails, must match VipLinearColorMap::applyColorMap() generic implementation
+	template<class T>
+	inline QRgb linearPixel(T v, double min_value, double factor, const QRgb* palette, int max_index)
+	{
+		if constexpr (std::is_floating_point_v<T>) {
+			if (v != v)
+				return palette[0];
+		}
+		double x = ((double)v - min_value) * factor + 2;
+		x = (x > (double)max_index) ? (double)max_index : (x < 1.) ? 1. : x;
+		return palette[(unsigned)x];
+	}
+
+	inline QRgb indexPixel(int index, const QRgb* palette, int num_colors, bool expand, double f)
+	{
+		if (!expand)
+			return palette[index];
+		if (index < num_colors + 2 && index > 1)
+			index = (int)(((index - 2) * f) + 2.5);
+		else if (index >= num_colors)
+			return qRgba(0, 0, 0, 0);
+		return palette[index];
+	}
+
+	template<class T>
+	void linearScalar(const T* in, qsizetype size, double min_value, double factor, const QRgb* palette, int max_index, QRgb* out)
+	{
+		for (qsizetype i = 0; i < size; ++i)
+			out[i] = linearPixel(in[i], min_value, factor, palette, max_index);
+	}
+
+#ifdef VIP_COLOR_MAP_X86
+
+	//
+	// SSE4.1 kernels: 2 doubles per register
+	//
+
+	VIP_TARGET_SSE41 inline __m128d load2(const unsigned char* p)
+	{
+		quint16 v;
+		memcpy(&v, p, 2);
+		return _mm_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(v)));
+	}
+	VIP_TARGET_SSE41 inline __m128d load2(const unsigned short* p)
+	{
+		int v;
+		memcpy(&v, p, 4);
+		return _mm_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_cvtsi32_si128(v)));
+	}
+	VIP_TARGET_SSE41 inline __m128d load2(const short* p)
+	{
+		int v;
+		memcpy(&v, p, 4);
+		return _mm_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_cvtsi32_si128(v)));
+	}
+	VIP_TARGET_SSE41 inline __m128d load2(const int* p) { return _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)p)); }
+	VIP_TARGET_SSE41 inline __m128d load2(const float* p) { return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)p))); }
+	VIP_TARGET_SSE41 inline __m128d load2(const double* p) { return _mm_loadu_pd(p); }
+
+	template<class T>
+	VIP_TARGET_SSE41 void linearSSE41(const T* in, qsizetype size, double min_value, double factor, const QRgb* palette, int max_index, QRgb* out)
+	{
+		const __m128d vmin = _mm_set1_pd(min_value);
+		const __m128d vfactor = _mm_set1_pd(factor);
+		const __m128d vtwo = _mm_set1_pd(2.);
+		const __m128d vone = _mm_set1_pd(1.);
+		const __m128d vmax = _mm_set1_pd((double)max_index);
+		const __m128d vzero = _mm_setzero_pd();
+
+		qsizetype i = 0;
+		for (; i + 4 <= size; i += 4) {
+			__m128d v0 = load2(in + i);
+			__m128d v1 = load2(in + i + 2);
+			// same operation order as the scalar version to get the same rounding
+			__m128d x0 = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(v0, vmin), vfactor), vtwo);
+			__m128d x1 = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(v1, vmin), vfactor), vtwo);
+			x0 = _mm_min_pd(_mm_max_pd(x0, vone), vmax);
+			x1 = _mm_min_pd(_mm_max_pd(x1, vone), vmax);
+			if constexpr (std::is_floating_point_v<T>) {
+				// NaN values use the first palette entry
+				x0 = _mm_blendv_pd(x0, vzero, _mm_cmpunord_pd(v0, v0));
+				x1 = _mm_blendv_pd(x1, vzero, _mm_cmpunord_pd(v1, v1));
+			}
+			const __m128i i0 = _mm_cvttpd_epi32(x0);
+			const __m128i i1 = _mm_cvttpd_epi32(x1);
+			out[i] = palette[_mm_cvtsi128_si32(i0)];
+			out[i + 1] = palette[_mm_extract_epi32(i0, 1)];
+			out[i + 2] = palette[_mm_cvtsi128_si32(i1)];
+			out[i + 3] = palette[_mm_extract_epi32(i1, 1)];
+		}
+		linearScalar(in + i, size - i, min_value, factor, palette, max_index, out + i);
+	}
+
+	//
+	// AVX2 kernels: 4 doubles per register, palette lookup using gather instructions
+	//
+
+	VIP_TARGET_AVX2 inline __m256d load4(const unsigned char* p)
+	{
+		int v;
+		memcpy(&v, p, 4);
+		return _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(v)));
+	}
+	VIP_TARGET_AVX2 inline __m256d load4(const unsigned short* p) { return _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)p))); }
+	VIP_TARGET_AVX2 inline __m256d load4(const short* p) { return _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)p))); }
+	VIP_TARGET_AVX2 inline __m256d load4(const int* p) { return _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)p)); }
+	VIP_TARGET_AVX2 inline __m256d load4(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+	VIP_TARGET_AVX2 inline __m256d load4(const double* p) { return _mm256_loadu_pd(p); }
+
+	template<class T>
+	VIP_TARGET_AVX2 inline __m128i linearIndex4(const T* in, __m256d vmin, __m256d vfactor, __m256d vtwo, __m256d vone, __m256d vmax)
+	{
+		const __m256d v = load4(in);
+		__m256d x = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(v, vmin), vfactor), vtwo);
+		x = _mm256_min_pd(_mm256_max_pd(x, vone), vmax);
+		if constexpr (std::is_floating_point_v<T>)
+			x = _mm256_blendv_pd(x, _mm256_setzero_pd(), _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+		return _mm256_cvttpd_epi32(x);
+	}
+
+	template<class T>
+	VIP_TARGET_AVX2 void linearAVX2(const T* in, qsizetype size, double min_value, double factor, const QRgb* palette, int max_index, QRgb* out)
+	{
+		const __m256d vmin = _mm256_set1_pd(min_value);
+		const __m256d vfactor = _mm256_set1_pd(factor);
+		const __m256d vtwo = _mm256_set1_pd(2.);
+		const __m256d vone = _mm256_set1_pd(1.);
+		const __m256d vmax = _mm256_set1_pd((double)max_index);
+
+		qsizetype i = 0;
+		for (; i + 8 <= size; i += 8) {
+			const __m128i lo = linearIndex4(in + i, vmin, vfactor, vtwo, vone, vmax);
+			const __m128i hi = linearIndex4(in + i + 4, vmin, vfactor, vtwo, vone, vmax);
+			const __m256i idx = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+			_mm256_storeu_si256((__m256i*)(out + i), _mm256_i32gather_epi32((const int*)palette, idx, 4));
+		}
+		linearScalar(in + i, size - i, min_value, factor, palette, max_index, out + i);
+	}
+
+	VIP_TARGET_AVX2 void indexesAVX2(const int* indexes, qsizetype size, const QRgb* palette, int num_colors, bool expand, double f, QRgb* out)
+	{
+		qsizetype i = 0;
+		if (!expand) {
+			for (; i + 8 <= size; i += 8) {
+				const __m256i idx = _mm256_loadu_si256((const __m256i*)(indexes + i));
+				_mm256_storeu_si256((__m256i*)(out + i), _mm256_i32gather_epi32((const int*)palette, idx, 4));
+			}
+		}
+		else {
+			const __m256d vf = _mm256_set1_pd(f);
+			const __m256d vtwo = _mm256_set1_pd(2.);
+			const __m256d vhalf = _mm256_set1_pd(2.5);
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i max_index = _mm256_set1_epi32(num_colors + 2);
+			const __m256i last = _mm256_set1_epi32(num_colors - 1);
+			for (; i + 8 <= size; i += 8) {
+				const __m256i idx = _mm256_loadu_si256((const __m256i*)(indexes + i));
+				// (index - 2) * f + 2.5, computed in double like the scalar version
+				const __m256d lo = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(idx)), vtwo), vf), vhalf);
+				const __m256d hi = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(idx, 1)), vtwo), vf), vhalf);
+				const __m256i remapped = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(lo)), _mm256_cvttpd_epi32(hi), 1);
+
+				const __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi32(idx, one), _mm256_cmpgt_epi32(max_index, idx));
+				const __m256i transparent = _mm256_andnot_si256(in_range, _mm256_cmpgt_epi32(idx, last));
+				__m256i sel = _mm256_blendv_epi8(idx, remapped, in_range);
+				sel = _mm256_andnot_si256(transparent, sel);
+				const __m256i colors = _mm256_i32gather_epi32((const int*)palette, sel, 4);
+				_mm256_storeu_si256((__m256i*)(out + i), _mm256_andnot_si256(transparent, colors));
+			}
+		}
+		for (; i < size; ++i)
+			out[i] = indexPixel(indexes[i], palette, num_colors, expand, f);
+	}
+
+#endif
+
+	VipColorMapKernels::Level computeSupportedLevel()
+	{
+#ifdef VIP_COLOR_MAP_X86
+		const VipCPUFeatures& features = vipCPUFeatures();
+		if (features.HAS_AVX2)
+			return VipColorMapKernels::AVX2;
+		if (features.HAS_SSE41)
+			return VipColorMapKernels::SSE41;
+#endif
+		return VipColorMapKernels::Scalar;
+	}
+
+	std::atomic<int>& currentLevel()
+	{
+		static std::atomic<int> level{ (int)VipColorMapKernels::supportedLevel() };
+		return level;
+	}
+
+	template<class T>
+	void applyLinearBlock(VipColorMapKernels::Level level, const T* in, qsizetype size, double min_value, double factor, const QRgb* palette, int max_index, QRgb* out)
+	{
+#ifdef VIP_COLOR_MAP_X86
+		if (level == VipColorMapKernels::AVX2)
+			return linearAVX2(in, size, min_value, factor, palette, max_index, out);
+		if (level == VipColorMapKernels::SSE41)
+			return linearSSE41(in, size, min_value, factor, palette, max_index, out);
+#else
+		(void)level;
+#endif
+		linearScalar(in, size, min_value, factor, palette, max_index, out);
+	}
+
+	template<class T>
+	void applyLinearTyped(VipColorMapKernels::Level level, const T* in, qsizetype size, double min_value, double factor, const QRgb* palette, int max_index, QRgb* out)
+	{
+		const qsizetype blocks = (size + _block_size - 1) / _block_size;
+		VIP_PARALLEL_FOR_NUM_THREADS(vipLoopThreadCount((int)std::min(size, (qsizetype)INT_MAX)))
+		for (qsizetype b = 0; b < blocks; ++b) {
+			const qsizetype start = b * _block_size;
+			const qsizetype count = std::min(_block_size, size - start);
+			applyLinearBlock(level, in + start, count, min_value, factor, palette, max_index, out + start);
+		}
+	}
+}
+
+namespace VipColorMapKernels
+{
+	Level supportedLevel()
+	{
+		static const Level level = computeSupportedLevel();
+		return level;
+	}
+
+	Level level()
+	{
+		return (Level)currentLevel().load(std::memory_order_relaxed);
+	}
+
+	void setLevel(Level l)
+	{
+		currentLevel().store((int)std::min(l, supportedLevel()));
+	}
+
+	bool applyLinear(const VipNDArray& ar, double min_value, double factor, const QRgb* palette, int num_colors, QRgb* out)
+	{
+		const Level l = level();
+		if (l == Scalar || ar.isEmpty() || ar.isView() || !ar.isUnstrided())
+			return false;
+
+		const int max_index = num_colors + 2;
+		const qsizetype size = ar.size();
+		switch (ar.dataType()) {
+			case QMetaType::UChar:
+				applyLinearTyped(l, (const unsigned char*)ar.constData(), size, min_value, factor, palette, max_index, out);
+				return true;
+			case QMetaType::UShort:
+				applyLinearTyped(l, (const unsigned short*)ar.constData(), size, min_value, factor, palette, max_index, out);
+				return true;
+			case QMetaType::Short:
+				applyLinearTyped(l, (const short*)ar.constData(), size, min_value, factor, palette, max_index, out);
+				return true;
+			case QMetaType::Int:
+				applyLinearTyped(l, (const int*)ar.constData(), size, min_value, factor, palette, max_index, out);
+				return true;
+			case QMetaType::Float:
+				applyLinearTyped(l, (const float*)ar.constData(), size, min_value, factor, palette, max_index, out);
+				return true;
+			case QMetaType::Double:
+				applyLinearTyped(l, (const double*)ar.constData(), size, min_value, factor, palette, max_index, out);
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	bool applyIndexes(const int* indexes, qsizetype size, const QRgb* palette, int num_colors, bool expand, double expand_factor, QRgb* out)
+	{
+		const Level l = level();
+		if (l == Scalar)
+			return false;
+
+		const qsizetype blocks = (size + _block_size - 1) / _block_size;
+		VIP_PARALLEL_FOR_NUM_THREADS(vipLoopThreadCount((int)std::min(size, (qsizetype)INT_MAX)))
+		for (qsizetype b = 0; b < blocks; ++b) {
+			const qsizetype start = b * _block_size;
+			const qsizetype count = std::min(_block_size, size - start);
+#ifdef VIP_COLOR_MAP_X86
+			if (l == AVX2) {
+				indexesAVX2(indexes + start, count, palette, num_colors, expand, expand_factor, out + start);
+				continue;
+			}
+#endif
+			for (qsizetype i = start; i < start + count; ++i)
+				out[i] = indexPixel(indexes[i], palette, num_colors, expand, expand_factor);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,85 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIP_COLOR_MAP_KERNELS_H
+#define VIP_COLOR_MAP_KERNELS_H
+
+#include "VipConfig.h"
+
+#include <QColor>
+
+/// \addtogroup Plotting
+/// @{
+
+class VipNDArray;
+
+/// @brief Vectorized kernels used by VipLinearColorMap::applyColorMap().
+///
+/// The kernels convert arrays of uint8, uint16, int16, int32, float and double
+/// into QRgb values using a VipLinearColorMap render palette. They produce exactly
+/// the same output as the generic vipEval() based implementation.
+///
+/// The instruction set is selected at runtime based on vipCPUFeatures().
+namespace VipColorMapKernels
+{
+	/// Instruction set used by the kernels
+	enum Level
+	{
+		Scalar, //! use the generic vipEval() implementation
+		SSE41,
+		AVX2
+	};
+
+	/// Returns the best instruction set supported by the CPU
+	VIP_PLOTTING_EXPORT Level supportedLevel();
+	/// Returns the instruction set currently used (default to supportedLevel())
+	VIP_PLOTTING_EXPORT Level level();
+	/// Set the instruction set to use. The level is clamped to supportedLevel().
+	/// This is mainly used for benchmarking.
+	VIP_PLOTTING_EXPORT void setLevel(Level);
+
+	/// Apply a linear color map to a dense array.
+	/// For each pixel value v, output the color palette[clamp((v - min_value) * factor + 2, 1, num_colors + 2)], or palette[0] for NaN values.
+	/// Returns false if the array type or layout is not supported by the kernels, or if level() is Scalar.
+	VIP_PLOTTING_EXPORT bool applyLinear(const VipNDArray& ar, double min_value, double factor, const QRgb* palette, int num_colors, QRgb* out);
+
+	/// Apply a palette to the histogram indexes computed by the flat histogram mode.
+	/// If expand is true, indexes in ]1, num_colors + 2[ are first remapped using (index - 2) * expand_factor + 2.5,
+	/// and other indexes greater or equal to num_colors produce a transparent color.
+	/// Returns false if level() is Scalar.
+	VIP_PLOTTING_EXPORT bool applyIndexes(const int* indexes, qsizetype size, const QRgb* palette, int num_colors, bool expand, double expand_factor, QRgb* out);
+}
+
+/// @}
+// end Plotting
+
+#endif
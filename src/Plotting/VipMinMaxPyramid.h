@@ -0,0 +1,189 @@
+/**
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2025, Institute for Magnetic Fusion Research - CEA/IRFM/GP3 Victor Moncada, Leo Dubus, Erwan Grelier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIP_MIN_MAX_PYRAMID_H
+#define VIP_MIN_MAX_PYRAMID_H
+
+#include <vector>
+
+#include "VipVectors.h"
+
+/// Min/max pyramid over the y values of a continuous VipPointVector.
+/// Level k stores, for each complete bucket of 8^(k+1) consecutive points, the index of the first
+/// minimum and first maximum y value. A range query combines the largest aligned buckets with the
+/// few remaining raw points on each side, and therefore runs in O(log N).
+/// The pyramid is extended incrementally when points are appended to the vector, and supports
+/// the removal of front points (sliding window) through popFront().
+/// Used by VipPlotCurve to render large continuous curves.
+struct VipMinMaxPyramid
+{
+	struct Node
+	{
+		qsizetype imin, imax;
+	};
+	// Nodes of a level. Node indexes are absolute: the node i is stored at nodes[head + i - first].
+	struct Level
+	{
+		std::vector<Node> nodes;
+		size_t head{ 0 };
+		qsizetype first{ 0 };
+
+		qsizetype size() const noexcept { return (qsizetype)(nodes.size() - head); }
+		qsizetype end() const noexcept { return first + size(); }
+		const Node& operator[](qsizetype i) const noexcept { return nodes[head + (i - first)]; }
+		void reset(qsizetype f)
+		{
+			nodes.clear();
+			head = 0;
+			first = f;
+		}
+		void dropBefore(qsizetype f)
+		{
+			if (f <= first)
+				return;
+			if (f >= end())
+				return reset(f);
+			head += f - first;
+			first = f;
+			if (head > nodes.size() / 2) {
+				nodes.erase(nodes.begin(), nodes.begin() + head);
+				head = 0;
+			}
+		}
+	};
+	std::vector<Level> levels;
+	// Point indexes are shifted by the number of points removed with popFront()
+	qsizetype shift{ 0 };
+	qsizetype count{ 0 };
+
+	void clear()
+	{
+		levels.clear();
+		shift = count = 0;
+	}
+
+	void merge(const VipPointVector& p, Node& n, qsizetype imin, qsizetype imax) const noexcept
+	{
+		// keep the first occurrence of the min/max values, whatever the merging order
+		const vip_double ymin = p[imin - shift].y(), cmin = p[n.imin - shift].y();
+		const vip_double ymax = p[imax - shift].y(), cmax = p[n.imax - shift].y();
+		if (ymin < cmin || (ymin == cmin && imin < n.imin))
+			n.imin = imin;
+		if (ymax > cmax || (ymax == cmax && imax < n.imax))
+			n.imax = imax;
+	}
+
+	void update(const VipPointVector& p)
+	{
+		if (shift + p.size() < count)
+			clear();
+		const qsizetype n = shift + p.size();
+		count = n;
+		if (levels.empty())
+			levels.emplace_back();
+
+		// level 0 is built from raw points. Buckets overlapping removed points are never built.
+		Level& l0 = levels[0];
+		const qsizetype start0 = (shift + 7) >> 3;
+		if (l0.end() < start0)
+			l0.reset(start0);
+		for (qsizetype b = l0.end() * 8; b + 8 <= n; b += 8) {
+			Node node{ b, b };
+			for (qsizetype i = b + 1; i < b + 8; ++i)
+				merge(p, node, i, i);
+			l0.nodes.push_back(node);
+		}
+		// upper levels are built from the previous one
+		for (size_t k = 0; levels[k].size() >= 8; ++k) {
+			if (k + 1 == levels.size())
+				levels.emplace_back();
+			const Level& src = levels[k];
+			Level& dst = levels[k + 1];
+			const qsizetype start = (src.first + 7) >> 3;
+			if (dst.end() < start)
+				dst.reset(start);
+			for (qsizetype b = dst.end() * 8; b + 8 <= src.end(); b += 8) {
+				Node node = src[b];
+				for (qsizetype i = b + 1; i < b + 8; ++i)
+					merge(p, node, src[i].imin, src[i].imax);
+				dst.nodes.push_back(node);
+			}
+		}
+	}
+
+	/// Tells that n points were removed from the front of the vector
+	void popFront(qsizetype n)
+	{
+		shift += n;
+		qsizetype first = shift;
+		for (size_t k = 0; k < levels.size(); ++k) {
+			first = (first + 7) >> 3;
+			levels[k].dropBefore(first);
+		}
+	}
+
+	/// Returns the indexes (relative to the vector start) of the first min and max y values in [begin, end).
+	/// end must be lower or equal to the number of points given to update().
+	Node query(const VipPointVector& p, qsizetype begin, qsizetype end) const
+	{
+		qsizetype lo = begin + shift, hi = end + shift;
+		Node res{ lo, lo };
+		for (; lo < hi && (lo & 7); ++lo)
+			merge(p, res, lo, lo);
+		while (hi > lo && (hi & 7)) {
+			--hi;
+			merge(p, res, hi, hi);
+		}
+		lo >>= 3;
+		hi >>= 3;
+		for (size_t k = 0; lo < hi; ++k) {
+			const Level& l = levels[k];
+			if (k + 1 == levels.size()) {
+				for (; lo < hi; ++lo)
+					merge(p, res, l[lo].imin, l[lo].imax);
+				break;
+			}
+			for (; lo < hi && (lo & 7); ++lo)
+				merge(p, res, l[lo].imin, l[lo].imax);
+			while (hi > lo && (hi & 7)) {
+				--hi;
+				merge(p, res, l[hi].imin, l[hi].imax);
+			}
+			lo >>= 3;
+			hi >>= 3;
+		}
+		res.imin -= shift;
+		res.imax -= shift;
+		return res;
+	}
+};
+
+#endif
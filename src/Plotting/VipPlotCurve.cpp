@@ -31,6 +31,7 @@
 
 #include "VipPlotCurve.h"
 #include "VipAbstractScale.h"
+#include "VipMinMaxPyramid.h"
 #include "VipPainter.h"
 #include "VipScaleEngine.h"
 #include "VipShapeDevice.h"
@@ -45,6 +46,9 @@
 #include <qpainter.h>
 #include <qpixmap.h>
 
+#include <deque>
+#include <vector>
+
 template<class Point, class Double>
 struct PointMerge
 {
@@ -124,6 +128,75 @@ struct PointMerge
 	}
 };
 
+// Minimum number of points of a continuous vector to use a VipMinMaxPyramid for rendering
+#define VIP_CURVE_PYRAMID_THRESHOLD 65536
+
+/// Incremental state of the NaN split and bounding box computed by VipPlotCurve::dataBoundingRect().
+/// Used by VipPlotCurve::addSamples() and VipPlotCurve::removeFirstSamples() to update the curve
+/// from the new (or removed) points only.
+struct CurveStreamState
+{
+	bool valid{ false };	 // the state matches the current curve data
+	bool open{ false };	 // the last raw point is valid: the last sub vector can be extended
+	bool sub_cont{ true };	 // running continuity flag of the last sub vector
+	bool links{ true };	 // each sub vector starts after the end of the previous one
+	bool has_bounds{ false };
+	vip_double last_x{ 0 };	 // x value of the last raw point
+	vip_double bounds[4]{ 0, 0, 0, 0 }; // x min, x max, y min, y max
+	qsizetype base{ 0 };	 // number of raw points removed from the front
+	qsizetype count{ 0 };	 // number of raw points
+	std::deque<qsizetype> starts; // raw index (including base) of each sub vector first point
+	// Sliding window state, only built on the first front removal.
+	// Monotonic queues of (raw index, value) track the x and y bounds of the valid points,
+	// and descents stores the raw indexes i for which x[i] < x[i-1].
+	bool window{ false };
+	std::deque<std::pair<qsizetype, vip_double>> xmin, xmax, ymin, ymax;
+	std::deque<qsizetype> descents;
+
+	static void pushQueues(std::deque<std::pair<qsizetype, vip_double>>& qmin, std::deque<std::pair<qsizetype, vip_double>>& qmax, qsizetype index, vip_double v)
+	{
+		while (qmin.size() && qmin.back().second >= v)
+			qmin.pop_back();
+		qmin.emplace_back(index, v);
+		while (qmax.size() && qmax.back().second <= v)
+			qmax.pop_back();
+		qmax.emplace_back(index, v);
+	}
+	static void popQueue(std::deque<std::pair<qsizetype, vip_double>>& q, qsizetype base)
+	{
+		while (q.front().first < base)
+			q.pop_front();
+	}
+	void pushWindow(qsizetype index, const VipPoint& pt)
+	{
+		pushQueues(xmin, xmax, index, pt.x());
+		pushQueues(ymin, ymax, index, pt.y());
+	}
+	void clearWindow()
+	{
+		xmin.clear();
+		xmax.clear();
+		ymin.clear();
+		ymax.clear();
+		descents.clear();
+		window = false;
+	}
+	void addBounds(const VipPoint& pt)
+	{
+		if (!has_bounds) {
+			bounds[0] = bounds[1] = pt.x();
+			bounds[2] = bounds[3] = pt.y();
+			has_bounds = true;
+		}
+		else {
+			bounds[0] = std::min(bounds[0], (vip_double)pt.x());
+			bounds[1] = std::max(bounds[1], (vip_double)pt.x());
+			bounds[2] = std::min(bounds[2], (vip_double)pt.y());
+			bounds[3] = std::max(bounds[3], (vip_double)pt.y());
+		}
+	}
+};
+
 static bool isPerfectRightCartesiant(QPainter* painter, const VipCoordinateSystemPtr& m)
 {
 	if (!m)
@@ -407,8 +480,231 @@ public:
 	// QList<VipInterval> bounding;
 	VipInterval bounding[2];
 	QList<VipPointVector> vectors;
+	std::vector<VipMinMaxPyramid> pyramids;
 	PointMerge<QPointF, double> merge;
 
+	// Returns the (up to date) pyramid associated to given vector, which must belong to vectors
+	const VipMinMaxPyramid* pyramid(const VipPointVector& points)
+	{
+		for (int i = 0; i < vectors.size(); ++i) {
+			if (&vectors.at(i) == &points) {
+				if (pyramids.size() != (size_t)vectors.size())
+					pyramids.assign(vectors.size(), VipMinMaxPyramid());
+				pyramids[i].update(points);
+				return &pyramids[i];
+			}
+		}
+		return nullptr;
+	}
+
+	// Incremental NaN split and bounding box, see addSamples() and removeFirstSamples()
+	CurveStreamState stream;
+
+	static bool isValidSample(const VipPoint& pt) { return !vipIsNan(pt.x()) && !vipIsNan(pt.y()) && std::isfinite(pt.y()); }
+
+	// Append points to the raw vector and to the sub vectors
+	void appendSamples(VipPointVector& raw, const VipPoint* pts, int numPoints)
+	{
+		if (numPoints <= 0)
+			return;
+
+		CurveStreamState& s = stream;
+		if (s.count == 0) {
+			// restart from an empty curve, like dataBoundingRect() does
+			vectors.clear();
+			continuous.clear();
+			pyramids.clear();
+			s = CurveStreamState();
+			s.valid = true;
+			s.last_x = pts[0].x();
+			sub_continuous = true;
+		}
+
+		// The raw vector and the only sub vector share the same buffer when there is no invalid point.
+		// Release the raw one to extend the sub vector in place, and share it again afterward.
+		bool all_valid = true;
+		for (int i = 0; i < numPoints && all_valid; ++i)
+			all_valid = isValidSample(pts[i]);
+		const bool shared = all_valid && vectors.size() == 1 && s.starts.front() == s.base && vectors.first().size() == raw.size();
+		if (shared)
+			raw = VipPointVector();
+
+		for (int i = 0; i < numPoints; ++i) {
+			const VipPoint& pt = pts[i];
+			if (!isValidSample(pt)) {
+				if (s.open) {
+					// close the last sub vector
+					continuous.last() = s.sub_cont;
+					sub_continuous = sub_continuous && s.sub_cont;
+					s.sub_cont = true;
+					s.open = false;
+				}
+			}
+			else {
+				if (!s.open) {
+					// start a new sub vector
+					if (vectors.size() && pt.x() < vectors.last().last().x())
+						s.links = false;
+					vectors.append(VipPointVector());
+					continuous.append(true);
+					s.starts.push_back(s.base + s.count);
+					if (pyramids.size())
+						pyramids.emplace_back();
+					s.open = true;
+				}
+				vectors.last().push_back(pt);
+				s.addBounds(pt);
+				if (s.window)
+					s.pushWindow(s.base + s.count, pt);
+			}
+			if (pt.x() < s.last_x) {
+				s.sub_cont = false;
+				if (s.window)
+					s.descents.push_back(s.base + s.count);
+			}
+			s.last_x = pt.x();
+			if (!shared)
+				raw.push_back(pt);
+			++s.count;
+		}
+
+		if (s.open) {
+			continuous.last() = s.sub_cont;
+			sub_continuous = sub_continuous && s.sub_cont;
+		}
+		full_continuous = sub_continuous && s.links;
+		if (shared)
+			raw = vectors.first();
+		updateBounds();
+	}
+
+	// Remove the count first raw points.
+	// VipPointVector is a circular buffer: dropping front points only moves its start index.
+	// Together with the sliding window queues, the cost is amortized O(count) instead of O(raw.size()).
+	void removeFrontSamples(VipPointVector& raw, qsizetype count)
+	{
+		CurveStreamState& s = stream;
+		if (count <= 0)
+			return;
+		if (count >= s.count) {
+			raw = VipPointVector();
+			vectors.clear();
+			continuous.clear();
+			pyramids.clear();
+			s = CurveStreamState();
+			s.valid = true;
+			full_continuous = sub_continuous = false;
+			bounding[0] = bounding[1] = VipInterval();
+			return;
+		}
+
+		if (!s.window) {
+			// first removal: build the sliding window state
+			s.clearWindow();
+			for (int i = 0; i < vectors.size(); ++i) {
+				const VipPointVector& v = vectors[i];
+				const qsizetype start = s.starts[i];
+				for (qsizetype j = 0; j < v.size(); ++j)
+					s.pushWindow(start + j, v[j]);
+			}
+			for (qsizetype i = 1; i < raw.size(); ++i)
+				if (raw[i].x() < raw[i - 1].x())
+					s.descents.push_back(s.base + i);
+			s.window = true;
+		}
+
+		const bool shared = vectors.size() == 1 && s.starts.front() == s.base && vectors.first().size() == raw.size();
+		if (shared)
+			raw = VipPointVector();
+		else
+			raw.resize_front(raw.size() - count);
+
+		const qsizetype base = s.base + count;
+
+		// remove the sub vectors that are entirely before the new start
+		int drop = 0;
+		while (drop < vectors.size() && s.starts[drop] + vectors[drop].size() <= base)
+			++drop;
+		if (drop) {
+			vectors.erase(vectors.begin(), vectors.begin() + drop);
+			continuous.erase(continuous.begin(), continuous.begin() + drop);
+			s.starts.erase(s.starts.begin(), s.starts.begin() + drop);
+			if (pyramids.size() >= (size_t)drop)
+				pyramids.erase(pyramids.begin(), pyramids.begin() + drop);
+		}
+		// trim the first sub vector
+		if (vectors.size() && s.starts.front() < base) {
+			const qsizetype trim = base - s.starts.front();
+			vectors.first().resize_front(vectors.first().size() - trim);
+			s.starts.front() = base;
+			if (pyramids.size() == (size_t)vectors.size())
+				pyramids.front().popFront(trim);
+		}
+		if (vectors.isEmpty())
+			s.open = false;
+		s.base = base;
+		s.count -= count;
+		if (shared)
+			raw = vectors.first();
+
+		// The continuity of the first sub vector also depends on the raw points preceding it,
+		// and the non ascending part might have been removed.
+		// A descent at raw index i compares the points i-1 and i, it only matters if both are still in the window.
+		while (s.descents.size() && s.descents.front() <= base)
+			s.descents.pop_front();
+		auto ascending = [&s, base](qsizetype end) { return s.descents.empty() || s.descents.front() >= base + end; };
+		if (vectors.isEmpty()) {
+			if (!s.sub_cont)
+				s.sub_cont = ascending(raw.size());
+		}
+		else if (!continuous.first()) {
+			continuous.first() = ascending(s.starts.front() - base + vectors.first().size());
+			if (s.open && vectors.size() == 1)
+				s.sub_cont = continuous.first();
+		}
+
+		// update flags from the remaining sub vectors
+		sub_continuous = true;
+		for (int i = 0; i < continuous.size(); ++i)
+			sub_continuous = sub_continuous && continuous[i];
+		s.links = true;
+		for (int i = 1; i < vectors.size() && s.links; ++i)
+			s.links = !(vectors[i].first().x() < vectors[i - 1].last().x());
+		full_continuous = sub_continuous && s.links;
+
+		// update bounds from the sliding window queues
+		s.has_bounds = vectors.size() > 0;
+		if (!s.has_bounds) {
+			s.xmin.clear();
+			s.xmax.clear();
+			s.ymin.clear();
+			s.ymax.clear();
+		}
+		else {
+			CurveStreamState::popQueue(s.xmin, base);
+			CurveStreamState::popQueue(s.xmax, base);
+			CurveStreamState::popQueue(s.ymin, base);
+			CurveStreamState::popQueue(s.ymax, base);
+			s.bounds[0] = s.xmin.front().second;
+			s.bounds[1] = s.xmax.front().second;
+			s.bounds[2] = s.ymin.front().second;
+			s.bounds[3] = s.ymax.front().second;
+		}
+		updateBounds();
+	}
+
+	void updateBounds()
+	{
+		if (stream.has_bounds) {
+			bounding[0] = VipInterval(stream.bounds[0], stream.bounds[1]);
+			bounding[1] = VipInterval(stream.bounds[2], stream.bounds[3]);
+		}
+		else {
+			bounding[0] = VipInterval(0, 0);
+			bounding[1] = VipInterval(0, 0);
+		}
+	}
+
 	VipPlotCurve::CurveAttributes attributes;
 	VipPlotCurve::LegendAttributes legendAttributes;
 
@@ -897,6 +1193,8 @@ void VipPlotCurve::draw(QPainter* painter, const VipCoordinateSystemPtr& m) cons
 				x += step;
 			}
 			d_data->vectors = QList<VipPointVector>() << vec;
+			d_data->pyramids.clear();
+			d_data->stream.valid = false;
 			d_data->continuous = QList<bool>() << true;
 			d_data->drawn_pcount = point_count;
 			d_data->drawn_interval = x_inter;
@@ -1043,6 +1341,82 @@ void VipPlotCurve::drawSelected(QPainter* painter, const VipCoordinateSystemPtr&
 	this->draw(painter, m);
 }
 
+// Lines/Steps simplification of a large continuous vector using its min/max pyramid.
+// Only the visible x range is considered, and each pixel column is reduced to its first, min, max and last points,
+// exactly like PointMerge does. The cost is O(pixels * log(N)) instead of O(N).
+static QPolygonF computeSimplifiedPyramid(const VipCoordinateSystemPtr& m,
+					  const VipPointVector& points,
+					  const VipMinMaxPyramid& pyr,
+					  PointMerge<QPointF, double>& merge)
+{
+	const VipInterval x_inter = m->axes().first()->scaleDiv().bounds().normalized();
+	const qsizetype size = points.size();
+
+	// first point >= x min, and first point > x max
+	qsizetype lo = 0, hi = size;
+	while (lo < hi) {
+		qsizetype mid = lo + (hi - lo) / 2;
+		if (points[mid].x() < x_inter.minValue())
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	qsizetype begin = lo;
+	hi = size;
+	while (lo < hi) {
+		qsizetype mid = lo + (hi - lo) / 2;
+		if (points[mid].x() <= x_inter.maxValue())
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	// keep one point on each side of the visible range
+	begin = std::max(begin - 1, (qsizetype)0);
+	const qsizetype end = std::min(lo + 1, size);
+
+	merge.vector.clear();
+	qsizetype i = begin;
+	while (i < end) {
+		const QPointF first = m->transform(points[i]);
+		const int col = qRound(first.x());
+
+		// find the end of the pixel column using an exponential search followed by a binary search
+		qsizetype step = 1, in = i, out = i + 1;
+		while (out < end && qRound(m->transform(points[out]).x()) == col) {
+			in = out;
+			step *= 2;
+			out = std::min(i + step, end);
+		}
+		while (out - in > 1) {
+			qsizetype mid = in + (out - in) / 2;
+			if (qRound(m->transform(points[mid]).x()) == col)
+				in = mid;
+			else
+				out = mid;
+		}
+
+		if (out - i <= 4) {
+			merge.vector.append(first);
+			for (qsizetype j = i + 1; j < out; ++j)
+				merge.vector.append(m->transform(points[j]));
+		}
+		else {
+			const VipMinMaxPyramid::Node n = pyr.query(points, i, out);
+			const QPointF last = m->transform(points[out - 1]);
+			const QPointF inter1 = m->transform(points[std::min(n.imin, n.imax)]);
+			const QPointF inter2 = m->transform(points[std::max(n.imin, n.imax)]);
+			merge.vector.append(first);
+			if (inter1.y() != first.y())
+				merge.vector.append(inter1);
+			if (inter2.y() != last.y())
+				merge.vector.append(inter2);
+			merge.vector.append(last);
+		}
+		i = out;
+	}
+	return merge.vector;
+}
+
 QPolygonF VipPlotCurve::computeSimplified(QPainter* painter, const VipCoordinateSystemPtr& m, const VipPointVector& points, bool continuous) const
 {
 	if (VipPainter::isVectoriel(painter))
@@ -1112,6 +1486,11 @@ QPolygonF VipPlotCurve::computeSimplified(QPainter* painter, const VipCoordinate
 	else if (style() == Lines || style() == Steps) {
 		// Lines and Steps: points merging
 
+		if (cartesian && continuous && points.size() > VIP_CURVE_PYRAMID_THRESHOLD) {
+			if (const VipMinMaxPyramid* pyr = d_data->pyramid(points))
+				return computeSimplifiedPyramid(m, points, *pyr, d_data->merge);
+		}
+
 		if (cartesian && continuous && points.size() && points.size() > 500) {
 			VipInterval x_inter = m->axes().first()->scaleDiv().bounds().normalized();
 			VipInterval y_inter = m->axes().last()->scaleDiv().bounds().normalized();
@@ -2218,21 +2597,27 @@ inline static bool isPointInside(const QPainterPath& shape, const QRectF& boundi
 	}
 }
 
-QList<VipInterval> VipPlotCurve::dataBoundingRect(const VipPointVector& samples,
-						  QList<VipPointVector>& out_vectors,
-						  QList<bool>& continuous,
-						  bool& full_continuous,
-						  bool& sub_continuous,
-						  const QPainterPath& shape,
-						  int shape_coord)
+static QList<VipInterval> splitSamples(const VipPointVector& samples,
+				       QList<VipPointVector>& out_vectors,
+				       QList<bool>& continuous,
+				       bool& full_continuous,
+				       bool& sub_continuous,
+				       const QPainterPath& shape,
+				       int shape_coord,
+				       CurveStreamState* state)
 {
 	// qint64 st = QDateTime::currentMSecsSinceEpoch();
 	full_continuous = sub_continuous = false;
 	continuous.clear();
 	QList<VipPointVector> vectors;
 
+	if (state)
+		*state = CurveStreamState();
+
 	if (!samples.size()) {
 		out_vectors.clear();
+		if (state)
+			state->valid = shape.isEmpty();
 		return QList<VipInterval>();
 	}
 
@@ -2254,6 +2639,8 @@ QList<VipInterval> VipPlotCurve::dataBoundingRect(const VipPointVector& samples,
 				continuous.append(sub_cont);
 				sub_continuous = sub_continuous && sub_cont;
 				sub_cont = true;
+				if (state)
+					state->starts.push_back(start + 1);
 			}
 
 			start = i;
@@ -2289,20 +2676,39 @@ QList<VipInterval> VipPlotCurve::dataBoundingRect(const VipPointVector& samples,
 			vectors.append(input.mid(start + 1, len));
 			continuous.append(sub_cont);
 			sub_continuous = sub_cont && sub_continuous;
+			if (state)
+				state->starts.push_back(start + 1);
 		}
 	}
 
 	// compute full_continous
-	if (sub_continuous) {
-		full_continuous = true;
+	bool links = true;
+	if (sub_continuous || state) {
 		const QList<VipPointVector>& vecs = vectors;
 		for (int i = 1; i < vecs.size(); ++i) {
 			if (vecs[i].first().x() < vecs[i - 1].last().x()) {
-				full_continuous = false;
+				links = false;
 				break;
 			}
 		}
 	}
+	full_continuous = sub_continuous && links;
+
+	if (state) {
+		state->valid = shape.isEmpty();
+		state->open = start < input.size() - 1;
+		state->sub_cont = sub_cont;
+		state->links = links;
+		state->last_x = start_x;
+		state->count = input.size();
+		if (!first) {
+			state->has_bounds = true;
+			state->bounds[0] = topleft.x();
+			state->bounds[1] = bottomright.x();
+			state->bounds[2] = topleft.y();
+			state->bounds[3] = bottomright.y();
+		}
+	}
 
 	// qint64 el = QDateTime::currentMSecsSinceEpoch() - st;
 	// vip_debug("dataBoundingRect: %i ms\n", (int)el);
@@ -2315,20 +2721,84 @@ QList<VipInterval> VipPlotCurve::dataBoundingRect(const VipPointVector& samples,
 	return QList<VipInterval>() << VipInterval(topleft.x(), bottomright.x()) << VipInterval(topleft.y(), bottomright.y());
 }
 
-void VipPlotCurve::addSamples(const VipPoint* pts, int numPoints)
+QList<VipInterval> VipPlotCurve::dataBoundingRect(const VipPointVector& samples,
+						  QList<VipPointVector>& out_vectors,
+						  QList<bool>& continuous,
+						  bool& full_continuous,
+						  bool& sub_continuous,
+						  const QPainterPath& shape,
+						  int shape_coord)
+{
+	return splitSamples(samples, out_vectors, continuous, full_continuous, sub_continuous, shape, shape_coord, nullptr);
+}
+
+void VipPlotCurve::addSamples(const VipPoint* pts, int numPoints, qsizetype maxSamples)
 {
-	updateSamples([&](VipPointVector& v) {
-		for (int i = 0; i < numPoints; ++i)
-			v.push_back(pts[i]);
-	});
+	dataLock()->lock();
+	VipPointVector raw;
+	bool incremental = d_data->stream.valid && !d_data->function;
+	if (incremental) {
+		raw = takeData().value<VipPointVector>();
+		if (raw.size() != d_data->stream.count) {
+			// data modified concurrently: revert to full update
+			setInternalData(QVariant::fromValue(raw));
+			incremental = false;
+		}
+	}
+	if (!incremental) {
+		dataLock()->unlock();
+		updateSamples([&](VipPointVector& v) {
+			for (int i = 0; i < numPoints; ++i)
+				v.push_back(pts[i]);
+			if (maxSamples >= 0 && v.size() > maxSamples)
+				v.erase(0, v.size() - maxSamples);
+		});
+		return;
+	}
+
+	d_data->appendSamples(raw, pts, numPoints);
+	if (maxSamples >= 0 && raw.size() > maxSamples)
+		d_data->removeFrontSamples(raw, raw.size() - maxSamples);
+	dataLock()->unlock();
+
+	// bypass VipPlotCurve::setData() as the sub vectors and bounds are already up to date
+	VipPlotItemData::setData(QVariant::fromValue(raw));
+}
+
+void VipPlotCurve::removeFirstSamples(qsizetype count)
+{
+	if (count <= 0)
+		return;
+
+	dataLock()->lock();
+	VipPointVector raw;
+	bool incremental = d_data->stream.valid && !d_data->function;
+	if (incremental) {
+		raw = takeData().value<VipPointVector>();
+		if (raw.size() != d_data->stream.count) {
+			setInternalData(QVariant::fromValue(raw));
+			incremental = false;
+		}
+	}
+	if (!incremental) {
+		dataLock()->unlock();
+		updateSamples([count](VipPointVector& v) { v.erase(0, std::min(count, v.size())); });
+		return;
+	}
+
+	d_data->removeFrontSamples(raw, count);
+	dataLock()->unlock();
+	VipPlotItemData::setData(QVariant::fromValue(raw));
 }
 
 void VipPlotCurve::dataBoundingRect(const VipPointVector& samples)
 {
 	dataLock()->lock();
 	d_data->merge.vector.reserve(samples.size());
+	d_data->pyramids.clear();
 
-	QList<VipInterval> bounds = dataBoundingRect(samples, d_data->vectors, d_data->continuous, d_data->full_continuous, d_data->sub_continuous);
+	QList<VipInterval> bounds =
+	  splitSamples(samples, d_data->vectors, d_data->continuous, d_data->full_continuous, d_data->sub_continuous, QPainterPath(), 0, &d_data->stream);
 	if (bounds.size() == 2) {
 		d_data->bounding[0] = bounds[0];
 		d_data->bounding[1] = bounds[1];
@@ -283,9 +283,15 @@ public:
 	/// Use VipPlotCurve::setRawData() to directly set a VipPointVector object.
 	virtual void setData(const QVariant&);
 
-	void addSample(const VipPoint& pt) { addSamples(&pt, 1); }
+	/// @brief Append samples to the curve.
+	/// The sub vectors, continuity flags and bounding intervals are updated from the new points only,
+	/// instead of rescanning the full curve data.
+	/// If maxSamples is positive, the oldest samples are removed to keep at most maxSamples points (sliding window).
+	void addSample(const VipPoint& pt, qsizetype maxSamples = -1) { addSamples(&pt, 1, maxSamples); }
 	//void addSamples(const VipPointVector& pts) { addSamples(pts.data(), pts.size()); }
-	void addSamples(const VipPoint* pts, int numPoints);
+	void addSamples(const VipPoint* pts, int numPoints, qsizetype maxSamples = -1);
+	/// @brief Remove the count first samples of the curve, without rescanning the remaining ones.
+	void removeFirstSamples(qsizetype count);
 
 	template<class F>
 	void updateSamples(F&& fun);
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <iostream>
+
+#include <qcoreapplication.h>
+#include <qdatetime.h>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+
+#include "VipIODevice.h"
+#include "VipNDArray.h"
+
+#ifdef VIP_WITH_HDF5
+
+/// Check the frame index sidecar file of .arch archives.
+/// A legacy archive (without index file) is opened twice with VipArchiveReader: the first opening must write
+/// the index, and the second one must reuse it without rewriting it. Frames must be read back unchanged.
+/// Return a non zero value if a check fails.
+
+static const int frames = 20;
+static bool failed = false;
+
+static void check(const std::string& name, bool ok)
+{
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+static VipNDArray createFrame(int frame)
+{
+	VipNDArrayType<int> ar(vipVector(8, 8));
+	for (int i = 0; i < ar.size(); ++i)
+		ar.ptr()[i] = frame * 100 + i;
+	return ar;
+}
+
+static bool createArchive(const QString& filename)
+{
+	VipArchiveRecorder recorder;
+	recorder.setPath(filename);
+	recorder.topLevelInputAt(0)->toMultiInput()->resize(1);
+	if (!recorder.open(VipIODevice::WriteOnly))
+		return false;
+	for (int i = 0; i < frames; ++i) {
+		recorder.inputAt(0)->setData(VipAnyData(QVariant::fromValue(createFrame(i)), i * 1000));
+		recorder.update();
+	}
+	recorder.close();
+	return true;
+}
+
+/// Open the archive and check its content
+static bool readArchive(const QString& filename, bool write_index)
+{
+	VipArchiveReader reader;
+	reader.setWriteFrameIndex(write_index);
+	reader.setPath(filename);
+	if (!reader.open(VipIODevice::ReadOnly) || reader.size() != frames)
+		return false;
+	for (int i = 0; i < frames; ++i) {
+		if (!reader.read(i * 1000, true))
+			return false;
+		const VipNDArrayType<int> ar = reader.outputAt(0)->value<VipNDArray>();
+		const VipNDArrayType<int> ref = createFrame(i);
+		if (reader.outputAt(0)->time() != i * 1000 || ar.shape() != ref.shape() || !std::equal(ref.ptr(), ref.ptr() + ref.size(), ar.ptr()))
+			return false;
+	}
+	reader.close();
+	return true;
+}
+
+static QDateTime indexModificationTime(const QString& index)
+{
+	return QFileInfo(index).lastModified();
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	const QString filename = QDir::tempPath() + "/ArchiveIndexTest.arch";
+	const QString index = filename + ".idx";
+	if (!createArchive(filename)) {
+		std::cout << "Unable to create " << filename.toLatin1().data() << std::endl;
+		return -1;
+	}
+	check("recorder writes the index", QFileInfo::exists(index));
+
+	// legacy archive: no index file
+	QFile::remove(index);
+	check("no index with setWriteFrameIndex(false)", readArchive(filename, false) && !QFileInfo::exists(index));
+
+	check("first opening of a legacy archive", readArchive(filename, true));
+	check("first opening writes the index", QFileInfo::exists(index));
+
+	// set an old modification time: the index must not be rewritten by the next opening
+	const QDateTime old_time(QDate(2001, 1, 1), QTime(0, 0));
+	{
+		QFile file(index);
+		check("set index modification time", file.open(QFile::ReadWrite) && file.setFileTime(old_time, QFileDevice::FileModificationTime));
+	}
+	const QByteArray content = [&]() {
+		QFile file(index);
+		return file.open(QFile::ReadOnly) ? file.readAll() : QByteArray();
+	}();
+
+	check("second opening", readArchive(filename, true));
+	check("second opening reuses the index", indexModificationTime(index) == old_time);
+	QFile file(index);
+	check("index unchanged", file.open(QFile::ReadOnly) && file.readAll() == content && !content.isEmpty());
+	file.close();
+
+	QFile::remove(filename);
+	QFile::remove(index);
+	std::cout << (failed ? "Some archive index checks FAILED" : "All archive index checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
+
+#else
+
+int main(int, char**)
+{
+	std::cout << "HDF5 support is not enabled" << std::endl;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <qbuffer.h>
+#include <qcoreapplication.h>
+#include <qdatastream.h>
+#include <qelapsedtimer.h>
+
+#include "VipArchive.h"
+#include "VipNDArray.h"
+
+/// Microbenchmark of VipNDArray serialization.
+/// For each pixel type, print the write and read throughput in MB/s of the legacy per element QDataStream format,
+/// of the raw memory block format and of a VipBinaryArchive (which uses the raw format), for a stream of 640x512 frames.
+/// Return a non zero value if a read array differs from the written one.
+
+static bool mismatch = false;
+
+template<class T>
+static VipNDArray createImage(qsizetype w, qsizetype h, int frame)
+{
+	VipNDArrayType<T> ar(vipVector(h, w));
+	for (qsizetype y = 0; y < h; ++y)
+		for (qsizetype x = 0; x < w; ++x)
+			ar(y, x) = (T)(60 * (std::cos(x * 0.01 + frame) + std::sin(y * 0.02) + 2));
+	return ar;
+}
+
+/// Write an array using the legacy per element format
+static void writeLegacy(QDataStream& stream, const VipNDArray& ar)
+{
+	stream << ar.handle()->handleType();
+	stream << ar.dataType();
+	stream << ar.shape();
+	ar.handle()->ostream(VipNDArrayShape(ar.shapeCount(), 0), ar.shape(), stream);
+}
+
+static bool sameArrays(const VipNDArray& a, const VipNDArray& b)
+{
+	return a.dataType() == b.dataType() && a.shape() == b.shape() && memcmp(a.constData(), b.constData(), a.size() * a.dataSize()) == 0;
+}
+
+static double throughput(qint64 bytes, qint64 ns)
+{
+	return (bytes / (1024. * 1024.)) / (ns * 1e-9);
+}
+
+template<class T>
+static void benchmarkType(const char* name, int frames)
+{
+	QVector<VipNDArray> arrays;
+	for (int i = 0; i < frames; ++i)
+		arrays.append(createImage<T>(640, 512, i));
+	const qint64 bytes = (qint64)arrays.first().size() * arrays.first().dataSize() * frames;
+
+	QElapsedTimer timer;
+	std::cout << name << ":";
+
+	for (int legacy = 1; legacy >= 0; --legacy) {
+		QByteArray content;
+		{
+			QDataStream stream(&content, QIODevice::WriteOnly);
+			stream.setByteOrder(QDataStream::LittleEndian);
+			timer.start();
+			for (const VipNDArray& ar : arrays) {
+				if (legacy)
+					writeLegacy(stream, ar);
+				else
+					stream << ar;
+			}
+		}
+		const double write_speed = throughput(bytes, timer.nsecsElapsed());
+
+		QDataStream stream(content);
+		stream.setByteOrder(QDataStream::LittleEndian);
+		bool same = true;
+		timer.restart();
+		for (const VipNDArray& ar : arrays) {
+			VipNDArray tmp;
+			stream >> tmp;
+			same = same && sameArrays(ar, tmp);
+		}
+		const double read_speed = throughput(bytes, timer.nsecsElapsed());
+		if (!same)
+			mismatch = true;
+		std::cout << (legacy ? " legacy" : ", raw") << " write " << write_speed << " MB/s, read " << read_speed << " MB/s" << (same ? "" : " (MISMATCH)");
+	}
+
+	QByteArray content;
+	{
+		VipBinaryArchive arch(&content, QIODevice::WriteOnly);
+		timer.restart();
+		for (const VipNDArray& ar : arrays)
+			arch.content("frame", ar);
+	}
+	const double write_speed = throughput(bytes, timer.nsecsElapsed());
+
+	VipBinaryArchive arch(content);
+	bool same = true;
+	timer.restart();
+	for (const VipNDArray& ar : arrays)
+		same = same && sameArrays(ar, arch.read("frame").value<VipNDArray>());
+	const double read_speed = throughput(bytes, timer.nsecsElapsed());
+	if (!same)
+		mismatch = true;
+	std::cout << ", archive write " << write_speed << " MB/s, read " << read_speed << " MB/s" << (same ? "" : " (MISMATCH)") << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	const int frames = 200;
+	benchmarkType<quint16>("uint16", frames);
+	benchmarkType<float>("float", frames);
+	benchmarkType<double>("double", frames);
+	benchmarkType<complex_f>("complex_f", frames);
+	return mismatch ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <qcoreapplication.h>
+#include <qelapsedtimer.h>
+
+#include "VipColorMap.h"
+#include "VipColorMapKernels.h"
+#include "VipNDArray.h"
+
+/// Microbenchmark of VipLinearColorMap::applyColorMap().
+/// For each supported input type, print the throughput in Mpixels/s of the generic implementation
+/// and of each vectorized kernel supported by the CPU, in both linear and flat histogram modes.
+/// Return a non zero value if a vectorized kernel output differs from the scalar one.
+
+static bool mismatch = false;
+
+static const char* levelName(VipColorMapKernels::Level level)
+{
+	switch (level) {
+		case VipColorMapKernels::Scalar:
+			return "scalar";
+		case VipColorMapKernels::SSE41:
+			return "sse4.1";
+		case VipColorMapKernels::AVX2:
+			return "avx2";
+	}
+	return "";
+}
+
+template<class T>
+static VipNDArray createImage(qsizetype w, qsizetype h)
+{
+	VipNDArrayType<T> ar(vipVector(h, w));
+	for (qsizetype y = 0; y < h; ++y)
+		for (qsizetype x = 0; x < w; ++x)
+			ar(y, x) = (T)(60 * (std::cos(x * 0.01) + std::sin(y * 0.02) + 2));
+	return ar;
+}
+
+static double benchmark(VipLinearColorMap* map, const VipNDArray& ar, const VipInterval& interval, std::vector<QRgb>& out, int repeat)
+{
+	// warm up: compute render colors and histogram
+	map->applyColorMap(interval, ar, out.data());
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < repeat; ++i)
+		map->applyColorMap(interval, ar, out.data());
+	qint64 ns = timer.nsecsElapsed();
+	return (ar.size() * (double)repeat) / (ns * 1e-3);
+}
+
+template<class T>
+static void benchmarkType(VipLinearColorMap* map, const char* name, int repeat)
+{
+	const VipNDArray ar = createImage<T>(2048, 2048);
+	const VipInterval interval(20, 220);
+	std::vector<QRgb> out(ar.size());
+	std::vector<QRgb> ref(ar.size());
+
+	for (int flat = 0; flat < 2; ++flat) {
+		map->setUseFlatHistogram(flat);
+
+		VipColorMapKernels::setLevel(VipColorMapKernels::Scalar);
+		double scalar = benchmark(map, ar, interval, ref, repeat);
+		std::cout << name << (flat ? " (flat histogram)" : " (linear)") << ": " << levelName(VipColorMapKernels::Scalar) << " " << scalar << " Mpixels/s";
+
+		for (int l = VipColorMapKernels::SSE41; l <= VipColorMapKernels::supportedLevel(); ++l) {
+			VipColorMapKernels::setLevel((VipColorMapKernels::Level)l);
+			double speed = benchmark(map, ar, interval, out, repeat);
+			bool same = out == ref;
+			if (!same)
+				mismatch = true;
+			std::cout << ", " << levelName((VipColorMapKernels::Level)l) << " " << speed << " Mpixels/s" << (same ? "" : " (MISMATCH)");
+		}
+		std::cout << std::endl;
+	}
+	VipColorMapKernels::setLevel(VipColorMapKernels::supportedLevel());
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	VipLinearColorMap* map = VipLinearColorMap::createColorMap(VipLinearColorMap::Jet);
+	const int repeat = 20;
+
+	std::cout << "Supported level: " << levelName(VipColorMapKernels::supportedLevel()) << std::endl;
+	benchmarkType<quint8>(map, "uint8", repeat);
+	benchmarkType<quint16>(map, "uint16", repeat);
+	benchmarkType<qint16>(map, "int16", repeat);
+	benchmarkType<qint32>(map, "int32", repeat);
+	benchmarkType<float>(map, "float", repeat);
+	benchmarkType<double>(map, "double", repeat);
+
+	delete map;
+	return mismatch ? 1 : 0;
+}
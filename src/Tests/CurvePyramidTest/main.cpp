@@ -0,0 +1,157 @@
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "VipMinMaxPyramid.h"
+
+/// Validation of the min/max pyramid used by VipPlotCurve to render large continuous curves.
+/// Each pyramid level is compared with a reference downsampling of the raw points (first minimum and
+/// first maximum of each bucket of 8^(k+1) points), and range queries are compared with a brute force scan.
+/// The pyramid is checked when built at once, when extended incrementally, and after front removals (sliding window).
+/// Return a non zero value if a check fails.
+
+static bool failed = false;
+
+static void check(const std::string& name, bool ok)
+{
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+// Reference: first minimum and first maximum of p[begin, end), with begin and end relative to the vector start
+static VipMinMaxPyramid::Node reference(const VipPointVector& p, qsizetype begin, qsizetype end)
+{
+	VipMinMaxPyramid::Node res{ begin, begin };
+	for (qsizetype i = begin + 1; i < end; ++i) {
+		if (p[i].y() < p[res.imin].y())
+			res.imin = i;
+		if (p[i].y() > p[res.imax].y())
+			res.imax = i;
+	}
+	return res;
+}
+
+// Compare each level with the reference downsampling of the raw points.
+// removed is the number of points removed from the front of the vector since the pyramid creation.
+static bool checkLevels(const VipMinMaxPyramid& pyr, const VipPointVector& p, qsizetype removed)
+{
+	const qsizetype count = removed + p.size();
+	qsizetype bucket = 8;
+	qsizetype first = removed;
+	for (size_t k = 0; k < pyr.levels.size(); ++k, bucket *= 8) {
+		const VipMinMaxPyramid::Level& l = pyr.levels[k];
+		// level k holds all complete buckets that do not overlap removed points
+		first = (first + 7) >> 3;
+		if (l.first != first || l.end() != count / bucket)
+			return false;
+		for (qsizetype i = l.first; i < l.end(); ++i) {
+			const VipMinMaxPyramid::Node ref = reference(p, i * bucket - removed, (i + 1) * bucket - removed);
+			if (l[i].imin - removed != ref.imin || l[i].imax - removed != ref.imax)
+				return false;
+		}
+	}
+	// all complete buckets of the last level are merged into the next one
+	return pyr.levels.empty() || pyr.levels.back().size() < 8;
+}
+
+static bool checkQueries(const VipMinMaxPyramid& pyr, const VipPointVector& p, std::mt19937& gen, int queries)
+{
+	const qsizetype size = p.size();
+	if (size == 0)
+		return true;
+	std::uniform_int_distribution<qsizetype> dist(0, size - 1);
+	for (int q = 0; q < queries; ++q) {
+		qsizetype begin = dist(gen), end = dist(gen) + 1;
+		if (begin >= end)
+			std::swap(begin, end);
+		if (begin == end)
+			++end;
+		const VipMinMaxPyramid::Node n = pyr.query(p, begin, end);
+		const VipMinMaxPyramid::Node ref = reference(p, begin, end);
+		if (n.imin != ref.imin || n.imax != ref.imax)
+			return false;
+	}
+	// full range
+	const VipMinMaxPyramid::Node n = pyr.query(p, 0, size);
+	const VipMinMaxPyramid::Node ref = reference(p, 0, size);
+	return n.imin == ref.imin && n.imax == ref.imax;
+}
+
+// Random samples with few distinct y values, so that the first occurrence rule is tested
+static void appendSamples(VipPointVector& p, qsizetype count, std::mt19937& gen)
+{
+	std::uniform_int_distribution<int> dist(-50, 50);
+	const qsizetype start = p.size() ? (qsizetype)p[p.size() - 1].x() + 1 : 0;
+	for (qsizetype i = 0; i < count; ++i)
+		p.push_back(VipPoint(start + i, dist(gen)));
+}
+
+static void testFullBuild(qsizetype size, std::mt19937& gen)
+{
+	VipPointVector p;
+	appendSamples(p, size, gen);
+	VipMinMaxPyramid pyr;
+	pyr.update(p);
+
+	const std::string name = "full build, " + std::to_string(size) + " points";
+	check(name + ": levels", checkLevels(pyr, p, 0));
+	check(name + ": queries", checkQueries(pyr, p, gen, 2000));
+}
+
+static void testIncremental(qsizetype size, qsizetype chunk, std::mt19937& gen)
+{
+	VipPointVector p;
+	VipMinMaxPyramid pyr;
+	bool levels = true, queries = true;
+	while (p.size() < size) {
+		appendSamples(p, std::min(chunk, size - p.size()), gen);
+		pyr.update(p);
+		levels = levels && checkLevels(pyr, p, 0);
+		queries = queries && checkQueries(pyr, p, gen, 50);
+	}
+
+	const std::string name = "incremental build, " + std::to_string(size) + " points by " + std::to_string(chunk);
+	check(name + ": levels", levels);
+	check(name + ": queries", queries);
+}
+
+static void testSlidingWindow(qsizetype window, qsizetype chunk, std::mt19937& gen)
+{
+	VipPointVector p;
+	VipMinMaxPyramid pyr;
+	qsizetype removed = 0;
+	bool levels = true, queries = true;
+	for (int step = 0; step < 200; ++step) {
+		appendSamples(p, chunk, gen);
+		if (p.size() > window) {
+			const qsizetype n = p.size() - window;
+			p.resize_front(window);
+			pyr.popFront(n);
+			removed += n;
+		}
+		pyr.update(p);
+		levels = levels && checkLevels(pyr, p, removed);
+		queries = queries && checkQueries(pyr, p, gen, 50);
+	}
+
+	const std::string name = "sliding window of " + std::to_string(window) + " points by " + std::to_string(chunk);
+	check(name + ": levels", levels);
+	check(name + ": queries", queries);
+}
+
+int main(int, char**)
+{
+	std::mt19937 gen(12345);
+
+	for (qsizetype size : { 1, 7, 8, 9, 63, 64, 65, 511, 512, 4097, 100000 })
+		testFullBuild(size, gen);
+	for (qsizetype chunk : { 1, 5, 64, 1000 })
+		testIncremental(20000, chunk, gen);
+	for (qsizetype window : { 10, 512, 5000 })
+		for (qsizetype chunk : { 1, 13, 700 })
+			testSlidingWindow(window, chunk, gen);
+
+	std::cout << (failed ? "Some pyramid checks FAILED" : "All pyramid checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <qapplication.h>
+
+#include "VipPlotCurve.h"
+
+/// Validation of the incremental stream state of VipPlotCurve.
+/// A random sequence of addSamples() (with or without sliding window), removeFirstSamples() and
+/// setRawData() (reset) is applied to a curve. After each step, the sub vectors, continuity flags and
+/// bounding intervals of the curve must be equal to a full recomputation with VipPlotCurve::dataBoundingRect().
+/// Return a non zero value if a check fails.
+
+static bool failed = false;
+
+static void check(const std::string& name, bool ok)
+{
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+static bool samePoints(const VipPointVector& a, const VipPointVector& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (qsizetype i = 0; i < a.size(); ++i) {
+		const VipPoint pa = a[i], pb = b[i];
+		// NaN values are compared by position
+		if ((pa.x() != pb.x() && !(std::isnan((double)pa.x()) && std::isnan((double)pb.x()))) ||
+		    (pa.y() != pb.y() && !(std::isnan((double)pa.y()) && std::isnan((double)pb.y()))))
+			return false;
+	}
+	return true;
+}
+
+static bool sameInterval(const VipInterval& a, const VipInterval& b)
+{
+	if (a.isValid() != b.isValid())
+		return false;
+	return !a.isValid() || (a.minValue() == b.minValue() && a.maxValue() == b.maxValue());
+}
+
+// Compare the curve state with a full recomputation from its raw data
+static bool checkState(const VipPlotCurve& curve, const VipPointVector& expected)
+{
+	const VipPointVector raw = curve.rawData();
+	if (!samePoints(raw, expected))
+		return false;
+
+	QList<VipPointVector> vectors;
+	QList<bool> continuous;
+	bool full_continuous = false, sub_continuous = false;
+	const QList<VipInterval> bounds = VipPlotCurve::dataBoundingRect(raw, vectors, continuous, full_continuous, sub_continuous);
+
+	if (curve.vectors().size() != vectors.size() || curve.continuousVectors() != continuous)
+		return false;
+	for (int i = 0; i < vectors.size(); ++i)
+		if (!samePoints(curve.vectors()[i], vectors[i]))
+			return false;
+	if (!raw.isEmpty() && (curve.isFullContinuous() != full_continuous || curve.isSubContinuous() != sub_continuous))
+		return false;
+
+	const QList<VipInterval> curve_bounds = curve.plotBoundingIntervals();
+	for (int i = 0; i < 2; ++i)
+		if (!sameInterval(curve_bounds[i], bounds.size() == 2 ? bounds[i] : VipInterval()))
+			return false;
+	return true;
+}
+
+// Generate count samples after the last x value. Depending on the mode, a few samples have a NaN x (new sub vector)
+// or go back in time (non continuous sub vector).
+static QVector<VipPoint> generate(qsizetype count, double& x, int mode, std::mt19937& gen)
+{
+	std::uniform_real_distribution<double> y(-100, 100);
+	std::uniform_int_distribution<int> event(0, 99);
+	QVector<VipPoint> res;
+	for (qsizetype i = 0; i < count; ++i) {
+		const int e = event(gen);
+		if (mode >= 1 && e < 3)
+			res.push_back(VipPoint(std::numeric_limits<double>::quiet_NaN(), y(gen)));
+		else if (mode >= 2 && e < 6)
+			res.push_back(VipPoint(x - 10, y(gen)));
+		else
+			res.push_back(VipPoint(x++, y(gen)));
+	}
+	return res;
+}
+
+static void testStream(int mode, qsizetype window, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> op(0, 99);
+	std::uniform_int_distribution<qsizetype> chunk(1, 50);
+
+	VipPlotCurve curve;
+	VipPointVector expected;
+	double x = 0;
+	bool ok = true;
+	int step = 0;
+	for (; step < 2000 && ok; ++step) {
+		const int o = op(gen);
+		if (o < 70) {
+			// push
+			const QVector<VipPoint> pts = generate(chunk(gen), x, mode, gen);
+			curve.addSamples(pts.data(), pts.size(), window);
+			for (const VipPoint& p : pts)
+				expected.push_back(p);
+			if (window >= 0 && expected.size() > window)
+				expected.resize_front(window);
+		}
+		else if (o < 90) {
+			// front removal
+			const qsizetype count = std::min(chunk(gen), expected.size());
+			curve.removeFirstSamples(count);
+			expected.resize_front(expected.size() - count);
+		}
+		else if (o < 95) {
+			// reset with new data
+			const QVector<VipPoint> pts = generate(chunk(gen), x, mode, gen);
+			expected = VipPointVector();
+			for (const VipPoint& p : pts)
+				expected.push_back(p);
+			curve.setRawData(expected);
+		}
+		else {
+			// reset to empty curve
+			expected = VipPointVector();
+			curve.setRawData(expected);
+		}
+		ok = checkState(curve, expected);
+	}
+
+	static const char* modes[] = { "sorted", "sorted with NaN", "unsorted with NaN" };
+	const std::string name = std::string(modes[mode]) + ", " + (window < 0 ? std::string("no window") : "window " + std::to_string(window));
+	check(name + (ok ? "" : ": mismatch at step " + std::to_string(step - 1)), ok);
+}
+
+int main(int argc, char** argv)
+{
+	if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+
+	unsigned seed = 1;
+	for (int mode = 0; mode < 3; ++mode)
+		for (qsizetype window : { (qsizetype)-1, (qsizetype)1, (qsizetype)20, (qsizetype)500 })
+			testStream(mode, window, seed++);
+
+	std::cout << (failed ? "Some curve stream checks FAILED" : "All curve stream checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
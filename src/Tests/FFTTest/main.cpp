@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <qcoreapplication.h>
+
+#include "VipFFT.h"
+
+/// Validation of the VipFFT transforms against a naive discrete Fourier transform computed in long double.
+/// Covers power of 2, odd, small prime (generic radix) and large prime (Bluestein) lengths, N-D shapes,
+/// the numpy-like rfftn/irfftn round trip and fftshift/ifftshift.
+/// Print one line per check and return a non zero value if any check fails.
+
+static bool failed = false;
+
+static void check(const std::string& name, double err, double tol)
+{
+	const bool ok = err <= tol;
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << " (error " << err << ")" << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+static std::vector<complex_d> randomComplex(qsizetype n, std::mt19937& gen)
+{
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<complex_d> res(n);
+	for (complex_d& v : res)
+		v = complex_d(dist(gen), dist(gen));
+	return res;
+}
+
+/// Naive N-D discrete Fourier transform of a row major array, normalized by 1/N for the backward direction
+static std::vector<complex_d> naiveDFT(const std::vector<complex_d>& in, const std::vector<qsizetype>& shape, bool backward)
+{
+	const qsizetype size = (qsizetype)in.size();
+	const int dims = (int)shape.size();
+	const long double pi = std::acos(-1.0L);
+	const long double sign = backward ? 2 : -2;
+
+	auto coords = [&](qsizetype index) {
+		std::vector<qsizetype> res(dims);
+		for (int d = dims - 1; d >= 0; --d) {
+			res[d] = index % shape[d];
+			index /= shape[d];
+		}
+		return res;
+	};
+
+	std::vector<complex_d> res(size);
+	for (qsizetype k = 0; k < size; ++k) {
+		const std::vector<qsizetype> kc = coords(k);
+		std::complex<long double> acc = 0;
+		for (qsizetype j = 0; j < size; ++j) {
+			const std::vector<qsizetype> jc = coords(j);
+			long double phase = 0;
+			for (int d = 0; d < dims; ++d)
+				phase += (long double)((kc[d] * jc[d]) % shape[d]) / shape[d];
+			const long double angle = sign * pi * phase;
+			acc += std::complex<long double>(in[j].real(), in[j].imag()) * std::complex<long double>(std::cos(angle), std::sin(angle));
+		}
+		if (backward)
+			acc /= (long double)size;
+		res[k] = complex_d((double)acc.real(), (double)acc.imag());
+	}
+	return res;
+}
+
+/// Maximum absolute difference, relative to the maximum magnitude of the reference
+template<class C>
+static double relativeError(const C* values, const std::vector<complex_d>& ref)
+{
+	double err = 0, mag = 0;
+	for (size_t i = 0; i < ref.size(); ++i) {
+		err = std::max(err, std::abs(complex_d(values[i]) - ref[i]));
+		mag = std::max(mag, std::abs(ref[i]));
+	}
+	return mag > 0 ? err / mag : err;
+}
+
+static std::string shapeString(const std::vector<qsizetype>& shape)
+{
+	std::string res = "(";
+	for (size_t i = 0; i < shape.size(); ++i)
+		res += (i ? ", " : "") + std::to_string(shape[i]);
+	return res + ")";
+}
+
+static VipNDArrayShape toShape(const std::vector<qsizetype>& shape)
+{
+	VipNDArrayShape res;
+	res.resize((int)shape.size());
+	for (size_t i = 0; i < shape.size(); ++i)
+		res[(int)i] = shape[i];
+	return res;
+}
+
+static void test1D(qsizetype n, const char* kind, std::mt19937& gen)
+{
+	const std::vector<complex_d> in = randomComplex(n, gen);
+	for (int backward = 0; backward < 2; ++backward) {
+		const Vip::FFTDirection dir = backward ? Vip::FFTBackward : Vip::FFTForward;
+		const std::vector<complex_d> ref = naiveDFT(in, { n }, backward);
+		const std::string name = std::string(backward ? "ifft " : "fft ") + kind + " n=" + std::to_string(n);
+
+		std::vector<complex_d> out(n);
+		vipFFT(in.data(), out.data(), n, dir);
+		check(name + " double", relativeError(out.data(), ref), 1e-10);
+
+		// in place
+		std::vector<complex_d> inplace = in;
+		vipFFT(inplace.data(), inplace.data(), n, dir);
+		check(name + " double in place", relativeError(inplace.data(), ref), 1e-10);
+
+		std::vector<complex_f> in_f(n), out_f(n);
+		for (qsizetype i = 0; i < n; ++i)
+			in_f[i] = complex_f((float)in[i].real(), (float)in[i].imag());
+		vipFFT(in_f.data(), out_f.data(), n, dir);
+		check(name + " float", relativeError(out_f.data(), ref), 1e-4);
+	}
+}
+
+static void testND(const std::vector<qsizetype>& shape, std::mt19937& gen)
+{
+	qsizetype size = 1;
+	for (qsizetype s : shape)
+		size *= s;
+
+	const std::vector<complex_d> in = randomComplex(size, gen);
+	VipNDArrayType<complex_d> ar(toShape(shape));
+	std::copy(in.begin(), in.end(), ar.ptr());
+
+	const VipNDArray fwd = vipFFT(ar);
+	const VipNDArray bwd = vipIFFT(ar);
+	const std::string name = shapeString(shape);
+	if (fwd.dataType() != qMetaTypeId<complex_d>() || fwd.shape() != ar.shape() || bwd.dataType() != qMetaTypeId<complex_d>()) {
+		check("fftn " + name + " output type", 1, 0);
+		return;
+	}
+	check("fftn " + name, relativeError(static_cast<const complex_d*>(fwd.constData()), naiveDFT(in, shape, false)), 1e-10);
+	check("ifftn " + name, relativeError(static_cast<const complex_d*>(bwd.constData()), naiveDFT(in, shape, true)), 1e-10);
+
+	const VipNDArray back = vipIFFT(fwd);
+	check("ifftn(fftn) " + name, relativeError(static_cast<const complex_d*>(back.constData()), in), 1e-12);
+
+	// real input is converted to complex
+	VipNDArrayType<double> real(toShape(shape));
+	std::vector<complex_d> real_in(size);
+	for (qsizetype i = 0; i < size; ++i) {
+		real.ptr()[i] = in[i].real();
+		real_in[i] = complex_d(in[i].real(), 0);
+	}
+	const VipNDArray real_fwd = vipFFT(real);
+	check("fftn real " + name, relativeError(static_cast<const complex_d*>(real_fwd.constData()), naiveDFT(real_in, shape, false)), 1e-10);
+}
+
+template<class T>
+static void testRFFT(const std::vector<qsizetype>& shape, std::mt19937& gen)
+{
+	using C = std::complex<T>;
+	std::uniform_real_distribution<double> dist(-1, 1);
+	const bool single = std::is_same<T, float>::value;
+	const double tol = single ? 1e-4 : 1e-10;
+	const std::string name = shapeString(shape) + (single ? " float" : " double");
+
+	qsizetype size = 1;
+	for (qsizetype s : shape)
+		size *= s;
+	const qsizetype n = shape.back();
+	const qsizetype m = n / 2 + 1;
+
+	VipNDArrayType<T> ar(toShape(shape));
+	std::vector<complex_d> in(size);
+	for (qsizetype i = 0; i < size; ++i) {
+		ar.ptr()[i] = (T)dist(gen);
+		in[i] = complex_d((double)ar.ptr()[i], 0);
+	}
+
+	const VipNDArray spectrum = vipRFFT(ar);
+	std::vector<qsizetype> half = shape;
+	half.back() = m;
+	if (spectrum.dataType() != qMetaTypeId<C>() || spectrum.shape() != toShape(half)) {
+		check("rfftn " + name + " output type", 1, 0);
+		return;
+	}
+
+	// the real transform is the first n/2+1 values of the last axis of the full transform
+	const std::vector<complex_d> full = naiveDFT(in, shape, false);
+	std::vector<complex_d> ref(size / n * m);
+	for (qsizetype r = 0; r < size / n; ++r)
+		std::copy(full.begin() + r * n, full.begin() + r * n + m, ref.begin() + r * m);
+	check("rfftn " + name, relativeError(static_cast<const C*>(spectrum.constData()), ref), tol);
+
+	const VipNDArray back = vipIRFFT(spectrum, n);
+	if (back.dataType() != qMetaTypeId<T>() || back.shape() != ar.shape()) {
+		check("irfftn " + name + " output type", 1, 0);
+		return;
+	}
+	double err = 0;
+	const T* values = static_cast<const T*>(back.constData());
+	for (qsizetype i = 0; i < size; ++i)
+		err = std::max(err, std::abs((double)values[i] - in[i].real()));
+	check("irfftn(rfftn) " + name, err, tol);
+}
+
+static void testShift(const std::vector<qsizetype>& shape)
+{
+	qsizetype size = 1;
+	for (qsizetype s : shape)
+		size *= s;
+	VipNDArrayType<int> ar(toShape(shape));
+	for (qsizetype i = 0; i < size; ++i)
+		ar.ptr()[i] = (int)i;
+
+	const VipNDArray shifted = vipFFTShift(ar);
+	const VipNDArray back = vipIFFTShift(shifted);
+
+	// fftshift moves the element at index i to index (i + n/2) % n along each axis
+	double err = 0;
+	const int* s = static_cast<const int*>(shifted.constData());
+	for (qsizetype i = 0; i < size; ++i) {
+		qsizetype index = i, dst = 0, stride = 1;
+		for (int d = (int)shape.size() - 1; d >= 0; --d) {
+			const qsizetype c = index % shape[d];
+			index /= shape[d];
+			dst += ((c + shape[d] / 2) % shape[d]) * stride;
+			stride *= shape[d];
+		}
+		err = std::max(err, (double)std::abs(s[dst] - (int)i));
+	}
+	const int* b = static_cast<const int*>(back.constData());
+	for (qsizetype i = 0; i < size; ++i)
+		err = std::max(err, (double)std::abs(b[i] - (int)i));
+	check("fftshift/ifftshift " + shapeString(shape), err, 0);
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	std::mt19937 gen(42);
+
+	for (qsizetype n : { 1, 2, 4, 8, 64, 1024 })
+		test1D(n, "power of 2", gen);
+	for (qsizetype n : { 9, 15, 45, 105, 225, 1000 })
+		test1D(n, "odd/mixed", gen);
+	for (qsizetype n : { 7, 13, 31, 61 })
+		test1D(n, "prime", gen);
+	for (qsizetype n : { 67, 127, 254, 1009 })
+		test1D(n, "bluestein", gen);
+
+	for (const std::vector<qsizetype>& shape : std::vector<std::vector<qsizetype>>{ { 6, 10 }, { 3, 5, 8 }, { 7, 1, 4 }, { 2, 67 }, { 4, 3, 2, 5 } })
+		testND(shape, gen);
+
+	for (const std::vector<qsizetype>& shape : std::vector<std::vector<qsizetype>>{ { 1 }, { 16 }, { 15 }, { 67 }, { 6, 10 }, { 5, 7 }, { 3, 4, 9 } }) {
+		testRFFT<double>(shape, gen);
+		testRFFT<float>(shape, gen);
+	}
+
+	for (const std::vector<qsizetype>& shape : std::vector<std::vector<qsizetype>>{ { 8 }, { 7 }, { 4, 5 }, { 3, 6, 5 } })
+		testShift(shape);
+
+	std::cout << (failed ? "Some FFT checks FAILED" : "All FFT checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,462 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <qcoreapplication.h>
+
+#include "VipFilters.h"
+
+/// Validation of the VipFilters kernels against brute force implementations.
+/// Each filter is compared with a direct evaluation over its full window, for the 4 border modes,
+/// several input types, and window sizes up to larger than the input itself.
+/// Print one line per failed check, a summary per filter, and return a non zero value if any check fails.
+
+static bool failed = false;
+
+using Shape = std::vector<qsizetype>;
+
+static const Vip::FilterBorderMode modes[] = { Vip::FilterReflect, Vip::FilterNearest, Vip::FilterMirror, Vip::FilterWrap };
+static const char* modeName(Vip::FilterBorderMode mode)
+{
+	switch (mode) {
+		case Vip::FilterReflect:
+			return "reflect";
+		case Vip::FilterNearest:
+			return "nearest";
+		case Vip::FilterMirror:
+			return "mirror";
+		case Vip::FilterWrap:
+			return "wrap";
+	}
+	return "";
+}
+
+static std::string shapeString(const Shape& shape)
+{
+	std::string res = "(";
+	for (size_t i = 0; i < shape.size(); ++i)
+		res += (i ? ", " : "") + std::to_string(shape[i]);
+	return res + ")";
+}
+
+static qsizetype shapeSize(const Shape& shape)
+{
+	qsizetype res = 1;
+	for (qsizetype s : shape)
+		res *= s;
+	return res;
+}
+
+static VipNDArrayShape toShape(const Shape& shape)
+{
+	VipNDArrayShape res;
+	res.resize((int)shape.size());
+	for (size_t i = 0; i < shape.size(); ++i)
+		res[(int)i] = shape[i];
+	return res;
+}
+
+/// Reference border handling, unfolding the signal one reflection at a time (scipy.ndimage conventions)
+static qsizetype referenceBorder(qsizetype i, qsizetype n, Vip::FilterBorderMode mode)
+{
+	switch (mode) {
+		case Vip::FilterNearest:
+			return std::min(std::max(i, (qsizetype)0), n - 1);
+		case Vip::FilterWrap:
+			while (i < 0)
+				i += n;
+			while (i >= n)
+				i -= n;
+			return i;
+		case Vip::FilterMirror:
+			if (n == 1)
+				return 0;
+			while (i < 0 || i >= n)
+				i = i < 0 ? -i : 2 * n - 2 - i;
+			return i;
+		case Vip::FilterReflect:
+			while (i < 0 || i >= n)
+				i = i < 0 ? -i - 1 : 2 * n - 1 - i;
+			return i;
+	}
+	return i;
+}
+
+/// Call \a fun(value, offsets) for each element of the window of \a sizes elements around \a index.
+/// The window covers [c - sizes[d]/2, c - sizes[d]/2 + sizes[d]) along each axis d.
+template<class T, class Fun>
+static void forEachInWindow(const T* data, const Shape& shape, qsizetype index, const Shape& sizes, Vip::FilterBorderMode mode, Fun&& fun)
+{
+	const int dims = (int)shape.size();
+	Shape center(dims), offset(dims, 0);
+	for (int d = dims - 1; d >= 0; --d) {
+		center[d] = index % shape[d];
+		index /= shape[d];
+	}
+	while (true) {
+		qsizetype src = 0;
+		for (int d = 0; d < dims; ++d)
+			src = src * shape[d] + referenceBorder(center[d] + offset[d] - sizes[d] / 2, shape[d], mode);
+		fun(data[src], offset);
+
+		int d = dims - 1;
+		for (; d >= 0; --d) {
+			if (++offset[d] < sizes[d])
+				break;
+			offset[d] = 0;
+		}
+		if (d < 0)
+			break;
+	}
+}
+
+template<class T>
+static VipNDArrayType<T> randomArray(const Shape& shape, std::mt19937& gen, bool ties)
+{
+	VipNDArrayType<T> res(toShape(shape));
+	std::uniform_int_distribution<int> small(0, 6);
+	std::uniform_int_distribution<int> large(0, 100);
+	const qsizetype size = shapeSize(shape);
+	for (qsizetype i = 0; i < size; ++i) {
+		if (ties)
+			res.ptr()[i] = (T)small(gen);
+		else if (std::is_floating_point<T>::value)
+			res.ptr()[i] = (T)(large(gen) / 7.);
+		else
+			res.ptr()[i] = (T)large(gen);
+	}
+	return res;
+}
+
+/// Collect failures of a group of checks and print a summary line
+class Group
+{
+	std::string m_name;
+	int m_count{ 0 };
+	int m_errors{ 0 };
+
+public:
+	explicit Group(const std::string& name)
+	  : m_name(name)
+	{
+	}
+	~Group()
+	{
+		std::cout << (m_errors ? "FAILED   " : "OK       ") << m_name << " (" << m_count << " checks, " << m_errors << " errors)" << std::endl;
+		if (m_errors)
+			failed = true;
+	}
+	void check(bool ok, const std::string& what)
+	{
+		++m_count;
+		if (!ok && ++m_errors <= 10)
+			std::cout << "  error: " << m_name << " " << what << std::endl;
+	}
+};
+
+static std::string caseName(const Shape& shape, int size, Vip::FilterBorderMode mode)
+{
+	return shapeString(shape) + " size " + std::to_string(size) + " " + modeName(mode);
+}
+
+template<class T>
+static void testMinMax(const char* type, std::mt19937& gen)
+{
+	Group group(std::string("min/max/grey morphology ") + type);
+	for (const Shape& shape : std::vector<Shape>{ { 1 }, { 17 }, { 5, 7 }, { 1, 9 }, { 12, 3 }, { 4, 5, 6 } })
+		for (int size : { 1, 2, 3, 4, 7, 15 })
+			for (Vip::FilterBorderMode mode : modes) {
+				const VipNDArrayType<T> ar = randomArray<T>(shape, gen, size % 2 == 0);
+				const std::string name = caseName(shape, size, mode);
+				const int dims = (int)shape.size();
+
+				const VipNDArray mn = vipMinimumFilter(ar, size, mode);
+				const VipNDArray mx = vipMaximumFilter(ar, size, mode);
+				const VipNDArray emn = vipGreyErosion(ar, size, false, mode);
+				const VipNDArray dmx = vipGreyDilation(ar, size, false, mode);
+				if (mn.dataType() != ar.dataType() || mx.dataType() != ar.dataType() || emn.dataType() != ar.dataType() || dmx.dataType() != ar.dataType()) {
+					group.check(false, name + " output type");
+					continue;
+				}
+				bool ok_min = true, ok_max = true, ok_cross = true;
+				for (qsizetype i = 0; i < shapeSize(shape); ++i) {
+					T lo = ar.ptr()[i], hi = lo, cross_lo = lo, cross_hi = lo;
+					forEachInWindow(ar.ptr(), shape, i, Shape(dims, size), mode, [&](T v, const Shape& offset) {
+						lo = std::min(lo, v);
+						hi = std::max(hi, v);
+						// cross structuring element: at most one axis away from the center
+						int moved = 0;
+						for (int d = 0; d < dims; ++d)
+							moved += offset[d] != size / 2;
+						if (moved <= 1) {
+							cross_lo = std::min(cross_lo, v);
+							cross_hi = std::max(cross_hi, v);
+						}
+					});
+					ok_min = ok_min && static_cast<const T*>(mn.constData())[i] == lo;
+					ok_max = ok_max && static_cast<const T*>(mx.constData())[i] == hi;
+					ok_cross = ok_cross && static_cast<const T*>(emn.constData())[i] == cross_lo && static_cast<const T*>(dmx.constData())[i] == cross_hi;
+				}
+				group.check(ok_min, name + " minimum");
+				group.check(ok_max, name + " maximum");
+				group.check(ok_cross, name + " cross erosion/dilation");
+			}
+}
+
+template<class T>
+static void testUniform(const char* type, std::mt19937& gen)
+{
+	Group group(std::string("uniform ") + type);
+	const bool single = std::is_same<T, float>::value;
+	for (const Shape& shape : std::vector<Shape>{ { 1 }, { 17 }, { 5, 7 }, { 4, 5, 6 } })
+		for (int size : { 1, 2, 3, 6, 11 })
+			for (Vip::FilterBorderMode mode : modes) {
+				const VipNDArrayType<T> ar = randomArray<T>(shape, gen, false);
+				const std::string name = caseName(shape, size, mode);
+				const VipNDArray res = vipUniformFilter(ar, size, mode);
+				if (res.dataType() != (single ? (int)QMetaType::Float : (int)QMetaType::Double)) {
+					group.check(false, name + " output type");
+					continue;
+				}
+				double err = 0;
+				for (qsizetype i = 0; i < shapeSize(shape); ++i) {
+					double sum = 0, count = 0;
+					forEachInWindow(ar.ptr(), shape, i, Shape(shape.size(), size), mode, [&](T v, const Shape&) {
+						sum += v;
+						++count;
+					});
+					const double value = single ? (double)static_cast<const float*>(res.constData())[i] : static_cast<const double*>(res.constData())[i];
+					err = std::max(err, std::abs(value - sum / count));
+				}
+				group.check(err < (single ? 1e-3 : 1e-9), name + " error " + std::to_string(err));
+			}
+}
+
+template<class T>
+static void testRank(const char* type, std::mt19937& gen)
+{
+	Group group(std::string("rank/percentile/median ") + type);
+	// windows above 5x5 use the sliding histogram, smaller ones the direct selection
+	for (const Shape& shape : std::vector<Shape>{ { 1 }, { 23 }, { 5, 7 }, { 1, 9 }, { 13, 2 }, { 20, 21 } })
+		for (int size : { 1, 2, 3, 5, 6, 7, 15 })
+			for (Vip::FilterBorderMode mode : modes) {
+				const VipNDArrayType<T> ar = randomArray<T>(shape, gen, size % 2 == 1);
+				const std::string name = caseName(shape, size, mode);
+				const Shape sizes(shape.size(), size);
+				const qsizetype wsize = shape.size() == 2 ? size * size : size;
+
+				std::uniform_int_distribution<int> dist(0, (int)wsize - 1);
+				const int rank = dist(gen);
+				const int negative_rank = -1 - dist(gen);
+				const double percentile = gen() % 2 ? 25 : -10;
+				const double p = percentile < 0 ? percentile + 100 : percentile;
+				const int percentile_rank = (int)(double(wsize) * p / 100.);
+
+				const VipNDArray r = vipRankFilter(ar, rank, size, mode);
+				const VipNDArray nr = vipRankFilter(ar, negative_rank, size, mode);
+				const VipNDArray pr = vipPercentileFilter(ar, percentile, size, mode);
+				const VipNDArray p100 = vipPercentileFilter(ar, 100, size, mode);
+				const VipNDArray md = vipMedianFilter(ar, size, mode);
+				if (r.dataType() != ar.dataType() || nr.dataType() != ar.dataType() || pr.dataType() != ar.dataType() || p100.dataType() != ar.dataType() ||
+				    md.dataType() != ar.dataType()) {
+					group.check(false, name + " output type");
+					continue;
+				}
+
+				bool ok_rank = true, ok_negative = true, ok_percentile = true, ok_median = true;
+				std::vector<T> window;
+				for (qsizetype i = 0; i < shapeSize(shape); ++i) {
+					window.clear();
+					forEachInWindow(ar.ptr(), shape, i, sizes, mode, [&](T v, const Shape&) { window.push_back(v); });
+					std::sort(window.begin(), window.end());
+					ok_rank = ok_rank && static_cast<const T*>(r.constData())[i] == window[rank];
+					ok_negative = ok_negative && static_cast<const T*>(nr.constData())[i] == window[wsize + negative_rank];
+					ok_percentile = ok_percentile && static_cast<const T*>(pr.constData())[i] == window[percentile_rank] &&
+							static_cast<const T*>(p100.constData())[i] == window.back();
+					ok_median = ok_median && static_cast<const T*>(md.constData())[i] == window[wsize / 2];
+				}
+				group.check(ok_rank, name + " rank " + std::to_string(rank));
+				group.check(ok_negative, name + " rank " + std::to_string(negative_rank));
+				group.check(ok_percentile, name + " percentile " + std::to_string(percentile));
+				group.check(ok_median, name + " median");
+			}
+}
+
+/// Reference binary morphology: outside elements are 0, iterations < 1 repeat until convergence.
+/// 1D arrays (rows == 0) only use the horizontal neighbors.
+static std::vector<bool> referenceMorphology(std::vector<bool> mask, qsizetype rows, qsizetype cols, bool dilate, bool full, int iterations)
+{
+	const bool oned = rows == 0;
+	rows = std::max(rows, (qsizetype)1);
+	for (int it = 0; iterations < 1 || it < iterations; ++it) {
+		std::vector<bool> res(mask.size());
+		for (qsizetype y = 0; y < rows; ++y)
+			for (qsizetype x = 0; x < cols; ++x) {
+				bool value = !dilate;
+				for (int dy = -1; dy <= 1; ++dy)
+					for (int dx = -1; dx <= 1; ++dx) {
+						if ((!full && dy && dx) || (oned && dy))
+							continue;
+						const qsizetype yy = y + dy, xx = x + dx;
+						const bool v = yy >= 0 && yy < rows && xx >= 0 && xx < cols && mask[yy * cols + xx];
+						value = dilate ? (value || v) : (value && v);
+					}
+				res[y * cols + x] = value;
+			}
+		const bool changed = res != mask;
+		mask = res;
+		if (!changed)
+			break;
+	}
+	return mask;
+}
+
+static void testBinary(std::mt19937& gen)
+{
+	Group group("binary morphology");
+	// column counts around the 64 bits packing boundaries
+	for (const Shape& shape : std::vector<Shape>{ { 1 }, { 70 }, { 1, 64 }, { 5, 63 }, { 7, 64 }, { 6, 65 }, { 4, 130 }, { 9, 3 } })
+		for (int iterations : { 1, 2, 0 })
+			for (bool full : { true, false }) {
+				const qsizetype rows = shape.size() == 2 ? shape[0] : 0;
+				const qsizetype cols = shape.back();
+				const qsizetype size = std::max(rows, (qsizetype)1) * cols;
+				const std::string name = shapeString(shape) + " iterations " + std::to_string(iterations) + (full ? " full" : " cross");
+
+				// sparse and dense masks
+				for (int density : { 4, 2 }) {
+					VipNDArrayType<int> ar(toShape(shape));
+					std::vector<bool> mask(size);
+					for (qsizetype i = 0; i < size; ++i)
+						mask[i] = ar.ptr()[i] = gen() % density == 0 ? (int)(gen() % 5 + 1) : 0;
+
+					const std::vector<bool> dilation = referenceMorphology(mask, rows, cols, true, full, iterations);
+					const std::vector<bool> erosion = referenceMorphology(mask, rows, cols, false, full, iterations);
+					const std::vector<bool> opening = referenceMorphology(erosion, rows, cols, true, full, iterations);
+					const std::vector<bool> closing = referenceMorphology(dilation, rows, cols, false, full, iterations);
+
+					const std::pair<VipNDArray, const std::vector<bool>*> results[] = { { vipBinaryDilation(ar, iterations, full), &dilation },
+													   { vipBinaryErosion(ar, iterations, full), &erosion },
+													   { vipBinaryOpening(ar, iterations, full), &opening },
+													   { vipBinaryClosing(ar, iterations, full), &closing } };
+					const char* names[] = { " dilation", " erosion", " opening", " closing" };
+					for (int k = 0; k < 4; ++k) {
+						const VipNDArray& res = results[k].first;
+						bool ok = res.dataType() == QMetaType::Bool && res.size() == size;
+						for (qsizetype i = 0; ok && i < size; ++i)
+							ok = static_cast<const bool*>(res.constData())[i] == (*results[k].second)[i];
+						group.check(ok, name + names[k]);
+					}
+				}
+			}
+}
+
+/// Reference separable correlation: the N-D kernel is the outer product of the 1D kernels (an empty kernel means identity)
+template<class T>
+static std::vector<double> referenceCorrelation(const VipNDArrayType<T>& ar, const Shape& shape, const std::vector<std::vector<double>>& kernels, Vip::FilterBorderMode mode)
+{
+	const int dims = (int)shape.size();
+	Shape sizes(dims);
+	for (int d = 0; d < dims; ++d)
+		sizes[d] = kernels[d].empty() ? 1 : (qsizetype)kernels[d].size();
+
+	std::vector<double> res(shapeSize(shape));
+	for (qsizetype i = 0; i < (qsizetype)res.size(); ++i) {
+		double sum = 0;
+		forEachInWindow(ar.ptr(), shape, i, sizes, mode, [&](T v, const Shape& offset) {
+			double w = 1;
+			for (int d = 0; d < dims; ++d)
+				if (kernels[d].size())
+					w *= kernels[d][offset[d]];
+			sum += w * v;
+		});
+		res[i] = sum;
+	}
+	return res;
+}
+
+template<class T>
+static void testLinear(const char* type, std::mt19937& gen)
+{
+	Group group(std::string("gaussian/sobel/prewitt/laplace ") + type);
+	const bool single = std::is_same<T, float>::value;
+	const double tol = single ? 1e-3 : 1e-9;
+
+	auto compare = [&](const VipNDArray& res, const std::vector<double>& ref, const std::string& name) {
+		if (res.dataType() != (single ? (int)QMetaType::Float : (int)QMetaType::Double) || res.size() != (qsizetype)ref.size()) {
+			group.check(false, name + " output type");
+			return;
+		}
+		double err = 0;
+		for (size_t i = 0; i < ref.size(); ++i) {
+			const double value = single ? (double)static_cast<const float*>(res.constData())[i] : static_cast<const double*>(res.constData())[i];
+			err = std::max(err, std::abs(value - ref[i]) / std::max(1., std::abs(ref[i])));
+		}
+		group.check(err < tol, name + " error " + std::to_string(err));
+	};
+
+	for (const Shape& shape : std::vector<Shape>{ { 1 }, { 2 }, { 17 }, { 5, 7 }, { 3, 4, 5 } })
+		for (Vip::FilterBorderMode mode : modes) {
+			const VipNDArrayType<T> ar = randomArray<T>(shape, gen, false);
+			const int dims = (int)shape.size();
+			const std::string name = shapeString(shape) + " " + modeName(mode);
+
+			for (double sigma : { 0.7, 2.5 }) {
+				const qsizetype radius = (qsizetype)(4. * sigma + 0.5);
+				std::vector<double> kernel(2 * radius + 1);
+				double sum = 0;
+				for (qsizetype i = -radius; i <= radius; ++i)
+					sum += kernel[i + radius] = std::exp(-0.5 * i * i / (sigma * sigma));
+				for (double& k : kernel)
+					k /= sum;
+				compare(vipGaussianFilter(ar, sigma, 0, mode), referenceCorrelation(ar, shape, std::vector<std::vector<double>>(dims, kernel), mode), name + " gaussian sigma " + std::to_string(sigma));
+			}
+
+			for (int axis = 0; axis < dims; ++axis) {
+				std::vector<std::vector<double>> sobel(dims, { 1., 2., 1. }), prewitt(dims, { 1., 1., 1. });
+				sobel[axis] = prewitt[axis] = { -1., 0., 1. };
+				compare(vipSobelFilter(ar, axis, mode), referenceCorrelation(ar, shape, sobel, mode), name + " sobel axis " + std::to_string(axis));
+				compare(vipPrewittFilter(ar, axis, mode), referenceCorrelation(ar, shape, prewitt, mode), name + " prewitt axis " + std::to_string(axis));
+			}
+
+			std::vector<double> laplace(shapeSize(shape), 0.);
+			for (int axis = 0; axis < dims; ++axis) {
+				std::vector<std::vector<double>> kernels(dims);
+				kernels[axis] = { 1., -2., 1. };
+				const std::vector<double> d2 = referenceCorrelation(ar, shape, kernels, mode);
+				for (size_t i = 0; i < d2.size(); ++i)
+					laplace[i] += d2[i];
+			}
+			compare(vipLaplaceFilter(ar, mode), laplace, name + " laplace");
+		}
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	std::mt19937 gen(7);
+
+	testMinMax<quint8>("uint8", gen);
+	testMinMax<qint16>("int16", gen);
+	testMinMax<float>("float", gen);
+	testMinMax<double>("double", gen);
+
+	testUniform<quint16>("uint16", gen);
+	testUniform<float>("float", gen);
+
+	testRank<quint8>("uint8", gen);
+	testRank<qint32>("int32", gen);
+	testRank<float>("float", gen);
+	testRank<double>("double", gen);
+
+	testBinary(gen);
+
+	testLinear<qint32>("int32", gen);
+	testLinear<float>("float", gen);
+	testLinear<double>("double", gen);
+
+	std::cout << (failed ? "Some filter checks FAILED" : "All filter checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
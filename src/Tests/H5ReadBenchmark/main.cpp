@@ -0,0 +1,199 @@
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <qcoreapplication.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+
+#include "VipIODevice.h"
+#include "VipNDArray.h"
+
+#ifdef VIP_WITH_HDF5
+#include "VipH5Archive.h"
+#include "VipH5DeviceDriver.h"
+
+/// Benchmark of concurrent HDF5 archive reading.
+/// Several files (640x512 uint16 frames) are read at the same time, one thread per file, and the aggregate
+/// throughput in MB/s is printed with the QIODevice based driver and global locking, and with native file access
+/// (positional reads and direct copy of uncompressed frames from the file mapping).
+/// Movie files are read with VipH5Archive::readMovieFrame(). Archives written by VipArchiveRecorder with the default
+/// record layout are read with VipArchiveReader: records always go through the HDF5 library under vipH5Mutex().
+/// Each frame is summed after reading to simulate decoding.
+/// Return a non zero value if the frames read differ from the written ones.
+
+static const int width = 640;
+static const int height = 512;
+static const int frames = 200;
+
+static VipNDArray createImage(int frame)
+{
+	VipNDArrayType<quint16> ar(vipVector(height, width));
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			ar(y, x) = (quint16)(1000 * (std::cos(x * 0.01 + frame) + std::sin(y * 0.02) + 2));
+	return ar;
+}
+
+/// Sum of all frames, computed once
+static double expectedSum()
+{
+	static const double sum = []() {
+		double res = 0;
+		for (int i = 0; i < frames; ++i) {
+			const VipNDArrayType<quint16> ar = createImage(i);
+			for (qsizetype p = 0; p < ar.size(); ++p)
+				res += ar[p];
+		}
+		return res;
+	}();
+	return sum;
+}
+
+static bool createMovie(const QString& filename, int compression)
+{
+	VipH5Archive arch;
+	arch.setMovieCompression(compression);
+	if (!arch.open(filename, QIODevice::ReadWrite | QIODevice::Truncate))
+		return false;
+	for (int i = 0; i < frames; ++i)
+		if (!arch.appendMovieFrame("movie", createImage(i), i * 1000))
+			return false;
+	return true;
+}
+
+/// Write an archive with VipArchiveRecorder using the default record layout (one record per frame)
+static bool createRecords(const QString& filename)
+{
+	VipArchiveRecorder recorder;
+	recorder.setPath(filename);
+	recorder.topLevelInputAt(0)->toMultiInput()->resize(1);
+	if (!recorder.open(VipIODevice::WriteOnly))
+		return false;
+	for (int i = 0; i < frames; ++i) {
+		recorder.inputAt(0)->setData(VipAnyData(QVariant::fromValue(createImage(i)), i * 1000));
+		recorder.update();
+	}
+	recorder.close();
+	return true;
+}
+
+static double readRecords(const QString& filename)
+{
+	VipArchiveReader reader;
+	reader.setPath(filename);
+	if (!reader.open(VipIODevice::ReadOnly))
+		return 0;
+	double sum = 0;
+	for (qint64 time = reader.firstTime(); time != VipInvalidTime; time = reader.nextTime(time)) {
+		reader.read(time, true);
+		const VipNDArrayType<quint16> ar = reader.outputAt(0)->value<VipNDArray>();
+		for (qsizetype p = 0; p < ar.size(); ++p)
+			sum += ar[p];
+		if (time == reader.lastTime())
+			break;
+	}
+	return sum;
+}
+
+static double readMovie(const QString& filename)
+{
+	VipH5Archive arch(filename, QIODevice::ReadOnly);
+	const qint64 count = arch.movieFrameCount("movie");
+	double sum = 0;
+	for (qint64 i = 0; i < count; ++i) {
+		const VipNDArrayType<quint16> ar = arch.readMovieFrame("movie", i);
+		for (qsizetype p = 0; p < ar.size(); ++p)
+			sum += ar[p];
+	}
+	return sum;
+}
+
+static bool mismatch = false;
+
+/// Read all files concurrently with \a read and returns the aggregate throughput in MB/s.
+/// \a same is set to false if a file content differs from the written frames.
+static double readAll(const QStringList& files, double (*read)(const QString&), bool& same)
+{
+	std::vector<std::thread> threads;
+	std::vector<double> sums(files.size());
+	QElapsedTimer timer;
+	timer.start();
+	for (qsizetype i = 0; i < files.size(); ++i)
+		threads.emplace_back([&, i]() { sums[i] = read(files[i]); });
+	for (std::thread& t : threads)
+		t.join();
+	const double bytes = (double)files.size() * frames * width * height * sizeof(quint16);
+	const double speed = bytes / (timer.nsecsElapsed() * 1e-3);
+	for (double sum : sums)
+		same = same && sum == expectedSum();
+	return speed;
+}
+
+/// Print the QIODevice and native throughputs of reading \a files with \a read
+static void benchmark(const QString& name, const QStringList& files, double (*read)(const QString&))
+{
+	bool same = true;
+	vipH5SetNativeFileAccess(false);
+	readAll(files, read, same); // warm up the file cache
+	const double qiodevice = readAll(files, read, same);
+	vipH5SetNativeFileAccess(true);
+	const double native = readAll(files, read, same);
+	std::cout << name.toLatin1().data() << ", " << files.size() << " file(s): QIODevice " << qiodevice << " MB/s, native " << native << " MB/s"
+		  << (same ? "" : " (MISMATCH)") << std::endl;
+	if (!same)
+		mismatch = true;
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	const QString dir = QDir::tempPath();
+	for (int compression : { 0, 1 }) {
+		for (int file_count : { 1, 2, 4 }) {
+			QStringList files;
+			for (int i = 0; i < file_count; ++i) {
+				files.append(dir + "/H5ReadBenchmark_" + QString::number(i) + ".h5");
+				if (!createMovie(files.back(), compression)) {
+					std::cout << "Unable to create " << files.back().toLatin1().data() << std::endl;
+					return -1;
+				}
+			}
+
+			benchmark("movie, compression " + QString::number(compression), files, readMovie);
+			for (const QString& f : files)
+				QFile::remove(f);
+		}
+	}
+
+	for (int file_count : { 1, 2, 4 }) {
+		QStringList files;
+		for (int i = 0; i < file_count; ++i) {
+			files.append(dir + "/H5ReadBenchmark_" + QString::number(i) + ".arch");
+			if (!createRecords(files.back())) {
+				std::cout << "Unable to create " << files.back().toLatin1().data() << std::endl;
+				return -1;
+			}
+		}
+
+		benchmark("records", files, readRecords);
+		for (const QString& f : files) {
+			QFile::remove(f);
+			QFile::remove(f + ".idx");
+		}
+	}
+	return mismatch ? 1 : 0;
+}
+
+#else
+
+int main(int, char**)
+{
+	std::cout << "HDF5 support is not enabled" << std::endl;
+	return 0;
+}
+
+#endif
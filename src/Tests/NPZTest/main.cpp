@@ -0,0 +1,185 @@
+#include <cstring>
+#include <iostream>
+
+#include <qcoreapplication.h>
+#include <qdir.h>
+#include <qfile.h>
+
+#include "VipNDArray.h"
+#include "VipNPZDevice.h"
+
+/// Validation of the NPZ and MAT writers.
+/// Files are written with VipNPZDevice and VipMATDevice, then parsed back independently:
+/// zip local header, zip64 extra fields, central directory and end record, CRC-32 of the stored entry,
+/// NPY header and frame values for NPZ files, and the v5 matrix element for MAT files.
+/// Print one line per check and return a non zero value if any check fails.
+
+static bool failed = false;
+
+static void check(const std::string& name, bool ok)
+{
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+template<class T>
+static T readValue(const QByteArray& ar, qsizetype pos)
+{
+	T res = T();
+	if (pos >= 0 && pos + (qsizetype)sizeof(T) <= ar.size())
+		memcpy(&res, ar.data() + pos, sizeof(T));
+	return res;
+}
+
+/// Bitwise zip CRC-32, independent from the table based implementation of the writer
+static quint32 referenceCrc32(const char* data, qsizetype size)
+{
+	quint32 crc = 0xFFFFFFFFU;
+	for (qsizetype i = 0; i < size; ++i) {
+		crc ^= (quint8)data[i];
+		for (int k = 0; k < 8; ++k)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+	}
+	return ~crc;
+}
+
+static VipNDArray createFrame(int frame, int h, int w)
+{
+	VipNDArrayType<float> ar(vipVector(h, w));
+	for (int i = 0; i < h * w; ++i)
+		ar.ptr()[i] = (float)(frame * 1000 + i);
+	return ar;
+}
+
+template<class Device>
+static QByteArray writeFrames(const QString& filename, int frames, int h, int w)
+{
+	{
+		Device dev;
+		dev.setPath(filename);
+		if (!dev.open(VipIODevice::WriteOnly))
+			return QByteArray();
+		for (int i = 0; i < frames; ++i) {
+			VipAnyData any(QVariant::fromValue(createFrame(i, h, w)), i);
+			any.setName("frames");
+			dev.inputAt(0)->setData(any);
+			dev.update();
+		}
+		dev.close();
+	}
+	QFile file(filename);
+	if (!file.open(QFile::ReadOnly))
+		return QByteArray();
+	return file.readAll();
+}
+
+static void testNPZ(int frames, int h, int w)
+{
+	const QString filename = QDir::tempPath() + "/NPZTest.npz";
+	const QByteArray content = writeFrames<VipNPZDevice>(filename, frames, h, w);
+	QFile::remove(filename);
+	const std::string name = "npz " + std::to_string(frames) + " frames " + std::to_string(h) + "x" + std::to_string(w);
+	if (content.isEmpty()) {
+		check(name + " written", false);
+		return;
+	}
+
+	// local file header with zip64 sizes
+	const quint16 name_len = readValue<quint16>(content, 26);
+	const quint16 extra_len = readValue<quint16>(content, 28);
+	const QByteArray entry = content.mid(30, name_len);
+	const qsizetype extra = 30 + name_len;
+	const quint64 size = readValue<quint64>(content, extra + 4);
+	const qsizetype data_pos = extra + extra_len;
+	check(name + " local header",
+	      readValue<quint32>(content, 0) == 0x04034b50 && readValue<quint16>(content, 4) == 45 && readValue<quint16>(content, 8) == 0 && entry == "arr_frames.npy" &&
+		readValue<quint32>(content, 18) == 0xFFFFFFFF && readValue<quint32>(content, 22) == 0xFFFFFFFF);
+	check(name + " local zip64 extra field",
+	      extra_len == 20 && readValue<quint16>(content, extra) == 0x0001 && readValue<quint16>(content, extra + 2) == 16 && readValue<quint64>(content, extra + 12) == size &&
+		data_pos + (qsizetype)size <= content.size());
+
+	const quint32 crc = referenceCrc32(content.data() + data_pos, (qsizetype)size);
+	check(name + " local CRC-32", readValue<quint32>(content, 14) == crc);
+
+	// central directory, right after the entry data
+	const qsizetype cd = data_pos + (qsizetype)size;
+	const quint16 cd_name_len = readValue<quint16>(content, cd + 28);
+	const qsizetype cd_extra = cd + 46 + cd_name_len;
+	check(name + " central directory",
+	      readValue<quint32>(content, cd) == 0x02014b50 && readValue<quint32>(content, cd + 16) == crc && readValue<quint32>(content, cd + 20) == 0xFFFFFFFF &&
+		readValue<quint32>(content, cd + 24) == 0xFFFFFFFF && cd_name_len == name_len && content.mid(cd + 46, cd_name_len) == entry &&
+		readValue<quint16>(content, cd + 30) == 20 && readValue<quint32>(content, cd + 42) == 0);
+	check(name + " central zip64 extra field",
+	      readValue<quint16>(content, cd_extra) == 0x0001 && readValue<quint16>(content, cd_extra + 2) == 16 && readValue<quint64>(content, cd_extra + 4) == size &&
+		readValue<quint64>(content, cd_extra + 12) == size);
+
+	// end of central directory record, at the end of the file
+	const qsizetype eocd = cd_extra + 20;
+	check(name + " end of central directory",
+	      readValue<quint32>(content, eocd) == 0x06054b50 && readValue<quint16>(content, eocd + 8) == 1 && readValue<quint16>(content, eocd + 10) == 1 &&
+		readValue<quint32>(content, eocd + 12) == (quint32)(eocd - cd) && readValue<quint32>(content, eocd + 16) == (quint32)cd && eocd + 22 == content.size());
+
+	// npy header and values
+	const QByteArray npy = content.mid(data_pos, (qsizetype)size);
+	const quint16 header_len = readValue<quint16>(npy, 8);
+	const QByteArray dict = npy.mid(10, header_len);
+	const QByteArray shape = frames == 1 ? "(" + QByteArray::number(h) + ", " + QByteArray::number(w) + ")"
+					     : "(" + QByteArray::number(frames) + ", " + QByteArray::number(h) + ", " + QByteArray::number(w) + ")";
+	check(name + " npy header",
+	      npy.startsWith(QByteArray("\x93NUMPY\x01\x00", 8)) && (10 + header_len) % 64 == 0 && dict.endsWith('\n') && dict.contains("'descr': '<f4'") &&
+		dict.contains("'fortran_order': False") && dict.contains("'shape': " + shape));
+
+	bool values = npy.size() == 10 + header_len + (qsizetype)frames * h * w * 4;
+	for (int f = 0; f < frames && values; ++f) {
+		const VipNDArrayType<float> ar = createFrame(f, h, w);
+		values = memcmp(npy.data() + 10 + header_len + (qsizetype)f * h * w * 4, ar.ptr(), h * w * 4) == 0;
+	}
+	check(name + " npy values", values);
+}
+
+static void testMAT(int frames, int h, int w)
+{
+	const QString filename = QDir::tempPath() + "/NPZTest.mat";
+	const QByteArray content = writeFrames<VipMATDevice>(filename, frames, h, w);
+	QFile::remove(filename);
+	const std::string name = "mat " + std::to_string(frames) + " frames " + std::to_string(h) + "x" + std::to_string(w);
+	if (content.isEmpty()) {
+		check(name + " written", false);
+		return;
+	}
+
+	check(name + " file header", content.startsWith("MATLAB 5.0 MAT-file") && readValue<quint16>(content, 124) == 0x0100 && content.mid(126, 2) == "IM");
+
+	// matrix element: tag, array flags, dimensions
+	const quint32 matrix_size = readValue<quint32>(content, 132);
+	check(name + " matrix element", readValue<quint32>(content, 128) == 14 && 136 + (qsizetype)matrix_size == content.size() && readValue<quint32>(content, 144) == 7);
+	check(name + " dimensions",
+	      readValue<quint32>(content, 152) == 5 && readValue<quint32>(content, 156) == 12 && readValue<qint32>(content, 160) == h && readValue<qint32>(content, 164) == w &&
+		readValue<qint32>(content, 168) == frames);
+
+	// array name, then the real part in column-major order
+	const quint32 name_len = readValue<quint32>(content, 180);
+	const qsizetype real = 184 + ((name_len + 7) / 8) * 8;
+	bool values = readValue<quint32>(content, 176) == 1 && content.mid(184, name_len) == "arr_frames" && readValue<quint32>(content, real) == 7 &&
+		      readValue<quint32>(content, real + 4) == (quint32)frames * h * w * 4;
+	for (int f = 0; f < frames && values; ++f)
+		for (int y = 0; y < h && values; ++y)
+			for (int x = 0; x < w && values; ++x)
+				values = readValue<float>(content, real + 8 + (((qsizetype)f * w + x) * h + y) * 4) == (float)(f * 1000 + y * w + x);
+	check(name + " values", values);
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	testNPZ(1, 4, 6);
+	testNPZ(7, 3, 5);
+	testNPZ(50, 64, 80);
+	testMAT(1, 4, 6);
+	testMAT(7, 3, 5);
+
+	std::cout << (failed ? "Some NPZ/MAT checks FAILED" : "All NPZ/MAT checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
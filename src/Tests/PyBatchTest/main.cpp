@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <iostream>
+
+#include <qcoreapplication.h>
+
+#include "VipNDArray.h"
+#include "VipPyProcessing.h"
+
+/// Check the batch mode of VipPyBaseProcessing.
+/// Frames are pushed faster than they are processed, so that one batch drains several scheduled runs.
+/// Each input frame must produce exactly one output, in order. VipPyFunctionProcessing without function
+/// forwards the stacked frames, so no Python code is executed.
+/// Return a non zero value if a check fails.
+
+static bool failed = false;
+
+static void check(const std::string& name, bool ok)
+{
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+static void testBatch(int frames, int batch)
+{
+	VipPyFunctionProcessing proc;
+	proc.setScheduleStrategy(VipProcessingObject::Asynchronous);
+	proc.setBatchSize(batch);
+	proc.setMaxBatchLatency(0);
+	proc.outputAt(0)->setBufferDataEnabled(true);
+
+	for (int i = 0; i < frames; ++i) {
+		VipNDArrayType<float> ar(vipVector(16, 16));
+		std::fill(ar.ptr(), ar.ptr() + ar.size(), (float)i);
+		proc.inputAt(0)->setData(VipAnyData(QVariant::fromValue(VipNDArray(ar)), i));
+	}
+	proc.wait();
+
+	const VipAnyDataList out = proc.outputAt(0)->clearBufferedData();
+	bool ordered = out.size() == frames;
+	for (int i = 0; i < out.size() && ordered; ++i) {
+		const VipNDArrayType<float> ar = out[i].value<VipNDArray>();
+		ordered = out[i].time() == i && ar.shape() == vipVector(16, 16) && ar.ptr()[0] == (float)i;
+	}
+	const std::string name = std::to_string(frames) + " frames, batch size " + std::to_string(batch);
+	check(name + ": " + std::to_string(out.size()) + " outputs", out.size() == frames);
+	check(name + ": output times and values", ordered);
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	for (int batch : { 2, 8, 64 })
+		for (int frames : { 1, 10, 500 })
+			testBatch(frames, batch);
+
+	std::cout << (failed ? "Some batch checks FAILED" : "All batch checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include <qcoreapplication.h>
+
+#include "VipStandardProcessing.h"
+
+/// Check the shared executor of asynchronous processings.
+/// Frames are pushed while another thread repeatedly takes the processing run lock through reset(),
+/// which parks the scheduled task until the lock is released (see TaskPool::runShared()).
+/// Each input frame must produce exactly one output, in order, and the processing destructor must return
+/// even if tasks are still scheduled or parked.
+/// Return a non zero value if a check fails.
+
+static bool failed = false;
+
+static void check(const std::string& name, bool ok)
+{
+	std::cout << (ok ? "OK       " : "FAILED   ") << name << std::endl;
+	if (!ok)
+		failed = true;
+}
+
+static void testConcurrentRun(int frames)
+{
+	VipAbs proc;
+	proc.setScheduleStrategy(VipProcessingObject::Asynchronous);
+	proc.outputAt(0)->setBufferDataEnabled(true);
+
+	std::atomic<bool> stop{ false };
+	std::thread runner([&]() {
+		while (!stop.load())
+			proc.reset();
+	});
+
+	for (int i = 0; i < frames; ++i)
+		proc.inputAt(0)->setData(VipAnyData(QVariant(-(double)i), i));
+	proc.wait();
+
+	stop.store(true);
+	runner.join();
+	proc.wait();
+
+	const VipAnyDataList out = proc.outputAt(0)->clearBufferedData();
+	bool ordered = out.size() == frames;
+	for (int i = 0; i < out.size() && ordered; ++i)
+		ordered = out[i].time() == i && out[i].value<double>() == (double)i;
+
+	const std::string name = std::to_string(frames) + " frames";
+	check(name + ": " + std::to_string(out.size()) + " outputs", out.size() == frames);
+	check(name + ": output times and values", ordered);
+}
+
+static void testDestroyBusy(int frames)
+{
+	{
+		VipAbs proc;
+		proc.setScheduleStrategy(VipProcessingObject::Asynchronous);
+
+		std::atomic<bool> stop{ false };
+		std::thread runner([&]() {
+			while (!stop.load())
+				proc.reset();
+		});
+		for (int i = 0; i < frames; ++i)
+			proc.inputAt(0)->setData(VipAnyData(QVariant((double)i), i));
+		stop.store(true);
+		runner.join();
+		// destroy without waiting: pending tasks are dropped
+	}
+	check("destroy with " + std::to_string(frames) + " pending frames", true);
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+	VipProcessingManager::setSharedExecutorEnabled(true);
+
+	for (int frames : { 1, 100, 10000 })
+		testConcurrentRun(frames);
+	for (int frames : { 1, 100, 10000 })
+		testDestroyBusy(frames);
+
+	std::cout << (failed ? "Some shared executor checks FAILED" : "All shared executor checks passed") << std::endl;
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+#include <cmath>
+#include <iostream>
+
+#include <qcoreapplication.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qtextstream.h>
+
+#include "VipIODevice.h"
+#include "VipTextParser.h"
+
+/// Benchmark of numeric text file parsing.
+/// A CSV file of 1e7 rows (or the row count given as first argument) using ';' separator and ',' decimal separator
+/// is read with the previous implementation (readAll() and one QTextStream per line) and with VipCSVReader.
+/// A text file of images is read with operator>>(QTextStream&, VipNDArray&) and with VipTextFileReader.
+/// The throughput is printed in MB/s.
+/// Return a non zero value if the parsed values differ from the reference ones.
+
+static bool createCSV(const QString& filename, qint64 rows)
+{
+	QFile file(filename);
+	if (!file.open(QFile::WriteOnly))
+		return false;
+	QByteArray line;
+	file.write("sep=;\nTime (s);Voltage (V);Current (A)\n");
+	for (qint64 i = 0; i < rows; ++i) {
+		line = QByteArray::number(i * 1e-3, 'f', 3) + ";" + QByteArray::number(std::sin(i * 1e-4) * 230, 'g', 9) + ";" +
+		       QByteArray::number(std::cos(i * 1e-4) * 16, 'g', 9) + "\n";
+		line.replace('.', ',');
+		file.write(line);
+	}
+	return true;
+}
+
+static bool createImages(const QString& filename, int count, int width, int height)
+{
+	QFile file(filename);
+	if (!file.open(QFile::WriteOnly))
+		return false;
+	QByteArray line;
+	for (int i = 0; i < count; ++i) {
+		file.write("# image " + QByteArray::number(i) + "\n");
+		for (int y = 0; y < height; ++y) {
+			line.clear();
+			for (int x = 0; x < width; ++x)
+				line += QByteArray::number(1000 * (std::cos(x * 0.01 + i) + std::sin(y * 0.02) + 2), 'f', 2) + " ";
+			file.write(line + "\n");
+		}
+		file.write("\n");
+	}
+	return true;
+}
+
+/// Previous VipCSVReader parsing
+static QVector<VipPointVector> readCSVReference(const QString& filename)
+{
+	QFile in(filename);
+	if (!in.open(QFile::ReadOnly | QFile::Text))
+		return QVector<VipPointVector>();
+	QByteArray data = in.readAll();
+	QTextStream stream(data);
+	stream.readLine();
+	stream.readLine();
+
+	QVector<VipPointVector> vectors(2);
+	while (true) {
+		QString line = stream.readLine();
+		line.replace(";", " ");
+		QTextStream str(line.toLatin1());
+		str.setLocale(QLocale(QLocale::German));
+
+		double x = 0, y = 0;
+		str >> x;
+		if (str.status() != QTextStream::Ok)
+			break;
+		for (int i = 0; i < vectors.size(); ++i) {
+			str >> y;
+			if (str.status() != QTextStream::Ok)
+				break;
+			vectors[i].append(VipPoint(x, y));
+		}
+		if (str.status() != QTextStream::Ok)
+			break;
+	}
+	return vectors;
+}
+
+static QList<VipNDArray> readImagesReference(const QString& filename)
+{
+	QList<VipNDArray> res;
+	QFile in(filename);
+	if (!in.open(QFile::ReadOnly | QFile::Text))
+		return res;
+	QTextStream stream(&in);
+	while (true) {
+		VipNDArray ar;
+		stream >> ar;
+		if (ar.isEmpty())
+			break;
+		res.append(ar);
+	}
+	return res;
+}
+
+static double speed(const QString& filename, qint64 nsecs)
+{
+	return QFileInfo(filename).size() / (nsecs * 1e-3);
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	const qint64 rows = argc > 1 ? QByteArray(argv[1]).toLongLong() : 10000000;
+	const QString csv = QDir::tempPath() + "/TextParserBenchmark.csv";
+	const QString txt = QDir::tempPath() + "/TextParserBenchmark.txt";
+	if (!createCSV(csv, rows) || !createImages(txt, 50, 320, 256)) {
+		std::cout << "Unable to create the test files" << std::endl;
+		return -1;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	const QVector<VipPointVector> ref = readCSVReference(csv);
+	const double ref_speed = speed(csv, timer.nsecsElapsed());
+
+	timer.restart();
+	VipCSVReader reader;
+	reader.setPath(csv);
+	if (!reader.open(VipIODevice::ReadOnly)) {
+		std::cout << "Unable to open " << csv.toLatin1().data() << std::endl;
+		return -1;
+	}
+	const double csv_speed = speed(csv, timer.nsecsElapsed());
+	// both parsers are correctly rounded, the values must be identical
+	double diff = 0;
+	for (int c = 0; c < ref.size() && diff >= 0; ++c) {
+		const VipPointVector values = reader.outputAt(c)->value<VipPointVector>();
+		if (values.size() != ref[c].size())
+			diff = -1;
+		for (qsizetype i = 0; i < values.size() && diff >= 0; ++i)
+			diff = std::max(diff, std::max(std::abs(values[i].x() - ref[c][i].x()), std::abs(values[i].y() - ref[c][i].y())));
+	}
+	bool mismatch = diff != 0;
+	std::cout << "CSV " << rows << " rows: QTextStream " << ref_speed << " MB/s, VipCSVReader " << csv_speed << " MB/s (max diff " << diff << ")"
+		  << (mismatch ? " (MISMATCH)" : "") << std::endl;
+
+	timer.restart();
+	const QList<VipNDArray> images = readImagesReference(txt);
+	const double images_ref_speed = speed(txt, timer.nsecsElapsed());
+
+	timer.restart();
+	VipTextFileReader text_reader;
+	text_reader.setPath(txt);
+	if (!text_reader.open(VipIODevice::ReadOnly)) {
+		std::cout << "Unable to open " << txt.toLatin1().data() << std::endl;
+		return -1;
+	}
+	const double images_speed = speed(txt, timer.nsecsElapsed());
+	const bool images_mismatch = text_reader.size() != images.size();
+	mismatch = mismatch || images_mismatch;
+	std::cout << "Images: QTextStream " << images_ref_speed << " MB/s (" << images.size() << " images), VipTextFileReader " << images_speed << " MB/s ("
+		  << text_reader.size() << " images)" << (images_mismatch ? " (MISMATCH)" : "") << std::endl;
+
+	reader.close();
+	text_reader.close();
+	QFile::remove(csv);
+	QFile::remove(txt);
+	return mismatch ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <qcoreapplication.h>
+#include <qelapsedtimer.h>
+
+#include "VipNDArray.h"
+#include "VipWarpingKernels.h"
+
+/// Microbenchmark of VipWarping sampling.
+/// For each pixel type, print the throughput in Mpixels/s of the previous implementation
+/// (sampling the VipPointVector deformation field for each pixel of each frame)
+/// and of the compiled VipWarpingLUT with each kernel level supported by the CPU.
+/// Return a non zero value if a LUT output differs from the reference by more than the tolerance of its pixel type.
+
+static bool mismatch = false;
+
+static const char* levelName(VipWarpingKernels::Level level)
+{
+	switch (level) {
+		case VipWarpingKernels::Scalar:
+			return "scalar";
+		case VipWarpingKernels::AVX2:
+			return "avx2";
+	}
+	return "";
+}
+
+/// Smooth camera-like deformation field
+static VipPointVector createField(int w, int h)
+{
+	VipPointVector field(w * h);
+	for (int y = 0; y < h; ++y)
+		for (int x = 0; x < w; ++x) {
+			double sx = x + 7.3 * std::sin(y * 0.013) + 0.02 * (x - w / 2);
+			double sy = y + 5.1 * std::cos(x * 0.011) - 0.015 * (y - h / 2);
+			field[y * w + x] = VipPoint(qBound(0., sx, w - 1.), qBound(0., sy, h - 1.));
+		}
+	return field;
+}
+
+template<class T>
+static VipNDArray createImage(int w, int h)
+{
+	VipNDArrayType<T> ar(vipVector(h, w));
+	for (int y = 0; y < h; ++y)
+		for (int x = 0; x < w; ++x)
+			ar(y, x) = (T)(60 * (std::cos(x * 0.01) + std::sin(y * 0.02) + 2));
+	return ar;
+}
+
+static VipNDArray createRGBImage(int w, int h)
+{
+	QImage img(w, h, QImage::Format_ARGB32);
+	for (int y = 0; y < h; ++y)
+		for (int x = 0; x < w; ++x)
+			img.setPixel(x, y, qRgba(x & 255, y & 255, (x + y) & 255, 255));
+	return vipToArray(img);
+}
+
+/// Previous per-pixel implementation, used as reference
+template<class T>
+static void fieldNearest(const T* src, T* dst, int w, int h, const VipPointVector& field)
+{
+	for (int i = 0; i < w * h; ++i)
+		dst[i] = src[qRound(field[i].y()) * w + qRound(field[i].x())];
+}
+
+template<class T>
+static void fieldBilinear(const T* src, T* dst, int w, int h, const VipPointVector& field)
+{
+	for (int i = 0; i < w * h; ++i) {
+		const VipPoint p = field[i];
+		const int x0 = (int)p.x();
+		const int y0 = (int)p.y();
+		const int x1 = x0 + 1 == w ? x0 : x0 + 1;
+		const int y1 = y0 + 1 == h ? y0 : y0 + 1;
+		const double u = p.x() - x0;
+		const double v = p.y() - y0;
+		dst[i] = (T)((src[y0 * w + x0] * (1 - v) + src[y1 * w + x0] * v) * (1 - u) + (src[y0 * w + x1] * (1 - v) + src[y1 * w + x1] * v) * u);
+	}
+}
+
+static void fieldRGB(const QRgb* src, QRgb* dst, int w, int h, const VipPointVector& field)
+{
+	const int size = w * h;
+#pragma omp parallel for
+	for (int i = 0; i < size; ++i) {
+		const VipPoint p = field[i];
+		const int x0 = (int)p.x();
+		const int y0 = (int)p.y();
+		const int x1 = x0 + 1 >= w ? x0 : x0 + 1;
+		const int y1 = y0 + 1 >= h ? y0 : y0 + 1;
+		const double u = p.x() - x0;
+		const double v = p.y() - y0;
+		int c[4];
+		for (int s = 0; s < 4; ++s) {
+			const int shift = s * 8;
+			const double top = ((src[y0 * w + x0] >> shift) & 255) * (1 - u) + ((src[y0 * w + x1] >> shift) & 255) * u;
+			const double bottom = ((src[y1 * w + x0] >> shift) & 255) * (1 - u) + ((src[y1 * w + x1] >> shift) & 255) * u;
+			c[s] = (int)(top * (1 - v) + bottom * v);
+		}
+		dst[i] = (QRgb)(c[0] | (c[1] << 8) | (c[2] << 16) | (c[3] << 24));
+	}
+}
+
+template<class T>
+static void fieldWarp(const VipNDArray& in, VipNDArray& out, const VipPointVector& field)
+{
+	const int w = in.shape(1), h = in.shape(0);
+	if constexpr (std::is_same_v<T, VipRGB>)
+		fieldRGB((const QRgb*)in.constData(), (QRgb*)out.data(), w, h, field);
+	else if constexpr (std::is_floating_point_v<T>)
+		fieldBilinear((const T*)in.constData(), (T*)out.data(), w, h, field);
+	else
+		fieldNearest((const T*)in.constData(), (T*)out.data(), w, h, field);
+}
+
+/// Maximum absolute difference (per channel for RGB images)
+template<class T>
+static double maxDifference(const VipNDArray& a, const VipNDArray& b)
+{
+	double res = 0;
+	for (qsizetype i = 0; i < a.size(); ++i) {
+		if constexpr (std::is_same_v<T, VipRGB>) {
+			const QRgb pa = ((const QRgb*)a.constData())[i];
+			const QRgb pb = ((const QRgb*)b.constData())[i];
+			for (int s = 0; s < 32; s += 8)
+				res = std::max(res, (double)std::abs((int)((pa >> s) & 255) - (int)((pb >> s) & 255)));
+		}
+		else
+			res = std::max(res, std::abs((double)((const T*)a.constData())[i] - (double)((const T*)b.constData())[i]));
+	}
+	return res;
+}
+
+template<class T>
+static void benchmarkType(const VipNDArray& ar, const VipPointVector& field, const char* name, int repeat, double tolerance)
+{
+	const int w = ar.shape(1), h = ar.shape(0);
+	VipNDArray ref(ar.dataType(), ar.shape());
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < repeat; ++i)
+		fieldWarp<T>(ar, ref, field);
+	double speed = (ar.size() * (double)repeat) / (timer.nsecsElapsed() * 1e-3);
+	std::cout << name << ": field " << speed << " Mpixels/s";
+
+	timer.restart();
+	const VipWarpingLUT lut(field, w, h);
+	std::cout << " (LUT compiled in " << timer.elapsed() << " ms)";
+
+	for (int l = VipWarpingKernels::Scalar; l <= VipWarpingKernels::supportedLevel(); ++l) {
+		VipWarpingKernels::setLevel((VipWarpingKernels::Level)l);
+		VipNDArray out = lut.apply(ar);
+		timer.restart();
+		for (int i = 0; i < repeat; ++i)
+			out = lut.apply(ar);
+		speed = (ar.size() * (double)repeat) / (timer.nsecsElapsed() * 1e-3);
+		const double diff = maxDifference<T>(ref, out);
+		std::cout << ", " << levelName((VipWarpingKernels::Level)l) << " " << speed << " Mpixels/s (max diff " << diff << ")" << (diff <= tolerance ? "" : " (MISMATCH)");
+		if (diff > tolerance)
+			mismatch = true;
+	}
+	std::cout << std::endl;
+	VipWarpingKernels::setLevel(VipWarpingKernels::supportedLevel());
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	const int w = 1024, h = 1024;
+	const int repeat = 50;
+	const VipPointVector field = createField(w, h);
+
+	std::cout << "Supported level: " << levelName(VipWarpingKernels::supportedLevel()) << std::endl;
+	std::cout << "Field size: " << field.size() * sizeof(VipPoint) / (1024 * 1024) << " MB, LUT size: " << field.size() * 8 / (1024 * 1024) << " MB" << std::endl;
+
+	// The LUT stores 14 bits weights: nearest sampling might select the neighbour pixel when the fractional
+	// part is close to 0.5 (the image gradient is below 2 per pixel), and RGB sampling uses 8 bits weights
+	// with integer truncation.
+	benchmarkType<quint16>(createImage<quint16>(w, h), field, "uint16", repeat, 2);
+	benchmarkType<qint32>(createImage<qint32>(w, h), field, "int32", repeat, 2);
+	benchmarkType<float>(createImage<float>(w, h), field, "float", repeat, 1e-3);
+	benchmarkType<double>(createImage<double>(w, h), field, "double", repeat, 1e-3);
+	benchmarkType<VipRGB>(createRGBImage(w, h), field, "rgb", repeat, 2);
+	return mismatch ? 1 : 0;
+}